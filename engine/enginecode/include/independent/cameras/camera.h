@@ -7,7 +7,8 @@
  *********************************************************************/
 #pragma once
 
-#include "core/application.h"
+#include <glm/glm.hpp>
+#include "cameras/frustum.h"
 
  /**
 * @class Camera
@@ -36,5 +37,51 @@ public:
     {
         view = glm::inverse(transform);
     }
+
+    /**
+    * @brief Get the planes bounding what the camera sees.
+    * @return The frustum, in world space.
+    */
+    Engine::Frustum getFrustum() const
+    {
+        return Engine::Frustum::fromMatrix(projection * view);
+    }
+
+    /**
+    * @brief Get where the camera is.
+    * @return The camera's position, in world space.
+    */
+    glm::vec3 getPosition() const
+    {
+        return glm::vec3(glm::inverse(view)[3]);
+    }
+
+    /**
+    * @brief Get how many pixels tall a length of one unit appears at a distance of one unit, for a perspective projection.
+    * @param viewportHeight Height of the viewport in pixels.
+    * @return The scale, to be divided by the distance to a length.
+    */
+    float getProjectionScale(float viewportHeight) const
+    {
+        return projection[1][1] * viewportHeight * 0.5f;
+    }
+
+    /**
+    * @brief Get the world space ray through a point on the screen, as used for picking.
+    * @param screenPoint The point in pixels, from the top left corner as the mouse position is.
+    * @param viewportSize Size of the viewport in pixels.
+    * @param origin Receives the point on the near plane under the screen point.
+    * @param direction Receives the unit direction from the near plane to the far plane.
+    */
+    void screenPointToRay(const glm::vec2& screenPoint, const glm::vec2& viewportSize, glm::vec3& origin, glm::vec3& direction) const
+    {
+        glm::vec2 ndc(2.f * screenPoint.x / viewportSize.x - 1.f, 1.f - 2.f * screenPoint.y / viewportSize.y);
+        glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+
+        glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndc.x, ndc.y, -1.f, 1.f);
+        glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndc.x, ndc.y, 1.f, 1.f);
+        origin = glm::vec3(nearPoint) / nearPoint.w;
+        direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+    }
 };
 
@@ -8,7 +8,7 @@
 #pragma once
 
 #include "cameras/camera.h"
-#include "events/event.h"
+#include "events/events.h"
 
  /**
 * @class CameraController
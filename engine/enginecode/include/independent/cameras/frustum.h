@@ -0,0 +1,81 @@
+/*****************************************************************//**
+@file   frustum.h
+@brief  The six planes bounding a camera's view volume, extracted from its view projection matrix.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Engine
+{
+    /**
+    * @struct Frustum
+    * @brief Planes stored as (normal, distance) with normals pointing into the volume, so a point p is inside when dot(normal, p) + distance >= 0 for every plane.
+    */
+    struct Frustum
+    {
+        /** @brief Index of each plane. */
+        enum Plane { Left = 0, Right, Bottom, Top, Near, Far, Count };
+
+        glm::vec4 planes[Count]; /**< The planes, with unit normals. */
+
+        /**
+        * @brief Extract the planes of a view projection matrix, for OpenGL's -w to w clip space.
+        * @param viewProjection The matrix, projection * view for a camera.
+        * @return The frustum, in the space the matrix transforms from.
+        */
+        static Frustum fromMatrix(const glm::mat4& viewProjection)
+        {
+            // Each plane is the sum or difference of the matrix's last row and one other.
+            glm::vec4 rows[4];
+            for (int r = 0; r < 4; r++) rows[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+
+            Frustum frustum;
+            frustum.planes[Left] = rows[3] + rows[0];
+            frustum.planes[Right] = rows[3] - rows[0];
+            frustum.planes[Bottom] = rows[3] + rows[1];
+            frustum.planes[Top] = rows[3] - rows[1];
+            frustum.planes[Near] = rows[3] + rows[2];
+            frustum.planes[Far] = rows[3] - rows[2];
+
+            for (glm::vec4& plane : frustum.planes) plane = plane / glm::length(glm::vec3(plane));
+            return frustum;
+        }
+
+        /**
+        * @brief Check if a sphere is at least partly inside.
+        * @param centre Centre of the sphere.
+        * @param radius Radius of the sphere.
+        * @return False only if the sphere is wholly outside one plane.
+        */
+        bool intersectsSphere(const glm::vec3& centre, float radius) const
+        {
+            for (const glm::vec4& plane : planes)
+            {
+                if (glm::dot(glm::vec3(plane), centre) + plane.w < -radius) return false;
+            }
+            return true;
+        }
+
+        /**
+        * @brief Check if an axis aligned box is at least partly inside.
+        * Boxes near a corner of the frustum may be reported inside when they are not, as with every plane test.
+        * @param centre Centre of the box.
+        * @param extent Half the size of the box on each axis.
+        * @return False only if the box is wholly outside one plane.
+        */
+        bool intersectsBox(const glm::vec3& centre, const glm::vec3& extent) const
+        {
+            for (const glm::vec4& plane : planes)
+            {
+                // The box's extent projected onto the plane normal.
+                float radius = glm::dot(glm::abs(glm::vec3(plane)), extent);
+                if (glm::dot(glm::vec3(plane), centre) + plane.w < -radius) return false;
+            }
+            return true;
+        }
+    };
+}
@@ -0,0 +1,26 @@
+/*****************************************************************//**
+@file   assetCache.h
+@brief  Naming of the files under ./cache/ which hold source assets converted to their runtime formats.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <string>
+
+namespace Engine
+{
+    namespace AssetCache
+    {
+        /**
+        * @brief Get the path the converted form of a source asset is cached at.
+        * The name is the flattened source path followed by a hash of the normalised source path, so distinct sources do not share a file.
+        * @param sourcePath Path of the source asset.
+        * @param folder Folder under ./cache/ holding this kind of asset, such as "textures".
+        * @param extension Extension of the cache file, including the dot.
+        * @return The cache file path.
+        */
+        std::string cachePath(const std::string& sourcePath, const char* folder, const char* extension);
+    }
+}
@@ -25,23 +25,60 @@ namespace Engine
         uint32_t m_size; /**< The size of the element in bytes. */
         uint32_t m_offset; /**< The offset of the element within the buffer. */
         bool m_normalised; /**< Flag indicating whether the element's values are normalized. */
+        uint32_t m_divisor; /**< Number of instances drawn before the element advances, 0 for per vertex data. */
 
         /** @brief Default constructor for BufferElement.*/
-        BufferElement() {}
+        constexpr BufferElement() : m_dataType(ShaderDataType::None), m_size(0), m_offset(0), m_normalised(false), m_divisor(0) {}
 
         /**
         * @brief Constructor for BufferElement.
         * @param dataType The data type of the element.
         * @param normalised Flag indicating whether the element's values are normalized.
+        * @param divisor Number of instances drawn before the element advances, 0 for per vertex data.
         */
-        BufferElement(ShaderDataType dataType, bool normalised = false) :
+        constexpr BufferElement(ShaderDataType dataType, bool normalised = false, uint32_t divisor = 0, uint32_t offset = 0) :
             m_dataType(dataType),
             m_size(SDT::size(dataType)),
-            m_offset(0),
-            m_normalised(normalised)
+            m_offset(offset),
+            m_normalised(normalised),
+            m_divisor(divisor)
         {}
     };
 
+    /**
+    * @class BufferLayoutView
+    * @brief A non owning view of a layout's elements, either a BufferLayout's or a VertexLayout's static table.
+    */
+    class BufferLayoutView
+    {
+    public:
+        /** @brief Default constructor for BufferLayoutView, viewing no elements. */
+        constexpr BufferLayoutView() : m_elements(nullptr), m_count(0), m_stride(0) {}
+
+        /**
+        * @brief Constructor for BufferLayoutView.
+        * @param elements The first element, which must outlive the view.
+        * @param count The number of elements.
+        * @param stride The stride value for the layout.
+        */
+        constexpr BufferLayoutView(const BufferElement* elements, uint32_t count, uint32_t stride) : m_elements(elements), m_count(count), m_stride(stride) {}
+
+        /**
+        * @brief Get the stride value of the buffer layout.
+        * @return The stride value.
+        */
+        constexpr uint32_t getStride() const { return m_stride; }
+
+        // Iterators for BufferElement collection
+        constexpr const BufferElement* begin() const { return m_elements; }
+        constexpr const BufferElement* end() const { return m_elements + m_count; }
+
+    private:
+        const BufferElement* m_elements; /**< The viewed elements. */
+        uint32_t m_count; /**< Number of viewed elements. */
+        uint32_t m_stride; /**< Stride value for the buffer layout. */
+    };
+
     /**
     * @class BufferLayout
     * @brief Represents the layout of a buffer containing multiple elements.
@@ -52,7 +89,13 @@ namespace Engine
         /**
          * @brief Default constructor for BufferLayout.
          */
-        BufferLayout() {};
+        BufferLayout() : m_stride(0) {};
+
+        /**
+        * @brief Constructor for BufferLayout, copying the elements and stride of a view.
+        * @param view The view to copy, whose offsets are kept as they are.
+        */
+        BufferLayout(const BufferLayoutView& view) : m_elements(view.begin(), view.end()), m_stride(view.getStride()) {}
 
         /**
         * @brief Constructor for BufferLayout.
@@ -82,6 +125,12 @@ namespace Engine
         inline std::vector<BufferElement>::const_iterator begin() const { return m_elements.begin(); }
         inline std::vector<BufferElement>::const_iterator end() const { return m_elements.end(); }
 
+        /**
+        * @brief Get a view of the layout's elements, valid until the layout is changed or destroyed.
+        * @return The view.
+        */
+        inline BufferLayoutView getView() const { return BufferLayoutView(m_elements.data(), static_cast<uint32_t>(m_elements.size()), m_stride); }
+
     private:
         std::vector<BufferElement> m_elements; /**< Collection of BufferElement objects in the layout. */
         uint32_t m_stride; /**< Stride value for the buffer layout. */
@@ -0,0 +1,23 @@
+/*****************************************************************//**
+@file   bufferUsage.h
+@brief  The BufferUsage enum describes how often a GPU buffer's contents are expected to change after creation.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+namespace Engine
+{
+    /**
+    * @enum BufferUsage
+    * @brief The update policy a buffer is created with, which decides its storage and memory placement.
+    */
+    enum class BufferUsage
+    {
+        Immutable = 0, /**< Written once at creation, any later edit is an error. */
+        Static = 1, /**< Written at creation and rarely edited, the default. */
+        Dynamic = 2, /**< Partially updated now and then. */
+        Stream = 3 /**< Fully rewritten every frame, full edits orphan the previous contents. */
+    };
+}
@@ -0,0 +1,146 @@
+/*****************************************************************//**
+@file   frustumCulling.h
+@brief  Frustum tests of many bounding spheres or boxes at once, four or eight per instruction as the CPU allows, producing a compact list of the visible ones.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "cameras/frustum.h"
+#include "systems/cpuFeatures.h"
+
+namespace Engine
+{
+    class WorkerPool;
+
+    /**
+    * @struct SphereBounds
+    * @brief Bounding spheres with each component in its own array, so consecutive spheres load into one register.
+    */
+    struct SphereBounds
+    {
+        std::vector<float> x; /**< Centre x of each sphere. */
+        std::vector<float> y; /**< Centre y of each sphere. */
+        std::vector<float> z; /**< Centre z of each sphere. */
+        std::vector<float> radius; /**< Radius of each sphere. */
+
+        /**
+        * @brief Append a sphere.
+        * @param centre Centre of the sphere.
+        * @param r Radius of the sphere.
+        */
+        inline void add(const glm::vec3& centre, float r) { x.push_back(centre.x); y.push_back(centre.y); z.push_back(centre.z); radius.push_back(r); }
+
+        inline void clear() { x.clear(); y.clear(); z.clear(); radius.clear(); } /**< Remove every sphere. */
+        inline uint32_t size() const { return static_cast<uint32_t>(x.size()); } /**< Get the number of spheres. */
+    };
+
+    /**
+    * @struct BoxBounds
+    * @brief Axis aligned bounding boxes as centres and half extents, with each component in its own array.
+    */
+    struct BoxBounds
+    {
+        std::vector<float> centreX; /**< Centre x of each box. */
+        std::vector<float> centreY; /**< Centre y of each box. */
+        std::vector<float> centreZ; /**< Centre z of each box. */
+        std::vector<float> extentX; /**< Half the width of each box. */
+        std::vector<float> extentY; /**< Half the height of each box. */
+        std::vector<float> extentZ; /**< Half the depth of each box. */
+
+        /**
+        * @brief Append a box.
+        * @param centre Centre of the box.
+        * @param extent Half the size of the box on each axis.
+        */
+        inline void add(const glm::vec3& centre, const glm::vec3& extent)
+        {
+            centreX.push_back(centre.x); centreY.push_back(centre.y); centreZ.push_back(centre.z);
+            extentX.push_back(extent.x); extentY.push_back(extent.y); extentZ.push_back(extent.z);
+        }
+
+        inline void clear() { centreX.clear(); centreY.clear(); centreZ.clear(); extentX.clear(); extentY.clear(); extentZ.clear(); } /**< Remove every box. */
+        inline uint32_t size() const { return static_cast<uint32_t>(centreX.size()); } /**< Get the number of boxes. */
+    };
+
+    namespace FrustumCulling
+    {
+        const uint32_t blockSize = 4096; /**< Number of bounds each worker tests at a time, a multiple of every vector width. */
+
+        /**
+        * @brief Get the widest instruction set the tests run with on this CPU.
+        * @return "AVX2", "SSE2" or "Scalar".
+        */
+        const char* getInstructionSet();
+
+        /**
+        * @brief Get the world space box around a transformed local space box.
+        * @param world The transform.
+        * @param min Smallest corner of the local box.
+        * @param max Largest corner of the local box.
+        * @param centre Centre of the world box.
+        * @param extent Half the size of the world box on each axis.
+        */
+        void transformBox(const glm::mat4& world, const glm::vec3& min, const glm::vec3& max, glm::vec3& centre, glm::vec3& extent);
+
+        /**
+        * @brief Test a range of spheres against a frustum.
+        * @param frustum The frustum.
+        * @param spheres The spheres.
+        * @param begin First sphere to test.
+        * @param end One past the last sphere to test.
+        * @param visible Receives the index of each sphere at least partly inside, in order, room for end - begin indices.
+        * @param set The instruction set to use, lowered to the supported one if wider.
+        * @return Number of visible spheres.
+        */
+        uint32_t cullSpheres(const Frustum& frustum, const SphereBounds& spheres, uint32_t begin, uint32_t end, uint32_t* visible, InstructionSet set);
+
+        /** @brief Test a range of spheres with the widest supported instruction set, see cullSpheres above. */
+        inline uint32_t cullSpheres(const Frustum& frustum, const SphereBounds& spheres, uint32_t begin, uint32_t end, uint32_t* visible)
+        {
+            return cullSpheres(frustum, spheres, begin, end, visible, CpuFeatures::getSupportedInstructionSet());
+        }
+
+        /**
+        * @brief Test a range of boxes against a frustum.
+        * @param frustum The frustum.
+        * @param boxes The boxes.
+        * @param begin First box to test.
+        * @param end One past the last box to test.
+        * @param visible Receives the index of each box at least partly inside, in order, room for end - begin indices.
+        * @param set The instruction set to use, lowered to the supported one if wider.
+        * @return Number of visible boxes.
+        */
+        uint32_t cullBoxes(const Frustum& frustum, const BoxBounds& boxes, uint32_t begin, uint32_t end, uint32_t* visible, InstructionSet set);
+
+        /** @brief Test a range of boxes with the widest supported instruction set, see cullBoxes above. */
+        inline uint32_t cullBoxes(const Frustum& frustum, const BoxBounds& boxes, uint32_t begin, uint32_t end, uint32_t* visible)
+        {
+            return cullBoxes(frustum, boxes, begin, end, visible, CpuFeatures::getSupportedInstructionSet());
+        }
+
+        /**
+        * @brief Test every sphere against a frustum, split across a pool's workers when there are enough.
+        * @param frustum The frustum.
+        * @param spheres The spheres.
+        * @param visible Resized to the index of each visible sphere, in order.
+        * @param workers The pool to split the tests across, null to test on the calling thread.
+        * @return Number of visible spheres.
+        */
+        uint32_t cullSpheres(const Frustum& frustum, const SphereBounds& spheres, std::vector<uint32_t>& visible, WorkerPool* workers = nullptr);
+
+        /**
+        * @brief Test every box against a frustum, split across a pool's workers when there are enough.
+        * @param frustum The frustum.
+        * @param boxes The boxes.
+        * @param visible Resized to the index of each visible box, in order.
+        * @param workers The pool to split the tests across, null to test on the calling thread.
+        * @return Number of visible boxes.
+        */
+        uint32_t cullBoxes(const Frustum& frustum, const BoxBounds& boxes, std::vector<uint32_t>& visible, WorkerPool* workers = nullptr);
+    }
+}
@@ -8,9 +8,20 @@
 #pragma once
 
 #include <cstdint>
+#include "rendering/bufferUsage.h"
 
 namespace Engine
 {
+    /**
+    * @enum IndexType
+    * @brief Width of the indices an index buffer stores.
+    */
+    enum class IndexType : uint8_t
+    {
+        UInt16 = 0, ///< 16 bit indices, for meshes of up to 65536 vertices.
+        UInt32      ///< 32 bit indices.
+    };
+
     /**
     * @class IndexBuffer
     * @brief Abstract base class for index buffers used in graphics rendering.
@@ -33,16 +44,32 @@ namespace Engine
         */
         virtual inline uint32_t getCount() const = 0;
 
+        /**
+        * @brief Get the width of the indices in the index buffer.
+        * @return The index type.
+        */
+        virtual inline IndexType getType() const = 0;
+
         /**
         * @brief Create an instance of an IndexBuffer.
         *
         * This function creates and returns an instance of an IndexBuffer.
-        * It takes the indices and their count as parameters.
+        * It takes the indices, their count and the buffer's update policy as parameters.
         *
         * @param indices Pointer to an array of indices.
         * @param count The count of indices in the array.
+        * @param usage The update policy of the buffer.
+        * @return A pointer to the created IndexBuffer instance.
+        */
+        static IndexBuffer* create(uint32_t* indices, uint32_t count, BufferUsage usage = BufferUsage::Static);
+
+        /**
+        * @brief Create an instance of an IndexBuffer holding 16 bit indices.
+        * @param indices Pointer to an array of indices.
+        * @param count The count of indices in the array.
+        * @param usage The update policy of the buffer.
         * @return A pointer to the created IndexBuffer instance.
         */
-        static IndexBuffer* create(uint32_t* indices, uint32_t count);
+        static IndexBuffer* create(uint16_t* indices, uint32_t count, BufferUsage usage = BufferUsage::Static);
     };
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+/*****************************************************************//**
+@file   indirectDraw.h
+@brief  The commands read by multi draw indirect calls, and how a frame's draws of pooled meshes are turned into them.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+
+namespace Engine
+{
+    /**
+    * @struct DrawElementsIndirectCommand
+    * @brief The command layout read by glMultiDrawElementsIndirect.
+    */
+    struct DrawElementsIndirectCommand
+    {
+        uint32_t count; /**< Number of indices to draw. */
+        uint32_t instanceCount; /**< Number of instances to draw. */
+        uint32_t firstIndex; /**< First index in the pool's index buffer. */
+        int32_t baseVertex; /**< Value added to each index, the first vertex of the mesh in the pool. */
+        uint32_t baseInstance; /**< First instance, used to fetch the draw's per instance data. */
+    };
+
+    /**
+    * @struct MeshHandle
+    * @brief The location of a mesh inside a mesh pool.
+    */
+    struct MeshHandle
+    {
+        uint32_t firstIndex = 0; /**< First index of the mesh in the pool's index buffer. */
+        uint32_t indexCount = 0; /**< Number of indices in the mesh. */
+        int32_t baseVertex = 0; /**< First vertex of the mesh in the pool's vertex buffer. */
+
+        /**
+        * @brief Check if the handle refers to a mesh.
+        * @return True if the mesh was added to the pool.
+        */
+        inline bool isValid() const { return indexCount > 0; }
+
+        /**
+        * @brief Check if two handles refer to the same mesh.
+        * @param other The other handle.
+        * @return True if both draw the same indices from the same vertices.
+        */
+        inline bool operator==(const MeshHandle& other) const { return firstIndex == other.firstIndex && indexCount == other.indexCount && baseVertex == other.baseVertex; }
+    };
+
+    namespace IndirectDraw
+    {
+        /**
+        * @brief Build the commands drawing a list of pooled meshes, one instance each.
+        * Consecutive draws of the same mesh become one command with an instance per draw, so the
+        * instance data of draw i must be stored at instance firstInstance + i. Invalid handles are skipped.
+        * @param meshes The mesh of each draw, in the order their instance data is stored.
+        * @param count Number of draws.
+        * @param firstInstance The instance holding the first draw's data.
+        * @param commands Receives the commands, with room for count of them.
+        * @return The number of commands written.
+        */
+        uint32_t buildCommands(const MeshHandle* meshes, uint32_t count, uint32_t firstInstance, DrawElementsIndirectCommand* commands);
+    }
+}
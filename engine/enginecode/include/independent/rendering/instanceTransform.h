@@ -0,0 +1,34 @@
+/*****************************************************************//**
+@file   instanceTransform.h
+@brief  The per instance data read by instanced shaders, a model matrix and its normal matrix advanced once per instance.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "rendering/vertexLayout.h"
+
+namespace Engine
+{
+    /**
+    * @struct InstanceTransform
+    * @brief One instance's transform, as stored in an instance vertex buffer.
+    * Added to a vertex array after the mesh's own buffer, so the matrices follow the mesh's attributes:
+    * with a position, normal and texture coordinate that puts a_model at location 3 and a_normalMatrix at location 7.
+    */
+    struct InstanceTransform
+    {
+        using Layout = VertexLayout<VertexAttributes::InstanceMat4, VertexAttributes::InstanceMat3>;
+
+        static constexpr uint32_t modelLocation = 3; /**< Location of a_model in the instanced shaders. */
+        static constexpr uint32_t normalMatrixLocation = 7; /**< Location of a_normalMatrix in the instanced shaders. */
+
+        glm::mat4 model; /**< The instance's model matrix. */
+        glm::mat3 normalMatrix; /**< The inverse transpose of the model matrix's upper 3x3. */
+    };
+
+    static_assert(InstanceTransform::Layout::matches<InstanceTransform>({ offsetof(InstanceTransform, model), offsetof(InstanceTransform, normalMatrix) }), "InstanceTransform layout mismatch");
+}
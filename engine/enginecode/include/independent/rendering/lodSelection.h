@@ -0,0 +1,56 @@
+/*****************************************************************//**
+@file   lodSelection.h
+@brief  Choice of a mesh's level of detail from how far its simplification error would show on screen.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include "rendering/meshFile.h"
+
+namespace Engine
+{
+    namespace LodSelection
+    {
+        /**
+        * @brief Get how many pixels an error appears as on screen.
+        * @param error The error, in world units.
+        * @param distance Distance from the camera to the nearest point of the object.
+        * @param projectionScale Pixels per unit at a distance of one, from Camera::getProjectionScale.
+        * @return The error in pixels.
+        */
+        inline float getScreenError(float error, float distance, float projectionScale)
+        {
+            return error * projectionScale / std::max(distance, 1e-4f);
+        }
+
+        /**
+        * @brief Choose the coarsest level whose error stays under a threshold on screen.
+        * A level coarser than the current one must come in under the threshold by the hysteresis fraction and a finer level is only
+        * swapped back to once the current one exceeds it by as much, so an object resting near a boundary does not flicker between levels.
+        * @param lods The levels, finest first, with errors that never decrease.
+        * @param lodCount Number of levels, at least one.
+        * @param scale Converts a level's model space error to world units, the object's largest scale axis.
+        * @param distance Distance from the camera to the nearest point of the object.
+        * @param projectionScale Pixels per unit at a distance of one, from Camera::getProjectionScale.
+        * @param current The level drawn last frame.
+        * @param threshold Largest error to allow, in pixels.
+        * @param hysteresis Fraction of the threshold to widen the current level's band by.
+        * @return The level to draw.
+        */
+        inline uint32_t select(const MeshLod* lods, uint32_t lodCount, float scale, float distance, float projectionScale, uint32_t current, float threshold = 1.f, float hysteresis = 0.25f)
+        {
+            uint32_t level = 0;
+            for (uint32_t i = 1; i < lodCount; i++)
+            {
+                float limit = threshold * (i <= current ? 1.f + hysteresis : 1.f - hysteresis);
+                if (getScreenError(lods[i].error * scale, distance, projectionScale) > limit) break;
+                level = i;
+            }
+            return level;
+        }
+    }
+}
@@ -0,0 +1,161 @@
+/*****************************************************************//**
+@file   meshFile.h
+@brief  The engine's binary mesh format, laid out so vertex and index data can be uploaded straight from a memory mapped file.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "rendering/bufferLayout.h"
+#include "rendering/indexBuffer.h"
+
+namespace Engine
+{
+    /**
+    * @struct MeshBounds
+    * @brief Axis aligned bounding box, stored as plain floats so it can be read in place.
+    */
+    struct MeshBounds
+    {
+        float min[3] = { 0.f, 0.f, 0.f }; /**< Smallest corner. */
+        float max[3] = { 0.f, 0.f, 0.f }; /**< Largest corner. */
+    };
+
+    /**
+    * @struct Submesh
+    * @brief A range of a mesh's indices drawn with one material.
+    */
+    struct Submesh
+    {
+        uint32_t firstIndex = 0; /**< First index of the range. */
+        uint32_t indexCount = 0; /**< Number of indices in the range. */
+        MeshBounds bounds; /**< Bounds of the range's vertices. */
+    };
+
+    /**
+    * @struct MeshLod
+    * @brief A range of a mesh's indices drawing the whole mesh at one level of detail, using the same vertices as every other level.
+    * The level's own submesh ranges lie within it, one for each full detail submesh and in the same order, so each keeps its material.
+    */
+    struct MeshLod
+    {
+        uint32_t firstIndex = 0; /**< First index of the range. */
+        uint32_t indexCount = 0; /**< Number of indices in the range. */
+        float error = 0.f; /**< How far the level strays from the full detail surface, in model units. */
+        uint32_t firstSubmesh = 0; /**< First of the level's entries in the submesh table. */
+        uint32_t submeshCount = 0; /**< Number of the level's entries in the submesh table, some may be empty. */
+        uint32_t padding[3] = {}; /**< Unused, keeps the table 16 byte aligned. */
+    };
+
+    /**
+    * @struct MeshFileAttribute
+    * @brief One vertex attribute as stored in a mesh file.
+    */
+    struct MeshFileAttribute
+    {
+        uint32_t dataType; /**< The ShaderDataType of the attribute. */
+        uint32_t offset; /**< Offset of the attribute within a vertex. */
+        uint32_t normalised; /**< Non zero if integer values are read as normalised. */
+        uint32_t padding; /**< Unused, keeps the table 16 byte aligned. */
+    };
+
+    /**
+    * @struct MeshFileHeader
+    * @brief The header at the start of a mesh file.
+    * The submesh and level of detail tables and the vertex and index blobs follow at the stored offsets, each aligned to MeshFile::blobAlignment.
+    */
+    struct MeshFileHeader
+    {
+        uint32_t magic; /**< MeshFile::magic. */
+        uint32_t version; /**< MeshFile::version. */
+        uint32_t vertexCount; /**< Number of vertices. */
+        uint32_t vertexStride; /**< Size of a vertex in bytes. */
+        uint32_t indexCount; /**< Number of indices. */
+        uint32_t indexType; /**< The IndexType of the indices. */
+        uint32_t attributeCount; /**< Number of entries used in the attribute table. */
+        uint32_t submeshCount; /**< Number of entries in the submesh table. */
+        MeshFileAttribute attributes[8]; /**< The vertex layout. */
+        MeshBounds bounds; /**< Bounds of every vertex. */
+        uint32_t lodCount; /**< Number of entries in the level of detail table, at least one. */
+        uint32_t padding; /**< Unused, aligns the offsets below. */
+        uint64_t submeshOffset; /**< Offset of the submesh table from the start of the file. */
+        uint64_t lodOffset; /**< Offset of the level of detail table from the start of the file. */
+        uint64_t vertexOffset; /**< Offset of the vertex blob from the start of the file. */
+        uint64_t indexOffset; /**< Offset of the index blob from the start of the file. */
+        uint64_t fileSize; /**< Size of the whole file, a shorter file was truncated. */
+    };
+
+    /**
+    * @struct MeshData
+    * @brief A mesh held in memory, as produced by an importer and written to a mesh file.
+    */
+    struct MeshData
+    {
+        BufferLayout layout; /**< The vertex layout. */
+        std::vector<uint8_t> vertices; /**< Vertex data, layout.getStride() bytes per vertex. */
+        std::vector<uint32_t> indices; /**< Triangle lists of every level of detail, narrowed to 16 bits when written if every index fits. */
+        std::vector<Submesh> submeshes; /**< Index ranges of every level of detail, each level's found through its MeshLod. */
+        std::vector<MeshLod> lods; /**< Index ranges of each level of detail, finest first, empty for one level covering every index and submesh. */
+        MeshBounds bounds; /**< Bounds of every vertex. */
+    };
+
+    namespace MeshFile
+    {
+        const uint32_t magic = 0x48534D47; /**< "GMSH" */
+        const uint32_t version = 4; /**< Bumped whenever the layout of the file, or of the vertices imported into it, changes. */
+        const uint32_t blobAlignment = 16; /**< Alignment of each table and blob within the file. */
+
+        /**
+        * @brief Write a mesh file.
+        * @param filepath Path of the file.
+        * @param mesh The mesh to write.
+        * @return True if the file was written.
+        */
+        bool write(const std::string& filepath, const MeshData& mesh);
+
+        /**
+        * @brief Get the path an imported source mesh is cached at.
+        * @param sourcePath Path of the source mesh.
+        * @return The mesh file path under ./cache/meshes/.
+        */
+        std::string cachePath(const std::string& sourcePath);
+    }
+
+    /**
+    * @class MeshFileView
+    * @brief Reads a mesh file in place, such as from a MappedFile, without copying any of it.
+    */
+    class MeshFileView
+    {
+    public:
+        /**
+        * @brief Check a mesh file's header and that every table and blob lies inside it.
+        * @param data The first byte of the file, which must stay valid while the view is used.
+        * @param size Size of the file in bytes.
+        * @param error Why the file was rejected.
+        * @return True if the file can be read.
+        */
+        bool open(const uint8_t* data, size_t size, std::string& error);
+
+        inline const MeshFileHeader& getHeader() const { return *m_header; } /**< Get the file's header. */
+        inline const void* getVertices() const { return m_data + m_header->vertexOffset; } /**< Get the vertex blob. */
+        inline const void* getIndices() const { return m_data + m_header->indexOffset; } /**< Get the index blob. */
+        inline const Submesh* getSubmeshes() const { return reinterpret_cast<const Submesh*>(m_data + m_header->submeshOffset); } /**< Get the submesh table. */
+        inline const MeshLod* getLods() const { return reinterpret_cast<const MeshLod*>(m_data + m_header->lodOffset); } /**< Get the level of detail table. */
+        inline IndexType getIndexType() const { return static_cast<IndexType>(m_header->indexType); } /**< Get the width of the indices. */
+
+        /**
+        * @brief Build the vertex layout stored in the header.
+        * @return The layout.
+        */
+        BufferLayout getLayout() const;
+
+    private:
+        const uint8_t* m_data = nullptr; /**< The file's contents. */
+        const MeshFileHeader* m_header = nullptr; /**< The header, at the start of the contents. */
+    };
+}
@@ -0,0 +1,59 @@
+/*****************************************************************//**
+@file   meshImporter.h
+@brief  Conversion of source models into the engine's binary mesh format, packed, optimised and cached on first load.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <glm/glm.hpp>
+#include "rendering/meshFile.h"
+#include "rendering/vertexLayout.h"
+
+namespace Engine
+{
+    namespace MeshImporter
+    {
+        const uint32_t maxLods = 4; /**< Most levels of detail built for a mesh, including full detail. */
+
+        /**
+        * @struct Vertex
+        * @brief The vertex every imported mesh is packed into, 20 bytes.
+        */
+        struct Vertex
+        {
+            using Layout = VertexLayout<VertexAttributes::Float3, VertexAttributes::Oct16, VertexAttributes::Half2>;
+
+            glm::vec3 position; /**< Position, read as a vec3. */
+            uint32_t normal; /**< Normal octahedral encoded as two shorts, read as a vec2 and decoded with octDecode. */
+            std::array<uint16_t, 2> uv; /**< Texture coordinates as halves, read as a vec2. */
+        };
+
+        /**
+        * @brief Import a Wavefront OBJ file.
+        * Polygons are triangulated as fans, and each o, g or usemtl line starts a new submesh.
+        * Corners without a normal take the smooth normal of their position. Texture coordinates
+        * are flipped vertically, as images are loaded top row first.
+        * Every submesh is reordered for the post-transform cache and overdraw, and the vertices for fetch locality.
+        * Coarser levels of detail are then built by edge collapse, each about half the last, sharing the vertices of full detail.
+        * @param filepath Path to the OBJ file.
+        * @param mesh The imported mesh.
+        * @param error Why the import failed.
+        * @return True if the file was read and holds at least one triangle.
+        */
+        bool importOBJ(const std::string& filepath, MeshData& mesh, std::string& error);
+
+        /**
+        * @brief Get the mesh file for a source model, importing and caching it if the cache is missing or older than the source.
+        * Source models are imported by extension, a .gmsh path is returned unchanged.
+        * @param sourcePath Path to the source model.
+        * @param error Why the model could not be imported.
+        * @return The path of the mesh file, empty if there is none.
+        */
+        std::string convert(const std::string& sourcePath, std::string& error);
+    }
+}
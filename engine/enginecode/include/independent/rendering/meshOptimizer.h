@@ -0,0 +1,88 @@
+/*****************************************************************//**
+@file   meshOptimizer.h
+@brief  Load time reordering of indexed triangle meshes for the post-transform cache, overdraw and vertex fetch, and narrowing of their indices.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Engine
+{
+    namespace MeshOptimizer
+    {
+        const uint32_t defaultCacheSize = 16; /**< Post-transform cache entries assumed when reordering, a conservative size for current hardware. */
+
+        /**
+        * @brief Simulate a FIFO post-transform cache over a triangle list.
+        * @param indices The triangle list.
+        * @param indexCount Number of indices, a multiple of 3.
+        * @param vertexCount Number of vertices the indices refer to.
+        * @param cacheSize Number of cache entries.
+        * @return The average cache miss ratio, vertices transformed per triangle, from 3 at worst to about 0.5 at best.
+        */
+        float cacheMissRatio(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize = defaultCacheSize);
+
+        /**
+        * @brief Reorder triangles so vertices are reused while still in the post-transform cache, using Tipsify.
+        * @param indices The triangle list, reordered in place.
+        * @param indexCount Number of indices, a multiple of 3.
+        * @param vertexCount Number of vertices the indices refer to.
+        * @param cacheSize Number of cache entries to optimise for.
+        */
+        void optimizeVertexCache(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize = defaultCacheSize);
+
+        /**
+        * @brief Reorder clusters of a cache optimised triangle list so outward facing clusters draw first and occlude the rest.
+        * Clusters are only split where the cache miss ratio stays within the threshold of the cache optimised order.
+        * @param indices The triangle list, reordered in place, which should already be cache optimised.
+        * @param indexCount Number of indices, a multiple of 3.
+        * @param positions The position of the first vertex, three floats.
+        * @param vertexCount Number of vertices the indices refer to.
+        * @param positionStride Distance in bytes between consecutive positions.
+        * @param threshold How much worse than the input order the cache miss ratio may become, 1.05 allows 5%.
+        * @param cacheSize Number of cache entries the input order was optimised for.
+        */
+        void optimizeOverdraw(uint32_t* indices, uint32_t indexCount, const float* positions, uint32_t vertexCount, uint32_t positionStride, float threshold = 1.05f, uint32_t cacheSize = defaultCacheSize);
+
+        /**
+        * @brief Reorder vertices into the order the triangle list first uses them, dropping vertices it never uses.
+        * @param vertices The vertex data, reordered in place.
+        * @param vertexCount Number of vertices.
+        * @param vertexSize Size of a vertex in bytes.
+        * @param indices The triangle list, remapped in place.
+        * @param indexCount Number of indices.
+        * @return The number of vertices kept.
+        */
+        uint32_t optimizeVertexFetch(void* vertices, uint32_t vertexCount, uint32_t vertexSize, uint32_t* indices, uint32_t indexCount);
+
+        /**
+        * @brief Run every pass, for the post-transform cache, overdraw and then vertex fetch.
+        * @param vertices The vertex data, reordered in place, each vertex starting with a Float3 position.
+        * @param vertexCount Number of vertices.
+        * @param vertexSize Size of a vertex in bytes.
+        * @param indices The triangle list, reordered and remapped in place.
+        * @param indexCount Number of indices, a multiple of 3.
+        * @return The number of vertices kept.
+        */
+        uint32_t optimize(void* vertices, uint32_t vertexCount, uint32_t vertexSize, uint32_t* indices, uint32_t indexCount);
+
+        /**
+        * @brief Check if every index of a mesh fits in 16 bits.
+        * @param vertexCount Number of vertices in the mesh.
+        * @return True if the mesh can be drawn with GL_UNSIGNED_SHORT indices.
+        */
+        inline bool fitsShortIndices(uint32_t vertexCount) { return vertexCount <= 65536; }
+
+        /**
+        * @brief Narrow indices to 16 bits, halving the index buffer.
+        * @param indices The indices, which must all be below 65536.
+        * @param indexCount Number of indices.
+        * @return The narrowed indices.
+        */
+        std::vector<uint16_t> toShortIndices(const uint32_t* indices, uint32_t indexCount);
+    }
+}
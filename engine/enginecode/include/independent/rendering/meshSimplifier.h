@@ -0,0 +1,36 @@
+/*****************************************************************//**
+@file   meshSimplifier.h
+@brief  Reduction of indexed triangle meshes by quadric error edge collapse, for building levels of detail that share one vertex buffer.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cfloat>
+#include <cstdint>
+
+namespace Engine
+{
+    namespace MeshSimplifier
+    {
+        /**
+        * @brief Simplify a triangle list by collapsing edges in order of the quadric error they add.
+        * Each collapse moves a vertex onto a neighbour, so the result indexes the same vertices and no new ones are made.
+        * Vertices on open borders and on seams, where vertices with different attributes share a position, are never moved,
+        * so the outline and the UV and normal splits are kept and heavily seamed meshes reduce less.
+        * @param destination Receives the simplified triangle list, room for indexCount indices, may be the same as indices.
+        * @param indices The triangle list.
+        * @param indexCount Number of indices, a multiple of 3.
+        * @param positions The position of the first vertex, three floats.
+        * @param vertexCount Number of vertices the indices refer to.
+        * @param positionStride Distance in bytes between consecutive positions.
+        * @param targetIndexCount Number of indices to stop at once reached.
+        * @param maxError Largest error a collapse may add, as a distance in the units of the positions.
+        * @param resultError Receives the largest error of any collapse made, may be null.
+        * @return Number of indices written.
+        */
+        uint32_t simplify(uint32_t* destination, const uint32_t* indices, uint32_t indexCount, const float* positions, uint32_t vertexCount, uint32_t positionStride,
+            uint32_t targetIndexCount, float maxError = FLT_MAX, float* resultError = nullptr);
+    }
+}
@@ -0,0 +1,134 @@
+/*****************************************************************//**
+@file   occlusionCulling.h
+@brief  A small depth buffer rasterized on the CPU from occluder meshes, against which bounding boxes are tested to skip drawing hidden objects.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "rendering/frustumCulling.h"
+
+namespace Engine
+{
+    class WorkerPool;
+
+    /**
+    * @struct OccluderMesh
+    * @brief Triangles rasterized into an OcclusionBuffer, which must lie inside the object they stand in for.
+    */
+    struct OccluderMesh
+    {
+        std::vector<glm::vec3> positions; /**< Vertex positions in the object's local space. */
+        std::vector<uint32_t> indices; /**< Three indices per triangle. */
+
+        /**
+        * @brief Make the twelve triangles of a box.
+        * @param min Smallest corner of the box.
+        * @param max Largest corner of the box.
+        * @return The mesh.
+        */
+        static OccluderMesh box(const glm::vec3& min, const glm::vec3& max);
+    };
+
+    /**
+    * @class OcclusionBuffer
+    * @brief A low resolution depth buffer split into tiles, each rasterized by one worker from the occluder triangles binned to it.
+    * Each 8x8 block and each tile keeps its nearest and farthest depth, so most box tests never read single pixels.
+    * Depths are OpenGL window depths, 0 at the near plane and 1 at the far plane, with rows from the bottom of the screen.
+    */
+    class OcclusionBuffer
+    {
+    public:
+        static const uint32_t tileSize = 32; /**< Width and height of a tile in pixels. */
+        static const uint32_t blockSize = 8; /**< Width and height of a block in pixels. */
+
+        /**
+        * @brief Constructor for OcclusionBuffer.
+        * @param width Width in pixels, rounded up to a whole number of tiles.
+        * @param height Height in pixels, rounded up to a whole number of tiles.
+        */
+        OcclusionBuffer(uint32_t width = 256, uint32_t height = 128);
+
+        /**
+        * @brief Start a frame, dropping the previous frame's occluders.
+        * @param viewProjection The camera's projection * view.
+        */
+        void begin(const glm::mat4& viewProjection);
+
+        /**
+        * @brief Transform an occluder's triangles to the screen and bin them to the tiles they touch.
+        * Triangles crossing the plane of the camera are dropped, which only loses occlusion.
+        * @param world The occluder's world transform.
+        * @param mesh The occluder's triangles.
+        */
+        void addOccluder(const glm::mat4& world, const OccluderMesh& mesh);
+
+        /**
+        * @brief Clear the buffer, rasterize the binned triangles and build the block and tile depths.
+        * @param workers The pool to split the tiles across, null to rasterize on the calling thread.
+        */
+        void rasterize(WorkerPool* workers = nullptr);
+
+        /**
+        * @brief Check if a world space box might be seen past the occluders.
+        * @param centre Centre of the box.
+        * @param extent Half the size of the box on each axis.
+        * @return False only if every pixel the box covers has an occluder in front of the whole box.
+        */
+        bool isVisible(const glm::vec3& centre, const glm::vec3& extent) const;
+
+        /**
+        * @brief Remove the hidden boxes from a list of visible ones, as after frustum culling.
+        * @param boxes World space boxes.
+        * @param visible Indices of the boxes to test, reduced in order to those which might be seen.
+        * @return Number of boxes still visible.
+        */
+        uint32_t cullBoxes(const BoxBounds& boxes, std::vector<uint32_t>& visible) const;
+
+        inline uint32_t getWidth() const { return m_width; } /**< Get the width in pixels. */
+        inline uint32_t getHeight() const { return m_height; } /**< Get the height in pixels. */
+        inline float getDepth(uint32_t x, uint32_t y) const { return m_depth[y * m_width + x]; } /**< Get the depth of a pixel. */
+        inline uint32_t getTriangleCount() const { return static_cast<uint32_t>(m_triangles.size()); } /**< Get the number of triangles binned this frame. */
+
+        /**
+        * @brief Get the instruction set the rasterizer was compiled for.
+        * @return "SSE2" or "Scalar".
+        */
+        static const char* getInstructionSet();
+
+    private:
+        /** @brief A screen space triangle set up for rasterizing, as three edge functions which are positive inside and a depth plane. */
+        struct Triangle
+        {
+            float edgeA[3]; /**< x coefficient of each edge function. */
+            float edgeB[3]; /**< y coefficient of each edge function. */
+            float edgeC[3]; /**< Constant of each edge function. */
+            float depth; /**< Depth at the screen origin. */
+            float depthX; /**< Change in depth per pixel along x. */
+            float depthY; /**< Change in depth per pixel along y. */
+            int32_t minX, minY, maxX, maxY; /**< Pixel bounds, inclusive and clamped to the screen. */
+        };
+
+        uint32_t m_width; /**< Width in pixels. */
+        uint32_t m_height; /**< Height in pixels. */
+        uint32_t m_tilesX; /**< Number of tiles across. */
+        uint32_t m_tilesY; /**< Number of tiles down. */
+        glm::mat4 m_viewProjection; /**< The camera's matrix for this frame. */
+
+        std::vector<float> m_depth; /**< Depth of each pixel, row by row. */
+        std::vector<float> m_blockMin; /**< Nearest depth of each block. */
+        std::vector<float> m_blockMax; /**< Farthest depth of each block. */
+        std::vector<float> m_tileMin; /**< Nearest depth of each tile. */
+        std::vector<float> m_tileMax; /**< Farthest depth of each tile. */
+        std::vector<Triangle> m_triangles; /**< This frame's triangles. */
+        std::vector<std::vector<uint32_t>> m_bins; /**< Triangles touching each tile. */
+        std::vector<glm::vec4> m_clipPositions; /**< Clip space positions of the occluder being added. */
+
+        /** @brief Rasterize one tile's triangles and build its block and tile depths. */
+        void rasterizeTile(uint32_t tile);
+    };
+}
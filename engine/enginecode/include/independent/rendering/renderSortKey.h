@@ -0,0 +1,100 @@
+/*****************************************************************//**
+@file   renderSortKey.h
+@brief  Packing of draw state into 64 bit sort keys, and the radix sort used to order them.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Engine
+{
+    /**
+    * @enum RenderPass
+    * @brief Passes a draw can be submitted to, in the order they are drawn.
+    */
+    enum class RenderPass : uint8_t
+    {
+        Opaque = 0,     ///< Opaque geometry, drawn front to back.
+        Transparent = 1 ///< Blended geometry, drawn back to front after all opaque geometry.
+    };
+
+    /**
+    * @struct SortItem
+    * @brief A sort key paired with the index of the draw command it was built from.
+    */
+    struct SortItem
+    {
+        uint64_t key; /**< The sort key. */
+        uint32_t index; /**< Index of the draw command. */
+    };
+
+    /**
+    * @namespace SortKey
+    * @brief The namespace that provides functions for building draw sort keys.
+    *
+    * Opaque keys are laid out as | pass:4 | program:12 | VAO:12 | texture:12 | depth:24 | so that
+    * draws sharing state end up adjacent and are drawn front to back within a state group.
+    * Transparent keys are laid out as | pass:4 | inverted depth:24 | program:12 | VAO:12 | texture:12 |
+    * so that correct back to front blending takes priority over state changes.
+    */
+    namespace SortKey
+    {
+        constexpr uint32_t passBits = 4;    /**< Number of bits holding the pass. */
+        constexpr uint32_t idBits = 12;     /**< Number of bits holding each of the program, VAO and texture. */
+        constexpr uint32_t depthBits = 24;  /**< Number of bits holding the depth. */
+
+        constexpr uint64_t idMask = (1ull << idBits) - 1; /**< Mask for an ID field. */
+        constexpr uint64_t depthMask = (1ull << depthBits) - 1; /**< Mask for the depth field. */
+
+        /**
+        * @brief Quantise a view space depth so that integer order matches float order.
+        * Non-negative IEEE floats order the same as their bit patterns, so the top 24 bits
+        * after the sign are kept.
+        * @param depth Distance from the camera.
+        * @return The quantised depth.
+        */
+        inline uint64_t quantiseDepth(float depth)
+        {
+            if (!(depth > 0.f)) return 0;
+            uint32_t bits;
+            std::memcpy(&bits, &depth, sizeof(bits));
+            return (bits >> 7) & depthMask;
+        }
+
+        /**
+        * @brief Build a sort key.
+        * @param pass The pass the draw belongs to.
+        * @param program ID of the shader program.
+        * @param vao ID of the vertex array.
+        * @param texture ID of the texture, 0 for none.
+        * @param depth Distance from the camera.
+        * @return The sort key.
+        */
+        inline uint64_t make(RenderPass pass, uint32_t program, uint32_t vao, uint32_t texture, float depth)
+        {
+            uint64_t state = ((program & idMask) << (2 * idBits)) | ((vao & idMask) << idBits) | (texture & idMask);
+            uint64_t passField = static_cast<uint64_t>(pass) << (64 - passBits);
+
+            if (pass == RenderPass::Transparent)
+            {
+                uint64_t invDepth = depthMask - quantiseDepth(depth);
+                return passField | (invDepth << (3 * idBits)) | state;
+            }
+
+            return passField | (state << depthBits) | quantiseDepth(depth);
+        }
+    }
+
+    /**
+    * @brief Sort items by key with a least significant digit radix sort.
+    * Passes over bytes which are identical in every key are skipped.
+    * @param items The items to sort, sorted in place.
+    * @param scratch Scratch storage, resized as needed and reusable between calls.
+    */
+    void radixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch);
+}
@@ -0,0 +1,184 @@
+/*****************************************************************//**
+@file   renderer3D.h
+@brief  The Renderer3D collects draw commands for a frame, orders them by sort key and issues only the state changes needed to draw them.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <memory>
+#include <glm/glm.hpp>
+#include "rendering/renderSortKey.h"
+#include "rendering/indirectDraw.h"
+#include "platforms/OpenGL/OpenGLVertexArray.h"
+#include "platforms/OpenGL/OpenGLShader.h"
+#include "platforms/OpenGL/OpenGLTexture.h"
+#include "platforms/OpenGL/OpenGLTextureArray.h"
+#include "cameras/camera.h"
+
+namespace Engine
+{
+    class OpenGLMeshPool;
+
+    /**
+    * @class Material
+    * @brief The shader, texture and tint used to draw a piece of geometry.
+    * Shaders declaring u_materialIndex read the texture and tint from the b_materials
+    * storage block instead, so draws with different textures need no texture binds between them.
+    * Such shaders sample a 2D texture through its bindless handle, or bound to unit 0 like any other draw where handles are unsupported.
+    */
+    class Material
+    {
+    public:
+        /**
+        * @brief Constructor for Material.
+        * @param shader The shader used to draw with the material.
+        * @param texture The texture bound to unit 0, may be null.
+        * @param tint The colour multiplied with the output, uploaded to u_tint.
+        * @param pass The pass draws using the material are submitted to.
+        */
+        Material(const std::shared_ptr<OpenGLShader>& shader, const std::shared_ptr<OpenGLTexture>& texture = nullptr, const glm::vec4& tint = glm::vec4(1.f), RenderPass pass = RenderPass::Opaque) :
+            m_shader(shader), m_texture(texture), m_tint(tint), m_pass(pass)
+        {}
+
+        /**
+        * @brief Constructor for Material sampling one layer of a texture array.
+        * @param shader The shader used to draw with the material, which must declare u_materialIndex.
+        * @param textureArray The texture array bound to Renderer3D::textureArrayUnit.
+        * @param layer The layer of the array sampled.
+        * @param tint The colour multiplied with the output.
+        * @param pass The pass draws using the material are submitted to.
+        */
+        Material(const std::shared_ptr<OpenGLShader>& shader, const std::shared_ptr<OpenGLTextureArray>& textureArray, uint32_t layer, const glm::vec4& tint = glm::vec4(1.f), RenderPass pass = RenderPass::Opaque) :
+            m_shader(shader), m_textureArray(textureArray), m_layer(layer), m_tint(tint), m_pass(pass)
+        {}
+
+        inline const std::shared_ptr<OpenGLShader>& getShader() const { return m_shader; } /**< Get the material's shader. */
+        inline const std::shared_ptr<OpenGLTexture>& getTexture() const { return m_texture; } /**< Get the material's texture. */
+        inline const std::shared_ptr<OpenGLTextureArray>& getTextureArray() const { return m_textureArray; } /**< Get the material's texture array. */
+        inline uint32_t getLayer() const { return m_layer; } /**< Get the layer of the texture array sampled. */
+        inline const glm::vec4& getTint() const { return m_tint; } /**< Get the material's tint. */
+        inline RenderPass getPass() const { return m_pass; } /**< Get the pass the material draws in. */
+
+        /**
+        * @brief Set the material's tint.
+        * @param tint The new tint.
+        */
+        inline void setTint(const glm::vec4& tint) { m_tint = tint; }
+
+    private:
+        std::shared_ptr<OpenGLShader> m_shader; /**< The shader used to draw with the material. */
+        std::shared_ptr<OpenGLTexture> m_texture; /**< The texture bound to unit 0, may be null. */
+        std::shared_ptr<OpenGLTextureArray> m_textureArray; /**< The texture array bound to textureArrayUnit, may be null. */
+        uint32_t m_layer = 0; /**< The layer of the texture array sampled. */
+        glm::vec4 m_tint; /**< The tint uploaded to u_tint. */
+        RenderPass m_pass; /**< The pass draws using the material are submitted to. */
+    };
+
+    /**
+    * @struct PointLight
+    * @brief A single point light shared by every shader through the b_lights block.
+    */
+    struct PointLight
+    {
+        glm::vec3 position = glm::vec3(0.f); /**< World space position of the light. */
+        glm::vec3 colour = glm::vec3(1.f); /**< Colour of the light. */
+    };
+
+    /**
+    * @struct RendererStats
+    * @brief Counters for the work done flushing the last frame.
+    */
+    struct RendererStats
+    {
+        uint32_t drawCalls = 0; /**< Number of draw calls issued. */
+        uint32_t instances = 0; /**< Number of instances drawn by instanced draw calls. */
+        uint32_t pooledDraws = 0; /**< Number of mesh pool draws, drawn by multi draw indirect calls. */
+        uint32_t indirectCommands = 0; /**< Number of commands read by multi draw indirect calls. */
+        uint32_t programBinds = 0; /**< Number of shader program changes. */
+        uint32_t vertexArrayBinds = 0; /**< Number of vertex array changes. */
+        uint32_t textureBinds = 0; /**< Number of texture changes. */
+        uint32_t materials = 0; /**< Number of materials written to the b_materials block. */
+    };
+
+    /**
+    * @class Renderer3D
+    * @brief Sort keyed 3D renderer.
+    * Draws submitted between begin and end are packed into 64 bit sort keys, radix sorted
+    * and then drawn with redundant program, vertex array and texture changes removed.
+    */
+    class Renderer3D
+    {
+    public:
+        static constexpr uint32_t materialsBinding = 0; /**< Shader storage binding of b_materials, matching the shaders. */
+        static constexpr uint32_t maxMaterials = 1024; /**< Number of materials the b_materials block holds each frame. */
+        static constexpr uint32_t textureArrayUnit = 1; /**< Texture unit arrays are bound to, 2D textures use unit 0. */
+
+        /** @brief Create the renderer's GPU resources. Must be called with a current context. */
+        static void init();
+
+        /** @brief Release the renderer's GPU resources. Must be called before the context is destroyed. */
+        static void shutdown();
+
+        /**
+        * @brief Begin a new frame, uploading the scene wide camera and light uniforms once.
+        * @param camera The camera the frame is drawn from.
+        * @param light The light shared by every shader.
+        */
+        static void begin(const Camera& camera, const PointLight& light);
+
+        /**
+        * @brief Submit a piece of geometry to be drawn this frame.
+        * The geometry and material must stay alive until end is called. Draws whose shader is still compiling are skipped.
+        * @param geometry The vertex array to draw.
+        * @param material The material to draw with.
+        * @param model The model matrix of the draw.
+        * @param normalMatrix The inverse transpose of the model matrix's upper 3x3, uploaded as u_normalMatrix so shaders need not invert per vertex.
+        */
+        static void submit(const std::shared_ptr<OpenGLVertexArray>& geometry, const std::shared_ptr<Material>& material, const glm::mat4& model, const glm::mat3& normalMatrix);
+
+        /**
+        * @brief Submit a piece of geometry to be drawn this frame, computing its normal matrix from the model matrix.
+        * Prefer the overload taking a normal matrix when one is already known, such as from TransformHierarchy::getNormal.
+        * @param geometry The vertex array to draw.
+        * @param material The material to draw with.
+        * @param model The model matrix of the draw.
+        */
+        static void submit(const std::shared_ptr<OpenGLVertexArray>& geometry, const std::shared_ptr<Material>& material, const glm::mat4& model);
+
+        /**
+        * @brief Submit many copies of a piece of geometry to be drawn in a single instanced draw call.
+        * The geometry must carry its per instance data in a vertex buffer of its own, such as the InstanceTransform buffer
+        * of OpenGLMesh::createInstancedVertexArray, and the material's shader must read it from vertex attributes.
+        * The geometry and material must stay alive until end is called. Draws whose shader is still compiling are skipped.
+        * @param geometry The vertex array to draw.
+        * @param material The material to draw with.
+        * @param instanceCount The number of instances to draw.
+        */
+        static void submitInstanced(const std::shared_ptr<OpenGLVertexArray>& geometry, const std::shared_ptr<Material>& material, uint32_t instanceCount);
+
+        /**
+        * @brief Submit a mesh held in a mesh pool to be drawn this frame.
+        * Opaque draws from one pool which sort next to each other and share a material are drawn with one multi draw indirect call,
+        * built when end is called, with repeats of a mesh drawn as instances of one command. The material's shader must read an
+        * InstanceTransform from its instance attributes, like the INSTANCED variants. Draws in other passes are drawn one per call, in order.
+        * The pool and material must stay alive until end is called. Draws whose shader is still compiling are skipped.
+        * @param pool The pool holding the mesh.
+        * @param mesh The mesh to draw.
+        * @param material The material to draw with.
+        * @param model The model matrix of the draw.
+        * @param normalMatrix The inverse transpose of the model matrix's upper 3x3.
+        */
+        static void submit(OpenGLMeshPool& pool, const MeshHandle& mesh, const std::shared_ptr<Material>& material, const glm::mat4& model, const glm::mat3& normalMatrix);
+
+        /** @brief Sort the frame's draws and issue them. */
+        static void end();
+
+        /**
+        * @brief Get the counters for the last flushed frame.
+        * @return The renderer counters.
+        */
+        static const RendererStats& getStats();
+    };
+}
@@ -0,0 +1,69 @@
+/*****************************************************************//**
+@file   shaderCache.h
+@brief  Hashing of shader sources and reading and writing linked program binaries to the shader cache.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine
+{
+    /**
+    * @struct ProgramBinary
+    * @brief A linked program as returned by the driver, with the driver specific format it must be loaded with.
+    */
+    struct ProgramBinary
+    {
+        uint32_t format = 0; /**< The driver's binary format enum. */
+        std::vector<uint8_t> data; /**< The binary blob. */
+    };
+
+    namespace ShaderCache
+    {
+        /**
+        * @brief Extend a 64 bit FNV-1a hash with more data.
+        * @param data The data to hash.
+        * @param size Size of the data in bytes.
+        * @param hash The hash so far.
+        * @return The extended hash.
+        */
+        uint64_t hash(const void* data, size_t size, uint64_t hash = 0xCBF29CE484222325ull);
+
+        /**
+        * @brief Build the cache key of a program.
+        * Stages are separated so moving text between them changes the key.
+        * @param sources Source of every stage, in pipeline order.
+        * @param driver Vendor, renderer and version strings of the driver, as binaries only load on the driver which wrote them.
+        * @return The key.
+        */
+        uint64_t programKey(const std::vector<std::string>& sources, const std::string& driver);
+
+        /**
+        * @brief Get the path a program's binary is cached at.
+        * @param key The program's cache key.
+        * @return The cache file path under ./cache/shaders/.
+        */
+        std::string cachePath(uint64_t key);
+
+        /**
+        * @brief Write a program binary to the cache.
+        * @param filepath Path of the file.
+        * @param binary The binary.
+        * @return True if the file was written.
+        */
+        bool writeBinary(const std::string& filepath, const ProgramBinary& binary);
+
+        /**
+        * @brief Read a program binary from the cache.
+        * @param filepath Path of the file.
+        * @param binary The binary read.
+        * @return True if the file exists and is a complete cache file.
+        */
+        bool readBinary(const std::string& filepath, ProgramBinary& binary);
+    }
+}
@@ -25,7 +25,14 @@ namespace Engine
         Short,    ///< Short integer.
         Short2,   ///< Two-component short integer.
         Short3,   ///< Three-component short integer.
-        Short4    ///< Four-component short integer.
+        Short4,   ///< Four-component short integer.
+        Mat4,     ///< Four by four floating point matrix, occupying four attribute slots.
+        Half2,    ///< Two-component half-precision floating point.
+        Half4,    ///< Four-component half-precision floating point.
+        UByte4N,  ///< Four unsigned bytes read as [0, 1], such as a packed colour.
+        Int2101010Rev, ///< Three signed 10 bit components and a 2 bit component read as [-1, 1], such as a normal or tangent.
+        Oct16,    ///< Two signed shorts read as [-1, 1], an octahedral encoded unit vector decoded in the shader.
+        Mat3      ///< Three by three floating point matrix, occupying three attribute slots.
     };
 
     /**
@@ -39,7 +46,7 @@ namespace Engine
         * @param type The ShaderDataType to get the size for.
         * @return The size in bytes of the specified ShaderDataType.
         */
-        static uint32_t size(ShaderDataType type)
+        static constexpr uint32_t size(ShaderDataType type)
         {
             switch (type)
             {
@@ -51,6 +58,13 @@ namespace Engine
             case ShaderDataType::Short2: return 2 * 2;
             case ShaderDataType::Short3: return 2 * 3;
             case ShaderDataType::Short4: return 2 * 4;
+            case ShaderDataType::Mat4:   return 4 * 4 * 4;
+            case ShaderDataType::Half2:  return 2 * 2;
+            case ShaderDataType::Half4:  return 2 * 4;
+            case ShaderDataType::UByte4N: return 4;
+            case ShaderDataType::Int2101010Rev: return 4;
+            case ShaderDataType::Oct16:  return 2 * 2;
+            case ShaderDataType::Mat3:   return 4 * 3 * 3;
             default: return 0;
             }
         }
@@ -60,7 +74,7 @@ namespace Engine
         * @param type The ShaderDataType to get the component count for.
         * @return The number of components in the specified ShaderDataType.
         */
-        static uint32_t componentCount(ShaderDataType type)
+        static constexpr uint32_t componentCount(ShaderDataType type)
         {
             switch (type)
             {
@@ -72,8 +86,69 @@ namespace Engine
             case ShaderDataType::Short2: return 2;
             case ShaderDataType::Short3: return 3;
             case ShaderDataType::Short4: return 4;
+            case ShaderDataType::Mat4:   return 4 * 4;
+            case ShaderDataType::Half2:  return 2;
+            case ShaderDataType::Half4:  return 4;
+            case ShaderDataType::UByte4N: return 4;
+            case ShaderDataType::Int2101010Rev: return 4;
+            case ShaderDataType::Oct16:  return 2;
+            case ShaderDataType::Mat3:   return 3 * 3;
             default: return 0;
             }
         }
+
+        /**
+        * @brief Get the alignment a vertex struct gives a member holding a ShaderDataType.
+        * Packed types are held in a single 32 bit integer, everything else in an array of its components.
+        * @param type The ShaderDataType to get the alignment for.
+        * @return The alignment in bytes of the specified ShaderDataType.
+        */
+        static constexpr uint32_t alignment(ShaderDataType type)
+        {
+            switch (type)
+            {
+            case ShaderDataType::Short:
+            case ShaderDataType::Short2:
+            case ShaderDataType::Short3:
+            case ShaderDataType::Short4:
+            case ShaderDataType::Half2:
+            case ShaderDataType::Half4: return 2;
+            case ShaderDataType::None: return 1;
+            default: return 4;
+            }
+        }
+
+        /**
+        * @brief Get the number of vertex attribute slots a ShaderDataType occupies.
+        * Matrices take one slot per column, everything else takes a single slot.
+        * @param type The ShaderDataType to get the slot count for.
+        * @return The number of attribute slots used by the specified ShaderDataType.
+        */
+        static constexpr uint32_t attributeSlots(ShaderDataType type)
+        {
+            switch (type)
+            {
+            case ShaderDataType::Mat4: return 4;
+            case ShaderDataType::Mat3: return 3;
+            default: return 1;
+            }
+        }
+
+        /**
+        * @brief Check if a ShaderDataType is always read as normalised, whatever its buffer element requests.
+        * Packed types only make sense normalised, their integer values are meaningless to a shader.
+        * @param type The ShaderDataType to check.
+        * @return True if the specified ShaderDataType is read as normalised.
+        */
+        static constexpr bool isNormalised(ShaderDataType type)
+        {
+            switch (type)
+            {
+            case ShaderDataType::UByte4N:
+            case ShaderDataType::Int2101010Rev:
+            case ShaderDataType::Oct16: return true;
+            default: return false;
+            }
+        }
     }
 }
\ No newline at end of file
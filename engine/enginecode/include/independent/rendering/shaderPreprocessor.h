@@ -0,0 +1,102 @@
+/*****************************************************************//**
+@file   shaderPreprocessor.h
+@brief  Resolution of #include directives, splitting of #region stages and injection of feature defines into shader sources.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine
+{
+    /**
+    * @namespace ShaderStages
+    * @brief The stages a single file shader can hold, each introduced by a #region line.
+    */
+    namespace ShaderStages
+    {
+        /** @brief Index of a stage's source. */
+        enum Stage : uint32_t
+        {
+            Vertex = 0,             ///< #region Vertex
+            Fragment,               ///< #region Fragment
+            Geometry,               ///< #region Geometry
+            TessellationControl,    ///< #region TessellationControl
+            TessellationEvaluation, ///< #region TessellationEvaluation
+            Compute,                ///< #region Compute
+            Count                   ///< Number of stages.
+        };
+    }
+
+    /**
+    * @namespace ShaderFeatures
+    * @brief Optional features a shader variant is compiled with, combined into a bitmask.
+    */
+    namespace ShaderFeatures
+    {
+        /** @brief A feature bit, injected into the source as a #define so it can be compiled in or out. */
+        enum Feature : uint32_t
+        {
+            None = 0,                ///< The base variant.
+            Instanced = 1 << 0,      ///< INSTANCED: model matrices come from per instance attributes.
+            MaterialBuffer = 1 << 1, ///< MATERIAL_BUFFER: texture and tint come from the b_materials block.
+            NormalMap = 1 << 2,      ///< HAS_NORMAL_MAP: a normal map is sampled.
+            AlphaTest = 1 << 3,      ///< ALPHA_TEST: fragments below the alpha cutoff are discarded.
+            Count = 4                ///< Number of feature bits.
+        };
+    }
+
+    /** @brief Shader sources, one per stage, empty where the stage is absent. */
+    using ShaderSources = std::array<std::string, ShaderStages::Count>;
+
+    namespace ShaderPreprocessor
+    {
+        /**
+        * @brief Get the #define names of the features in a mask.
+        * @param features Bitmask of ShaderFeatures values.
+        * @return The define names, in feature bit order.
+        */
+        std::vector<std::string> featureDefines(uint32_t features);
+
+        /**
+        * @brief Read a file, replacing every #include "path" line with the included file.
+        * Paths are relative to the including file. A file already included is skipped, as if it had #pragma once.
+        * @param filepath Path to the file.
+        * @param source The file with every include resolved.
+        * @param error Why resolution failed.
+        * @return True if the file and every file it includes could be read.
+        */
+        bool resolveIncludes(const std::string& filepath, std::string& source, std::string& error);
+
+        /**
+        * @brief Split a single file shader into its stages at each #region line.
+        * @param source The whole file.
+        * @return The source of each stage.
+        */
+        ShaderSources splitStages(const std::string& source);
+
+        /**
+        * @brief Insert #define lines directly after a stage's #version and #extension lines.
+        * @param source The stage source.
+        * @param defines The names to define.
+        * @return The source with the defines injected.
+        */
+        std::string injectDefines(const std::string& source, const std::vector<std::string>& defines);
+
+        /**
+        * @brief Load a single file shader, resolving includes and injecting the defines of a feature mask into every stage.
+        * The file is split into stages first and each stage's includes are resolved on their own, so every stage which includes a file gets it.
+        * @param filepath Path to the shader file.
+        * @param features Bitmask of ShaderFeatures values.
+        * @param sources The preprocessed source of each stage.
+        * @param error Why loading failed.
+        * @return True if the shader and its includes could be read.
+        */
+        bool load(const std::string& filepath, uint32_t features, ShaderSources& sources, std::string& error);
+    }
+}
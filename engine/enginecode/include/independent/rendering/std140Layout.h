@@ -0,0 +1,163 @@
+/*****************************************************************//**
+@file   std140Layout.h
+@brief  Compile time std140 layouts for uniform blocks, and a writer which packs values into a block's memory image.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <array>
+#include <tuple>
+#include <cstdint>
+#include <cstring>
+#include <glm/glm.hpp>
+
+namespace Engine
+{
+    /**
+    * @namespace Std140
+    * @brief The namespace that provides the std140 alignment rules for the supported types.
+    */
+    namespace Std140
+    {
+        /**
+        * @brief Round a value up to a multiple of an alignment.
+        * @param value The value to round.
+        * @param alignment The alignment, which must be a power of two.
+        * @return The rounded value.
+        */
+        constexpr uint32_t alignUp(uint32_t value, uint32_t alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+
+        /**
+        * @struct Traits
+        * @brief Base alignment and size of a type inside a std140 block.
+        * @tparam T The type being laid out.
+        */
+        template<typename T> struct Traits;
+
+        template<> struct Traits<float>     { static constexpr uint32_t alignment = 4;  static constexpr uint32_t size = 4; };
+        template<> struct Traits<int32_t>   { static constexpr uint32_t alignment = 4;  static constexpr uint32_t size = 4; };
+        template<> struct Traits<uint32_t>  { static constexpr uint32_t alignment = 4;  static constexpr uint32_t size = 4; };
+        template<> struct Traits<glm::vec2> { static constexpr uint32_t alignment = 8;  static constexpr uint32_t size = 8; };
+        template<> struct Traits<glm::vec3> { static constexpr uint32_t alignment = 16; static constexpr uint32_t size = 12; };
+        template<> struct Traits<glm::vec4> { static constexpr uint32_t alignment = 16; static constexpr uint32_t size = 16; };
+        template<> struct Traits<glm::mat3> { static constexpr uint32_t alignment = 16; static constexpr uint32_t size = 48; }; // Three columns, each padded to a vec4
+        template<> struct Traits<glm::mat4> { static constexpr uint32_t alignment = 16; static constexpr uint32_t size = 64; };
+
+        /**
+        * @brief Write a value into a block at its std140 offset.
+        * @param dst Pointer to the start of the value in the block.
+        * @param value The value to write.
+        */
+        template<typename T>
+        inline void write(uint8_t* dst, const T& value) { std::memcpy(dst, &value, Traits<T>::size); }
+
+        /**
+        * @brief Write a mat3 into a block, padding each column to a vec4.
+        * @param dst Pointer to the start of the value in the block.
+        * @param value The value to write.
+        */
+        template<>
+        inline void write<glm::mat3>(uint8_t* dst, const glm::mat3& value)
+        {
+            for (int i = 0; i < 3; i++) std::memcpy(dst + i * 16, &value[i], sizeof(glm::vec3));
+        }
+    }
+
+    /**
+    * @class Std140Layout
+    * @brief The std140 layout of a uniform block made of the given member types, in declaration order.
+    * All offsets and the block size are computed at compile time.
+    * @tparam Ts The types of the block members.
+    */
+    template<typename... Ts>
+    class Std140Layout
+    {
+    public:
+        static_assert(sizeof...(Ts) > 0, "A uniform block must have at least one member");
+
+        static constexpr uint32_t count = sizeof...(Ts); /**< Number of members in the block. */
+
+        /**
+        * @brief Type of a member of the block.
+        * @tparam I Index of the member.
+        */
+        template<uint32_t I>
+        using Type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    private:
+        static constexpr std::array<uint32_t, count> s_alignments = { Std140::Traits<Ts>::alignment... };
+        static constexpr std::array<uint32_t, count> s_sizes = { Std140::Traits<Ts>::size... };
+
+        static constexpr std::array<uint32_t, count> calcOffsets()
+        {
+            std::array<uint32_t, count> result = {};
+            uint32_t offset = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                offset = Std140::alignUp(offset, s_alignments[i]);
+                result[i] = offset;
+                offset += s_sizes[i];
+            }
+            return result;
+        }
+
+    public:
+        static constexpr std::array<uint32_t, count> offsets = calcOffsets(); /**< Byte offset of each member. */
+        static constexpr uint32_t size = Std140::alignUp(offsets[count - 1] + s_sizes[count - 1], 16); /**< Size of the block in bytes. */
+    };
+
+    /**
+    * @class Std140Writer
+    * @brief Holds the memory image of a uniform block and packs values into it at their std140 offsets.
+    * @tparam Layout The Std140Layout of the block.
+    */
+    template<typename Layout>
+    class Std140Writer
+    {
+    public:
+        /**
+        * @brief Set a member of the block.
+        * @param value The value of the member.
+        * @tparam I Index of the member.
+        */
+        template<uint32_t I>
+        inline void set(const typename Layout::template Type<I>& value)
+        {
+            Std140::write(m_data.data() + Layout::offsets[I], value);
+        }
+
+        /**
+        * @brief Get the memory image of the block.
+        * @return Pointer to the block data.
+        */
+        inline const uint8_t* data() const { return m_data.data(); }
+
+        /**
+        * @brief Get the size of the block.
+        * @return The size of the block in bytes.
+        */
+        inline constexpr uint32_t size() const { return Layout::size; }
+
+    private:
+        std::array<uint8_t, Layout::size> m_data = {}; /**< The memory image of the block. */
+    };
+
+    /**
+    * @namespace UniformBlocks
+    * @brief Binding points and layouts of the uniform blocks shared by every shader.
+    */
+    namespace UniformBlocks
+    {
+        /** @brief Fixed binding points, matching the binding qualifiers in the shaders. */
+        enum Binding : uint32_t
+        {
+            Camera = 0, ///< b_camera: u_view, u_projection, u_viewPos.
+            Lights = 1  ///< b_lights: u_lightPos, u_lightColour.
+        };
+
+        using CameraLayout = Std140Layout<glm::mat4, glm::mat4, glm::vec3>; /**< Layout of b_camera. */
+        using LightsLayout = Std140Layout<glm::vec3, glm::vec3>; /**< Layout of b_lights. */
+    }
+}
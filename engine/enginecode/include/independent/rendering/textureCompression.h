@@ -0,0 +1,147 @@
+/*****************************************************************//**
+@file   textureCompression.h
+@brief  CPU transcoding of images to BC1/BC3 block compressed mip chains, and reading and writing them as DDS files.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Engine
+{
+    /**
+    * @enum TextureFormat
+    * @brief Pixel formats texture data can be stored in.
+    */
+    enum class TextureFormat
+    {
+        RGB8 = 0, /**< Uncompressed, three bytes per pixel. */
+        RGBA8 = 1, /**< Uncompressed, four bytes per pixel. */
+        BC1 = 2, /**< DXT1, 8 bytes per 4x4 block, opaque colour. */
+        BC3 = 3 /**< DXT5, 16 bytes per 4x4 block, colour with interpolated alpha. */
+    };
+
+    /**
+    * @struct TextureMip
+    * @brief One level of a texture's mip chain.
+    */
+    struct TextureMip
+    {
+        uint32_t width = 0; /**< Width of the level in pixels. */
+        uint32_t height = 0; /**< Height of the level in pixels. */
+        std::vector<uint8_t> data; /**< Pixels or compressed blocks of the level. */
+    };
+
+    /**
+    * @struct TextureData
+    * @brief A texture's format and complete mip chain, ready for upload.
+    */
+    struct TextureData
+    {
+        TextureFormat format = TextureFormat::RGBA8; /**< Format of every level. */
+        std::vector<TextureMip> mips; /**< Mip levels, largest first. */
+
+        /**
+        * @brief Check if the data is block compressed.
+        * @return True for BC formats.
+        */
+        inline bool isCompressed() const { return format == TextureFormat::BC1 || format == TextureFormat::BC3; }
+    };
+
+    namespace TextureCompression
+    {
+        /**
+        * @brief Get the number of bytes in each 4x4 block of a compressed format.
+        * @param format The format.
+        * @return The block size, or 0 for uncompressed formats.
+        */
+        uint32_t blockSize(TextureFormat format);
+
+        /**
+        * @brief Get the size of one level in a format.
+        * @param format The format.
+        * @param width Width of the level in pixels.
+        * @param height Height of the level in pixels.
+        * @return The size in bytes.
+        */
+        uint32_t levelSize(TextureFormat format, uint32_t width, uint32_t height);
+
+        /**
+        * @brief Build a full RGBA8 mip chain down to 1x1 with a 2x2 box filter.
+        * @param pixels The top level pixels.
+        * @param width Width of the top level.
+        * @param height Height of the top level.
+        * @param channels Channels per pixel in the top level, 3 or 4.
+        * @return Every level as RGBA8, largest first.
+        */
+        std::vector<TextureMip> buildMipChain(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels);
+
+        /**
+        * @brief Encode a 4x4 block of RGBA8 pixels to BC1.
+        * @param block 16 pixels in row order.
+        * @param out The 8 byte encoded block.
+        */
+        void encodeBC1Block(const uint8_t block[64], uint8_t out[8]);
+
+        /**
+        * @brief Encode a 4x4 block of RGBA8 pixels to BC3.
+        * @param block 16 pixels in row order.
+        * @param out The 16 byte encoded block.
+        */
+        void encodeBC3Block(const uint8_t block[64], uint8_t out[16]);
+
+        /**
+        * @brief Transcode an image to a block compressed format with a full mip chain.
+        * @param pixels The image pixels.
+        * @param width Width of the image.
+        * @param height Height of the image.
+        * @param channels Channels per pixel, 3 or 4.
+        * @param format BC1 or BC3.
+        * @return The compressed texture.
+        */
+        TextureData compress(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels, TextureFormat format);
+
+        /**
+        * @brief Transcode an existing RGBA8 mip chain to a block compressed format.
+        * @param chain Every level as RGBA8, largest first, as built by buildMipChain.
+        * @param format BC1 or BC3.
+        * @return The compressed texture.
+        */
+        TextureData compressMipChain(const std::vector<TextureMip>& chain, TextureFormat format);
+
+        /**
+        * @brief Write block compressed texture data as a DDS file.
+        * @param filepath Path of the file.
+        * @param texture The texture, which must be BC1 or BC3.
+        * @return True if the file was written.
+        */
+        bool writeDDS(const std::string& filepath, const TextureData& texture);
+
+        /**
+        * @brief Read a BC1 or BC3 DDS file.
+        * @param filepath Path of the file.
+        * @param texture The texture read.
+        * @return True if the file was read, holds a supported format and its header agrees with its length.
+        */
+        bool readDDS(const std::string& filepath, TextureData& texture);
+
+        /**
+        * @brief Get the path transcoded data for a source image is cached at.
+        * @param sourcePath Path of the source image.
+        * @return The cache file path under ./cache/textures/.
+        */
+        std::string cachePath(const std::string& sourcePath);
+
+        /**
+        * @brief Get the path a source image transcoded to a chosen block format is cached at, apart from the automatically chosen one.
+        * @param sourcePath Path of the source image.
+        * @param format BC1 or BC3.
+        * @return The cache file path under ./cache/textures/.
+        */
+        std::string cachePath(const std::string& sourcePath, TextureFormat format);
+    }
+}
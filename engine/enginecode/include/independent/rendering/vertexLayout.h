@@ -0,0 +1,133 @@
+/*****************************************************************//**
+@file   vertexLayout.h
+@brief  Vertex layouts computed at compile time from a list of attributes, checked against the vertex struct they describe.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include "bufferLayout.h"
+
+namespace Engine
+{
+    /**
+    * @struct VertexAttribute
+    * @brief Compile time description of one attribute in a VertexLayout.
+    * @tparam Type The data type of the attribute.
+    * @tparam Normalised Whether integer values are read as normalised.
+    * @tparam Divisor Number of instances drawn before the attribute advances, 0 for per vertex data.
+    */
+    template<ShaderDataType Type, bool Normalised = false, uint32_t Divisor = 0>
+    struct VertexAttribute
+    {
+        static constexpr ShaderDataType type = Type; /**< The data type of the attribute. */
+        static constexpr bool normalised = Normalised; /**< Whether integer values are read as normalised. */
+        static constexpr uint32_t divisor = Divisor; /**< Number of instances drawn before the attribute advances. */
+    };
+
+    /**
+    * @namespace VertexAttributes
+    * @brief Shorthands for the common attributes, an N suffix marks a normalised integer attribute.
+    */
+    namespace VertexAttributes
+    {
+        using Float = VertexAttribute<ShaderDataType::Float>;
+        using Float2 = VertexAttribute<ShaderDataType::Float2>;
+        using Float3 = VertexAttribute<ShaderDataType::Float3>;
+        using Float4 = VertexAttribute<ShaderDataType::Float4>;
+        using Short2N = VertexAttribute<ShaderDataType::Short2, true>;
+        using Short3N = VertexAttribute<ShaderDataType::Short3, true>;
+        using Short4N = VertexAttribute<ShaderDataType::Short4, true>;
+        using Half2 = VertexAttribute<ShaderDataType::Half2>;
+        using Half4 = VertexAttribute<ShaderDataType::Half4>;
+        using UByte4N = VertexAttribute<ShaderDataType::UByte4N>;
+        using Int2101010Rev = VertexAttribute<ShaderDataType::Int2101010Rev>;
+        using Oct16 = VertexAttribute<ShaderDataType::Oct16>;
+        using InstanceMat4 = VertexAttribute<ShaderDataType::Mat4, false, 1>;
+        using InstanceMat3 = VertexAttribute<ShaderDataType::Mat3, false, 1>;
+    }
+
+    /**
+    * @struct VertexLayout
+    * @brief A vertex layout whose offsets and stride are computed at compile time.
+    * Offsets follow the alignment a C++ struct gives each member, so a layout listing a
+    * struct's members in order matches that struct, which matches() proves with a static_assert.
+    * The elements live in a static table, so no layout is allocated at runtime.
+    * @tparam Attributes The VertexAttribute of each member, in declaration order.
+    */
+    template<typename... Attributes>
+    struct VertexLayout
+    {
+        static constexpr uint32_t count = sizeof...(Attributes); /**< Number of attributes. */
+        static_assert(count > 0, "A vertex layout needs at least one attribute");
+
+    private:
+        /** @brief Compute every attribute's element, with its offset aligned like a struct member. */
+        static constexpr std::array<BufferElement, count> computeElements()
+        {
+            std::array<BufferElement, count> elements{};
+            const ShaderDataType types[] = { Attributes::type... };
+            const bool normalised[] = { Attributes::normalised... };
+            const uint32_t divisors[] = { Attributes::divisor... };
+
+            uint32_t offset = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                uint32_t alignment = SDT::alignment(types[i]);
+                offset = (offset + alignment - 1) / alignment * alignment;
+                elements[i] = BufferElement(types[i], normalised[i], divisors[i], offset);
+                offset += elements[i].m_size;
+            }
+            return elements;
+        }
+
+        /** @brief Compute the stride, padded to the largest alignment like a struct's size. */
+        static constexpr uint32_t computeStride()
+        {
+            const ShaderDataType types[] = { Attributes::type... };
+
+            uint32_t alignment = 1;
+            for (uint32_t i = 0; i < count; i++) alignment = alignment < SDT::alignment(types[i]) ? SDT::alignment(types[i]) : alignment;
+
+            const BufferElement& last = elements[count - 1];
+            return (last.m_offset + last.m_size + alignment - 1) / alignment * alignment;
+        }
+
+        /** @brief Count the attribute slots of every attribute, matrices taking one per column. */
+        static constexpr uint32_t computeSlots()
+        {
+            return (SDT::attributeSlots(Attributes::type) + ...);
+        }
+
+    public:
+        static constexpr std::array<BufferElement, count> elements = computeElements(); /**< Every attribute's element. */
+        static constexpr uint32_t stride = computeStride(); /**< Distance between consecutive vertices in bytes. */
+        static constexpr uint32_t slots = computeSlots(); /**< Number of attribute locations the layout occupies. */
+
+        /**
+        * @brief Get a view of the static element table, to set up a vertex array with.
+        * @return The view.
+        */
+        static constexpr BufferLayoutView view() { return BufferLayoutView(elements.data(), count, stride); }
+
+        /**
+        * @brief Check the layout matches a vertex struct, for use in a static_assert.
+        * @param memberOffsets The offsetof of each of the struct's members, in order.
+        * @tparam Vertex The vertex struct.
+        * @return True if the stride matches the struct's size and every offset matches its member.
+        */
+        template<typename Vertex>
+        static constexpr bool matches(const std::array<size_t, count>& memberOffsets)
+        {
+            if (stride != sizeof(Vertex)) return false;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (elements[i].m_offset != memberOffsets[i]) return false;
+            }
+            return true;
+        }
+    };
+}
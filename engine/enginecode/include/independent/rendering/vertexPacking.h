@@ -0,0 +1,90 @@
+/*****************************************************************//**
+@file   vertexPacking.h
+@brief  CPU encoding of vertex attributes into the compact ShaderDataType formats, and decoding them back.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace Engine
+{
+    namespace VertexPacking
+    {
+        /**
+        * @brief Convert a float to half precision, rounding to nearest even.
+        * Values too large for a half become infinity and values too small become zero or denormals.
+        * @param value The value to convert.
+        * @return The half's bits.
+        */
+        uint16_t toHalf(float value);
+
+        /**
+        * @brief Convert a half precision value back to a float.
+        * @param half The half's bits.
+        * @return The value, exact as every half is representable as a float.
+        */
+        float fromHalf(uint16_t half);
+
+        /**
+        * @brief Pack a vector for a Half2 attribute.
+        * @param value The vector.
+        * @return The two halves, in component order.
+        */
+        std::array<uint16_t, 2> packHalf2(const glm::vec2& value);
+
+        /**
+        * @brief Pack a vector for a Half4 attribute.
+        * @param value The vector.
+        * @return The four halves, in component order.
+        */
+        std::array<uint16_t, 4> packHalf4(const glm::vec4& value);
+
+        /**
+        * @brief Pack a [0, 1] vector, such as a colour, for a UByte4N attribute.
+        * @param value The vector, clamped to [0, 1].
+        * @return x in the lowest byte through w in the highest, matching the bytes' order in memory.
+        */
+        uint32_t packUByte4N(const glm::vec4& value);
+
+        /**
+        * @brief Unpack a UByte4N attribute as the shader reads it.
+        * @param packed The packed vector.
+        * @return The vector.
+        */
+        glm::vec4 unpackUByte4N(uint32_t packed);
+
+        /**
+        * @brief Pack a [-1, 1] vector, such as a normal or a tangent with its handedness in w, for an Int2101010Rev attribute.
+        * @param value The vector, clamped to [-1, 1].
+        * @return x in the lowest 10 bits, then y and z, and w in the highest 2 bits.
+        */
+        uint32_t packInt2101010Rev(const glm::vec4& value);
+
+        /**
+        * @brief Unpack an Int2101010Rev attribute as the shader reads it.
+        * @param packed The packed vector.
+        * @return The vector.
+        */
+        glm::vec4 unpackInt2101010Rev(uint32_t packed);
+
+        /**
+        * @brief Encode a unit vector on the octahedron for an Oct16 attribute.
+        * The shader decodes it with octDecode from include/octahedral.glsl.
+        * @param normal The unit vector.
+        * @return The encoded x in the low 16 bits and y in the high 16 bits, both signed.
+        */
+        uint32_t packOct16(const glm::vec3& normal);
+
+        /**
+        * @brief Decode an Oct16 attribute as the shader does.
+        * @param packed The encoded vector.
+        * @return The unit vector.
+        */
+        glm::vec3 unpackOct16(uint32_t packed);
+    }
+}
@@ -0,0 +1,346 @@
+/*****************************************************************//**
+@file   aabbTree.h
+@brief  An incrementally updated bounding volume hierarchy of fattened boxes, kept balanced by tree rotations, for visibility, picking and overlap queries.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "cameras/frustum.h"
+
+namespace Engine
+{
+    /**
+    * @struct AABB
+    * @brief An axis aligned box.
+    */
+    struct AABB
+    {
+        glm::vec3 min = glm::vec3(0.f); /**< Smallest corner. */
+        glm::vec3 max = glm::vec3(0.f); /**< Largest corner. */
+
+        inline glm::vec3 getCentre() const { return (min + max) * 0.5f; } /**< Get the centre of the box. */
+        inline glm::vec3 getExtent() const { return (max - min) * 0.5f; } /**< Get half the size of the box on each axis. */
+
+        /**
+        * @brief Get the surface area of the box, the cost of a node in the tree.
+        * @return The area.
+        */
+        inline float getSurfaceArea() const
+        {
+            glm::vec3 size = max - min;
+            return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        /**
+        * @brief Check if another box lies wholly inside this one.
+        * @param other The other box.
+        * @return True if the other box is contained.
+        */
+        inline bool contains(const AABB& other) const
+        {
+            return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z && other.max.x <= max.x && other.max.y <= max.y && other.max.z <= max.z;
+        }
+
+        /**
+        * @brief Check if another box touches this one.
+        * @param other The other box.
+        * @return True if the boxes overlap.
+        */
+        inline bool overlaps(const AABB& other) const
+        {
+            return min.x <= other.max.x && min.y <= other.max.y && min.z <= other.max.z && other.min.x <= max.x && other.min.y <= max.y && other.min.z <= max.z;
+        }
+
+        /**
+        * @brief Get the box around two boxes.
+        * @param a The first box.
+        * @param b The second box.
+        * @return The union of the boxes.
+        */
+        static inline AABB merge(const AABB& a, const AABB& b) { return { glm::min(a.min, b.min), glm::max(a.max, b.max) }; }
+
+        /**
+        * @brief Find where a ray enters the box.
+        * @param origin Start of the ray.
+        * @param inverseDirection One over each component of the ray's direction.
+        * @param maxDistance Furthest distance along the ray to look.
+        * @param distance Distance along the ray at which it enters, 0 if it starts inside.
+        * @return True if the ray enters the box within maxDistance.
+        */
+        inline bool raycast(const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance, float& distance) const
+        {
+            float enter = 0.f, exit = maxDistance;
+            for (int axis = 0; axis < 3; axis++)
+            {
+                float t0 = (min[axis] - origin[axis]) * inverseDirection[axis];
+                float t1 = (max[axis] - origin[axis]) * inverseDirection[axis];
+                if (t0 > t1) std::swap(t0, t1);
+                enter = std::max(enter, t0);
+                exit = std::min(exit, t1);
+            }
+            distance = enter;
+            return enter <= exit;
+        }
+    };
+
+    /**
+    * @struct RayHit
+    * @brief The nearest proxy hit by a ray cast into a DynamicAABBTree.
+    */
+    struct RayHit
+    {
+        int32_t proxy = -1; /**< The proxy hit, -1 if none was. */
+        float distance = 0.f; /**< Distance along the ray of the hit. */
+
+        inline bool isHit() const { return proxy >= 0; } /**< Check if anything was hit. */
+    };
+
+    /**
+    * @class DynamicAABBTree
+    * @brief A binary tree of boxes whose leaves are proxies for objects, each holding a fattened copy of its object's box.
+    * Leaves are inserted where they add the least surface area, and rotations keep the tree balanced.
+    * A proxy only moves in the tree once its object leaves the fattened box, so small movements cost a containment test.
+    */
+    class DynamicAABBTree
+    {
+    public:
+        static const int32_t NullNode = -1; /**< A node which does not exist. */
+
+        /**
+        * @brief Constructor for DynamicAABBTree.
+        * @param margin Distance each proxy's box is grown by on every side.
+        * @param displacementScale How far ahead of a moving object its box is extended, as a multiple of its displacement.
+        */
+        explicit DynamicAABBTree(float margin = 0.1f, float displacementScale = 2.f);
+
+        /**
+        * @brief Add a proxy for an object.
+        * @param box The object's box.
+        * @param userData A value identifying the object, passed to query callbacks.
+        * @return The proxy, valid until destroyed.
+        */
+        int32_t createProxy(const AABB& box, uint32_t userData);
+
+        /**
+        * @brief Remove a proxy.
+        * @param proxy The proxy.
+        */
+        void destroyProxy(int32_t proxy);
+
+        /**
+        * @brief Refit a proxy to its object's new box, reinserting it only if the box has left the fattened one.
+        * @param proxy The proxy.
+        * @param box The object's new box.
+        * @param displacement How far the object moved since its last update, to extend the fattened box along.
+        * @return True if the proxy was reinserted.
+        */
+        bool moveProxy(int32_t proxy, const AABB& box, const glm::vec3& displacement = glm::vec3(0.f));
+
+        inline const AABB& getFatAABB(int32_t proxy) const { return m_nodes[proxy].box; } /**< Get a proxy's fattened box. */
+        inline uint32_t getUserData(int32_t proxy) const { return m_nodes[proxy].userData; } /**< Get a proxy's user data. */
+        inline uint32_t getProxyCount() const { return m_proxyCount; } /**< Get the number of proxies. */
+        inline int32_t getHeight() const { return m_root == NullNode ? 0 : m_nodes[m_root].height; } /**< Get the height of the tree, 0 for a leaf. */
+
+        /**
+        * @brief Get the total surface area of the internal nodes relative to the root's, lower is a better tree.
+        * @return The ratio, 0 for an empty tree.
+        */
+        float getAreaRatio() const;
+
+        /**
+        * @brief Check the tree's links, heights and boxes are consistent.
+        * @return True if the tree is valid.
+        */
+        bool validate() const;
+
+        /**
+        * @brief Find every proxy whose fattened box overlaps a box.
+        * @param box The box.
+        * @param callback Called with each proxy and its user data, returns false to stop the query.
+        */
+        template<typename F>
+        void queryBox(const AABB& box, F&& callback) const
+        {
+            traverse([&box](const AABB& node) { return box.overlaps(node); }, callback);
+        }
+
+        /**
+        * @brief Find every proxy whose fattened box overlaps a sphere.
+        * @param centre Centre of the sphere.
+        * @param radius Radius of the sphere.
+        * @param callback Called with each proxy and its user data, returns false to stop the query.
+        */
+        template<typename F>
+        void querySphere(const glm::vec3& centre, float radius, F&& callback) const
+        {
+            traverse([&centre, radius](const AABB& node)
+            {
+                glm::vec3 offset = centre - glm::clamp(centre, node.min, node.max);
+                return glm::dot(offset, offset) <= radius * radius;
+            }, callback);
+        }
+
+        /**
+        * @brief Find every proxy whose fattened box is at least partly inside a frustum.
+        * Proxies below a node wholly inside the frustum are reported without being tested.
+        * @param frustum The frustum.
+        * @param callback Called with each proxy and its user data, returns false to stop the query.
+        */
+        template<typename F>
+        void queryFrustum(const Frustum& frustum, F&& callback) const
+        {
+            if (m_root == NullNode) return;
+
+            // Each entry carries whether its parent was wholly inside, which its children inherit.
+            std::vector<std::pair<int32_t, bool>> stack;
+            stack.reserve(64);
+            stack.push_back({ m_root, false });
+            while (!stack.empty())
+            {
+                auto [id, inside] = stack.back();
+                stack.pop_back();
+                const Node& node = m_nodes[id];
+
+                if (!inside)
+                {
+                    glm::vec3 centre = node.box.getCentre(), extent = node.box.getExtent();
+                    bool outside = false;
+                    inside = true;
+                    for (const glm::vec4& plane : frustum.planes)
+                    {
+                        float distance = glm::dot(glm::vec3(plane), centre) + plane.w;
+                        float radius = glm::dot(glm::abs(glm::vec3(plane)), extent);
+                        if (distance < -radius) { outside = true; break; }
+                        if (distance < radius) inside = false;
+                    }
+                    if (outside) continue;
+                }
+
+                if (node.isLeaf())
+                {
+                    if (!callback(id, node.userData)) return;
+                }
+                else
+                {
+                    stack.push_back({ node.child2, inside });
+                    stack.push_back({ node.child1, inside });
+                }
+            }
+        }
+
+        /**
+        * @brief Find the nearest object hit by a ray.
+        * Only proxies whose fattened box the ray enters before the nearest hit so far are tested.
+        * @param origin Start of the ray.
+        * @param direction Direction of the ray, distances are in multiples of its length.
+        * @param maxDistance Furthest distance along the ray to look.
+        * @param hitTest Called with each candidate proxy and its user data, returns the distance at which the ray hits the object, or a negative value for a miss.
+        * @return The nearest hit.
+        */
+        template<typename F>
+        RayHit raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, F&& hitTest) const
+        {
+            RayHit hit;
+            hit.distance = maxDistance;
+            if (m_root == NullNode) return hit;
+
+            glm::vec3 inverseDirection(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+            std::vector<int32_t> stack;
+            stack.reserve(64);
+            stack.push_back(m_root);
+            while (!stack.empty())
+            {
+                int32_t id = stack.back();
+                stack.pop_back();
+                const Node& node = m_nodes[id];
+
+                float entry;
+                if (!node.box.raycast(origin, inverseDirection, hit.distance, entry)) continue;
+
+                if (node.isLeaf())
+                {
+                    float distance = hitTest(id, node.userData);
+                    if (distance >= 0.f && distance <= hit.distance)
+                    {
+                        hit.proxy = id;
+                        hit.distance = distance;
+                    }
+                }
+                else
+                {
+                    stack.push_back(node.child2);
+                    stack.push_back(node.child1);
+                }
+            }
+            return hit;
+        }
+
+    private:
+        /** @brief A node of the tree, a proxy if it is a leaf. */
+        struct Node
+        {
+            AABB box; /**< Fattened box of a leaf, or the union of the children's boxes. */
+            uint32_t userData = 0; /**< The user data of a leaf. */
+            int32_t parent = NullNode; /**< Parent node, or the next free node while unused. */
+            int32_t child1 = NullNode; /**< First child, NullNode for a leaf. */
+            int32_t child2 = NullNode; /**< Second child, NullNode for a leaf. */
+            int32_t height = -1; /**< 0 for a leaf, one more than the taller child otherwise, -1 while unused. */
+
+            inline bool isLeaf() const { return child1 == NullNode; }
+        };
+
+        std::vector<Node> m_nodes; /**< Every node, used or free. */
+        int32_t m_root = NullNode; /**< The root node. */
+        int32_t m_freeList = NullNode; /**< First unused node. */
+        uint32_t m_proxyCount = 0; /**< Number of leaves. */
+        float m_margin; /**< Distance each proxy's box is grown by. */
+        float m_displacementScale; /**< How far ahead of a moving object its box is extended. */
+
+        /** @brief Take a node from the free list, growing the storage if it is empty. */
+        int32_t allocateNode();
+        /** @brief Return a node to the free list. */
+        void freeNode(int32_t node);
+        /** @brief Insert a leaf beside the node where it adds the least area. */
+        void insertLeaf(int32_t leaf);
+        /** @brief Remove a leaf, replacing its parent with its sibling. */
+        void removeLeaf(int32_t leaf);
+        /** @brief Refit boxes and heights from a node to the root, rotating unbalanced nodes on the way. */
+        void refitAncestors(int32_t node);
+        /** @brief Rotate a node's taller child up if the children's heights differ by more than one. */
+        int32_t balance(int32_t node);
+
+        /** @brief Visit every leaf whose ancestors and own box pass a test. */
+        template<typename Test, typename F>
+        void traverse(const Test& test, F& callback) const
+        {
+            if (m_root == NullNode) return;
+
+            std::vector<int32_t> stack;
+            stack.reserve(64);
+            stack.push_back(m_root);
+            while (!stack.empty())
+            {
+                int32_t id = stack.back();
+                stack.pop_back();
+                const Node& node = m_nodes[id];
+                if (!test(node.box)) continue;
+
+                if (node.isLeaf())
+                {
+                    if (!callback(id, node.userData)) return;
+                }
+                else
+                {
+                    stack.push_back(node.child2);
+                    stack.push_back(node.child1);
+                }
+            }
+        }
+    };
+}
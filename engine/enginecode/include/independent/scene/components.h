@@ -0,0 +1,98 @@
+/*****************************************************************//**
+@file   components.h
+@brief  The components of renderable scene objects, stored in an EntityRegistry.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <glm/glm.hpp>
+#include "scene/transformHierarchy.h"
+#include "rendering/indirectDraw.h"
+
+namespace Engine
+{
+    class OpenGLVertexArray;
+    class Material;
+    class OpenGLMesh;
+    class OpenGLMeshPool;
+    struct OccluderMesh;
+
+    /**
+    * @struct Transform
+    * @brief Places an entity through a TransformHierarchy, which owns the matrices so they can be updated in one sweep.
+    */
+    struct Transform
+    {
+        TransformID id = NullTransform; /**< The entity's transform in the scene's hierarchy. */
+    };
+
+    /**
+    * @struct MeshRef
+    * @brief The geometry an entity is drawn with.
+    */
+    struct MeshRef
+    {
+        std::shared_ptr<OpenGLVertexArray> geometry; /**< Vertex array of the mesh. */
+    };
+
+    /**
+    * @struct PooledMesh
+    * @brief Geometry suballocated from a mesh pool, drawn in place of a MeshRef so draws sharing the pool can be batched.
+    */
+    struct PooledMesh
+    {
+        OpenGLMeshPool* pool = nullptr; /**< The pool holding the mesh, which must outlive the entity. */
+        MeshHandle mesh; /**< The mesh's ranges in the pool. */
+    };
+
+    /**
+    * @struct LevelOfDetail
+    * @brief Swaps an entity's MeshRef between its mesh's levels of detail as its size on screen changes.
+    */
+    struct LevelOfDetail
+    {
+        std::shared_ptr<OpenGLMesh> mesh; /**< The mesh whose levels are chosen between. */
+        uint32_t current = 0; /**< The level drawn last frame, which the choice sticks to near a boundary. */
+    };
+
+    /**
+    * @struct MaterialRef
+    * @brief The material an entity is drawn with.
+    */
+    struct MaterialRef
+    {
+        std::shared_ptr<Material> material; /**< The material, shared between entities which look alike. */
+    };
+
+    /**
+    * @struct Bounds
+    * @brief Axis aligned bounds of an entity's geometry, in the entity's local space.
+    */
+    struct Bounds
+    {
+        glm::vec3 min = glm::vec3(0.f); /**< Smallest corner. */
+        glm::vec3 max = glm::vec3(0.f); /**< Largest corner. */
+    };
+
+    /**
+    * @struct SpatialProxy
+    * @brief An entity's leaf in the scene's DynamicAABBTree, refitted as the entity moves.
+    */
+    struct SpatialProxy
+    {
+        int32_t id = -1; /**< The proxy, whose user data is the entity's index. */
+    };
+
+    /**
+    * @struct Occluder
+    * @brief Marks an entity as hiding what is behind it, through simple triangles inside its geometry.
+    */
+    struct Occluder
+    {
+        std::shared_ptr<OccluderMesh> mesh; /**< The triangles rasterized for occlusion, in the entity's local space. */
+    };
+}
@@ -0,0 +1,365 @@
+/*****************************************************************//**
+@file   entityRegistry.h
+@brief  Entity component storage grouped by archetype, each component held in a contiguous array per fixed size chunk.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Engine
+{
+    /**
+    * @struct Entity
+    * @brief Handle of an entity, whose generation tells a destroyed entity from a new one reusing its index.
+    */
+    struct Entity
+    {
+        uint32_t index = 0xFFFFFFFF; /**< Index of the entity's record. */
+        uint32_t generation = 0; /**< Number of times the record had been reused when the entity was created. */
+
+        inline bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+        inline bool operator!=(const Entity& other) const { return !(*this == other); }
+    };
+
+    const Entity NullEntity; /**< An entity which never exists. */
+
+    /** @brief Set of component types, one bit per type. */
+    using ComponentMask = uint64_t;
+
+    /**
+    * @struct ComponentInfo
+    * @brief How to move and destroy a component type without knowing it.
+    */
+    struct ComponentInfo
+    {
+        uint32_t size; /**< Size of the type in bytes. */
+        uint32_t alignment; /**< Alignment of the type in bytes. */
+        void (*moveAndDestroy)(void* destination, void* source); /**< Move construct into uninitialised storage, then destroy the source. */
+        void (*destroy)(void* component); /**< Destroy a component in place. */
+    };
+
+    namespace ComponentTypes
+    {
+        const uint32_t maxTypes = 64; /**< Number of component types a program may use, the width of ComponentMask. */
+
+        /**
+        * @brief Register a component type, called once per type by id().
+        * @param info How to move and destroy the type.
+        * @return The type's ID.
+        */
+        uint32_t registerType(const ComponentInfo& info);
+
+        /**
+        * @brief Get the description of a component type.
+        * @param id The type's ID.
+        * @return The description.
+        */
+        const ComponentInfo& getInfo(uint32_t id);
+
+        /**
+        * @brief Get the ID of a component type, registering it on first use.
+        * @return The type's ID, below maxTypes.
+        */
+        template<typename T>
+        uint32_t id()
+        {
+            static_assert(std::is_move_constructible<T>::value, "Components must be move constructible");
+            static const uint32_t s_id = registerType({ sizeof(T), alignof(T),
+                [](void* destination, void* source) { new (destination) T(std::move(*static_cast<T*>(source))); static_cast<T*>(source)->~T(); },
+                [](void* component) { static_cast<T*>(component)->~T(); } });
+            return s_id;
+        }
+
+        /**
+        * @brief Get the mask of a set of component types.
+        * @return The types' bits.
+        */
+        template<typename... Ts>
+        ComponentMask mask() { return (ComponentMask(0) | ... | (ComponentMask(1) << id<Ts>())); }
+    }
+
+    /**
+    * @class Archetype
+    * @brief Storage of every entity with exactly one set of component types.
+    * Rows are packed into chunks of chunkSize bytes, each chunk holding the rows' entities and then one array per component.
+    * Every chunk but the last is full, rows removed from the middle are filled from the end.
+    */
+    class Archetype
+    {
+    public:
+        static const uint32_t chunkSize = 16 * 1024; /**< Target size of a chunk in bytes. */
+        static const uint32_t chunkAlignment = 64; /**< Alignment of each chunk, a cache line. */
+
+        /**
+        * @struct Chunk
+        * @brief A block of rows.
+        */
+        struct Chunk
+        {
+            uint8_t* data = nullptr; /**< The entities, then each component's array. */
+            uint32_t count = 0; /**< Number of rows in use. */
+        };
+
+        /**
+        * @brief Constructor for Archetype, laying out its chunks.
+        * @param mask The component types of the archetype.
+        */
+        explicit Archetype(ComponentMask mask);
+
+        /**
+        * @brief Destructor for Archetype.
+        * Destroys every component and frees the chunks.
+        */
+        ~Archetype();
+
+        Archetype(const Archetype&) = delete;
+        Archetype& operator=(const Archetype&) = delete;
+
+        inline ComponentMask getMask() const { return m_mask; } /**< Get the component types of the archetype. */
+        inline const std::vector<uint32_t>& getTypes() const { return m_types; } /**< Get the IDs of the archetype's component types, in ascending order. */
+        inline uint32_t getCapacity() const { return m_capacity; } /**< Get the number of rows per chunk. */
+        inline const std::vector<Chunk>& getChunks() const { return m_chunks; } /**< Get the chunks, all but the last full. */
+
+        /**
+        * @brief Get the entities of a chunk.
+        * @param chunk The chunk's index.
+        * @return One entity per row.
+        */
+        inline Entity* getEntities(uint32_t chunk) const { return reinterpret_cast<Entity*>(m_chunks[chunk].data); }
+
+        /**
+        * @brief Get a component's array in a chunk.
+        * @param chunk The chunk's index.
+        * @param type The component type's ID, which must be in the archetype.
+        * @return The first row's component.
+        */
+        inline void* getColumn(uint32_t chunk, uint32_t type) const { return m_chunks[chunk].data + m_offsets[type]; }
+
+        /**
+        * @brief Add a row for an entity, leaving its components uninitialised.
+        * @param entity The entity.
+        * @param chunk The chunk of the new row.
+        * @param row The new row within its chunk.
+        */
+        void allocateRow(Entity entity, uint32_t& chunk, uint32_t& row);
+
+        /**
+        * @brief Remove a row, filling it with the last row.
+        * @param chunk The row's chunk.
+        * @param row The row.
+        * @param destroyComponents False if the row's components were already moved out.
+        * @return The entity moved into the row, NullEntity if the row was last.
+        */
+        Entity removeRow(uint32_t chunk, uint32_t row, bool destroyComponents);
+
+    private:
+        ComponentMask m_mask; /**< The component types of the archetype. */
+        std::vector<uint32_t> m_types; /**< IDs of the component types, in ascending order. */
+        uint32_t m_capacity; /**< Number of rows per chunk. */
+        uint32_t m_bytes; /**< Size of each chunk in bytes. */
+        uint32_t m_offsets[ComponentTypes::maxTypes]; /**< Offset of each component type's array in a chunk. */
+        std::vector<Chunk> m_chunks; /**< The chunks, all but the last full. */
+    };
+
+    /**
+    * @struct ChunkView
+    * @brief The rows of one chunk matching a query, as a count and one array per queried component.
+    * Chunks share no data, so a query's chunks can be handed to different threads.
+    */
+    template<typename... Ts>
+    struct ChunkView
+    {
+        uint32_t count; /**< Number of rows. */
+        const Entity* entities; /**< The entity of each row. */
+        std::tuple<Ts*...> columns; /**< Each queried component's array. */
+
+        /**
+        * @brief Get a queried component's array.
+        * @return The first row's component.
+        */
+        template<typename T>
+        inline T* get() const { return std::get<T*>(columns); }
+    };
+
+    /**
+    * @class EntityRegistry
+    * @brief Creates entities and stores their components, grouped by archetype.
+    * Adding or removing a component moves the entity to the archetype of its new set of components.
+    * Pointers to components are invalidated by any change to the components of any entity.
+    */
+    class EntityRegistry
+    {
+    public:
+        /** @brief Default constructor for EntityRegistry, holding the empty archetype. */
+        EntityRegistry();
+
+        EntityRegistry(const EntityRegistry&) = delete;
+        EntityRegistry& operator=(const EntityRegistry&) = delete;
+
+        /**
+        * @brief Create an entity with some components.
+        * @param components The entity's components, one of each type.
+        * @return The entity.
+        */
+        template<typename... Ts>
+        Entity create(Ts&&... components)
+        {
+            Entity entity = createEntity(ComponentTypes::mask<std::decay_t<Ts>...>());
+            const Record& record = m_records[entity.index];
+            (construct<std::decay_t<Ts>>(record, std::forward<Ts>(components)), ...);
+            return entity;
+        }
+
+        /**
+        * @brief Destroy an entity and its components.
+        * @param entity The entity, ignored if it no longer exists.
+        */
+        void destroy(Entity entity);
+
+        /**
+        * @brief Check an entity exists.
+        * @param entity The entity.
+        * @return True if the entity was created and not yet destroyed.
+        */
+        inline bool isAlive(Entity entity) const { return entity.index < m_records.size() && m_records[entity.index].generation == entity.generation; }
+
+        /**
+        * @brief Add a component to an entity, or replace its component of that type.
+        * @param entity The entity, which must exist.
+        * @param component The component.
+        * @return The entity's component.
+        */
+        template<typename T>
+        std::decay_t<T>& add(Entity entity, T&& component)
+        {
+            using Type = std::decay_t<T>;
+            if (Type* existing = get<Type>(entity)) return *existing = std::forward<T>(component);
+
+            move(entity, m_archetypes[m_records[entity.index].archetype]->getMask() | ComponentTypes::mask<Type>());
+            return *construct<Type>(m_records[entity.index], std::forward<T>(component));
+        }
+
+        /**
+        * @brief Remove a component from an entity.
+        * @param entity The entity, which must exist.
+        */
+        template<typename T>
+        void remove(Entity entity)
+        {
+            if (!has<T>(entity)) return;
+            move(entity, m_archetypes[m_records[entity.index].archetype]->getMask() & ~ComponentTypes::mask<T>());
+        }
+
+        /**
+        * @brief Check if an entity has a component.
+        * @param entity The entity.
+        * @return True if the entity exists and has the component.
+        */
+        template<typename T>
+        bool has(Entity entity) const
+        {
+            return isAlive(entity) && (m_archetypes[m_records[entity.index].archetype]->getMask() & ComponentTypes::mask<T>()) != 0;
+        }
+
+        /**
+        * @brief Get an entity's component.
+        * @param entity The entity.
+        * @return The component, null if the entity does not exist or lacks the component.
+        */
+        template<typename T>
+        T* get(Entity entity) const
+        {
+            if (!has<T>(entity)) return nullptr;
+            const Record& record = m_records[entity.index];
+            return static_cast<T*>(m_archetypes[record.archetype]->getColumn(record.chunk, ComponentTypes::id<T>())) + record.row;
+        }
+
+        /**
+        * @brief Find every chunk whose entities have all of a set of components.
+        * @return A view of each chunk.
+        */
+        template<typename... Ts>
+        std::vector<ChunkView<Ts...>> query() const
+        {
+            std::vector<ChunkView<Ts...>> views;
+            ComponentMask required = ComponentTypes::mask<Ts...>();
+            for (const auto& archetype : m_archetypes)
+            {
+                if ((archetype->getMask() & required) != required) continue;
+
+                const auto& chunks = archetype->getChunks();
+                for (uint32_t c = 0; c < chunks.size(); c++)
+                {
+                    views.push_back({ chunks[c].count, archetype->getEntities(c), std::make_tuple(static_cast<Ts*>(archetype->getColumn(c, ComponentTypes::id<Ts>()))...) });
+                }
+            }
+            return views;
+        }
+
+        /**
+        * @brief Call a function for every entity with all of a set of components.
+        * @param function Called with the entity and a reference to each of its components, in query order.
+        */
+        template<typename... Ts, typename F>
+        void each(F&& function) const
+        {
+            for (const ChunkView<Ts...>& chunk : query<Ts...>())
+            {
+                for (uint32_t row = 0; row < chunk.count; row++) function(chunk.entities[row], std::get<Ts*>(chunk.columns)[row]...);
+            }
+        }
+
+        /**
+        * @brief Get the number of entities.
+        * @return The entity count.
+        */
+        inline uint32_t size() const { return m_alive; }
+
+        /**
+        * @brief Get the number of archetypes, one per set of components in use so far.
+        * @return The archetype count.
+        */
+        inline uint32_t getArchetypeCount() const { return static_cast<uint32_t>(m_archetypes.size()); }
+
+    private:
+        /** @brief Where an entity's components are stored. */
+        struct Record
+        {
+            uint32_t generation = 0; /**< Generation of the entity using the record. */
+            uint32_t archetype = 0; /**< Index of the entity's archetype. */
+            uint32_t chunk = 0; /**< Chunk of the entity's row. */
+            uint32_t row = 0; /**< The entity's row within its chunk. */
+        };
+
+        std::vector<std::unique_ptr<Archetype>> m_archetypes; /**< Every archetype created so far. */
+        std::unordered_map<ComponentMask, uint32_t> m_archetypeIndices; /**< Index of the archetype of each set of components. */
+        std::vector<Record> m_records; /**< Indexed by entity index. */
+        std::vector<uint32_t> m_freeRecords; /**< Records of destroyed entities, to be reused. */
+        uint32_t m_alive = 0; /**< Number of entities. */
+
+        /** @brief Get the archetype of a set of components, creating it if needed. */
+        uint32_t getArchetype(ComponentMask mask);
+        /** @brief Create an entity with a row in an archetype, leaving its components uninitialised. */
+        Entity createEntity(ComponentMask mask);
+        /** @brief Move an entity to another archetype, moving the components both share and destroying the rest. */
+        void move(Entity entity, ComponentMask mask);
+
+        /** @brief Construct a component in an entity's uninitialised row. */
+        template<typename T, typename U>
+        T* construct(const Record& record, U&& value)
+        {
+            void* column = m_archetypes[record.archetype]->getColumn(record.chunk, ComponentTypes::id<T>());
+            return new (static_cast<T*>(column) + record.row) T(std::forward<U>(value));
+        }
+    };
+}
@@ -0,0 +1,139 @@
+/*****************************************************************//**
+@file   transformHierarchy.h
+@brief  Parented transforms stored as structure of arrays in parent first order, with world matrices recomputed only for dirty subtrees.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Engine
+{
+    /** @brief Stable handle of a transform, unchanged when the hierarchy is reordered. */
+    using TransformID = uint32_t;
+
+    const TransformID NullTransform = 0xFFFFFFFF; /**< A transform which does not exist, used for roots' parents. */
+
+    /**
+    * @class TransformHierarchy
+    * @brief Holds the local position, rotation and scale of many transforms, and their world matrices.
+    * Each component lives in its own array, and every parent is stored before its children,
+    * so one forward sweep updates every world matrix. The sweep starts at the first dirty transform
+    * and only recomputes transforms which changed or whose parent did, so a static scene costs nothing.
+    */
+    class TransformHierarchy
+    {
+    public:
+        /**
+        * @brief Reserve storage for a number of transforms.
+        * @param count Number of transforms.
+        */
+        void reserve(uint32_t count);
+
+        /**
+        * @brief Add a transform, at the origin with no rotation and unit scale.
+        * The handle of a destroyed transform is reused before a new one is made.
+        * @param parent The parent transform, or NullTransform for a root.
+        * @return The new transform.
+        */
+        TransformID create(TransformID parent = NullTransform);
+
+        /**
+        * @brief Remove a transform, moving the last slot into its place.
+        * Its children are moved under its parent, keeping their local transforms like setParent does.
+        * @param id The transform to remove, whose handle must not be used again until create returns it.
+        */
+        void destroy(TransformID id);
+
+        /**
+        * @brief Move a transform, and its subtree, under a new parent.
+        * The local transform is kept, so the world transform changes with the parent's.
+        * @param id The transform to move.
+        * @param parent The new parent, or NullTransform to make it a root.
+        * @return False if the parent is the transform or one of its descendants.
+        */
+        bool setParent(TransformID id, TransformID parent);
+
+        void setPosition(TransformID id, const glm::vec3& position); /**< Set a transform's position relative to its parent. */
+        void setRotation(TransformID id, const glm::quat& rotation); /**< Set a transform's rotation relative to its parent. */
+        void setScale(TransformID id, const glm::vec3& scale); /**< Set a transform's scale relative to its parent. */
+
+        inline const glm::vec3& getPosition(TransformID id) const { return m_positions[m_slots[id]]; } /**< Get a transform's position relative to its parent. */
+        inline const glm::quat& getRotation(TransformID id) const { return m_rotations[m_slots[id]]; } /**< Get a transform's rotation relative to its parent. */
+        inline const glm::vec3& getScale(TransformID id) const { return m_scales[m_slots[id]]; } /**< Get a transform's scale relative to its parent. */
+
+        /**
+        * @brief Get a transform's parent.
+        * @param id The transform.
+        * @return The parent, NullTransform for a root.
+        */
+        TransformID getParent(TransformID id) const;
+
+        /**
+        * @brief Get a transform's world matrix.
+        * @param id The transform.
+        * @return The world matrix as of the last update.
+        */
+        inline const glm::mat4& getWorld(TransformID id) const { return m_worlds[m_slots[id]]; }
+
+        /**
+        * @brief Get a transform's normal matrix, which keeps normals perpendicular to surfaces under non uniform scale.
+        * @param id The transform.
+        * @return The inverse transpose of the world matrix's upper 3x3, as of the last update.
+        */
+        inline const glm::mat3& getNormal(TransformID id) const { return m_normals[m_slots[id]]; }
+
+        /**
+        * @brief Recompute the world and normal matrices of every changed transform and their descendants.
+        * The local matrices of everything changed are composed in one batch by TransformKernels before being joined to their parents'.
+        * Returns immediately if nothing changed since the last update.
+        */
+        void update();
+
+        /**
+        * @brief Get the transforms whose world matrix was recomputed by the last update.
+        * @return The transforms, parents before children.
+        */
+        inline const std::vector<TransformID>& getUpdated() const { return m_updated; }
+
+        /**
+        * @brief Get the number of transforms.
+        * @return The transform count.
+        */
+        inline uint32_t size() const { return static_cast<uint32_t>(m_ids.size()); }
+
+    private:
+        // Per slot data, slots are in parent first order.
+        std::vector<glm::vec3> m_positions; /**< Position relative to the parent. */
+        std::vector<glm::quat> m_rotations; /**< Rotation relative to the parent. */
+        std::vector<glm::vec3> m_scales; /**< Scale relative to the parent. */
+        std::vector<uint32_t> m_parents; /**< Slot of the parent, NullTransform for a root. */
+        std::vector<glm::mat4> m_worlds; /**< World matrix as of the last update. */
+        std::vector<glm::mat3> m_normals; /**< Normal matrix as of the last update. */
+        std::vector<uint8_t> m_dirty; /**< Non zero if the local transform changed since the last update. */
+        std::vector<uint8_t> m_changed; /**< Scratch for update, non zero if the world matrix was recomputed. */
+        std::vector<TransformID> m_ids; /**< The transform held in each slot. */
+
+        std::vector<uint32_t> m_slots; /**< The slot holding each transform, NullTransform once destroyed. */
+        std::vector<TransformID> m_freeIDs; /**< Handles of destroyed transforms, reused by create. */
+        std::vector<TransformID> m_updated; /**< Transforms recomputed by the last update. */
+        std::vector<uint32_t> m_batch; /**< Scratch for update, the slots being recomputed in parent first order. */
+        std::vector<float> m_batchTRS; /**< Scratch for update, the batch's local transforms as ten streams of floats. */
+        std::vector<glm::mat4> m_batchLocals; /**< Scratch for update, the batch's local matrices. */
+        std::vector<glm::mat3> m_batchNormals; /**< Scratch for update, the batch's local normal matrices. */
+        uint32_t m_firstDirty = NullTransform; /**< Lowest dirty slot, where the next sweep starts. */
+        bool m_needsSort = false; /**< True if a parent was moved after one of its children. */
+
+        /** @brief Mark a slot's local transform as changed. */
+        void markDirty(uint32_t slot);
+        /** @brief Point every child of one slot at another, flagging a sort if a child would come before its parent. */
+        void moveChildren(uint32_t from, uint32_t to, bool dirty);
+        /** @brief Reorder the slots so every parent comes before its children, keeping the order otherwise. */
+        void sort();
+    };
+}
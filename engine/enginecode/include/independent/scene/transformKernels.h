@@ -0,0 +1,47 @@
+/*****************************************************************//**
+@file   transformKernels.h
+@brief  Batched composition of position, rotation and scale into world and normal matrices, vectorised with SSE2 or AVX2 as the CPU allows.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "systems/cpuFeatures.h"
+
+namespace Engine
+{
+    /**
+    * @struct TRSStreams
+    * @brief Transforms as one array per component, so a vector register loads the same component of several transforms at once.
+    */
+    struct TRSStreams
+    {
+        const float* position[3]; /**< x, y and z of each position. */
+        const float* rotation[4]; /**< x, y, z and w of each rotation, a unit quaternion. */
+        const float* scale[3]; /**< x, y and z of each scale, none of them zero. */
+    };
+
+    namespace TransformKernels
+    {
+        /**
+        * @brief Compose transforms into matrices, equal to translate * mat4_cast(rotation) * scale.
+        * The normal matrices are the inverse transpose of each matrix's upper 3x3, which for a single TRS is the rotation divided by the scale,
+        * so no inverse is needed. A child's normal matrix is its parent's times its own, like the world matrix.
+        * @param trs The transforms.
+        * @param count Number of transforms.
+        * @param matrices Receives one matrix per transform.
+        * @param normals Receives one normal matrix per transform, may be null.
+        * @param set The instruction set to use, lowered to the supported one if wider.
+        */
+        void compose(const TRSStreams& trs, uint32_t count, glm::mat4* matrices, glm::mat3* normals, InstructionSet set);
+
+        /** @brief Compose transforms with the widest supported instruction set, see compose above. */
+        inline void compose(const TRSStreams& trs, uint32_t count, glm::mat4* matrices, glm::mat3* normals)
+        {
+            compose(trs, count, matrices, normals, CpuFeatures::getSupportedInstructionSet());
+        }
+    }
+}
@@ -0,0 +1,30 @@
+/*****************************************************************//**
+@file   cpuFeatures.h
+@brief  Detection of the vector instruction sets the CPU and operating system support, so wide code paths can be chosen at runtime.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+namespace Engine
+{
+    /** @brief The vector code paths a kernel can run, narrowest first. */
+    enum class InstructionSet { Scalar = 0, SSE2, AVX2 };
+
+    namespace CpuFeatures
+    {
+        /**
+        * @brief Get the widest instruction set this CPU and build support, detected once on first use.
+        * @return AVX2 if the CPU has AVX2 and FMA, otherwise SSE2 on x86, otherwise Scalar.
+        */
+        InstructionSet getSupportedInstructionSet();
+
+        /**
+        * @brief Get an instruction set's name, for logging.
+        * @param set The instruction set.
+        * @return "AVX2", "SSE2" or "Scalar".
+        */
+        const char* getInstructionSetName(InstructionSet set);
+    }
+}
@@ -0,0 +1,74 @@
+/*****************************************************************//**
+@file   mappedFile.h
+@brief  Read only memory mapping of a whole file, so its contents can be used in place without being read or copied.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Engine
+{
+    /** @brief Class mapping a file read only into the address space, unmapped on destruction. */
+    class MappedFile
+    {
+    public:
+        /** @brief Default constructor for MappedFile, mapping nothing. */
+        MappedFile() = default;
+
+        /**
+        * @brief Constructor for MappedFile, mapping a file.
+        * @param filepath Path to the file.
+        */
+        explicit MappedFile(const char* filepath) { open(filepath); }
+
+        /**
+        * @brief Destructor for MappedFile.
+        * Unmaps the file and closes its handles.
+        */
+        ~MappedFile() { close(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+        * @brief Map a file, unmapping any file already mapped.
+        * Pages are only read from disk as they are first touched.
+        * @param filepath Path to the file.
+        * @return True if the file was opened and mapped.
+        */
+        bool open(const char* filepath);
+
+        /** @brief Unmap the file. */
+        void close();
+
+        /**
+        * @brief Check if a file is mapped.
+        * @return True if the file's contents can be read.
+        */
+        inline bool isOpen() const { return m_data != nullptr; }
+
+        /**
+        * @brief Get the mapped contents.
+        * @return The first byte of the file, valid until the file is closed.
+        */
+        inline const uint8_t* getData() const { return m_data; }
+
+        /**
+        * @brief Get the size of the mapped file.
+        * @return The size in bytes.
+        */
+        inline size_t getSize() const { return m_size; }
+
+    private:
+        const uint8_t* m_data = nullptr; /**< The mapped contents. */
+        size_t m_size = 0; /**< Size of the mapping in bytes. */
+#ifdef NG_PLATFORM_WINDOWS
+        void* m_file = nullptr; /**< Handle of the open file. */
+        void* m_mapping = nullptr; /**< Handle of the file mapping object. */
+#endif
+    };
+}
@@ -0,0 +1,81 @@
+/*****************************************************************//**
+@file   workerPool.h
+@brief  A fixed set of worker threads which split loops over ranges between themselves and the calling thread.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine
+{
+    /** @brief Class running the blocks of a loop on persistent worker threads. */
+    class WorkerPool
+    {
+    public:
+        /**
+        * @brief Constructor for WorkerPool, starting the workers.
+        * @param workerCount Number of worker threads, by default one fewer than the hardware threads as the caller also works.
+        */
+        explicit WorkerPool(uint32_t workerCount = defaultWorkerCount());
+
+        /**
+        * @brief Destructor for WorkerPool.
+        * Stops and joins the workers.
+        */
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        /**
+        * @brief Split the range [0, count) into blocks and run the function on each, returning once all have run.
+        * The calling thread runs blocks too. Blocks may run in any order and on any thread.
+        * A range of one block or less runs on the calling thread alone.
+        * @param count Size of the range.
+        * @param blockSize Number of elements per block, the last block may be smaller.
+        * @param function Called with the first and one past the last element of each block.
+        */
+        void parallelFor(uint32_t count, uint32_t blockSize, const std::function<void(uint32_t, uint32_t)>& function);
+
+        /**
+        * @brief Get the number of worker threads.
+        * @return The worker count, not including the calling thread.
+        */
+        inline uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+        /**
+        * @brief Get the default number of workers.
+        * @return One fewer than the number of hardware threads.
+        */
+        static uint32_t defaultWorkerCount();
+
+    private:
+        std::vector<std::thread> m_workers; /**< The worker threads. */
+        std::mutex m_callMutex; /**< Lets one parallelFor run at a time. */
+        std::mutex m_mutex; /**< Guards the job description and the counters below. */
+        std::condition_variable m_wake; /**< Signalled when a job starts or the pool stops. */
+        std::condition_variable m_done; /**< Signalled when the last worker finishes a job. */
+
+        const std::function<void(uint32_t, uint32_t)>* m_function = nullptr; /**< The current job. */
+        uint32_t m_count = 0; /**< Size of the current job's range. */
+        uint32_t m_blockSize = 1; /**< Block size of the current job. */
+        std::atomic<uint32_t> m_next{ 0 }; /**< First element of the next unclaimed block. */
+        uint32_t m_generation = 0; /**< Incremented for each job, so workers can tell a new job from a spurious wake. */
+        uint32_t m_busy = 0; /**< Number of workers yet to finish the current job. */
+        bool m_stopping = false; /**< True once the pool is being destroyed. */
+
+        /** @brief Claim and run blocks of the current job until none are left. */
+        void runBlocks();
+        /** @brief Wait for jobs and help run them, until the pool stops. */
+        void workerLoop();
+    };
+}
@@ -0,0 +1,46 @@
+/*****************************************************************//**
+@file   OpenGLBufferStorage.h
+@brief  Helpers allocating and updating OpenGL buffer storage according to a buffer usage policy.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include "rendering/bufferUsage.h"
+
+namespace Engine
+{
+    namespace OpenGLBufferStorage
+    {
+        /**
+        * @brief Allocate storage for a buffer created with glCreateBuffers.
+        * Immutable buffers get storage with no client access, filled directly from the initial data.
+        * @param bufferID The OpenGL ID of the buffer.
+        * @param size Size of the storage in bytes.
+        * @param data Pointer to the initial contents, may be null unless the usage is immutable.
+        * @param usage The update policy of the buffer.
+        */
+        void allocate(uint32_t bufferID, uint32_t size, const void* data, BufferUsage usage);
+
+        /**
+        * @brief Update part of a buffer's storage.
+        * @param bufferID The OpenGL ID of the buffer.
+        * @param bufferSize Size of the whole buffer in bytes.
+        * @param data Pointer to the new contents.
+        * @param size Size of the new contents in bytes.
+        * @param offset Offset at which to write the new contents in bytes.
+        * @param usage The update policy of the buffer.
+        * @return False if the policy forbids the update or it falls outside the buffer.
+        */
+        bool update(uint32_t bufferID, uint32_t bufferSize, const void* data, uint32_t size, uint32_t offset, BufferUsage usage);
+
+        /**
+        * @brief Convert a mutable buffer usage policy to an OpenGL usage hint.
+        * @param usage The update policy.
+        * @return The OpenGL usage hint.
+        */
+        uint32_t toGLUsage(BufferUsage usage);
+    }
+}
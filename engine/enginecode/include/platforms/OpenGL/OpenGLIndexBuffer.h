@@ -25,8 +25,16 @@ namespace Engine
 		* @brief Constructor, creates an OpenGL index buffer with provided indices data and count.
 		* @param indices Pointer to the array of indices.
 		* @param count Number of indices in the buffer.
+		* @param usage Update policy of the buffer, immutable buffers must be given their indices here.
 		*/
-		OpenGLIndexBuffer(uint32_t* indices, uint32_t count);
+		OpenGLIndexBuffer(uint32_t* indices, uint32_t count, BufferUsage usage = BufferUsage::Static);
+		/**
+		* @brief Constructor, creates an OpenGL index buffer of 16 bit indices, half the size of 32 bit ones.
+		* @param indices Pointer to the array of indices.
+		* @param count Number of indices in the buffer.
+		* @param usage Update policy of the buffer, immutable buffers must be given their indices here.
+		*/
+		OpenGLIndexBuffer(uint16_t* indices, uint32_t count, BufferUsage usage = BufferUsage::Static);
 		/**
 		* @brief Get the OpenGL render identifier of the buffer.
 		* Returns the OpenGL identifier associated with the buffer.
@@ -39,6 +47,32 @@ namespace Engine
 		* @return The count of elements in the buffer.
 		*/
 		inline uint32_t getCount() const { return m_count; }
+		/**
+		* @brief Get the width of the indices in the buffer.
+		* @return The index type.
+		*/
+		inline IndexType getType() const { return m_type; }
+		/**
+		* @brief Edit the index buffer's data.
+		* Logs an error and leaves the buffer unchanged if it is immutable.
+		* @param indices Pointer to the new indices.
+		* @param count Number of new indices.
+		* @param offset Index at which to write the new indices.
+		*/
+		void edit(uint32_t* indices, uint32_t count, uint32_t offset);
+		/**
+		* @brief Edit a 16 bit index buffer's data.
+		* Logs an error and leaves the buffer unchanged if it is immutable or holds 32 bit indices.
+		* @param indices Pointer to the new indices.
+		* @param count Number of new indices.
+		* @param offset Index at which to write the new indices.
+		*/
+		void edit(uint16_t* indices, uint32_t count, uint32_t offset);
+		/**
+		* @brief Get the update policy of the buffer.
+		* @return The buffer usage.
+		*/
+		inline BufferUsage getUsage() const { return m_usage; }
 		/** @brief Method to bind the index buffer for rendering.*/
 		void bind();
 		/** @brief  Method to unbind the currently bound index buffer.*/
@@ -46,5 +80,12 @@ namespace Engine
 	private:
 		uint32_t m_OpenGL_ID; /**< The OpenGL identifier of the index buffer. */
 		uint32_t m_count; /**< The number of indices in the index buffer. */
+		BufferUsage m_usage; /**< The update policy of the index buffer. */
+		IndexType m_type; /**< The width of the indices. */
+
+		/** @brief Create the buffer and allocate its storage. */
+		void allocateStorage(void* indices, uint32_t indexSize);
+		/** @brief Update a range of the buffer, checking the new indices match its width. */
+		void editRange(void* indices, uint32_t count, uint32_t offset, IndexType type);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+/*****************************************************************//**
+@file   OpenGLMesh.h
+@brief  This class loads a mesh file through a memory mapping and uploads its vertex and index blobs directly into immutable buffers.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "OpenGLVertexArray.h"
+#include "rendering/meshFile.h"
+
+namespace Engine
+{
+    /** @brief Class representing a mesh loaded from a mesh file. */
+    class OpenGLMesh
+    {
+    public:
+        /**
+        * @brief Constructor for OpenGLMesh.
+        * Source models are converted to a cached mesh file first, see MeshImporter::convert.
+        * The file is mapped rather than read, and its blobs are handed to the GL without being copied.
+        * Logs an error and leaves the mesh empty if the file cannot be loaded.
+        * @param filepath Path to a mesh file or a source model.
+        */
+        explicit OpenGLMesh(const char* filepath);
+
+        /**
+        * @brief Check if the mesh was loaded.
+        * @return True if the mesh has geometry to draw.
+        */
+        inline bool isLoaded() const { return m_vertexArray != nullptr; }
+
+        /**
+        * @brief Get the vertex array holding the mesh's full detail geometry.
+        * @return The vertex array, null if the mesh failed to load.
+        */
+        inline const std::shared_ptr<OpenGLVertexArray>& getVertexArray() const { return m_vertexArray; }
+
+        /**
+        * @brief Get the mesh's levels of detail.
+        * @return The levels, finest first, empty if the mesh failed to load.
+        */
+        inline const std::vector<MeshLod>& getLods() const { return m_lods; }
+
+        /**
+        * @brief Get the vertex array drawing one level of detail, which shares its vertex buffer with every other level.
+        * @param level The level, 0 for full detail.
+        * @return The vertex array.
+        */
+        inline const std::shared_ptr<OpenGLVertexArray>& getLodVertexArray(uint32_t level) const { return m_lodVertexArrays[level]; }
+
+        /**
+        * @brief Create a vertex array drawing one level of detail once per instance, sharing the mesh's vertex and index buffers.
+        * The instance buffer's attributes follow the mesh's, so an InstanceTransform buffer lands where the instanced shaders read it.
+        * @param instances Vertex buffer holding the per instance data, with a divisor of 1.
+        * @param level The level, 0 for full detail.
+        * @return The vertex array, null if the mesh failed to load.
+        */
+        std::shared_ptr<OpenGLVertexArray> createInstancedVertexArray(const std::shared_ptr<OpenGLVertexBuffer>& instances, uint32_t level = 0) const;
+
+        /**
+        * @brief Get the mesh's index ranges at every level of detail, each level's found through its MeshLod.
+        * The ranges index the whole file's indices, so drawn from a level's vertex array they start the level's firstIndex earlier.
+        * @return The submeshes, in index order.
+        */
+        inline const std::vector<Submesh>& getSubmeshes() const { return m_submeshes; }
+
+        /**
+        * @brief Get the bounds of the mesh.
+        * @return The axis aligned bounds of every vertex.
+        */
+        inline const MeshBounds& getBounds() const { return m_bounds; }
+
+    private:
+        std::shared_ptr<OpenGLVertexArray> m_vertexArray; /**< Vertex array drawing full detail. */
+        std::vector<std::shared_ptr<OpenGLVertexArray>> m_lodVertexArrays; /**< Vertex array drawing each level of detail. */
+        std::shared_ptr<OpenGLVertexBuffer> m_vertexBuffer; /**< Vertices shared by every level of detail. */
+        std::vector<std::shared_ptr<IndexBuffer>> m_lodIndexBuffers; /**< Indices of each level of detail. */
+        std::vector<MeshLod> m_lods; /**< Index range and error of each level of detail. */
+        std::vector<Submesh> m_submeshes; /**< Index ranges of the mesh. */
+        MeshBounds m_bounds; /**< Bounds of every vertex. */
+    };
+}
@@ -0,0 +1,114 @@
+/*****************************************************************//**
+@file   OpenGLMeshPool.h
+@brief  This class suballocates many meshes sharing a vertex format into one vertex and index buffer, and draws batches of them with single multi draw indirect calls.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "OpenGLVertexArray.h"
+#include "OpenGLStreamingBuffer.h"
+#include "rendering/indirectDraw.h"
+#include "rendering/instanceTransform.h"
+
+namespace Engine
+{
+    /** @brief Class representing a pool of meshes drawn with multi draw indirect. */
+    class OpenGLMeshPool
+    {
+    public:
+        /**
+        * @brief Constructor for OpenGLMeshPool.
+        * Each draw's InstanceTransform is appended to the vertex array with a divisor of 1, immediately after
+        * the attributes in the layout, and is selected through its command's base instance.
+        * Instance data and commands are written straight into a persistently mapped streaming buffer, one region per frame.
+        * @param layout The vertex layout shared by every mesh in the pool.
+        * @param maxVertices Capacity of the vertex buffer in vertices.
+        * @param maxIndices Capacity of the index buffer in indices.
+        * @param maxDraws Maximum number of draws per frame.
+        */
+        OpenGLMeshPool(const BufferLayout& layout, uint32_t maxVertices, uint32_t maxIndices, uint32_t maxDraws);
+
+        /**
+        * @brief Copy a mesh into the pool.
+        * @param vertices Pointer to the vertex data, in the pool's layout.
+        * @param vertexCount Number of vertices.
+        * @param indices Pointer to the indices, relative to the mesh's first vertex.
+        * @param indexCount Number of indices.
+        * @return A handle to the mesh, invalid if the pool is full.
+        */
+        MeshHandle addMesh(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+
+        /**
+        * @brief Copy the full detail level of a mesh file, or a source model converted to one, into the pool.
+        * Logs an error and returns an invalid handle if the file cannot be loaded or its vertices are not in the pool's layout.
+        * @param filepath Path to a mesh file or a source model.
+        * @return A handle to the mesh.
+        */
+        MeshHandle addMesh(const char* filepath);
+
+        /**
+        * @brief Record a draw of a mesh for the next flush.
+        * The first draw of a frame claims the frame's region of the streaming buffer.
+        * @param mesh The mesh to draw.
+        * @param model The model matrix of the draw.
+        * @param normalMatrix The inverse transpose of the model matrix's upper 3x3.
+        */
+        void submit(const MeshHandle& mesh, const glm::mat4& model, const glm::mat3& normalMatrix);
+
+        /**
+        * @brief Issue the draws recorded since the last flush with one glMultiDrawElementsIndirect call, using the bound program.
+        * Their commands are built into the frame's region after those of earlier flushes, consecutive draws of a mesh becoming one command.
+        * The program must read an InstanceTransform from the instance attributes.
+        */
+        void flush();
+
+        /** @brief Fence the frame's region once every flush reading it has been issued, so it is not rewritten too early. */
+        void endFrame();
+
+        /**
+        * @brief Get the vertex array holding the pool's geometry.
+        * @return The vertex array.
+        */
+        inline const std::shared_ptr<OpenGLVertexArray>& getVertexArray() const { return m_vertexArray; }
+
+        /**
+        * @brief Get the number of commands issued by the last flush.
+        * @return The command count.
+        */
+        inline uint32_t getLastCommandCount() const { return m_lastCommandCount; }
+
+        /**
+        * @brief Get the streaming buffer holding the per draw data.
+        * @return The streaming buffer.
+        */
+        inline const std::shared_ptr<OpenGLStreamingBuffer>& getStreamingBuffer() const { return m_streamingBuffer; }
+
+    private:
+        std::shared_ptr<OpenGLVertexArray> m_vertexArray; /**< Vertex array combining the pool's buffers. */
+        std::shared_ptr<OpenGLVertexBuffer> m_vertexBuffer; /**< Vertex storage shared by every mesh. */
+        std::shared_ptr<OpenGLIndexBuffer> m_indexBuffer; /**< Index storage shared by every mesh. */
+        std::shared_ptr<OpenGLStreamingBuffer> m_streamingBuffer; /**< Per frame instance data and draw commands. */
+
+        uint32_t m_vertexStride; /**< Size of one vertex in bytes. */
+        uint32_t m_maxVertices; /**< Capacity of the vertex buffer in vertices. */
+        uint32_t m_maxIndices; /**< Capacity of the index buffer in indices. */
+        uint32_t m_maxDraws; /**< Maximum number of draws per flush. */
+        uint32_t m_usedVertices = 0; /**< Number of vertices allocated. */
+        uint32_t m_usedIndices = 0; /**< Number of indices allocated. */
+        uint32_t m_lastCommandCount = 0; /**< Number of commands issued by the last flush. */
+        uint32_t m_flushedDraws = 0; /**< Number of this frame's draws already flushed. */
+        uint32_t m_commandCount = 0; /**< Number of this frame's commands already issued. */
+        uint32_t m_firstInstance = 0; /**< Instance index of this frame's first draw, counted from the start of the buffer. */
+        bool m_frameBegun = false; /**< True once this frame's region has been claimed, until endFrame. */
+        bool m_allocationFailureLogged = false; /**< True once a failed allocation has been reported, so it is not repeated every frame. */
+
+        std::vector<MeshHandle> m_meshes; /**< The mesh of each of this frame's draws, which the commands are built from. */
+        InstanceTransform* m_instances = nullptr; /**< This frame's instance data in mapped memory, one per draw. */
+        StreamAllocation m_commands; /**< This frame's draw commands. */
+    };
+}
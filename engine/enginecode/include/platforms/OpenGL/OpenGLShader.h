@@ -8,9 +8,79 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <type_traits>
 
 namespace Engine
 {
+    /**
+    * @enum UniformType
+    * @brief API independent description of the type of a reflected uniform.
+    */
+    enum class UniformType : uint8_t
+    {
+        Unknown = 0, ///< A type the shader class has no upload method for.
+        Int,         ///< Single integer.
+        Float,       ///< Single-precision floating point.
+        Float2,      ///< Two-component floating point.
+        Float3,      ///< Three-component floating point.
+        Float4,      ///< Four-component floating point.
+        Mat3,        ///< Three by three floating point matrix.
+        Mat4,        ///< Four by four floating point matrix.
+        Sampler      ///< Texture sampler, uploaded as an integer texture unit.
+    };
+
+    /**
+    * @struct UniformHandle
+    * @brief Typed handle to a uniform reflected from a linked program.
+    * A handle is only valid for the shader which issued it.
+    * @tparam T The C++ type uploaded through the handle.
+    */
+    template<typename T>
+    struct UniformHandle
+    {
+        int32_t index = -1; /**< Index of the uniform in the shader's uniform table. */
+
+        /**
+        * @brief Check if the handle refers to an active uniform.
+        * @return True if the handle can be uploaded to.
+        */
+        inline bool isValid() const { return index >= 0; }
+    };
+
+    /**
+    * @struct UniformUploadStats
+    * @brief Counters for uniform uploads issued to, or filtered from, the driver.
+    */
+    struct UniformUploadStats
+    {
+        uint32_t issued = 0; /**< Number of glUniform* calls issued. */
+        uint32_t skipped = 0; /**< Number of uploads skipped because the value was unchanged. */
+    };
+
+    /**
+    * @enum ShaderCompileMode
+    * @brief How a shader waits for the driver's compiler.
+    */
+    enum class ShaderCompileMode : uint8_t
+    {
+        Blocking = 0, ///< Compile and link before the constructor returns.
+        Parallel      ///< Submit every stage and the link, then poll until the driver finishes in the background.
+    };
+
+    /**
+    * @enum ShaderStatus
+    * @brief Whether a shader's program can be drawn with yet.
+    */
+    enum class ShaderStatus : uint8_t
+    {
+        Pending = 0, ///< Still compiling or linking.
+        Ready,       ///< Linked and reflected, usable for drawing.
+        Failed       ///< The source could not be read, compiled or linked.
+    };
+
     /** @brief Class representing an OpenGL shader. */
     class OpenGLShader
     {
@@ -28,11 +98,19 @@ namespace Engine
         /**
         * @brief Constructor for OpenGLShader.
         * Constructs an OpenGL shader by compiling and linking the shader
-        * from the provided file.
+        * from the provided file, split into stages by #region lines.
+        * #include lines are resolved and each feature is injected as a #define.
+        *
+        * @param filepath Path to the shader file.
+        * In parallel mode the constructor returns once the work is submitted, and the shader
+        * must be polled until it is ready. This needs KHR_parallel_shader_compile to overlap
+        * with rendering, without it the link completes on the first poll.
         *
         * @param filepath Path to the shader file.
+        * @param features Bitmask of ShaderFeatures values the variant is compiled with.
+        * @param mode Whether to wait for the compiler or poll it.
         */
-        OpenGLShader(const char* filepath);
+        OpenGLShader(const char* filepath, uint32_t features = 0, ShaderCompileMode mode = ShaderCompileMode::Blocking);
 
         /**
         * @brief Destructor for OpenGLShader.
@@ -46,6 +124,42 @@ namespace Engine
         */
         uint32_t getID() { return m_OpenGL_ID; }
 
+        /**
+        * @brief Poll the driver and finish the link once it has completed.
+        * Uniforms are only reflected, and the shader only usable, once this returns Ready.
+        * @return The shader's status.
+        */
+        ShaderStatus poll();
+
+        /**
+        * @brief Poll the shader and check if it can be drawn with.
+        * @return True if the program is linked.
+        */
+        inline bool isReady() { return poll() == ShaderStatus::Ready; }
+
+        /**
+        * @brief Check if the driver compiles in the background and reports completion without blocking.
+        * @return True if KHR_parallel_shader_compile is available.
+        */
+        static bool isParallelCompileSupported();
+
+        /**
+        * @brief Get a typed handle to an active uniform.
+        * Returns an invalid handle if the uniform is not active or its type does not match T.
+        *
+        * @param name Name of the uniform.
+        * @tparam T The C++ type which will be uploaded through the handle.
+        * @return A handle to the uniform.
+        */
+        template<typename T>
+        UniformHandle<T> getUniformHandle(const char* name)
+        {
+            UniformHandle<T> handle;
+            int32_t index = findUniform(name);
+            if (index >= 0 && typeMatches(m_uniforms[index].type, uniformTypeOf<T>())) handle.index = index;
+            return handle;
+        }
+
         // Methods for uploading shader uniforms
 
         void uploadInt(const char* name, int value);
@@ -53,19 +167,132 @@ namespace Engine
         void uploadFloat2(const char* name, const glm::vec2& value);
         void uploadFloat3(const char* name, const glm::vec3& value);
         void uploadFloat4(const char* name, const glm::vec4& value);
+        void uploadMat3(const char* name, const glm::mat3& value);
         void uploadMat4(const char* name, const glm::mat4& value);
 
+        // Methods for uploading shader uniforms through reflected handles
+
+        void upload(UniformHandle<int> handle, int value);
+        void upload(UniformHandle<float> handle, float value);
+        void upload(UniformHandle<glm::vec2> handle, const glm::vec2& value);
+        void upload(UniformHandle<glm::vec3> handle, const glm::vec3& value);
+        void upload(UniformHandle<glm::vec4> handle, const glm::vec4& value);
+        void upload(UniformHandle<glm::mat3> handle, const glm::mat3& value);
+        void upload(UniformHandle<glm::mat4> handle, const glm::mat4& value);
+
+        /**
+        * @brief Get the uniform upload counters accumulated since the last reset.
+        * @return The upload counters.
+        */
+        inline const UniformUploadStats& getUploadStats() const { return m_uploadStats; }
+
+        /** @brief Reset the uniform upload counters, typically once per frame. */
+        inline void resetUploadStats() { m_uploadStats = UniformUploadStats(); }
+
     private:
-        uint32_t m_OpenGL_ID; /**< The OpenGL shader ID. */
+        /**
+        * @struct UniformInfo
+        * @brief A uniform reflected from the linked program, with a CPU side copy of its last uploaded value.
+        */
+        struct UniformInfo
+        {
+            std::string name; /**< Name of the uniform, without any array suffix. */
+            int32_t location; /**< The OpenGL uniform location. */
+            UniformType type; /**< The type of the uniform. */
+            uint32_t shadowOffset; /**< Offset of the uniform's value in the shadow storage. */
+            uint32_t shadowSize; /**< Size of the uniform's value in bytes. */
+            bool initialised; /**< Whether a value has been uploaded yet. */
+        };
+
+        uint32_t m_OpenGL_ID = 0; /**< The OpenGL shader ID. */
+        ShaderStatus m_status = ShaderStatus::Failed; /**< Whether the program is linked, until compileAndLink runs it has failed. */
+        uint32_t m_pendingVertex = 0; /**< The vertex shader attached while the link is pending. */
+        uint32_t m_pendingFragment = 0; /**< The fragment shader attached while the link is pending. */
+        std::string m_cachePath; /**< Path the program binary is cached at, empty if binaries are unsupported. */
+        std::vector<UniformInfo> m_uniforms; /**< Table of active uniforms, reflected at link time. */
+        std::unordered_map<std::string, int32_t> m_uniformIndices; /**< Uniform name to index in the uniform table. */
+        std::vector<uint8_t> m_shadow; /**< Last uploaded value of every uniform. */
+        UniformUploadStats m_uploadStats; /**< Upload counters. */
 
         /**
         * @brief Compile and link the shader from source code.
         * This private method compiles and links the shader using the provided
-        * vertex and fragment shader source code.
+        * vertex and fragment shader source code. Where the driver supports program
+        * binaries, the linked program is cached and later runs load it instead.
+        * No status is queried until the link is finished, so the driver's compiler threads are not serialized.
         *
         * @param vertexShaderSrc Vertex shader source code.
         * @param fragmentShaderSrc Fragment shader source code.
+        * @param mode Whether to finish the link before returning.
+        */
+        void compileAndLink(const char* vertexShaderSrc, const char* fragmentShaderSrc, ShaderCompileMode mode);
+
+        /** @brief Check the compile and link results, release the stages and reflect the program's uniforms. */
+        void finishLink();
+
+        /** @brief Ask the driver for as many compiler threads as it will give, once per context. */
+        static void enableParallelCompile();
+
+        /**
+        * @brief Load a program binary from the shader cache.
+        * @param cachePath Path of the cache file.
+        * @return True if the binary was found and accepted by the driver.
+        */
+        bool loadBinary(const std::string& cachePath);
+
+        /**
+        * @brief Save the linked program's binary to the shader cache.
+        * @param cachePath Path of the cache file.
+        */
+        void saveBinary(const std::string& cachePath);
+
+        /** @brief Build the uniform table from the program's active uniforms. */
+        void reflectUniforms();
+
+        /**
+        * @brief Find a uniform in the uniform table.
+        * @param name Name of the uniform.
+        * @return Index of the uniform, or -1 if it is not active.
+        */
+        int32_t findUniform(const char* name) const;
+
+        /**
+        * @brief Compare a value against the uniform's shadow copy and store it if it differs.
+        * @param index Index of the uniform.
+        * @param value Pointer to the new value.
+        * @param size Size of the new value in bytes.
+        * @return True if the value changed and must be uploaded.
+        */
+        bool updateShadow(int32_t index, const void* value, uint32_t size);
+
+        /**
+        * @brief Get the uniform type matching a C++ type.
+        * @tparam T The C++ type.
+        * @return The matching uniform type.
+        */
+        template<typename T>
+        static constexpr UniformType uniformTypeOf()
+        {
+            if constexpr (std::is_same_v<T, int>) return UniformType::Int;
+            else if constexpr (std::is_same_v<T, float>) return UniformType::Float;
+            else if constexpr (std::is_same_v<T, glm::vec2>) return UniformType::Float2;
+            else if constexpr (std::is_same_v<T, glm::vec3>) return UniformType::Float3;
+            else if constexpr (std::is_same_v<T, glm::vec4>) return UniformType::Float4;
+            else if constexpr (std::is_same_v<T, glm::mat3>) return UniformType::Mat3;
+            else if constexpr (std::is_same_v<T, glm::mat4>) return UniformType::Mat4;
+            else return UniformType::Unknown;
+        }
+
+        /**
+        * @brief Check if a value of one type may be uploaded to a uniform of another.
+        * @param uniformType The type of the uniform.
+        * @param valueType The type of the value.
+        * @return True if the upload is valid.
         */
-        void compileAndLink(const char* vertexShaderSrc, const char* fragmentShaderSrc);
+        static inline bool typeMatches(UniformType uniformType, UniformType valueType)
+        {
+            if (uniformType == valueType) return true;
+            return uniformType == UniformType::Sampler && valueType == UniformType::Int;
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+/*****************************************************************//**
+@file   OpenGLShaderRegistry.h
+@brief  This class compiles shader variants on first request and shares them, keyed by source file and feature bitmask.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "platforms/OpenGL/OpenGLShader.h"
+#include "rendering/shaderPreprocessor.h"
+
+namespace Engine
+{
+    /** @brief Class which deduplicates shader variants, so each combination of file and features is compiled once. */
+    class OpenGLShaderRegistry
+    {
+    public:
+        /**
+        * @brief Get a variant, compiling it if it has not been requested before.
+        * @param filepath Path to the single file shader.
+        * @param features Bitmask of ShaderFeatures values.
+        * @param mode Whether a newly requested variant blocks until linked or compiles in parallel.
+        * @return The shared variant, which may still be pending if compiled in parallel.
+        */
+        std::shared_ptr<OpenGLShader> get(const std::string& filepath, uint32_t features = ShaderFeatures::None, ShaderCompileMode mode = ShaderCompileMode::Blocking);
+
+        /**
+        * @brief Poll every variant, finishing those the driver has completed.
+        * Called once per frame while shaders warm up, so a loading screen can keep rendering.
+        * @return The number of variants still pending.
+        */
+        uint32_t pollPending();
+
+        /**
+        * @brief Get the number of variants compiled.
+        * @return The number of variants.
+        */
+        uint32_t getVariantCount() const;
+
+        /** @brief Release every variant not held outside the registry. */
+        void releaseUnused();
+
+    private:
+        /** @brief Variants of one file, keyed by feature bitmask. */
+        using Variants = std::unordered_map<uint32_t, std::shared_ptr<OpenGLShader>>;
+
+        std::unordered_map<std::string, Variants> m_files; /**< Variants compiled from each file. */
+    };
+}
@@ -0,0 +1,178 @@
+/*****************************************************************//**
+@file   OpenGLStateCache.h
+@brief  This class shadows the OpenGL binding and capability state so redundant state changes are never sent to the driver.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <unordered_map>
+
+namespace Engine
+{
+    /**
+    * @struct StateCacheStats
+    * @brief Counts of state changes sent to the driver and filtered by the cache.
+    */
+    struct StateCacheStats
+    {
+        uint32_t issued = 0; /**< State changes passed on to OpenGL. */
+        uint32_t filtered = 0; /**< State changes skipped because they changed nothing. */
+    };
+
+    /**
+    * @class OpenGLStateCache
+    * @brief Tracks the current program, vertex array, buffer bindings, texture units, capabilities, depth writes, blend factors and pixel unpack alignment.
+    * Every OpenGL platform class routes its state changes through here. Values start unknown, so the
+    * first change to any state is always issued.
+    */
+    class OpenGLStateCache
+    {
+    public:
+        /**
+        * @brief Make a program current.
+        * @param program The OpenGL program ID.
+        */
+        static void useProgram(uint32_t program);
+
+        /**
+        * @brief Bind a vertex array, which also replaces the element array buffer binding.
+        * @param vertexArray The OpenGL vertex array ID.
+        */
+        static void bindVertexArray(uint32_t vertexArray);
+
+        /**
+        * @brief Bind a buffer to a target.
+        * @param target The buffer target, e.g. GL_ARRAY_BUFFER.
+        * @param buffer The OpenGL buffer ID.
+        */
+        static void bindBuffer(uint32_t target, uint32_t buffer);
+
+        /**
+        * @brief Bind a range of a buffer to an indexed binding point, which also binds it to the generic target.
+        * @param target The indexed target, GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER.
+        * @param index The binding point.
+        * @param buffer The OpenGL buffer ID.
+        * @param offset Offset of the range in bytes.
+        * @param size Size of the range in bytes.
+        */
+        static void bindBufferRange(uint32_t target, uint32_t index, uint32_t buffer, uint32_t offset, uint32_t size);
+
+        /**
+        * @brief Bind a texture to a texture unit.
+        * @param unit The texture unit.
+        * @param texture The OpenGL texture ID.
+        */
+        static void bindTexture(uint32_t unit, uint32_t texture);
+
+        /**
+        * @brief Enable a capability such as GL_DEPTH_TEST.
+        * @param capability The capability.
+        */
+        static void enable(uint32_t capability);
+
+        /**
+        * @brief Disable a capability such as GL_BLEND.
+        * @param capability The capability.
+        */
+        static void disable(uint32_t capability);
+
+        /**
+        * @brief Set the row alignment of pixel data read from client memory or a pixel unpack buffer.
+        * @param alignment The alignment in bytes, 1, 2, 4 or 8.
+        */
+        static void setUnpackAlignment(uint32_t alignment);
+
+        /**
+        * @brief Set whether draws write to the depth buffer.
+        * @param write True to write depth.
+        */
+        static void depthMask(bool write);
+
+        /**
+        * @brief Set the factors blended colours are combined with, for every draw buffer.
+        * @param source Factor of the incoming colour, e.g. GL_SRC_ALPHA.
+        * @param destination Factor of the colour already in the buffer, e.g. GL_ONE_MINUS_SRC_ALPHA.
+        */
+        static void blendFunc(uint32_t source, uint32_t destination);
+
+        /** @brief Forget a program which is being deleted. @param program The OpenGL program ID. */
+        static void onDeleteProgram(uint32_t program);
+        /** @brief Forget a vertex array which is being deleted. @param vertexArray The OpenGL vertex array ID. */
+        static void onDeleteVertexArray(uint32_t vertexArray);
+        /** @brief Forget a buffer which is being deleted. @param buffer The OpenGL buffer ID. */
+        static void onDeleteBuffer(uint32_t buffer);
+        /** @brief Forget a texture which is being deleted. @param texture The OpenGL texture ID. */
+        static void onDeleteTexture(uint32_t texture);
+
+        /**
+        * @brief Mark every cached value unknown, for use after code which changes state behind the cache.
+        */
+        static void invalidate();
+
+        /**
+        * @brief Close the current frame's counters and start new ones.
+        */
+        static void beginFrame();
+
+        /**
+        * @brief Get the counters of the last completed frame.
+        * @return The state change counts.
+        */
+        inline static const StateCacheStats& getLastFrameStats() { return s_lastFrameStats; }
+
+        /**
+        * @brief Get the counters of the frame in progress.
+        * @return The state change counts.
+        */
+        inline static const StateCacheStats& getStats() { return s_stats; }
+
+    private:
+        /** @brief Generic buffer targets tracked by the cache. */
+        enum BufferSlot { Array = 0, ElementArray, Uniform, ShaderStorage, DrawIndirect, PixelUnpack, CopyRead, CopyWrite, BufferSlotCount };
+
+        /** @brief An indexed buffer binding. */
+        struct BufferRange
+        {
+            uint32_t buffer; /**< The bound buffer. */
+            uint32_t offset; /**< Offset of the range in bytes. */
+            uint32_t size; /**< Size of the range in bytes. */
+        };
+
+        static const uint32_t s_unknown = 0xFFFFFFFF; /**< Marks a value the cache has not seen set. */
+        static const uint32_t s_maxTextureUnits = 32; /**< Number of texture units tracked. */
+        static const uint32_t s_maxIndexedBindings = 16; /**< Number of indexed bindings tracked per target. */
+
+        /**
+        * @brief Find the cache slot of a generic buffer target.
+        * @param target The buffer target.
+        * @return The slot, or BufferSlotCount if the target is not tracked.
+        */
+        static uint32_t slotOf(uint32_t target);
+
+        /**
+        * @brief Compare a cached value with a new one and update it.
+        * @param cached The cached value.
+        * @param value The requested value.
+        * @return True if the call must be issued.
+        */
+        static bool change(uint32_t& cached, uint32_t value);
+
+        static uint32_t s_program; /**< The current program. */
+        static uint32_t s_vertexArray; /**< The bound vertex array. */
+        static std::array<uint32_t, BufferSlotCount> s_buffers; /**< Buffer bound to each generic target. */
+        static std::array<BufferRange, s_maxIndexedBindings> s_uniformRanges; /**< Indexed uniform buffer bindings. */
+        static std::array<BufferRange, s_maxIndexedBindings> s_storageRanges; /**< Indexed shader storage buffer bindings. */
+        static std::array<uint32_t, s_maxTextureUnits> s_textures; /**< Texture bound to each unit. */
+        static std::unordered_map<uint32_t, bool> s_capabilities; /**< Known enabled state of each capability. */
+        static uint32_t s_unpackAlignment; /**< The pixel unpack row alignment. */
+        static uint32_t s_depthMask; /**< Whether depth writes are enabled, 1 or 0. */
+        static uint32_t s_blendSource; /**< The source blend factor. */
+        static uint32_t s_blendDestination; /**< The destination blend factor. */
+        static StateCacheStats s_stats; /**< Counters of the frame in progress. */
+        static StateCacheStats s_lastFrameStats; /**< Counters of the last completed frame. */
+    };
+}
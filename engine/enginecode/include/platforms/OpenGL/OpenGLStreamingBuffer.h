@@ -0,0 +1,118 @@
+/*****************************************************************//**
+@file   OpenGLStreamingBuffer.h
+@brief  This class provides a persistently mapped ring buffer, split into fenced frame regions, for data rewritten every frame.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Engine
+{
+    /**
+    * @struct StreamAllocation
+    * @brief A block of a streaming buffer which can be written by the CPU this frame.
+    */
+    struct StreamAllocation
+    {
+        void* data = nullptr; /**< Mapped pointer to the start of the block. */
+        uint32_t offset = 0; /**< Offset of the block from the start of the buffer in bytes. */
+        uint32_t size = 0; /**< Size of the block in bytes. */
+
+        /**
+        * @brief Check if the allocation succeeded.
+        * @return True if the block can be written.
+        */
+        inline bool isValid() const { return data != nullptr; }
+    };
+
+    /** @brief Class representing a persistently mapped OpenGL streaming buffer. */
+    class OpenGLStreamingBuffer
+    {
+    public:
+        /**
+        * @brief Constructor for OpenGLStreamingBuffer.
+        * Allocates immutable storage for every region and maps it once for the lifetime of the buffer.
+        * @param regionSize Size of each frame region in bytes.
+        * @param regionCount Number of frame regions, i.e. how many frames the CPU may run ahead of the GPU.
+        */
+        OpenGLStreamingBuffer(uint32_t regionSize, uint32_t regionCount = 3);
+
+        /**
+        * @brief Destructor for OpenGLStreamingBuffer.
+        * Unmaps the buffer and cleans up the buffer and its fences.
+        */
+        ~OpenGLStreamingBuffer();
+
+        /**
+        * @brief Move to the next frame region, waiting only if the GPU is still reading it.
+        */
+        void beginFrame();
+
+        /**
+        * @brief Allocate a block from the current frame region.
+        * @param size Size of the block in bytes.
+        * @param alignment Alignment of the block's offset, which must be a power of two.
+        * @return The allocation, invalid if the region is full.
+        */
+        StreamAllocation allocate(uint32_t size, uint32_t alignment = 16);
+
+        /**
+        * @brief Fence the current frame region once every command reading it has been issued.
+        */
+        void endFrame();
+
+        /**
+        * @brief Bind a block to an indexed binding point, such as a uniform block binding.
+        * @param target The indexed buffer target, e.g. GL_UNIFORM_BUFFER.
+        * @param index The binding point.
+        * @param allocation The block to bind.
+        */
+        void bindRange(uint32_t target, uint32_t index, const StreamAllocation& allocation);
+
+        /**
+        * @brief Get the render ID of the streaming buffer.
+        * @return The OpenGL render ID.
+        */
+        inline uint32_t getRenderID() const { return m_OpenGL_ID; }
+
+        /**
+        * @brief Get the size of each frame region.
+        * @return The region size in bytes.
+        */
+        inline uint32_t getRegionSize() const { return m_regionSize; }
+
+        /**
+        * @brief Get the offset alignment required for uniform block bindings.
+        * @return The alignment in bytes.
+        */
+        inline uint32_t getUniformAlignment() const { return m_uniformAlignment; }
+
+        /**
+        * @brief Get the offset alignment required for shader storage block bindings.
+        * @return The alignment in bytes.
+        */
+        inline uint32_t getStorageAlignment() const { return m_storageAlignment; }
+
+        /**
+        * @brief Get the number of times beginFrame had to block on the GPU.
+        * @return The stall count.
+        */
+        inline uint32_t getStallCount() const { return m_stallCount; }
+
+    private:
+        uint32_t m_OpenGL_ID; /**< The OpenGL buffer ID. */
+        uint8_t* m_mapped = nullptr; /**< Persistent mapping of the whole buffer. */
+        uint32_t m_regionSize; /**< Size of each frame region in bytes. */
+        uint32_t m_regionCount; /**< Number of frame regions. */
+        uint32_t m_region = 0; /**< Index of the current region. */
+        uint32_t m_regionHead = 0; /**< Bytes allocated from the current region. */
+        uint32_t m_uniformAlignment = 256; /**< GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT. */
+        uint32_t m_storageAlignment = 256; /**< GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT. */
+        uint32_t m_stallCount = 0; /**< Number of times the CPU waited on the GPU. */
+        std::vector<void*> m_fences; /**< Fence for each region, null if the region is free. */
+    };
+}
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <cstdint>
+#include "rendering/textureCompression.h"
 
 namespace Engine
 {
@@ -18,7 +19,10 @@ namespace Engine
         /**
         * @brief Constructor for OpenGLTexture from file.
         * Constructs an OpenGL texture by loading the texture data from the provided
-        * image file.
+        * image file. Where BC compression is supported the image is transcoded with a
+        * full mip chain on first load and cached as a DDS file, later loads upload the
+        * cached blocks directly. The load blocks, use OpenGLTextureStreamer to load
+        * without stalling frames.
         *
         * @param filepath Path to the image file.
         */
@@ -36,6 +40,14 @@ namespace Engine
         */
         OpenGLTexture(uint32_t width, uint32_t height, uint32_t channels, unsigned char* data);
 
+        /**
+        * @brief Constructor for OpenGLTexture from prepared texture data.
+        * Uploads every mip level as given, block compressed levels are uploaded without decoding.
+        *
+        * @param data The texture's format and mip chain.
+        */
+        OpenGLTexture(const TextureData& data);
+
         /**
         * @brief Destructor for OpenGLTexture.
         * Cleans up resources associated with the OpenGL texture.
@@ -45,6 +57,7 @@ namespace Engine
         /**
         * @brief Edit a portion of the texture.
         * Edits a rectangular region of the texture with new pixel data.
+        * Compressed textures cannot be edited.
         *
         * @param xOffset X-coordinate of the starting point.
         * @param yOffset Y-coordinate of the starting point.
@@ -78,11 +91,81 @@ namespace Engine
         */
         inline uint32_t getChannels() { return m_channels; }
 
+        /**
+        * @brief Get the format the texture is stored in.
+        * @return The texture format.
+        */
+        inline TextureFormat getFormat() { return m_format; }
+
+        /**
+        * @brief Check if the OpenGL context can sample BC1 and BC3 textures.
+        * @return True if S3TC formats are supported.
+        */
+        static bool isCompressionSupported();
+
+        /**
+        * @brief Check if the OpenGL context supports ARB_bindless_texture.
+        * @return True if textures can be sampled through handles.
+        */
+        static bool isBindlessSupported();
+
+        /**
+        * @brief Get a resident bindless handle for the texture, creating it on first use.
+        * The texture's sampling parameters cannot change once a handle exists.
+        *
+        * @return The handle, or 0 if bindless textures are unsupported or the texture is not yet resident.
+        */
+        uint64_t getBindlessHandle();
+
+        /**
+        * @brief Check if the texture's own data is on the GPU.
+        * @return False while a streamed texture is still showing its placeholder.
+        */
+        inline bool isResident() const { return m_ownsID; }
+
+        /**
+        * @brief Load an image file into a complete mip chain ready for upload, making no OpenGL calls.
+        * Safe to call from worker threads.
+        *
+        * @param filepath Path to the image file.
+        * @param compress Transcode to BC1/BC3, reading and writing the DDS cache.
+        * @param data The loaded texture data.
+        * @return True if the image was loaded.
+        */
+        static bool loadData(const char* filepath, bool compress, TextureData& data);
+
+        /**
+        * @brief Load an image file transcoded to a chosen block format, reading and writing that format's DDS cache.
+        * Safe to call from worker threads.
+        *
+        * @param filepath Path to the image file.
+        * @param format BC1 or BC3, used whatever the image's channel count.
+        * @param data The loaded texture data.
+        * @return True if the image was loaded.
+        */
+        static bool loadData(const char* filepath, TextureFormat format, TextureData& data);
+
     private:
-        uint32_t m_OpenGL_ID; /**< The OpenGL texture ID. */
-        uint32_t m_width; /**< The width of the texture. */
-        uint32_t m_height; /**< The height of the texture. */
-        uint32_t m_channels; /**< The number of color channels. */
+        uint32_t m_OpenGL_ID = 0; /**< The OpenGL texture ID. */
+        uint32_t m_width = 0; /**< The width of the texture. */
+        uint32_t m_height = 0; /**< The height of the texture. */
+        uint32_t m_channels = 0; /**< The number of color channels. */
+        TextureFormat m_format = TextureFormat::RGBA8; /**< The format the texture is stored in. */
+        bool m_ownsID = true; /**< False while the texture reports a placeholder's ID. */
+        uint64_t m_bindlessHandle = 0; /**< Resident bindless handle, 0 until requested. */
+
+        friend class OpenGLTextureStreamer;
+        friend class OpenGLTextureArray;
+
+        /** @brief Default constructor for streamed textures, which are given a placeholder until uploaded. */
+        OpenGLTexture() = default;
+
+        /**
+        * @brief Report a placeholder's ID and size, without taking ownership, until the texture is resident.
+        *
+        * @param placeholder The texture to show.
+        */
+        void usePlaceholder(const OpenGLTexture& placeholder);
 
         /**
         * @brief Initialize the texture with raw data.
@@ -94,5 +177,62 @@ namespace Engine
         * @param data Raw pixel data.
         */
         void init(uint32_t width, uint32_t height, uint32_t channels, unsigned char* data);
+
+        /**
+        * @brief Initialize the texture with a prepared mip chain.
+        *
+        * @param data The texture's format and mip chain.
+        */
+        void init(const TextureData& data);
+
+        /**
+        * @brief Create a texture with immutable storage for every level of a mip chain.
+        *
+        * @param data The texture's format and mip chain.
+        * @return The OpenGL texture ID.
+        */
+        static uint32_t createStorage(const TextureData& data);
+
+        /**
+        * @brief Upload one mip level.
+        *
+        * @param textureID The OpenGL texture ID.
+        * @param format Format of the level.
+        * @param level Index of the level.
+        * @param mip Size of the level.
+        * @param pixels Level data in client memory, or an offset into the bound pixel unpack buffer.
+        */
+        static void uploadLevel(uint32_t textureID, TextureFormat format, uint32_t level, const TextureMip& mip, const void* pixels);
+
+        /**
+        * @brief Take ownership of a fully uploaded texture, replacing any placeholder.
+        *
+        * @param textureID The OpenGL texture ID.
+        * @param data The texture's format and mip chain.
+        */
+        void makeResident(uint32_t textureID, const TextureData& data);
+
+        /**
+        * @brief Convert a texture format to an OpenGL sized internal format.
+        *
+        * @param format The texture format.
+        * @return The OpenGL internal format.
+        */
+        static uint32_t toGLInternalFormat(TextureFormat format);
+
+        /**
+        * @brief Create a bindless handle for a texture and make it resident.
+        *
+        * @param textureID The OpenGL texture ID.
+        * @return The handle, or 0 if bindless textures are unsupported.
+        */
+        static uint64_t createBindlessHandle(uint32_t textureID);
+
+        /**
+        * @brief Make a bindless handle non-resident before its texture is deleted.
+        *
+        * @param handle The handle, ignored if 0.
+        */
+        static void releaseBindlessHandle(uint64_t handle);
     };
 }
\ No newline at end of file
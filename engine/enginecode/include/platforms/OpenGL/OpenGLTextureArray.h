@@ -0,0 +1,97 @@
+/*****************************************************************//**
+@file   OpenGLTextureArray.h
+@brief  This class provides a GL_TEXTURE_2D_ARRAY whose layers hold same sized images, so draws using different images can share one binding.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include "rendering/textureCompression.h"
+
+namespace Engine
+{
+    /** @brief Class representing an OpenGL 2D texture array. */
+    class OpenGLTextureArray
+    {
+    public:
+        /**
+        * @brief Constructor for OpenGLTextureArray.
+        * Allocates immutable storage for every layer with a full mip chain.
+        *
+        * @param width Width of every layer.
+        * @param height Height of every layer.
+        * @param layerCount Number of layers which can be added.
+        * @param format Format every layer is stored in.
+        */
+        OpenGLTextureArray(uint32_t width, uint32_t height, uint32_t layerCount, TextureFormat format);
+
+        /**
+        * @brief Destructor for OpenGLTextureArray.
+        * Cleans up resources associated with the OpenGL texture.
+        */
+        ~OpenGLTextureArray();
+
+        /**
+        * @brief Upload an image to the next free layer.
+        *
+        * @param data The image's mip chain, which must match the array's size and format.
+        * @return The layer index, or -1 if the array is full or the data does not match.
+        */
+        int32_t addLayer(const TextureData& data);
+
+        /**
+        * @brief Load an image file into the next free layer, transcoding it to the array's format.
+        *
+        * @param filepath Path to the image file.
+        * @return The layer index, or -1 if the image could not be added.
+        */
+        int32_t addLayer(const char* filepath);
+
+        /**
+        * @brief Get the OpenGL ID of the texture array.
+        * @return The OpenGL texture ID.
+        */
+        inline uint32_t getID() const { return m_OpenGL_ID; }
+
+        /**
+        * @brief Get the width of every layer.
+        * @return The width of the layers.
+        */
+        inline uint32_t getWidth() const { return m_width; }
+
+        /**
+        * @brief Get the height of every layer.
+        * @return The height of the layers.
+        */
+        inline uint32_t getHeight() const { return m_height; }
+
+        /**
+        * @brief Get the number of layers added so far.
+        * @return The number of layers in use.
+        */
+        inline uint32_t getLayerCount() const { return m_layerCount; }
+
+        /**
+        * @brief Get the number of layers the array was created with.
+        * @return The layer capacity.
+        */
+        inline uint32_t getLayerCapacity() const { return m_layerCapacity; }
+
+        /**
+        * @brief Get the format the layers are stored in.
+        * @return The texture format.
+        */
+        inline TextureFormat getFormat() const { return m_format; }
+
+    private:
+        uint32_t m_OpenGL_ID = 0; /**< The OpenGL texture ID. */
+        uint32_t m_width; /**< The width of every layer. */
+        uint32_t m_height; /**< The height of every layer. */
+        uint32_t m_levels = 1; /**< The number of mip levels in every layer. */
+        uint32_t m_layerCount = 0; /**< The number of layers added. */
+        uint32_t m_layerCapacity; /**< The number of layers allocated. */
+        TextureFormat m_format; /**< The format the layers are stored in. */
+    };
+}
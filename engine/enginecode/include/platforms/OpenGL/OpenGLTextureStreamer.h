@@ -0,0 +1,108 @@
+/*****************************************************************//**
+@file   OpenGLTextureStreamer.h
+@brief  This class loads textures without blocking frames, decoding on worker threads and uploading through a pixel buffer within a per-frame byte budget.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "platforms/OpenGL/OpenGLTexture.h"
+#include "platforms/OpenGL/OpenGLStreamingBuffer.h"
+
+namespace Engine
+{
+    /** @brief Class which streams OpenGL textures in the background, showing a placeholder until each is resident. */
+    class OpenGLTextureStreamer
+    {
+    public:
+        /**
+        * @brief Constructor for OpenGLTextureStreamer.
+        * Must be called on the render thread, it creates the placeholder texture and the staging pixel buffer.
+        * @param uploadBudget Maximum bytes uploaded to textures each frame.
+        * @param workerCount Number of threads decoding images.
+        */
+        OpenGLTextureStreamer(uint32_t uploadBudget = 4 * 1024 * 1024, uint32_t workerCount = 2);
+
+        /**
+        * @brief Destructor for OpenGLTextureStreamer.
+        * Joins the workers and deletes any partially uploaded textures. Textures still
+        * showing the placeholder must not be sampled after the streamer is destroyed.
+        */
+        ~OpenGLTextureStreamer();
+
+        /**
+        * @brief Queue an image file to be loaded.
+        * @param filepath Path to the image file.
+        * @return The texture, which shows the placeholder until its data is resident.
+        */
+        std::shared_ptr<OpenGLTexture> load(const char* filepath);
+
+        /**
+        * @brief Upload decoded textures, stopping once the frame's budget is spent. Call once per frame on the render thread.
+        */
+        void update();
+
+        /**
+        * @brief Get the number of textures queued or being uploaded.
+        * @return The number of textures not yet resident.
+        */
+        inline uint32_t getPendingCount() const { return m_pendingCount; }
+
+        /**
+        * @brief Get the bytes uploaded by the last call to update.
+        * @return The uploaded size in bytes.
+        */
+        inline uint32_t getLastFrameBytes() const { return m_lastFrameBytes; }
+
+        /**
+        * @brief Get the maximum bytes uploaded each frame.
+        * @return The upload budget in bytes.
+        */
+        inline uint32_t getUploadBudget() const { return m_staging->getRegionSize(); }
+
+    private:
+        /** @brief An image file waiting for a worker. */
+        struct LoadRequest
+        {
+            std::string filepath; /**< Path to the image file. */
+            std::weak_ptr<OpenGLTexture> texture; /**< The texture to fill, skipped if it has been released. */
+        };
+
+        /** @brief A decoded image being uploaded a level at a time. */
+        struct PendingUpload
+        {
+            std::weak_ptr<OpenGLTexture> texture; /**< The texture to fill, skipped if it has been released. */
+            TextureData data; /**< The decoded mip chain. */
+            uint32_t textureID = 0; /**< Storage being uploaded to, 0 until the first level is uploaded. */
+            uint32_t nextLevel = 0; /**< Index of the next level to upload. */
+        };
+
+        /** @brief Decode queued images until the streamer is destroyed. */
+        void workerLoop();
+
+        std::unique_ptr<OpenGLTexture> m_placeholder; /**< Texture shown until a streamed texture is resident. */
+        std::unique_ptr<OpenGLStreamingBuffer> m_staging; /**< Fenced pixel unpack buffer, one region per frame. */
+        bool m_compress; /**< Whether workers transcode to BC1/BC3, queried once on the render thread. */
+
+        std::vector<std::thread> m_workers; /**< Threads decoding images. */
+        std::mutex m_mutex; /**< Guards the request and decoded queues. */
+        std::condition_variable m_condition; /**< Wakes workers when requests are queued or the streamer stops. */
+        std::deque<LoadRequest> m_requests; /**< Images waiting for a worker. */
+        std::deque<PendingUpload> m_decoded; /**< Images decoded by workers, waiting for the render thread. */
+        bool m_stopping = false; /**< Tells workers to exit. */
+
+        std::deque<PendingUpload> m_uploads; /**< Images being uploaded, only touched by the render thread. */
+        std::atomic<uint32_t> m_pendingCount{ 0 }; /**< Textures not yet resident or dropped. */
+        uint32_t m_lastFrameBytes = 0; /**< Bytes uploaded by the last update. */
+    };
+}
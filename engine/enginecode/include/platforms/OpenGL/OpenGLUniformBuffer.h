@@ -0,0 +1,76 @@
+/*****************************************************************//**
+@file   OpenGLUniformBuffer.h
+@brief  This class provides functionality for creating and managing OpenGL uniform buffers bound to fixed binding points.
+
+@author Joseph-Cossins-Smith
+@date   July 2023
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include "rendering/std140Layout.h"
+
+namespace Engine
+{
+    /** @brief Class representing an OpenGL uniform buffer. */
+    class OpenGLUniformBuffer
+    {
+    public:
+        /**
+        * @brief Destructor for OpenGLUniformBuffer.
+        * Cleans up resources associated with the OpenGL uniform buffer.
+        */
+        ~OpenGLUniformBuffer();
+
+        /**
+        * @brief Constructor for OpenGLUniformBuffer.
+        * Allocates the buffer and binds it to its binding point.
+        * @param size Size of the buffer in bytes.
+        * @param bindingPoint The uniform block binding point the buffer is attached to.
+        */
+        OpenGLUniformBuffer(uint32_t size, uint32_t bindingPoint);
+
+        /**
+        * @brief Upload data into the buffer.
+        * @param data Pointer to the new data.
+        * @param size Size of the new data in bytes.
+        * @param offset Offset at which to write the new data.
+        */
+        void uploadData(const void* data, uint32_t size, uint32_t offset = 0);
+
+        /**
+        * @brief Upload the whole memory image of a std140 block.
+        * @param block The block writer holding the data.
+        */
+        template<typename Layout>
+        void upload(const Std140Writer<Layout>& block) { uploadData(block.data(), block.size()); }
+
+        /**
+        * @brief Get the render ID of the uniform buffer.
+        * @return The OpenGL render ID.
+        */
+        inline uint32_t getRenderID() const { return m_OpenGL_ID; }
+
+        /**
+        * @brief Get the binding point of the uniform buffer.
+        * @return The uniform block binding point.
+        */
+        inline uint32_t getBindingPoint() const { return m_bindingPoint; }
+
+        /**
+        * @brief Get the size of the uniform buffer.
+        * @return The size in bytes.
+        */
+        inline uint32_t getSize() const { return m_size; }
+
+        /**
+        * @brief Bind the uniform buffer to its binding point.
+        */
+        void bind();
+
+    private:
+        uint32_t m_OpenGL_ID; /**< The OpenGL uniform buffer ID. */
+        uint32_t m_size; /**< The size of the buffer in bytes. */
+        uint32_t m_bindingPoint; /**< The uniform block binding point. */
+    };
+}
@@ -35,6 +35,22 @@ namespace Engine
         */
         void addVertexBuffer(const std::shared_ptr<OpenGLVertexBuffer>& vertexBuffer);
 
+        /**
+        * @brief Add attributes sourced from a buffer not owned by the vertex array, such as a streaming buffer.
+        * The caller must keep the buffer alive for as long as the vertex array is used.
+        * @param bufferID The OpenGL ID of the buffer.
+        * @param layout Buffer layout specifying the attributes.
+        */
+        void addVertexBuffer(uint32_t bufferID, const BufferLayout& layout);
+
+        /**
+        * @brief Add attributes sourced from a buffer not owned by the vertex array, described by a view such as a VertexLayout's static table.
+        * The caller must keep the buffer and the viewed elements alive for as long as the vertex array is used.
+        * @param bufferID The OpenGL ID of the buffer.
+        * @param layout View of the elements specifying the attributes.
+        */
+        void addVertexBuffer(uint32_t bufferID, const BufferLayoutView& layout);
+
         /**
         * @brief Set the index buffer for the vertex array.
         * @param indexBuffer Shared pointer to the index buffer.
@@ -53,6 +69,12 @@ namespace Engine
         */
         inline uint32_t getDrawCount() { return (m_indexBuffer) ? m_indexBuffer->getCount() : 0; }
 
+        /**
+        * @brief Get the width of the indices drawn.
+        * @return The index type of the index buffer, 32 bit if there is none.
+        */
+        inline IndexType getIndexType() { return (m_indexBuffer) ? m_indexBuffer->getType() : IndexType::UInt32; }
+
         /**
         * @brief Bind the vertex array.
         */
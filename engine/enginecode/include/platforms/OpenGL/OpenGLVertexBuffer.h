@@ -8,6 +8,7 @@
 #pragma once
 
 #include "rendering/bufferLayout.h"
+#include "rendering/bufferUsage.h"
 
 namespace Engine
 {
@@ -26,11 +27,26 @@ namespace Engine
         * @param vertices Pointer to the vertex data.
         * @param size Size of the vertex data in bytes.
         * @param layout Buffer layout specifying vertex attributes.
+        * @param usage Update policy of the buffer, immutable buffers must be given their data here.
         */
-        OpenGLVertexBuffer(void* vertices, uint32_t size, BufferLayout layout);
+        OpenGLVertexBuffer(void* vertices, uint32_t size, BufferLayout layout, BufferUsage usage = BufferUsage::Static);
+
+        /**
+        * @brief Constructor for OpenGLVertexBuffer, described by a static layout such as VertexLayout::view().
+        * @param vertices Pointer to the vertex data.
+        * @param size Size of the vertex data in bytes.
+        * @param layout View of the elements specifying vertex attributes, which must outlive the buffer.
+        * @param usage Update policy of the buffer, immutable buffers must be given their data here.
+        */
+        OpenGLVertexBuffer(void* vertices, uint32_t size, const BufferLayoutView& layout, BufferUsage usage = BufferUsage::Static);
+
+        // The layout view may point into the buffer's own layout, so buffers are not copied.
+        OpenGLVertexBuffer(const OpenGLVertexBuffer&) = delete;
+        OpenGLVertexBuffer& operator=(const OpenGLVertexBuffer&) = delete;
 
         /**
         * @brief Edit the vertex buffer's data.
+        * Logs an error and leaves the buffer unchanged if it is immutable.
         * @param vertices Pointer to the new vertex data.
         * @param size Size of the new vertex data in bytes.
         * @param offset Offset at which to write the new data.
@@ -45,9 +61,15 @@ namespace Engine
 
         /**
         * @brief Get the layout of the vertex buffer.
-        * @return The buffer layout specifying vertex attributes.
+        * @return A view of the elements specifying vertex attributes.
+        */
+        inline const BufferLayoutView& getLayout() const { return m_view; }
+
+        /**
+        * @brief Get the update policy of the vertex buffer.
+        * @return The buffer usage.
         */
-        inline const BufferLayout& getLayout() const { return m_layout; }
+        inline BufferUsage getUsage() const { return m_usage; }
 
         /**
         * @brief Bind the vertex buffer.
@@ -63,6 +85,9 @@ namespace Engine
 
     private:
         uint32_t m_OpenGL_ID; /**< The OpenGL vertex buffer ID. */
-        BufferLayout m_layout; /**< The layout specifying vertex attributes. */
+        BufferLayout m_layout; /**< The layout specifying vertex attributes, empty if constructed from a static layout. */
+        BufferLayoutView m_view; /**< View of the elements specifying vertex attributes, either m_layout's or a static table. */
+        uint32_t m_size; /**< Size of the buffer in bytes. */
+        BufferUsage m_usage; /**< The update policy of the buffer. */
     };
 }
\ No newline at end of file
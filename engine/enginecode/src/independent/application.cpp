@@ -5,9 +5,28 @@
 #include "core/application.h"
 #include <glad/glad.h>
 #include "platforms/OpenGL/OpenGLVertexArray.h"
+#include "platforms/OpenGL/OpenGLMesh.h"
+#include "platforms/OpenGL/OpenGLMeshPool.h"
 #include "platforms/OpenGL/OpenGLShader.h"
+#include "platforms/OpenGL/OpenGLShaderRegistry.h"
 #include "platforms/OpenGL/OpenGLTexture.h"
+#include "platforms/OpenGL/OpenGLTextureStreamer.h"
+#include "platforms/OpenGL/OpenGLTextureArray.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
+#include "rendering/renderer3D.h"
 #include "rendering/indexBuffer.h"
+#include "rendering/lodSelection.h"
+#include "rendering/meshImporter.h"
+#include "rendering/frustumCulling.h"
+#include "rendering/instanceTransform.h"
+#include "rendering/occlusionCulling.h"
+#include "rendering/vertexLayout.h"
+#include "rendering/vertexPacking.h"
+#include "scene/aabbTree.h"
+#include "scene/components.h"
+#include "scene/entityRegistry.h"
+#include "scene/transformHierarchy.h"
+#include "systems/workerPool.h"
 
 #ifdef NG_PLATFORM_WINDOWS
 	#include "platforms/windows/winTimer.h"
@@ -16,6 +35,8 @@
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include "GLFW/glfw3.h"
 
 
 namespace Engine {
@@ -23,31 +44,30 @@ namespace Engine {
 	class FCVertex
 	{
 	public:
+		using Layout = VertexLayout<VertexAttributes::Float3, VertexAttributes::UByte4N>;
+
 		glm::vec3 m_pos;
-		glm::vec3 m_colour;
-		FCVertex() : m_pos(glm::vec3(0.f)), m_colour(glm::vec3(0.f)) {}
-		FCVertex(const glm::vec3& pos, const glm::vec3 colour) : m_pos(pos), m_colour(colour) {}
-		static BufferLayout getLayout() { return s_layout; }
-	private:
-		static BufferLayout s_layout;
+		uint32_t m_colour;
+		FCVertex() : m_pos(glm::vec3(0.f)), m_colour(0) {}
+		FCVertex(const glm::vec3& pos, const glm::vec3 colour) : m_pos(pos), m_colour(VertexPacking::packUByte4N(glm::vec4(colour, 1.f))) {}
 	};
 
 	class TPVertexNormalised
 	{
 	public:
+		using Layout = VertexLayout<VertexAttributes::Float3, VertexAttributes::Short3N, VertexAttributes::Short2N>;
+
 		glm::vec3 m_pos;
 		std::array<int16_t, 3> m_normal;
 		std::array<int16_t, 2> m_uv;
 
 		TPVertexNormalised() : m_pos(glm::vec3(0.f)), m_normal({ 0, 0, 0 }), m_uv({ 0, 0 }) {}
 		TPVertexNormalised(const glm::vec3& pos, const std::array<int16_t, 3>& normal, const std::array<int16_t, 2>& uv) : m_pos(pos), m_normal(normal), m_uv(uv) {}
-		static BufferLayout getLayout() { return s_layout; }
-	private:
-		static BufferLayout s_layout;
 	};
 
-	BufferLayout FCVertex::s_layout = { ShaderDataType::Float3, ShaderDataType::Float3 };
-	BufferLayout TPVertexNormalised::s_layout = { {ShaderDataType::Float3, {ShaderDataType::Short3, true}, {ShaderDataType::Short2, true}}, 24 };
+	// A layout which disagrees with its struct's size or member offsets fails to compile.
+	static_assert(FCVertex::Layout::matches<FCVertex>({ offsetof(FCVertex, m_pos), offsetof(FCVertex, m_colour) }), "FCVertex layout mismatch");
+	static_assert(TPVertexNormalised::Layout::matches<TPVertexNormalised>({ offsetof(TPVertexNormalised, m_pos), offsetof(TPVertexNormalised, m_normal), offsetof(TPVertexNormalised, m_uv) }), "TPVertexNormalised layout mismatch");
 #pragma endregion
 	// Set static vars
 	Application* Application::s_instance = nullptr;
@@ -190,39 +210,6 @@ namespace Engine {
 	{
 #pragma region RAW_DATA
 
-		float cubeVertices[8 * 24] = {
-			//	 <------ Pos ------>  <--- normal --->  <-- UV -->
-				 0.5f,  0.5f, -0.5f,  0.f,  0.f, -1.f,  0.f,   0.f,
-				 0.5f, -0.5f, -0.5f,  0.f,  0.f, -1.f,  0.f,   0.5f,
-				-0.5f, -0.5f, -0.5f,  0.f,  0.f, -1.f,  0.33f, 0.5f,
-				-0.5f,  0.5f, -0.5f,  0.f,  0.f, -1.f,  0.33f, 0.f,
-
-				-0.5f, -0.5f, 0.5f,   0.f,  0.f,  1.f,  0.33f, 0.5f,
-				 0.5f, -0.5f, 0.5f,   0.f,  0.f,  1.f,  0.66f, 0.5f,
-				 0.5f,  0.5f, 0.5f,   0.f,  0.f,  1.f,  0.66f, 0.f,
-				-0.5f,  0.5f, 0.5f,   0.f,  0.f,  1.f,  0.33,  0.f,
-
-				-0.5f, -0.5f, -0.5f,  0.f, -1.f,  0.f,  1.f,   0.f,
-				 0.5f, -0.5f, -0.5f,  0.f, -1.f,  0.f,  0.66f, 0.f,
-				 0.5f, -0.5f, 0.5f,   0.f, -1.f,  0.f,  0.66f, 0.5f,
-				-0.5f, -0.5f, 0.5f,   0.f, -1.f,  0.f,  1.0f,  0.5f,
-
-				 0.5f,  0.5f, 0.5f,   0.f,  1.f,  0.f,  0.f,   0.5f,
-				 0.5f,  0.5f, -0.5f,  0.f,  1.f,  0.f,  0.f,   1.0f,
-				-0.5f,  0.5f, -0.5f,  0.f,  1.f,  0.f,  0.33f, 1.0f,
-				-0.5f,  0.5f, 0.5f,   0.f,  1.f,  0.f,  0.3f,  0.5f,
-
-				-0.5f,  0.5f, 0.5f,  -1.f,  0.f,  0.f,  0.66f, 0.5f,
-				-0.5f,  0.5f, -0.5f, -1.f,  0.f,  0.f,  0.33f, 0.5f,
-				-0.5f, -0.5f, -0.5f, -1.f,  0.f,  0.f,  0.33f, 1.0f,
-				-0.5f, -0.5f, 0.5f,  -1.f,  0.f,  0.f,  0.66f, 1.0f,
-
-				 0.5f, -0.5f, -0.5f,  1.f,  0.f,  0.f,  1.0f,  1.0f,
-				 0.5f,  0.5f, -0.5f,  1.f,  0.f,  0.f,  1.0f,  0.5f,
-				 0.5f,  0.5f, 0.5f,   1.f,  0.f,  0.f,  0.66f, 0.5f,
-				 0.5f, -0.5f, 0.5f,   1.f,  0.f,  0.f,  0.66f, 1.0f
-		};
-
 		std::vector<FCVertex> pyramidVertices(16);
 
 		pyramidVertices.at(0) = FCVertex({ -0.5f, -0.5f, -0.5f }, { 0.8f, 0.2f, 0.8f });
@@ -251,41 +238,13 @@ namespace Engine {
 			10, 11, 12,
 			13, 14, 15
 		};
-
-		uint32_t cubeIndices[3 * 12] = {
-			0, 1, 2,
-			2, 3, 0,
-			4, 5, 6,
-			6, 7, 4,
-			8, 9, 10,
-			10, 11, 8,
-			12, 13, 14,
-			14, 15, 12,
-			16, 17, 18,
-			18, 19, 16,
-			20, 21, 22,
-			22, 23, 20
-		};
 #pragma endregion
 
 #pragma region GL_BUFFERS
 
-		std::shared_ptr<OpenGLVertexArray> cubeVAO;
-		std::shared_ptr<OpenGLVertexBuffer> cubeVBO;
-		std::shared_ptr<IndexBuffer> cubeIBO;
-
-		cubeVAO.reset(new OpenGLVertexArray);
-
-		BufferLayout cubeBL = { ShaderDataType::Float3, ShaderDataType::Float3, ShaderDataType::Float2 };
-		cubeVBO.reset(new OpenGLVertexBuffer(cubeVertices, sizeof(cubeVertices), cubeBL));
-
-		cubeIBO.reset(IndexBuffer::create(cubeIndices, 36));
-
-		cubeVAO->addVertexBuffer(cubeVBO);
-		cubeVAO->setIndexBuffer(cubeIBO);
-
-		cubeVAO->unbind();
-		cubeVBO->unbind();
+		// Imported, packed and optimised on the first run, then mapped straight from ./cache/meshes/ on later ones.
+		std::shared_ptr<OpenGLMesh> cubeMesh = std::make_shared<OpenGLMesh>("./assets/models/cube.obj");
+		std::shared_ptr<OpenGLVertexArray> cubeVAO = cubeMesh->getVertexArray();
 
 		std::shared_ptr<OpenGLVertexArray> pyramidVAO;
 		std::shared_ptr<OpenGLVertexBuffer> pyramidVBO;
@@ -293,10 +252,9 @@ namespace Engine {
 
 		pyramidVAO.reset(new OpenGLVertexArray);
 
-		BufferLayout pyramidBL = { ShaderDataType::Float3, ShaderDataType::Float3 };
-		pyramidVBO.reset(new OpenGLVertexBuffer(pyramidVertices.data(), sizeof(FCVertex)* pyramidVertices.size(), FCVertex::getLayout()));
+		pyramidVBO.reset(new OpenGLVertexBuffer(pyramidVertices.data(), sizeof(FCVertex)* pyramidVertices.size(), FCVertex::Layout::view(), BufferUsage::Immutable));
 
-		pyramidIBO.reset(new OpenGLIndexBuffer(pyramidIndices, 18));
+		pyramidIBO.reset(new OpenGLIndexBuffer(pyramidIndices, 18, BufferUsage::Immutable));
 
 		pyramidVAO->addVertexBuffer(pyramidVBO);
 		pyramidVAO->setIndexBuffer(pyramidIBO);
@@ -304,30 +262,157 @@ namespace Engine {
 		pyramidVAO->unbind();
 		pyramidVBO->unbind();
 
+		// A grid of cubes below the scene, drawn with one instanced call reading each cube's matrices from an instance buffer.
+		const uint32_t gridSize = 8;
+		std::shared_ptr<OpenGLVertexArray> cubeGridVAO;
+		if (cubeMesh->isLoaded())
+		{
+			std::vector<InstanceTransform> gridInstances;
+			for (uint32_t x = 0; x < gridSize; x++)
+			{
+				for (uint32_t z = 0; z < gridSize; z++)
+				{
+					glm::mat4 model = glm::translate(glm::mat4(1.f), glm::vec3(x * 1.5f - 5.25f, -3.f, z * -1.5f - 4.f));
+					model = glm::scale(model, glm::vec3(0.5f));
+					gridInstances.push_back({ model, glm::transpose(glm::inverse(glm::mat3(model))) });
+				}
+			}
+
+			std::shared_ptr<OpenGLVertexBuffer> gridVBO;
+			gridVBO.reset(new OpenGLVertexBuffer(gridInstances.data(), sizeof(InstanceTransform) * gridInstances.size(), InstanceTransform::Layout::view(), BufferUsage::Immutable));
+			cubeGridVAO = cubeMesh->createInstancedVertexArray(gridVBO);
+		}
+
+		// Meshes in the imported vertex format suballocated from shared buffers, so the renderer draws many of them with one multi draw indirect call.
+		OpenGLMeshPool meshPool(MeshImporter::Vertex::Layout::view(), 4096, 16384, 64);
+		MeshHandle pooledCube = meshPool.addMesh("./assets/models/cube.obj");
+
 #pragma endregion
 
 #pragma region SHADERS
-		std::shared_ptr<OpenGLShader> TPShader;
-		TPShader.reset(new OpenGLShader("./assets/shaders/texturePhong.glsl"));
-
-		std::shared_ptr<OpenGLShader> FCShader;
-		FCShader.reset(new OpenGLShader("./assets/shaders/flatColour.glsl"));
+		// Variants are compiled only when first requested, then shared.
+		// Both compile in parallel, draws using them are skipped until they are ready so the window keeps rendering.
+		OpenGLShaderRegistry shaders;
+
+		// Reads its texture and tint from b_materials, so differently textured draws need no texture binds between them.
+		std::shared_ptr<OpenGLShader> TPBatchedShader = shaders.get("./assets/shaders/texturePhong.glsl", ShaderFeatures::MaterialBuffer, ShaderCompileMode::Parallel);
+		std::shared_ptr<OpenGLShader> TPInstancedShader = shaders.get("./assets/shaders/texturePhong.glsl", ShaderFeatures::Instanced | ShaderFeatures::MaterialBuffer, ShaderCompileMode::Parallel);
+		std::shared_ptr<OpenGLShader> FCShader = shaders.get("./assets/shaders/flatColour.glsl", ShaderFeatures::None, ShaderCompileMode::Parallel);
 #pragma endregion 
 
 #pragma region TEXTURES
-		std::shared_ptr<OpenGLTexture> letterTexture;
-		letterTexture.reset(new OpenGLTexture("./assets/textures/letterCube.png"));
+		OpenGLTextureStreamer textureStreamer;
 
+		std::shared_ptr<OpenGLTexture> letterTexture;
 		std::shared_ptr<OpenGLTexture> numberTexture;
-		numberTexture.reset(new OpenGLTexture("./assets/textures/numberCube.png"));
+		std::shared_ptr<OpenGLTextureArray> cubeTextures;
+		int32_t letterLayer = 0, numberLayer = 0;
+
+		if (OpenGLTexture::isBindlessSupported())
+		{
+			// Decoded on worker threads and sampled through bindless handles once uploaded.
+			letterTexture = textureStreamer.load("./assets/textures/letterCube.png");
+			numberTexture = textureStreamer.load("./assets/textures/numberCube.png");
+		}
+		else
+		{
+			// Without bindless handles both images share one array, bound once for both cubes.
+			cubeTextures.reset(new OpenGLTextureArray(300, 200, 2, OpenGLTexture::isCompressionSupported() ? TextureFormat::BC3 : TextureFormat::RGBA8));
+			letterLayer = cubeTextures->addLayer("./assets/textures/letterCube.png");
+			numberLayer = cubeTextures->addLayer("./assets/textures/numberCube.png");
+		}
+#pragma endregion
+
+#pragma region MATERIALS
+		std::shared_ptr<Material> pyramidMaterial;
+		pyramidMaterial.reset(new Material(FCShader));
+
+		std::shared_ptr<Material> letterCubeMaterial;
+		std::shared_ptr<Material> numberCubeMaterial;
+		std::shared_ptr<Material> cubeGridMaterial;
+		if (cubeTextures)
+		{
+			letterCubeMaterial.reset(new Material(TPBatchedShader, cubeTextures, std::max(letterLayer, 0)));
+			numberCubeMaterial.reset(new Material(TPBatchedShader, cubeTextures, std::max(numberLayer, 0)));
+			cubeGridMaterial.reset(new Material(TPInstancedShader, cubeTextures, std::max(numberLayer, 0)));
+		}
+		else
+		{
+			letterCubeMaterial.reset(new Material(TPBatchedShader, letterTexture));
+			numberCubeMaterial.reset(new Material(TPBatchedShader, numberTexture));
+			cubeGridMaterial.reset(new Material(TPInstancedShader, numberTexture));
+		}
 #pragma endregion
 
-		glm::mat4 models[3];
-		models[0] = glm::translate(glm::mat4(1.0f), glm::vec3(-2.f, 0.f, -6.f));
-		models[1] = glm::translate(glm::mat4(1.0f), glm::vec3(0.f, 0.f, -6.f));
-		models[2] = glm::translate(glm::mat4(1.0f), glm::vec3(2.f, 0.f, -6.f));
+		// World matrices are only recomputed for objects moved since the last update.
+		TransformHierarchy sceneTransforms;
+		EntityRegistry scene;
+		// Fattened world boxes of every object, for picking and range queries.
+		DynamicAABBTree sceneTree;
+
+		auto addObject = [&](const glm::vec3& position, const std::shared_ptr<OpenGLVertexArray>& geometry, const std::shared_ptr<Material>& material, const Bounds& bounds)
+		{
+			Transform transform{ sceneTransforms.create() };
+			sceneTransforms.setPosition(transform.id, position);
+			Entity entity = scene.create(transform, MeshRef{ geometry }, MaterialRef{ material }, bounds);
+			scene.add(entity, SpatialProxy{ sceneTree.createProxy({ position + bounds.min, position + bounds.max }, entity.index) });
+			return entity;
+		};
+
+		addObject(glm::vec3(-2.f, 0.f, -6.f), pyramidVAO, pyramidMaterial, Bounds{ glm::vec3(-0.5f), glm::vec3(0.5f) });
+		if (cubeMesh->isLoaded())
+		{
+			const MeshBounds& cubeBounds = cubeMesh->getBounds();
+			Bounds bounds{ glm::vec3(cubeBounds.min[0], cubeBounds.min[1], cubeBounds.min[2]), glm::vec3(cubeBounds.max[0], cubeBounds.max[1], cubeBounds.max[2]) };
+			Entity letterCube = addObject(glm::vec3(0.f, 0.f, -6.f), cubeVAO, letterCubeMaterial, bounds);
+			Entity numberCube = addObject(glm::vec3(2.f, 0.f, -6.f), cubeVAO, numberCubeMaterial, bounds);
+
+			// The cubes fill their bounds, so the bounds can stand in for them as occluders.
+			std::shared_ptr<OccluderMesh> cubeOccluder = std::make_shared<OccluderMesh>(OccluderMesh::box(bounds.min, bounds.max));
+			scene.add(letterCube, Occluder{ cubeOccluder });
+			scene.add(numberCube, Occluder{ cubeOccluder });
+			scene.add(letterCube, LevelOfDetail{ cubeMesh });
+			scene.add(numberCube, LevelOfDetail{ cubeMesh });
+
+			// A ring of cubes above the scene drawn from the mesh pool.
+			if (pooledCube.isValid())
+			{
+				const uint32_t ringSize = 12;
+				for (uint32_t i = 0; i < ringSize; i++)
+				{
+					float angle = glm::radians(360.f * i / ringSize);
+					glm::vec3 position(4.f * std::cos(angle), 3.f, 4.f * std::sin(angle) - 10.f);
+
+					Transform transform{ sceneTransforms.create() };
+					sceneTransforms.setPosition(transform.id, position);
+					Entity entity = scene.create(transform, PooledMesh{ &meshPool, pooledCube }, MaterialRef{ cubeGridMaterial }, bounds);
+					scene.add(entity, SpatialProxy{ sceneTree.createProxy({ position + bounds.min, position + bounds.max }, entity.index) });
+				}
+			}
+		}
+
+		float spin = 0.f;
+
+		// A drawable entity's components, valid for the frame they were gathered in.
+		struct Drawable
+		{
+			const MeshRef* mesh; // Null for pooled drawables
+			const PooledMesh* pooled; // Null for those with a MeshRef
+			const MaterialRef* material;
+			const glm::mat4* world;
+			const glm::mat3* normal;
+		};
+
+		WorkerPool workers;
+		BoxBounds cullBounds;
+		std::vector<Drawable> drawables;
+		std::vector<uint32_t> visible;
+		OcclusionBuffer occlusion;
+		// Exact world box of each entity by index, which picking tests the tree's candidates against.
+		std::vector<AABB> worldBoxes;
+		bool pickHeld = false;
 
-		glEnable(GL_DEPTH_TEST);
+		OpenGLStateCache::enable(GL_DEPTH_TEST);
 		glClearColor(1.0f, 0.0f, 1.0f, 1.0f);
 
 		float timestep = 0.f;
@@ -336,61 +421,120 @@ namespace Engine {
 		CameraControllerEuler camera(props);
 		eulerCamera = &camera;
 
-		glEnable(GL_DEPTH_TEST);
+		OpenGLStateCache::enable(GL_DEPTH_TEST);
 		glClearColor(1.0f, 0.0f, 1.0f, 1.0f);
 
+		Renderer3D::init();
+
+		PointLight light;
+		light.position = glm::vec3(1.0f, 4.0f, 6.0f);
+		light.colour = glm::vec3(1.0f, 1.0f, 1.0f);
+
 		while (m_running)
 		{
 			timestep = m_timer->reset();
+			OpenGLStateCache::beginFrame();
+			textureStreamer.update();
 
 			// Do frame stuff
 			float constant = 5.0f;
-			for (auto& model : models) { model = glm::rotate(model, timestep * constant, glm::vec3(0.f, 1.0f, 0.f)); }
+			spin += timestep * constant;
+			scene.each<Transform>([&](Entity, const Transform& transform) { sceneTransforms.setRotation(transform.id, glm::angleAxis(spin, glm::vec3(0.f, 1.0f, 0.f))); });
+			sceneTransforms.update();
+
+			// Refit the tree to the moved objects, which only restructures it for those leaving their fattened boxes.
+			scene.each<Transform, Bounds, SpatialProxy>([&](Entity entity, const Transform& transform, const Bounds& bounds, const SpatialProxy& proxy)
+			{
+				glm::vec3 centre, extent;
+				FrustumCulling::transformBox(sceneTransforms.getWorld(transform.id), bounds.min, bounds.max, centre, extent);
+				if (worldBoxes.size() <= entity.index) worldBoxes.resize(entity.index + 1);
+				worldBoxes[entity.index] = { centre - extent, centre + extent };
+				sceneTree.moveProxy(proxy.id, worldBoxes[entity.index]);
+			});
+
+			// Pick the object under the mouse when the left button goes down.
+			bool pickPressed = InputPoller::isMouseButtonPressed(GLFW_MOUSE_BUTTON_LEFT);
+			if (pickPressed && !pickHeld)
+			{
+				glm::vec3 origin, direction;
+				eulerCamera->getCamera().screenPointToRay(InputPoller::getMousePosition(), glm::vec2(m_window->getWidth(), m_window->getHeight()), origin, direction);
+				glm::vec3 inverseDirection = glm::vec3(1.f) / direction;
+
+				RayHit hit = sceneTree.raycast(origin, direction, 1000.f, [&](int32_t, uint32_t entityIndex)
+				{
+					float distance;
+					return worldBoxes[entityIndex].raycast(origin, inverseDirection, 1000.f, distance) ? distance : -1.f;
+				});
+				if (hit.isHit()) Log::info("Picked entity {0} at distance {1}", sceneTree.getUserData(hit.proxy), hit.distance);
+			}
+			pickHeld = pickPressed;
 
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-			glUseProgram(FCShader->getID());
-			pyramidVAO->bind();
-
-			GLuint uniformLocation;
-
-			FCShader->uploadMat4("u_model", models[0]);
-			FCShader->uploadMat4("u_view", eulerCamera->getCamera().view);
-			FCShader->uploadMat4("u_projection", eulerCamera->getCamera().projection);
-
-			glDrawElements(GL_TRIANGLES, pyramidVAO->getDrawCount(), GL_UNSIGNED_INT, nullptr);
-
-			glUseProgram(TPShader->getID());
-			cubeVAO->bind();
-
-			TPShader->uploadMat4("u_model", models[1]);
-			TPShader->uploadMat4("u_view", eulerCamera->getCamera().view);
-			TPShader->uploadMat4("u_projection", eulerCamera->getCamera().projection);
-			TPShader->uploadFloat4("u_tint", glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
-			TPShader->uploadFloat3("u_lightColour", glm::vec3(1.0f, 1.0f, 1.0f));
-			TPShader->uploadFloat3("u_lightPos", glm::vec3(1.0f, 4.0f, 6.0f));
-			TPShader->uploadFloat3("u_viewPos", glm::vec3(0.0f, 0.0f, 0.0f));
-
-			uniformLocation = glGetUniformLocation(TPShader->getID(), "u_texData");
-			glUniform1i(uniformLocation, 0);
-
-			glBindTexture(GL_TEXTURE_2D, letterTexture->getID());
-			uniformLocation = glGetUniformLocation(TPShader->getID(), "u_texData");
-			glUniform1i(uniformLocation, 0);
-			glDrawElements(GL_TRIANGLES, cubeVAO->getDrawCount(), GL_UNSIGNED_INT, nullptr);
-
-			TPShader->uploadMat4("u_model", models[2]);
-
-
-			glBindTexture(GL_TEXTURE_2D, numberTexture->getID());
-
-			glDrawElements(GL_TRIANGLES, cubeVAO->getDrawCount(), GL_UNSIGNED_INT, nullptr);
+			Renderer3D::begin(eulerCamera->getCamera(), light);
+
+			const Camera& view = eulerCamera->getCamera();
+
+			// Draw each mesh at the coarsest level whose simplification stays under a pixel from where the camera is.
+			glm::vec3 cameraPosition = view.getPosition();
+			float projectionScale = view.getProjectionScale(static_cast<float>(m_window->getHeight()));
+			scene.each<Transform, Bounds, MeshRef, LevelOfDetail>([&](Entity, const Transform& transform, const Bounds& bounds, MeshRef& mesh, LevelOfDetail& lod)
+			{
+				const glm::mat4& world = sceneTransforms.getWorld(transform.id);
+				glm::vec3 centre, extent;
+				FrustumCulling::transformBox(world, bounds.min, bounds.max, centre, extent);
+				float distance = std::max(glm::length(centre - cameraPosition) - glm::length(extent), 0.f);
+				float scale = std::max(glm::length(glm::vec3(world[0])), std::max(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+
+				const std::vector<MeshLod>& lods = lod.mesh->getLods();
+				lod.current = LodSelection::select(lods.data(), static_cast<uint32_t>(lods.size()), scale, distance, projectionScale, lod.current);
+				mesh.geometry = lod.mesh->getLodVertexArray(lod.current);
+			});
+
+			// Gather world bounds of every drawable, then only submit those inside the view.
+			cullBounds.clear();
+			drawables.clear();
+			scene.each<Transform, Bounds, MeshRef, MaterialRef>([&](Entity, const Transform& transform, const Bounds& bounds, const MeshRef& mesh, const MaterialRef& material)
+			{
+				const glm::mat4& world = sceneTransforms.getWorld(transform.id);
+				glm::vec3 centre, extent;
+				FrustumCulling::transformBox(world, bounds.min, bounds.max, centre, extent);
+				cullBounds.add(centre, extent);
+				drawables.push_back({ &mesh, nullptr, &material, &world, &sceneTransforms.getNormal(transform.id) });
+			});
+			scene.each<Transform, Bounds, PooledMesh, MaterialRef>([&](Entity, const Transform& transform, const Bounds& bounds, const PooledMesh& pooled, const MaterialRef& material)
+			{
+				const glm::mat4& world = sceneTransforms.getWorld(transform.id);
+				glm::vec3 centre, extent;
+				FrustumCulling::transformBox(world, bounds.min, bounds.max, centre, extent);
+				cullBounds.add(centre, extent);
+				drawables.push_back({ nullptr, &pooled, &material, &world, &sceneTransforms.getNormal(transform.id) });
+			});
+
+			FrustumCulling::cullBoxes(view.getFrustum(), cullBounds, visible, &workers);
+
+			// Then drop those hidden behind the occluders, rasterized into a small depth buffer on the CPU.
+			occlusion.begin(view.projection * view.view);
+			scene.each<Transform, Occluder>([&](Entity, const Transform& transform, const Occluder& occluder) { occlusion.addOccluder(sceneTransforms.getWorld(transform.id), *occluder.mesh); });
+			occlusion.rasterize(&workers);
+			occlusion.cullBoxes(cullBounds, visible);
+			for (uint32_t index : visible)
+			{
+				const Drawable& drawable = drawables[index];
+				if (drawable.pooled) Renderer3D::submit(*drawable.pooled->pool, drawable.pooled->mesh, drawable.material->material, *drawable.world, *drawable.normal);
+				else Renderer3D::submit(drawable.mesh->geometry, drawable.material->material, *drawable.world, *drawable.normal);
+			}
+			if (cubeGridVAO) Renderer3D::submitInstanced(cubeGridVAO, cubeGridMaterial, gridSize * gridSize);
+
+			Renderer3D::end();
 
 			//Frame stuff
 			eulerCamera->onUpdate(timestep);
 			m_window->onUpdate(timestep);
 		}
 
+		Renderer3D::shutdown();
+
 		Log::info("Exiting");
 	}
 }
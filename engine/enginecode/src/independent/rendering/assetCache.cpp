@@ -0,0 +1,36 @@
+#include "engine_pch.h"
+#include "rendering/assetCache.h"
+#include "rendering/shaderCache.h"
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+
+namespace Engine
+{
+	namespace AssetCache
+	{
+		std::string cachePath(const std::string& sourcePath, const char* folder, const char* extension)
+		{
+			// Normalise so every spelling of the same source names the same cache file.
+			std::string normalised = sourcePath;
+			for (char& c : normalised)
+			{
+				if (c == '\\') c = '/';
+			}
+			normalised = std::filesystem::path(normalised).lexically_normal().generic_string();
+
+			// Flatten for a readable name, which on its own is ambiguous as "a/b.png" and "a_b.png" both give "a_b_png".
+			std::string name = normalised;
+			for (char& c : name)
+			{
+				if (!isalnum(static_cast<unsigned char>(c))) c = '_';
+			}
+
+			// So the hash of the full normalised path keeps them apart.
+			char suffix[18];
+			snprintf(suffix, sizeof(suffix), "_%016llx", static_cast<unsigned long long>(ShaderCache::hash(normalised.data(), normalised.size())));
+
+			return std::string("./cache/") + folder + "/" + name + suffix + extension;
+		}
+	}
+}
@@ -0,0 +1,323 @@
+#include "engine_pch.h"
+#include "rendering/frustumCulling.h"
+#include "systems/workerPool.h"
+#include <algorithm>
+#include <cstring>
+
+// SSE2 is part of every x64 target. AVX2 is only compiled into the functions which use it, and only run once the CPU reports it.
+// FMA is left out so every path rounds exactly as the scalar tests do.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <immintrin.h>
+	#define NG_CULL_SSE 1
+	#if defined(_MSC_VER)
+		#define NG_CULL_AVX2 1
+		#define NG_TARGET_AVX2
+	#elif defined(__GNUC__) || defined(__clang__)
+		#define NG_CULL_AVX2 1
+		#define NG_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+namespace Engine
+{
+	namespace
+	{
+		/** @brief Append the indices of a vector's set lanes, writing every lane but only advancing past the set ones so there is no branch. */
+		inline uint32_t appendLanes(int mask, uint32_t base, uint32_t lanes, uint32_t* visible, uint32_t count)
+		{
+			for (uint32_t lane = 0; lane < lanes; lane++)
+			{
+				visible[count] = base + lane;
+				count += (mask >> lane) & 1;
+			}
+
+			return count;
+		}
+
+		/** @brief Cull every bound, splitting the range into blocks across the workers and then closing the gaps between each block's results. */
+		template<typename Cull>
+		uint32_t cullAll(uint32_t count, std::vector<uint32_t>& visible, WorkerPool* workers, const Cull& cull)
+		{
+			visible.resize(count);
+			if (!workers || count <= FrustumCulling::blockSize)
+			{
+				uint32_t visibleCount = cull(0, count, visible.data());
+				visible.resize(visibleCount);
+				return visibleCount;
+			}
+
+			// Each block writes its results at its own start, so blocks never share output.
+			std::vector<uint32_t> blockCounts((count + FrustumCulling::blockSize - 1) / FrustumCulling::blockSize);
+			workers->parallelFor(count, FrustumCulling::blockSize, [&](uint32_t begin, uint32_t end)
+			{
+				blockCounts[begin / FrustumCulling::blockSize] = cull(begin, end, visible.data() + begin);
+			});
+
+			uint32_t visibleCount = 0;
+			for (uint32_t block = 0; block < blockCounts.size(); block++)
+			{
+				memmove(visible.data() + visibleCount, visible.data() + block * FrustumCulling::blockSize, blockCounts[block] * sizeof(uint32_t));
+				visibleCount += blockCounts[block];
+			}
+
+			visible.resize(visibleCount);
+			return visibleCount;
+		}
+
+#if defined(NG_CULL_AVX2)
+		/** @brief Test spheres eight at a time, the range a multiple of eight. */
+		NG_TARGET_AVX2 uint32_t cullSpheresAVX2(const Frustum& frustum, const SphereBounds& spheres, uint32_t begin, uint32_t end, uint32_t* visible, uint32_t count)
+		{
+			const float* xs = spheres.x.data();
+			const float* ys = spheres.y.data();
+			const float* zs = spheres.z.data();
+			const float* radii = spheres.radius.data();
+			const glm::vec4* planes = frustum.planes;
+
+			for (uint32_t i = begin; i < end; i += 8)
+			{
+				__m256 x = _mm256_loadu_ps(xs + i), y = _mm256_loadu_ps(ys + i), z = _mm256_loadu_ps(zs + i);
+				__m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radii + i));
+				__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+				for (uint32_t p = 0; p < Frustum::Count; p++)
+				{
+					__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(planes[p].x)), _mm256_mul_ps(y, _mm256_set1_ps(planes[p].y))),
+						_mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(planes[p].z)), _mm256_set1_ps(planes[p].w)));
+					inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+				}
+
+				count = appendLanes(_mm256_movemask_ps(inside), i, 8, visible, count);
+			}
+
+			return count;
+		}
+
+		/** @brief Test boxes eight at a time, the range a multiple of eight. */
+		NG_TARGET_AVX2 uint32_t cullBoxesAVX2(const glm::vec4* planes, const glm::vec3* absNormals, const BoxBounds& boxes, uint32_t begin, uint32_t end, uint32_t* visible, uint32_t count)
+		{
+			const float* cxs = boxes.centreX.data();
+			const float* cys = boxes.centreY.data();
+			const float* czs = boxes.centreZ.data();
+			const float* exs = boxes.extentX.data();
+			const float* eys = boxes.extentY.data();
+			const float* ezs = boxes.extentZ.data();
+
+			for (uint32_t i = begin; i < end; i += 8)
+			{
+				__m256 cx = _mm256_loadu_ps(cxs + i), cy = _mm256_loadu_ps(cys + i), cz = _mm256_loadu_ps(czs + i);
+				__m256 ex = _mm256_loadu_ps(exs + i), ey = _mm256_loadu_ps(eys + i), ez = _mm256_loadu_ps(ezs + i);
+				__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+				for (uint32_t p = 0; p < Frustum::Count; p++)
+				{
+					__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cx, _mm256_set1_ps(planes[p].x)), _mm256_mul_ps(cy, _mm256_set1_ps(planes[p].y))),
+						_mm256_add_ps(_mm256_mul_ps(cz, _mm256_set1_ps(planes[p].z)), _mm256_set1_ps(planes[p].w)));
+					__m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex, _mm256_set1_ps(absNormals[p].x)), _mm256_mul_ps(ey, _mm256_set1_ps(absNormals[p].y))),
+						_mm256_mul_ps(ez, _mm256_set1_ps(absNormals[p].z)));
+					inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+				}
+
+				count = appendLanes(_mm256_movemask_ps(inside), i, 8, visible, count);
+			}
+
+			return count;
+		}
+#endif
+
+#if defined(NG_CULL_SSE)
+		/** @brief Test spheres four at a time, the range a multiple of four. */
+		uint32_t cullSpheresSSE(const Frustum& frustum, const SphereBounds& spheres, uint32_t begin, uint32_t end, uint32_t* visible, uint32_t count)
+		{
+			const float* xs = spheres.x.data();
+			const float* ys = spheres.y.data();
+			const float* zs = spheres.z.data();
+			const float* radii = spheres.radius.data();
+			const glm::vec4* planes = frustum.planes;
+
+			for (uint32_t i = begin; i < end; i += 4)
+			{
+				__m128 x = _mm_loadu_ps(xs + i), y = _mm_loadu_ps(ys + i), z = _mm_loadu_ps(zs + i);
+				__m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radii + i));
+				__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+				for (uint32_t p = 0; p < Frustum::Count; p++)
+				{
+					__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(planes[p].x)), _mm_mul_ps(y, _mm_set1_ps(planes[p].y))),
+						_mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(planes[p].z)), _mm_set1_ps(planes[p].w)));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+				}
+
+				count = appendLanes(_mm_movemask_ps(inside), i, 4, visible, count);
+			}
+
+			return count;
+		}
+
+		/** @brief Test boxes four at a time, the range a multiple of four. */
+		uint32_t cullBoxesSSE(const glm::vec4* planes, const glm::vec3* absNormals, const BoxBounds& boxes, uint32_t begin, uint32_t end, uint32_t* visible, uint32_t count)
+		{
+			const float* cxs = boxes.centreX.data();
+			const float* cys = boxes.centreY.data();
+			const float* czs = boxes.centreZ.data();
+			const float* exs = boxes.extentX.data();
+			const float* eys = boxes.extentY.data();
+			const float* ezs = boxes.extentZ.data();
+
+			for (uint32_t i = begin; i < end; i += 4)
+			{
+				__m128 cx = _mm_loadu_ps(cxs + i), cy = _mm_loadu_ps(cys + i), cz = _mm_loadu_ps(czs + i);
+				__m128 ex = _mm_loadu_ps(exs + i), ey = _mm_loadu_ps(eys + i), ez = _mm_loadu_ps(ezs + i);
+				__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+				for (uint32_t p = 0; p < Frustum::Count; p++)
+				{
+					__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(planes[p].x)), _mm_mul_ps(cy, _mm_set1_ps(planes[p].y))),
+						_mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(planes[p].z)), _mm_set1_ps(planes[p].w)));
+					__m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(absNormals[p].x)), _mm_mul_ps(ey, _mm_set1_ps(absNormals[p].y))),
+						_mm_mul_ps(ez, _mm_set1_ps(absNormals[p].z)));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+				}
+
+				count = appendLanes(_mm_movemask_ps(inside), i, 4, visible, count);
+			}
+
+			return count;
+		}
+#endif
+
+		/** @brief Test spheres one at a time, the reference the vector paths must match. */
+		uint32_t cullSpheresScalar(const Frustum& frustum, const SphereBounds& spheres, uint32_t begin, uint32_t end, uint32_t* visible, uint32_t count)
+		{
+			const float* xs = spheres.x.data();
+			const float* ys = spheres.y.data();
+			const float* zs = spheres.z.data();
+			const float* radii = spheres.radius.data();
+			const glm::vec4* planes = frustum.planes;
+
+			for (uint32_t i = begin; i < end; i++)
+			{
+				bool inside = true;
+				for (uint32_t p = 0; p < Frustum::Count; p++)
+				{
+					float distance = (xs[i] * planes[p].x + ys[i] * planes[p].y) + (zs[i] * planes[p].z + planes[p].w);
+					inside &= distance >= -radii[i];
+				}
+				count = appendLanes(inside ? 1 : 0, i, 1, visible, count);
+			}
+
+			return count;
+		}
+
+		/** @brief Test boxes one at a time, the reference the vector paths must match. */
+		uint32_t cullBoxesScalar(const glm::vec4* planes, const glm::vec3* absNormals, const BoxBounds& boxes, uint32_t begin, uint32_t end, uint32_t* visible, uint32_t count)
+		{
+			const float* cxs = boxes.centreX.data();
+			const float* cys = boxes.centreY.data();
+			const float* czs = boxes.centreZ.data();
+			const float* exs = boxes.extentX.data();
+			const float* eys = boxes.extentY.data();
+			const float* ezs = boxes.extentZ.data();
+
+			for (uint32_t i = begin; i < end; i++)
+			{
+				bool inside = true;
+				for (uint32_t p = 0; p < Frustum::Count; p++)
+				{
+					float distance = (cxs[i] * planes[p].x + cys[i] * planes[p].y) + (czs[i] * planes[p].z + planes[p].w);
+					float radius = (exs[i] * absNormals[p].x + eys[i] * absNormals[p].y) + ezs[i] * absNormals[p].z;
+					inside &= distance + radius >= 0.f;
+				}
+				count = appendLanes(inside ? 1 : 0, i, 1, visible, count);
+			}
+
+			return count;
+		}
+	}
+
+	namespace FrustumCulling
+	{
+		const char* getInstructionSet()
+		{
+			return CpuFeatures::getInstructionSetName(CpuFeatures::getSupportedInstructionSet());
+		}
+
+		void transformBox(const glm::mat4& world, const glm::vec3& min, const glm::vec3& max, glm::vec3& centre, glm::vec3& extent)
+		{
+			glm::vec3 localCentre = (min + max) * 0.5f;
+			glm::vec3 localExtent = (max - min) * 0.5f;
+
+			// Each world axis's extent is the sum of the local extents projected onto it.
+			centre = glm::vec3(world * glm::vec4(localCentre, 1.f));
+			for (int axis = 0; axis < 3; axis++)
+			{
+				extent[axis] = std::abs(world[0][axis]) * localExtent.x + std::abs(world[1][axis]) * localExtent.y + std::abs(world[2][axis]) * localExtent.z;
+			}
+		}
+
+		uint32_t cullSpheres(const Frustum& frustum, const SphereBounds& spheres, uint32_t begin, uint32_t end, uint32_t* visible, InstructionSet set)
+		{
+			set = std::min(set, CpuFeatures::getSupportedInstructionSet());
+
+			// Each path takes as many whole vectors as it can and leaves the rest to the next narrower one.
+			uint32_t count = 0;
+#if defined(NG_CULL_AVX2)
+			if (set == InstructionSet::AVX2)
+			{
+				uint32_t wide = begin + ((end - begin) & ~7u);
+				count = cullSpheresAVX2(frustum, spheres, begin, wide, visible, count);
+				begin = wide;
+			}
+#endif
+#if defined(NG_CULL_SSE)
+			if (set != InstructionSet::Scalar)
+			{
+				uint32_t wide = begin + ((end - begin) & ~3u);
+				count = cullSpheresSSE(frustum, spheres, begin, wide, visible, count);
+				begin = wide;
+			}
+#endif
+			return cullSpheresScalar(frustum, spheres, begin, end, visible, count);
+		}
+
+		uint32_t cullBoxes(const Frustum& frustum, const BoxBounds& boxes, uint32_t begin, uint32_t end, uint32_t* visible, InstructionSet set)
+		{
+			set = std::min(set, CpuFeatures::getSupportedInstructionSet());
+
+			// The projected extent uses the absolute normal, computed once rather than per box.
+			const glm::vec4* planes = frustum.planes;
+			glm::vec3 absNormals[Frustum::Count];
+			for (uint32_t p = 0; p < Frustum::Count; p++) absNormals[p] = glm::abs(glm::vec3(planes[p]));
+
+			// Each path takes as many whole vectors as it can and leaves the rest to the next narrower one.
+			uint32_t count = 0;
+#if defined(NG_CULL_AVX2)
+			if (set == InstructionSet::AVX2)
+			{
+				uint32_t wide = begin + ((end - begin) & ~7u);
+				count = cullBoxesAVX2(planes, absNormals, boxes, begin, wide, visible, count);
+				begin = wide;
+			}
+#endif
+#if defined(NG_CULL_SSE)
+			if (set != InstructionSet::Scalar)
+			{
+				uint32_t wide = begin + ((end - begin) & ~3u);
+				count = cullBoxesSSE(planes, absNormals, boxes, begin, wide, visible, count);
+				begin = wide;
+			}
+#endif
+			return cullBoxesScalar(planes, absNormals, boxes, begin, end, visible, count);
+		}
+
+		uint32_t cullSpheres(const Frustum& frustum, const SphereBounds& spheres, std::vector<uint32_t>& visible, WorkerPool* workers)
+		{
+			return cullAll(spheres.size(), visible, workers, [&](uint32_t begin, uint32_t end, uint32_t* out) { return cullSpheres(frustum, spheres, begin, end, out); });
+		}
+
+		uint32_t cullBoxes(const Frustum& frustum, const BoxBounds& boxes, std::vector<uint32_t>& visible, WorkerPool* workers)
+		{
+			return cullAll(boxes.size(), visible, workers, [&](uint32_t begin, uint32_t end, uint32_t* out) { return cullBoxes(frustum, boxes, begin, end, out); });
+		}
+	}
+}
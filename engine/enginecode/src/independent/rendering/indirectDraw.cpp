@@ -0,0 +1,33 @@
+#include "engine_pch.h"
+#include "rendering/indirectDraw.h"
+
+namespace Engine
+{
+	namespace IndirectDraw
+	{
+		uint32_t buildCommands(const MeshHandle* meshes, uint32_t count, uint32_t firstInstance, DrawElementsIndirectCommand* commands)
+		{
+			uint32_t commandCount = 0;
+			for (uint32_t i = 0; i < count; i++)
+			{
+				const MeshHandle& mesh = meshes[i];
+				if (!mesh.isValid()) continue;
+
+				// A repeat of the previous draw's mesh, with its instance data next in line, is one more instance of its command.
+				if (i > 0 && meshes[i - 1] == mesh)
+				{
+					commands[commandCount - 1].instanceCount++;
+					continue;
+				}
+
+				DrawElementsIndirectCommand& cmd = commands[commandCount++];
+				cmd.count = mesh.indexCount;
+				cmd.instanceCount = 1;
+				cmd.firstIndex = mesh.firstIndex;
+				cmd.baseVertex = mesh.baseVertex;
+				cmd.baseInstance = firstInstance + i; // Selects this draw's instance data
+			}
+			return commandCount;
+		}
+	}
+}
@@ -0,0 +1,182 @@
+#include "engine_pch.h"
+#include "rendering/meshFile.h"
+#include "rendering/assetCache.h"
+#include "rendering/meshOptimizer.h"
+#include <fstream>
+
+namespace Engine
+{
+	namespace
+	{
+		const uint32_t s_maxAttributes = sizeof(MeshFileHeader::attributes) / sizeof(MeshFileAttribute);
+
+		/** @brief Round an offset up to the blob alignment. */
+		uint64_t align(uint64_t offset)
+		{
+			return (offset + MeshFile::blobAlignment - 1) / MeshFile::blobAlignment * MeshFile::blobAlignment;
+		}
+
+		/** @brief Write zeros up to an aligned offset. */
+		void padTo(std::ofstream& handle, uint64_t written, uint64_t offset)
+		{
+			static const char s_zeros[MeshFile::blobAlignment] = {};
+			handle.write(s_zeros, static_cast<std::streamsize>(offset - written));
+		}
+
+		/** @brief Check a table or blob lies inside the file and is aligned. */
+		bool isInside(uint64_t offset, uint64_t size, size_t fileSize)
+		{
+			return offset % MeshFile::blobAlignment == 0 && offset <= fileSize && size <= fileSize - offset;
+		}
+	}
+
+	namespace MeshFile
+	{
+		bool write(const std::string& filepath, const MeshData& mesh)
+		{
+			uint32_t stride = mesh.layout.getStride();
+			uint32_t attributeCount = static_cast<uint32_t>(mesh.layout.end() - mesh.layout.begin());
+			if (stride == 0 || attributeCount > s_maxAttributes || mesh.vertices.size() % stride != 0) return false;
+
+			MeshFileHeader header = {};
+			header.magic = magic;
+			header.version = version;
+			header.vertexCount = static_cast<uint32_t>(mesh.vertices.size() / stride);
+			header.vertexStride = stride;
+			header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+			header.attributeCount = attributeCount;
+			header.submeshCount = static_cast<uint32_t>(mesh.submeshes.size());
+			header.bounds = mesh.bounds;
+
+			// A mesh without levels of detail is one level of every index.
+			std::vector<MeshLod> lods = mesh.lods;
+			if (lods.empty()) lods.push_back({ 0, header.indexCount, 0.f, 0, header.submeshCount });
+			header.lodCount = static_cast<uint32_t>(lods.size());
+
+			uint32_t i = 0;
+			for (const BufferElement& element : mesh.layout)
+			{
+				header.attributes[i].dataType = static_cast<uint32_t>(element.m_dataType);
+				header.attributes[i].offset = element.m_offset;
+				header.attributes[i].normalised = element.m_normalised ? 1 : 0;
+				i++;
+			}
+
+			// Narrow the indices now, so loading never has to convert them.
+			std::vector<uint16_t> shortIndices;
+			const void* indexData = mesh.indices.data();
+			uint64_t indexSize = mesh.indices.size() * sizeof(uint32_t);
+			header.indexType = static_cast<uint32_t>(IndexType::UInt32);
+			if (MeshOptimizer::fitsShortIndices(header.vertexCount))
+			{
+				shortIndices = MeshOptimizer::toShortIndices(mesh.indices.data(), header.indexCount);
+				indexData = shortIndices.data();
+				indexSize = shortIndices.size() * sizeof(uint16_t);
+				header.indexType = static_cast<uint32_t>(IndexType::UInt16);
+			}
+
+			uint64_t submeshSize = mesh.submeshes.size() * sizeof(Submesh);
+			uint64_t lodSize = lods.size() * sizeof(MeshLod);
+			header.submeshOffset = align(sizeof(MeshFileHeader));
+			header.lodOffset = align(header.submeshOffset + submeshSize);
+			header.vertexOffset = align(header.lodOffset + lodSize);
+			header.indexOffset = align(header.vertexOffset + mesh.vertices.size());
+			header.fileSize = header.indexOffset + indexSize;
+
+			std::ofstream handle(filepath, std::ios::out | std::ios::binary);
+			if (!handle.is_open()) return false;
+
+			handle.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			padTo(handle, sizeof(header), header.submeshOffset);
+			handle.write(reinterpret_cast<const char*>(mesh.submeshes.data()), static_cast<std::streamsize>(submeshSize));
+			padTo(handle, header.submeshOffset + submeshSize, header.lodOffset);
+			handle.write(reinterpret_cast<const char*>(lods.data()), static_cast<std::streamsize>(lodSize));
+			padTo(handle, header.lodOffset + lodSize, header.vertexOffset);
+			handle.write(reinterpret_cast<const char*>(mesh.vertices.data()), static_cast<std::streamsize>(mesh.vertices.size()));
+			padTo(handle, header.vertexOffset + mesh.vertices.size(), header.indexOffset);
+			handle.write(static_cast<const char*>(indexData), static_cast<std::streamsize>(indexSize));
+
+			return handle.good();
+		}
+
+		std::string cachePath(const std::string& sourcePath)
+		{
+			return AssetCache::cachePath(sourcePath, "meshes", ".gmsh");
+		}
+	}
+
+	bool MeshFileView::open(const uint8_t* data, size_t size, std::string& error)
+	{
+		m_data = nullptr;
+		m_header = nullptr;
+
+		if (!data || size < sizeof(MeshFileHeader))
+		{
+			error = "Mesh file is too small for its header";
+			return false;
+		}
+
+		const MeshFileHeader* header = reinterpret_cast<const MeshFileHeader*>(data);
+		if (header->magic != MeshFile::magic || header->version != MeshFile::version)
+		{
+			error = "Mesh file has the wrong magic or version";
+			return false;
+		}
+
+		uint64_t indexSize = static_cast<uint64_t>(header->indexCount) * (header->indexType == static_cast<uint32_t>(IndexType::UInt16) ? 2 : 4);
+		bool valid = header->fileSize <= size
+			&& header->attributeCount <= s_maxAttributes
+			&& header->indexType <= static_cast<uint32_t>(IndexType::UInt32)
+			&& header->lodCount > 0
+			&& isInside(header->submeshOffset, static_cast<uint64_t>(header->submeshCount) * sizeof(Submesh), size)
+			&& isInside(header->lodOffset, static_cast<uint64_t>(header->lodCount) * sizeof(MeshLod), size)
+			&& isInside(header->vertexOffset, static_cast<uint64_t>(header->vertexCount) * header->vertexStride, size)
+			&& isInside(header->indexOffset, indexSize, size);
+		if (!valid)
+		{
+			error = "Mesh file is truncated or its offsets are corrupt";
+			return false;
+		}
+
+		// Each level is drawn straight from its range, so it must lie within the indices, and its submeshes within it.
+		const MeshLod* lods = reinterpret_cast<const MeshLod*>(data + header->lodOffset);
+		const Submesh* submeshes = reinterpret_cast<const Submesh*>(data + header->submeshOffset);
+		for (uint32_t i = 0; i < header->lodCount; i++)
+		{
+			const MeshLod& lod = lods[i];
+			if (lod.firstIndex > header->indexCount || lod.indexCount > header->indexCount - lod.firstIndex
+				|| lod.firstSubmesh > header->submeshCount || lod.submeshCount > header->submeshCount - lod.firstSubmesh)
+			{
+				error = "Mesh file has a level of detail outside its indices or submeshes";
+				return false;
+			}
+
+			uint32_t lodEnd = lod.firstIndex + lod.indexCount;
+			for (uint32_t s = lod.firstSubmesh; s < lod.firstSubmesh + lod.submeshCount; s++)
+			{
+				const Submesh& submesh = submeshes[s];
+				if (submesh.firstIndex < lod.firstIndex || submesh.firstIndex > lodEnd || submesh.indexCount > lodEnd - submesh.firstIndex)
+				{
+					error = "Mesh file has a submesh outside its level of detail";
+					return false;
+				}
+			}
+		}
+
+		m_data = data;
+		m_header = header;
+		return true;
+	}
+
+	BufferLayout MeshFileView::getLayout() const
+	{
+		std::vector<BufferElement> elements;
+		for (uint32_t i = 0; i < m_header->attributeCount; i++)
+		{
+			const MeshFileAttribute& attribute = m_header->attributes[i];
+			elements.emplace_back(static_cast<ShaderDataType>(attribute.dataType), attribute.normalised != 0, 0, attribute.offset);
+		}
+
+		return BufferLayout(BufferLayoutView(elements.data(), static_cast<uint32_t>(elements.size()), m_header->vertexStride));
+	}
+}
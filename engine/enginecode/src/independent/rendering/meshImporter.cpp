@@ -0,0 +1,285 @@
+#include "engine_pch.h"
+#include "rendering/meshImporter.h"
+#include "rendering/meshOptimizer.h"
+#include "rendering/meshSimplifier.h"
+#include "rendering/vertexPacking.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace Engine
+{
+	namespace
+	{
+		/** @brief One polygon corner, as 0 based indices into the position, UV and normal lists, -1 if absent. */
+		struct Corner
+		{
+			int32_t position = -1;
+			int32_t uv = -1;
+			int32_t normal = -1;
+
+			bool operator<(const Corner& other) const
+			{
+				if (position != other.position) return position < other.position;
+				if (uv != other.uv) return uv < other.uv;
+				return normal < other.normal;
+			}
+		};
+
+		/** @brief Resolve a 1 based, or negative relative, OBJ index against a list's current size. */
+		int32_t resolveIndex(const std::string& token, size_t listSize)
+		{
+			if (token.empty()) return -1;
+
+			int32_t index = std::atoi(token.c_str());
+			if (index < 0) index += static_cast<int32_t>(listSize);
+			else index -= 1;
+			return index >= 0 && static_cast<size_t>(index) < listSize ? index : -2;
+		}
+
+		/** @brief Grow a bounding box to contain a point. */
+		void expand(MeshBounds& bounds, const glm::vec3& point, bool first)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				bounds.min[axis] = first ? point[axis] : std::min(bounds.min[axis], point[axis]);
+				bounds.max[axis] = first ? point[axis] : std::max(bounds.max[axis], point[axis]);
+			}
+		}
+
+		/** @brief Check a cache file exists, is no older than its source and was written in the current format. */
+		bool isCacheFresh(const std::string& cachePath, const std::string& sourcePath)
+		{
+			std::error_code cacheError, sourceError;
+			auto cacheTime = std::filesystem::last_write_time(cachePath, cacheError);
+			auto sourceTime = std::filesystem::last_write_time(sourcePath, sourceError);
+			if (cacheError || sourceError || cacheTime < sourceTime) return false;
+
+			uint32_t start[2] = { 0, 0 };
+			std::ifstream handle(cachePath, std::ios::in | std::ios::binary);
+			handle.read(reinterpret_cast<char*>(start), sizeof(start));
+			return handle.good() && start[0] == MeshFile::magic && start[1] == MeshFile::version;
+		}
+
+		/**
+		* @brief Append coarser levels of detail to a mesh's indices, each simplified from the last to about half its triangles.
+		* Each submesh is simplified on its own, so the borders between them stay closed, and its range in every level is added to the submesh table.
+		* Stops early once a level barely reduces.
+		*/
+		void buildLods(MeshData& mesh, const std::vector<MeshImporter::Vertex>& vertices)
+		{
+			uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+			uint32_t submeshCount = static_cast<uint32_t>(mesh.submeshes.size());
+			mesh.lods = { { 0, static_cast<uint32_t>(mesh.indices.size()), 0.f, 0, submeshCount } };
+
+			std::vector<Submesh> current;
+			std::vector<uint32_t> source, simplified;
+			while (mesh.lods.size() < MeshImporter::maxLods)
+			{
+				const MeshLod& previous = mesh.lods.back();
+				MeshLod lod = { static_cast<uint32_t>(mesh.indices.size()), 0, 0.f, static_cast<uint32_t>(mesh.submeshes.size()), submeshCount };
+				current.assign(mesh.submeshes.begin() + previous.firstSubmesh, mesh.submeshes.begin() + previous.firstSubmesh + submeshCount);
+				simplified.clear();
+				float levelError = 0.f;
+				for (Submesh& submesh : current)
+				{
+					source.assign(mesh.indices.begin() + submesh.firstIndex, mesh.indices.begin() + submesh.firstIndex + submesh.indexCount);
+					uint32_t target = submesh.indexCount / 6 * 3;
+					float error = 0.f;
+
+					submesh.firstIndex = lod.firstIndex + static_cast<uint32_t>(simplified.size());
+					simplified.resize(simplified.size() + submesh.indexCount);
+					submesh.indexCount = MeshSimplifier::simplify(simplified.data() + (submesh.firstIndex - lod.firstIndex), source.data(), submesh.indexCount,
+						&vertices[0].position.x, vertexCount, sizeof(MeshImporter::Vertex), target, FLT_MAX, &error);
+					simplified.resize(submesh.firstIndex - lod.firstIndex + submesh.indexCount);
+
+					MeshOptimizer::optimizeVertexCache(simplified.data() + (submesh.firstIndex - lod.firstIndex), submesh.indexCount, vertexCount);
+					levelError = std::max(levelError, error);
+				}
+
+				// The error is measured against the level simplified from, so the distance from full detail is at most the sum of every step's.
+				lod.error = previous.error + levelError;
+				lod.indexCount = static_cast<uint32_t>(simplified.size());
+				if (lod.indexCount == 0 || lod.indexCount > previous.indexCount * 4 / 5) break;
+
+				mesh.indices.insert(mesh.indices.end(), simplified.begin(), simplified.end());
+				mesh.submeshes.insert(mesh.submeshes.end(), current.begin(), current.end());
+				mesh.lods.push_back(lod);
+			}
+		}
+	}
+
+	namespace MeshImporter
+	{
+		bool importOBJ(const std::string& filepath, MeshData& mesh, std::string& error)
+		{
+			std::ifstream handle(filepath, std::ios::in);
+			if (!handle.is_open())
+			{
+				error = "Could not open model: " + filepath;
+				return false;
+			}
+
+			std::vector<glm::vec3> positions, normals;
+			std::vector<glm::vec2> uvs;
+			std::vector<Corner> corners;
+			std::vector<uint32_t> groupStarts = { 0 };
+
+			std::string line;
+			uint32_t lineNumber = 0;
+			while (getline(handle, line))
+			{
+				lineNumber++;
+				std::istringstream tokens(line);
+				std::string keyword;
+				tokens >> keyword;
+
+				if (keyword == "v") { glm::vec3 p(0.f); tokens >> p.x >> p.y >> p.z; positions.push_back(p); }
+				else if (keyword == "vt") { glm::vec2 uv(0.f); tokens >> uv.x >> uv.y; uvs.push_back(uv); }
+				else if (keyword == "vn") { glm::vec3 n(0.f); tokens >> n.x >> n.y >> n.z; normals.push_back(n); }
+				else if (keyword == "o" || keyword == "g" || keyword == "usemtl")
+				{
+					if (groupStarts.back() != corners.size()) groupStarts.push_back(static_cast<uint32_t>(corners.size()));
+				}
+				else if (keyword == "f")
+				{
+					std::vector<Corner> polygon;
+					std::string vertex;
+					while (tokens >> vertex)
+					{
+						// v, v/vt, v//vn or v/vt/vn
+						std::string parts[3];
+						size_t start = 0;
+						for (int part = 0; part < 3 && start <= vertex.size(); part++)
+						{
+							size_t slash = vertex.find('/', start);
+							parts[part] = vertex.substr(start, slash == std::string::npos ? std::string::npos : slash - start);
+							if (slash == std::string::npos) break;
+							start = slash + 1;
+						}
+
+						Corner corner;
+						corner.position = resolveIndex(parts[0], positions.size());
+						corner.uv = resolveIndex(parts[1], uvs.size());
+						corner.normal = resolveIndex(parts[2], normals.size());
+						if (corner.position < 0 || corner.uv == -2 || corner.normal == -2)
+						{
+							error = filepath + ":" + std::to_string(lineNumber) + ": face index out of range";
+							return false;
+						}
+						polygon.push_back(corner);
+					}
+
+					for (size_t i = 2; i < polygon.size(); i++) corners.insert(corners.end(), { polygon[0], polygon[i - 1], polygon[i] });
+				}
+			}
+
+			if (corners.empty())
+			{
+				error = "Model has no faces: " + filepath;
+				return false;
+			}
+
+			// Smooth normals for corners which do not give one, weighted by face area through the unnormalised cross product.
+			std::vector<glm::vec3> smoothNormals(positions.size(), glm::vec3(0.f));
+			for (size_t i = 0; i < corners.size(); i += 3)
+			{
+				glm::vec3 p0 = positions[corners[i].position], p1 = positions[corners[i + 1].position], p2 = positions[corners[i + 2].position];
+				glm::vec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+				for (size_t c = 0; c < 3; c++) smoothNormals[corners[i + c].position] += faceNormal;
+			}
+
+			// Corners sharing a position, UV and normal become one vertex.
+			std::map<Corner, uint32_t> vertexIndices;
+			std::vector<Vertex> vertices;
+			mesh.indices.clear();
+			mesh.indices.reserve(corners.size());
+			for (const Corner& corner : corners)
+			{
+				auto it = vertexIndices.find(corner);
+				if (it == vertexIndices.end())
+				{
+					glm::vec3 normal = corner.normal >= 0 ? normals[corner.normal] : smoothNormals[corner.position];
+					if (glm::dot(normal, normal) > 0.f) normal = glm::normalize(normal);
+					glm::vec2 uv = corner.uv >= 0 ? uvs[corner.uv] : glm::vec2(0.f);
+
+					Vertex vertex;
+					vertex.position = positions[corner.position];
+					vertex.normal = VertexPacking::packOct16(normal);
+					vertex.uv = VertexPacking::packHalf2(glm::vec2(uv.x, 1.f - uv.y));
+
+					it = vertexIndices.emplace(corner, static_cast<uint32_t>(vertices.size())).first;
+					vertices.push_back(vertex);
+				}
+				mesh.indices.push_back(it->second);
+			}
+
+			// Optimise each submesh's triangles within its own range, so submeshes stay contiguous.
+			uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+			groupStarts.push_back(static_cast<uint32_t>(corners.size()));
+			mesh.submeshes.clear();
+			for (size_t g = 0; g + 1 < groupStarts.size(); g++)
+			{
+				Submesh submesh;
+				submesh.firstIndex = groupStarts[g];
+				submesh.indexCount = groupStarts[g + 1] - groupStarts[g];
+				if (submesh.indexCount == 0) continue;
+
+				uint32_t* indices = mesh.indices.data() + submesh.firstIndex;
+				MeshOptimizer::optimizeVertexCache(indices, submesh.indexCount, vertexCount);
+				MeshOptimizer::optimizeOverdraw(indices, submesh.indexCount, &vertices[0].position.x, vertexCount, sizeof(Vertex));
+				mesh.submeshes.push_back(submesh);
+			}
+
+			// Every level indexes the same vertices, which are then ordered by their first use at full detail.
+			buildLods(mesh, vertices);
+			vertexCount = MeshOptimizer::optimizeVertexFetch(vertices.data(), vertexCount, sizeof(Vertex), mesh.indices.data(), static_cast<uint32_t>(mesh.indices.size()));
+			vertices.resize(vertexCount);
+
+			for (Submesh& submesh : mesh.submeshes)
+			{
+				for (uint32_t i = 0; i < submesh.indexCount; i++) expand(submesh.bounds, vertices[mesh.indices[submesh.firstIndex + i]].position, i == 0);
+			}
+			for (uint32_t v = 0; v < vertexCount; v++) expand(mesh.bounds, vertices[v].position, v == 0);
+
+			mesh.layout = BufferLayout(Vertex::Layout::view());
+			mesh.vertices.resize(vertices.size() * sizeof(Vertex));
+			memcpy(mesh.vertices.data(), vertices.data(), mesh.vertices.size());
+			return true;
+		}
+
+		std::string convert(const std::string& sourcePath, std::string& error)
+		{
+			std::string extension = std::filesystem::path(sourcePath).extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+			if (extension == ".gmsh") return sourcePath;
+
+			std::string cachePath = MeshFile::cachePath(sourcePath);
+			if (isCacheFresh(cachePath, sourcePath)) return cachePath;
+
+			MeshData mesh;
+			if (extension == ".obj")
+			{
+				if (!importOBJ(sourcePath, mesh, error)) return std::string();
+			}
+			else
+			{
+				error = "No importer for model " + sourcePath;
+				return std::string();
+			}
+
+			std::error_code directoryError;
+			std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), directoryError);
+			if (!MeshFile::write(cachePath, mesh))
+			{
+				error = "Could not write mesh cache " + cachePath;
+				return std::string();
+			}
+
+			return cachePath;
+		}
+	}
+}
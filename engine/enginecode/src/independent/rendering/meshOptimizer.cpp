@@ -0,0 +1,283 @@
+#include "engine_pch.h"
+#include "rendering/meshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace Engine
+{
+	namespace
+	{
+		/** @brief Triangles using each vertex, as offsets into one shared list. */
+		struct Adjacency
+		{
+			std::vector<uint32_t> offsets; /**< Start of each vertex's triangles, with one extra entry for the end. */
+			std::vector<uint32_t> triangles; /**< Triangle indices, grouped by vertex. */
+		};
+
+		/** @brief Build the triangles using each vertex. */
+		Adjacency buildAdjacency(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount)
+		{
+			Adjacency adjacency;
+			adjacency.offsets.assign(vertexCount + 1, 0);
+			for (uint32_t i = 0; i < indexCount; i++) adjacency.offsets[indices[i] + 1]++;
+			for (uint32_t v = 0; v < vertexCount; v++) adjacency.offsets[v + 1] += adjacency.offsets[v];
+
+			std::vector<uint32_t> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+			adjacency.triangles.resize(indexCount);
+			for (uint32_t i = 0; i < indexCount; i++) adjacency.triangles[fill[indices[i]]++] = i / 3;
+
+			return adjacency;
+		}
+
+		/**
+		* @brief Pick the vertex to fan around next, preferring the one whose triangles will stay in cache longest.
+		* Falls back to recently used vertices and then to any vertex with triangles left.
+		*/
+		int64_t nextVertex(const std::vector<uint32_t>& candidates, const std::vector<uint32_t>& live, const std::vector<uint32_t>& cacheTime,
+			uint32_t timestamp, uint32_t cacheSize, std::vector<uint32_t>& deadEnd, uint32_t& cursor)
+		{
+			int64_t best = -1;
+			int64_t bestPriority = -1;
+			for (uint32_t v : candidates)
+			{
+				if (live[v] == 0) continue;
+
+				// A vertex still cached after emitting all its triangles scores by age, otherwise it scores zero.
+				int64_t priority = 0;
+				if (timestamp - cacheTime[v] + 2 * live[v] <= cacheSize) priority = timestamp - cacheTime[v];
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					best = v;
+				}
+			}
+			if (best >= 0) return best;
+
+			while (!deadEnd.empty())
+			{
+				uint32_t v = deadEnd.back();
+				deadEnd.pop_back();
+				if (live[v] > 0) return v;
+			}
+
+			while (cursor < live.size())
+			{
+				if (live[cursor] > 0) return cursor;
+				cursor++;
+			}
+
+			return -1;
+		}
+	}
+
+	namespace MeshOptimizer
+	{
+		float cacheMissRatio(const uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+		{
+			if (indexCount < 3) return 0.f;
+
+			// A vertex is cached while fewer than cacheSize misses have happened since it was loaded.
+			std::vector<uint32_t> cacheTime(vertexCount, 0);
+			uint32_t timestamp = cacheSize + 1;
+			uint32_t misses = 0;
+			for (uint32_t i = 0; i < indexCount; i++)
+			{
+				uint32_t v = indices[i];
+				if (timestamp - cacheTime[v] > cacheSize)
+				{
+					cacheTime[v] = timestamp++;
+					misses++;
+				}
+			}
+
+			return static_cast<float>(misses) / (indexCount / 3);
+		}
+
+		void optimizeVertexCache(uint32_t* indices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+		{
+			uint32_t triangleCount = indexCount / 3;
+			if (triangleCount == 0) return;
+
+			Adjacency adjacency = buildAdjacency(indices, indexCount, vertexCount);
+
+			std::vector<uint32_t> live(vertexCount);
+			for (uint32_t v = 0; v < vertexCount; v++) live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+			std::vector<uint32_t> cacheTime(vertexCount, 0);
+			std::vector<bool> emitted(triangleCount, false);
+			std::vector<uint32_t> deadEnd, candidates;
+			std::vector<uint32_t> output;
+			output.reserve(indexCount);
+
+			uint32_t timestamp = cacheSize + 1;
+			uint32_t cursor = 0;
+			int64_t fan = nextVertex(candidates, live, cacheTime, timestamp, cacheSize, deadEnd, cursor);
+
+			// Emit every remaining triangle around the fanning vertex, then move to the best vertex they touched.
+			while (fan >= 0)
+			{
+				candidates.clear();
+				for (uint32_t i = adjacency.offsets[fan]; i < adjacency.offsets[fan + 1]; i++)
+				{
+					uint32_t triangle = adjacency.triangles[i];
+					if (emitted[triangle]) continue;
+
+					for (uint32_t corner = 0; corner < 3; corner++)
+					{
+						uint32_t v = indices[triangle * 3 + corner];
+						output.push_back(v);
+						deadEnd.push_back(v);
+						candidates.push_back(v);
+						live[v]--;
+						if (timestamp - cacheTime[v] > cacheSize) cacheTime[v] = timestamp++;
+					}
+					emitted[triangle] = true;
+				}
+
+				fan = nextVertex(candidates, live, cacheTime, timestamp, cacheSize, deadEnd, cursor);
+			}
+
+			memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+		}
+
+		void optimizeOverdraw(uint32_t* indices, uint32_t indexCount, const float* positions, uint32_t vertexCount, uint32_t positionStride, float threshold, uint32_t cacheSize)
+		{
+			uint32_t triangleCount = indexCount / 3;
+			if (triangleCount < 2) return;
+
+			// Each cluster is simulated from an empty cache, so drawing clusters in any order keeps the miss ratio close to the threshold.
+			float targetRatio = cacheMissRatio(indices, indexCount, vertexCount, cacheSize) * threshold;
+			std::vector<uint32_t> clusters = { 0 };
+
+			std::vector<uint32_t> cacheTime(vertexCount, 0);
+			uint32_t timestamp = cacheSize + 1;
+			uint32_t clusterMisses = 0;
+			for (uint32_t triangle = 0; triangle < triangleCount; triangle++)
+			{
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					uint32_t v = indices[triangle * 3 + corner];
+					if (timestamp - cacheTime[v] > cacheSize)
+					{
+						cacheTime[v] = timestamp++;
+						clusterMisses++;
+					}
+				}
+
+				// Close the cluster as soon as it is as cheap as the whole mesh, then empty the cache for the next one.
+				uint32_t clusterTriangles = triangle + 1 - clusters.back();
+				if (triangle + 1 < triangleCount && static_cast<float>(clusterMisses) / clusterTriangles <= targetRatio)
+				{
+					clusters.push_back(triangle + 1);
+					clusterMisses = 0;
+					timestamp += cacheSize + 1;
+				}
+			}
+			clusters.push_back(triangleCount);
+
+			// The last cluster closes wherever the mesh ends, so it joins the one before, which then starts it on a warm cache.
+			if (clusters.size() > 2 && static_cast<float>(clusterMisses) / (triangleCount - clusters[clusters.size() - 2]) > targetRatio) clusters.erase(clusters.end() - 2);
+
+			auto position = [&](uint32_t v)
+			{
+				return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) + static_cast<size_t>(v) * positionStride);
+			};
+
+			// Area weighted centroid and normal of each cluster, and the centroid of the whole mesh.
+			uint32_t clusterCount = static_cast<uint32_t>(clusters.size()) - 1;
+			std::vector<float> centroids(clusterCount * 3, 0.f), normals(clusterCount * 3, 0.f);
+			float meshCentroid[3] = { 0.f, 0.f, 0.f };
+			float meshArea = 0.f;
+
+			for (uint32_t c = 0; c < clusterCount; c++)
+			{
+				float area = 0.f;
+				for (uint32_t triangle = clusters[c]; triangle < clusters[c + 1]; triangle++)
+				{
+					const float* p0 = position(indices[triangle * 3]);
+					const float* p1 = position(indices[triangle * 3 + 1]);
+					const float* p2 = position(indices[triangle * 3 + 2]);
+
+					float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+					float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+					float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+					float triangleArea = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+					for (uint32_t axis = 0; axis < 3; axis++)
+					{
+						centroids[c * 3 + axis] += (p0[axis] + p1[axis] + p2[axis]) / 3.f * triangleArea;
+						normals[c * 3 + axis] += n[axis];
+						meshCentroid[axis] += (p0[axis] + p1[axis] + p2[axis]) / 3.f * triangleArea;
+					}
+					area += triangleArea;
+				}
+
+				if (area > 0.f) for (uint32_t axis = 0; axis < 3; axis++) centroids[c * 3 + axis] /= area;
+				meshArea += area;
+			}
+			if (meshArea > 0.f) for (uint32_t axis = 0; axis < 3; axis++) meshCentroid[axis] /= meshArea;
+
+			// Clusters further out along their own normal are more likely to occlude, so they draw first.
+			std::vector<float> sortKeys(clusterCount);
+			for (uint32_t c = 0; c < clusterCount; c++)
+			{
+				float key = 0.f;
+				for (uint32_t axis = 0; axis < 3; axis++) key += (centroids[c * 3 + axis] - meshCentroid[axis]) * normals[c * 3 + axis];
+				sortKeys[c] = key;
+			}
+
+			std::vector<uint32_t> order(clusterCount);
+			std::iota(order.begin(), order.end(), 0);
+			std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+			std::vector<uint32_t> output;
+			output.reserve(indexCount);
+			for (uint32_t c : order) output.insert(output.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+
+			// A cluster starting on a warm cache can still miss more than it did from an empty one. Keep the input order rather than break the threshold.
+			if (cacheMissRatio(output.data(), indexCount, vertexCount, cacheSize) > targetRatio) return;
+
+			memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+		}
+
+		uint32_t optimizeVertexFetch(void* vertices, uint32_t vertexCount, uint32_t vertexSize, uint32_t* indices, uint32_t indexCount)
+		{
+			// Number vertices in the order they are first used, so the index stream walks the vertex buffer forwards.
+			const uint32_t unused = ~0u;
+			std::vector<uint32_t> remap(vertexCount, unused);
+			uint32_t next = 0;
+			for (uint32_t i = 0; i < indexCount; i++)
+			{
+				uint32_t& target = remap[indices[i]];
+				if (target == unused) target = next++;
+				indices[i] = target;
+			}
+
+			uint8_t* data = static_cast<uint8_t*>(vertices);
+			std::vector<uint8_t> reordered(static_cast<size_t>(next) * vertexSize);
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				if (remap[v] != unused) memcpy(reordered.data() + static_cast<size_t>(remap[v]) * vertexSize, data + static_cast<size_t>(v) * vertexSize, vertexSize);
+			}
+
+			memcpy(data, reordered.data(), reordered.size());
+			return next;
+		}
+
+		uint32_t optimize(void* vertices, uint32_t vertexCount, uint32_t vertexSize, uint32_t* indices, uint32_t indexCount)
+		{
+			optimizeVertexCache(indices, indexCount, vertexCount);
+			optimizeOverdraw(indices, indexCount, static_cast<const float*>(vertices), vertexCount, vertexSize);
+			return optimizeVertexFetch(vertices, vertexCount, vertexSize, indices, indexCount);
+		}
+
+		std::vector<uint16_t> toShortIndices(const uint32_t* indices, uint32_t indexCount)
+		{
+			std::vector<uint16_t> shortIndices(indexCount);
+			for (uint32_t i = 0; i < indexCount; i++) shortIndices[i] = static_cast<uint16_t>(indices[i]);
+			return shortIndices;
+		}
+	}
+}
@@ -0,0 +1,227 @@
+#include "engine_pch.h"
+#include "rendering/meshSimplifier.h"
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Engine
+{
+	namespace
+	{
+		/** @brief A weighted sum of squared distances to a set of planes, as the upper triangle of a symmetric 4x4 matrix. */
+		struct Quadric
+		{
+			double a2 = 0.0, b2 = 0.0, c2 = 0.0, ab = 0.0, ac = 0.0, bc = 0.0, ad = 0.0, bd = 0.0, cd = 0.0, d2 = 0.0;
+			double weight = 0.0; /**< Total weight of the planes. */
+
+			/** @brief Add the plane dot(normal, p) + d = 0, with a unit normal. */
+			void addPlane(const glm::vec3& normal, float d, float planeWeight)
+			{
+				double a = normal.x, b = normal.y, c = normal.z, w = planeWeight;
+				a2 += w * a * a; b2 += w * b * b; c2 += w * c * c;
+				ab += w * a * b; ac += w * a * c; bc += w * b * c;
+				ad += w * a * d; bd += w * b * d; cd += w * c * d;
+				d2 += w * d * d;
+				weight += w;
+			}
+
+			void add(const Quadric& other)
+			{
+				a2 += other.a2; b2 += other.b2; c2 += other.c2;
+				ab += other.ab; ac += other.ac; bc += other.bc;
+				ad += other.ad; bd += other.bd; cd += other.cd;
+				d2 += other.d2;
+				weight += other.weight;
+			}
+
+			/** @brief The weighted mean squared distance from a point to the planes. */
+			double evaluate(const glm::vec3& p) const
+			{
+				if (weight <= 0.0) return 0.0;
+				double x = p.x, y = p.y, z = p.z;
+				double error = a2 * x * x + b2 * y * y + c2 * z * z + 2.0 * (ab * x * y + ac * x * z + bc * y * z + ad * x + bd * y + cd * z) + d2;
+				return std::max(error / weight, 0.0);
+			}
+		};
+
+		/** @brief Moving one vertex onto another, named by vertex index. */
+		struct Collapse
+		{
+			uint32_t from; /**< The vertex removed. */
+			uint32_t to; /**< The vertex it merges into. */
+			double cost; /**< The quadric error at the merged position. */
+		};
+
+		/** @brief Read a vertex's position. */
+		inline glm::vec3 getPosition(const float* positions, uint32_t stride, uint32_t vertex)
+		{
+			const float* p = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) + static_cast<size_t>(vertex) * stride);
+			return glm::vec3(p[0], p[1], p[2]);
+		}
+
+		/** @brief Key of an undirected edge. */
+		inline uint64_t edgeKey(uint32_t a, uint32_t b)
+		{
+			return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+		}
+	}
+
+	namespace MeshSimplifier
+	{
+		uint32_t simplify(uint32_t* destination, const uint32_t* indices, uint32_t indexCount, const float* positions, uint32_t vertexCount, uint32_t positionStride,
+			uint32_t targetIndexCount, float maxError, float* resultError)
+		{
+			std::vector<uint32_t> result(indices, indices + indexCount);
+			auto position = [&](uint32_t vertex) { return getPosition(positions, positionStride, vertex); };
+
+			// Vertices at the same position are one point of the surface, whatever their attributes.
+			std::vector<uint32_t> point(vertexCount);
+			std::map<std::array<float, 3>, uint32_t> pointAt;
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				glm::vec3 p = position(v);
+				point[v] = pointAt.emplace(std::array<float, 3>{ p.x, p.y, p.z }, v).first->second;
+			}
+
+			// Lock seams, where a point has several used vertices, and points on edges without exactly two triangles.
+			std::vector<uint8_t> locked(vertexCount, 0);
+			std::vector<uint32_t> firstVertex(vertexCount, UINT32_MAX);
+			std::unordered_map<uint64_t, uint32_t> edgeUses;
+			for (uint32_t i = 0; i < indexCount; i++)
+			{
+				uint32_t v = result[i];
+				if (firstVertex[point[v]] == UINT32_MAX) firstVertex[point[v]] = v;
+				else if (firstVertex[point[v]] != v) locked[point[v]] = 1;
+
+				uint32_t next = result[i - i % 3 + (i + 1) % 3];
+				edgeUses[edgeKey(point[v], point[next])]++;
+			}
+			for (const auto& [key, uses] : edgeUses)
+			{
+				if (uses == 2) continue;
+				locked[static_cast<uint32_t>(key >> 32)] = 1;
+				locked[static_cast<uint32_t>(key & 0xFFFFFFFF)] = 1;
+			}
+
+			// Each point starts with the planes of the triangles around it, weighted by area so small slivers count for little.
+			std::vector<Quadric> quadrics(vertexCount);
+			for (uint32_t i = 0; i < indexCount; i += 3)
+			{
+				glm::vec3 p0 = position(result[i]), p1 = position(result[i + 1]), p2 = position(result[i + 2]);
+				glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+				float length = glm::length(normal);
+				if (length <= 0.f) continue;
+
+				normal = normal / length;
+				for (uint32_t c = 0; c < 3; c++) quadrics[point[result[i + c]]].addPlane(normal, -glm::dot(normal, p0), 0.5f * length);
+			}
+
+			double maxCost = static_cast<double>(maxError) * maxError;
+			double worstCost = 0.0;
+			uint32_t count = indexCount;
+			std::vector<uint32_t> collapseTo(vertexCount);
+			std::vector<uint8_t> touched(vertexCount);
+			std::vector<uint32_t> offsets, triangles;
+			std::vector<Collapse> candidates;
+
+			// Each pass collapses the cheapest edges whose neighbourhoods do not overlap, then rewrites the triangle list.
+			while (count > targetIndexCount)
+			{
+				offsets.assign(vertexCount + 1, 0);
+				for (uint32_t i = 0; i < count; i++) offsets[point[result[i]] + 1]++;
+				for (uint32_t v = 0; v < vertexCount; v++) offsets[v + 1] += offsets[v];
+				std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+				triangles.resize(count);
+				for (uint32_t i = 0; i < count; i++) triangles[fill[point[result[i]]]++] = i / 3;
+
+				// The cheaper direction of each edge, found from the one triangle that lists its points in increasing order.
+				candidates.clear();
+				for (uint32_t i = 0; i < count; i++)
+				{
+					uint32_t a = result[i], b = result[i - i % 3 + (i + 1) % 3];
+					if (point[a] >= point[b] || (locked[point[a]] && locked[point[b]])) continue;
+
+					Quadric merged = quadrics[point[a]];
+					merged.add(quadrics[point[b]]);
+					Collapse towardsB = { a, b, locked[point[a]] ? DBL_MAX : merged.evaluate(position(b)) };
+					Collapse towardsA = { b, a, locked[point[b]] ? DBL_MAX : merged.evaluate(position(a)) };
+					candidates.push_back(towardsB.cost <= towardsA.cost ? towardsB : towardsA);
+				}
+				std::sort(candidates.begin(), candidates.end(), [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+				// An interior collapse removes two triangles.
+				uint32_t triangleCount = count / 3, targetTriangles = targetIndexCount / 3;
+				uint32_t allowed = std::max((triangleCount - targetTriangles + 1) / 2, 1u);
+
+				// Many candidates are skipped for sharing a neighbourhood, so rather than reaching far down the list for the rest,
+				// stop a little past the cost of the last collapse the pass would ideally make and leave them to later passes.
+				double passCost = maxCost;
+				if (allowed < candidates.size()) passCost = std::min(passCost, 1.5 * candidates[allowed].cost);
+				for (uint32_t v = 0; v < vertexCount; v++) collapseTo[v] = v;
+				std::fill(touched.begin(), touched.end(), 0);
+
+				uint32_t collapses = 0;
+				for (const Collapse& collapse : candidates)
+				{
+					if (collapse.cost > passCost) break;
+					uint32_t from = point[collapse.from], to = point[collapse.to];
+					if (touched[from] || touched[to]) continue;
+
+					// Reject collapses which would turn a surviving triangle over.
+					glm::vec3 target = position(collapse.to);
+					bool flips = false;
+					for (uint32_t t = offsets[from]; t < offsets[from + 1] && !flips; t++)
+					{
+						const uint32_t* corners = &result[triangles[t] * 3];
+						glm::vec3 before[3], after[3];
+						bool survives = true;
+						for (uint32_t c = 0; c < 3; c++)
+						{
+							survives &= point[corners[c]] != to;
+							before[c] = position(corners[c]);
+							after[c] = point[corners[c]] == from ? target : before[c];
+						}
+						if (!survives) continue;
+
+						glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+						glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+						flips = glm::dot(normalBefore, normalAfter) <= 0.f;
+					}
+					if (flips) continue;
+
+					// An unlocked point has one vertex, so redirecting it moves the whole point.
+					collapseTo[collapse.from] = collapse.to;
+					quadrics[to].add(quadrics[from]);
+					for (uint32_t t = offsets[from]; t < offsets[from + 1]; t++)
+					{
+						for (uint32_t c = 0; c < 3; c++) touched[point[result[triangles[t] * 3 + c]]] = 1;
+					}
+
+					worstCost = std::max(worstCost, collapse.cost);
+					if (++collapses >= allowed) break;
+				}
+				if (collapses == 0) break;
+
+				uint32_t written = 0;
+				for (uint32_t i = 0; i < count; i += 3)
+				{
+					uint32_t v0 = collapseTo[result[i]], v1 = collapseTo[result[i + 1]], v2 = collapseTo[result[i + 2]];
+					if (point[v0] == point[v1] || point[v1] == point[v2] || point[v2] == point[v0]) continue;
+					result[written++] = v0;
+					result[written++] = v1;
+					result[written++] = v2;
+				}
+				count = written;
+			}
+
+			std::copy(result.begin(), result.begin() + count, destination);
+			if (resultError) *resultError = static_cast<float>(std::sqrt(worstCost));
+			return count;
+		}
+	}
+}
@@ -0,0 +1,307 @@
+#include "engine_pch.h"
+#include "rendering/occlusionCulling.h"
+#include "systems/workerPool.h"
+#include <algorithm>
+#include <cmath>
+
+// SSE2 is part of every x64 target.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define NG_OCCLUSION_SSE 1
+#endif
+
+namespace Engine
+{
+	namespace
+	{
+		const float minimumW = 1e-4f; /**< Vertices closer to the plane of the camera than this are not projected. */
+		const float depthBias = 1e-6f; /**< How far behind an occluder a box must be to be hidden, so an occluder never hides its own box. */
+
+		/** @brief Round up to a whole number of tiles. */
+		inline uint32_t roundToTiles(uint32_t pixels)
+		{
+			return std::max((pixels + OcclusionBuffer::tileSize - 1) / OcclusionBuffer::tileSize, 1u) * OcclusionBuffer::tileSize;
+		}
+	}
+
+	OccluderMesh OccluderMesh::box(const glm::vec3& min, const glm::vec3& max)
+	{
+		OccluderMesh mesh;
+		for (uint32_t corner = 0; corner < 8; corner++)
+		{
+			mesh.positions.push_back(glm::vec3(corner & 1 ? max.x : min.x, corner & 2 ? max.y : min.y, corner & 4 ? max.z : min.z));
+		}
+
+		// Two triangles for each face, -x, +x, -y, +y, -z, +z.
+		mesh.indices = {
+			0, 4, 6, 0, 6, 2,
+			1, 3, 7, 1, 7, 5,
+			0, 1, 5, 0, 5, 4,
+			2, 6, 7, 2, 7, 3,
+			0, 2, 3, 0, 3, 1,
+			4, 5, 7, 4, 7, 6
+		};
+		return mesh;
+	}
+
+	OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height) :
+		m_width(roundToTiles(width)),
+		m_height(roundToTiles(height)),
+		m_viewProjection(1.f)
+	{
+		m_tilesX = m_width / tileSize;
+		m_tilesY = m_height / tileSize;
+
+		m_depth.assign(m_width * m_height, 1.f);
+		m_blockMin.assign((m_width / blockSize) * (m_height / blockSize), 1.f);
+		m_blockMax.assign(m_blockMin.size(), 1.f);
+		m_tileMin.assign(m_tilesX * m_tilesY, 1.f);
+		m_tileMax.assign(m_tileMin.size(), 1.f);
+		m_bins.resize(m_tileMin.size());
+	}
+
+	void OcclusionBuffer::begin(const glm::mat4& viewProjection)
+	{
+		m_viewProjection = viewProjection;
+		m_triangles.clear();
+		for (std::vector<uint32_t>& bin : m_bins) bin.clear();
+	}
+
+	void OcclusionBuffer::addOccluder(const glm::mat4& world, const OccluderMesh& mesh)
+	{
+		glm::mat4 toClip = m_viewProjection * world;
+		m_clipPositions.resize(mesh.positions.size());
+		for (size_t i = 0; i < mesh.positions.size(); i++) m_clipPositions[i] = toClip * glm::vec4(mesh.positions[i], 1.f);
+
+		for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+		{
+			float x[3], y[3], z[3];
+			bool projected = true;
+			for (uint32_t v = 0; v < 3; v++)
+			{
+				const glm::vec4& clip = m_clipPositions[mesh.indices[i + v]];
+				if (clip.w < minimumW) { projected = false; break; }
+				x[v] = (clip.x / clip.w * 0.5f + 0.5f) * m_width;
+				y[v] = (clip.y / clip.w * 0.5f + 0.5f) * m_height;
+				z[v] = clip.z / clip.w * 0.5f + 0.5f;
+			}
+			if (!projected) continue;
+
+			// Both faces are rasterized, so wind every triangle the same way to keep its edge functions positive inside.
+			float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+			if (std::abs(area) < 1e-6f) continue;
+			if (area < 0.f)
+			{
+				std::swap(x[1], x[2]); std::swap(y[1], y[2]); std::swap(z[1], z[2]);
+				area = -area;
+			}
+
+			// The pixels whose centres lie within the triangle's bounds.
+			Triangle triangle;
+			triangle.minX = std::max(static_cast<int32_t>(std::ceil(std::min({ x[0], x[1], x[2] }) - 0.5f)), 0);
+			triangle.minY = std::max(static_cast<int32_t>(std::ceil(std::min({ y[0], y[1], y[2] }) - 0.5f)), 0);
+			triangle.maxX = std::min(static_cast<int32_t>(std::floor(std::max({ x[0], x[1], x[2] }) - 0.5f)), static_cast<int32_t>(m_width) - 1);
+			triangle.maxY = std::min(static_cast<int32_t>(std::floor(std::max({ y[0], y[1], y[2] }) - 0.5f)), static_cast<int32_t>(m_height) - 1);
+			if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) continue;
+
+			for (uint32_t edge = 0; edge < 3; edge++)
+			{
+				uint32_t a = edge, b = (edge + 1) % 3;
+				triangle.edgeA[edge] = y[a] - y[b];
+				triangle.edgeB[edge] = x[b] - x[a];
+				triangle.edgeC[edge] = x[a] * y[b] - x[b] * y[a];
+			}
+
+			// Window depth is linear in screen space, so one plane gives the depth of every pixel.
+			triangle.depthX = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+			triangle.depthY = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+			triangle.depth = z[0] - triangle.depthX * x[0] - triangle.depthY * y[0];
+
+			uint32_t index = static_cast<uint32_t>(m_triangles.size());
+			m_triangles.push_back(triangle);
+			for (int32_t ty = triangle.minY / static_cast<int32_t>(tileSize); ty <= triangle.maxY / static_cast<int32_t>(tileSize); ty++)
+			{
+				for (int32_t tx = triangle.minX / static_cast<int32_t>(tileSize); tx <= triangle.maxX / static_cast<int32_t>(tileSize); tx++)
+				{
+					m_bins[ty * m_tilesX + tx].push_back(index);
+				}
+			}
+		}
+	}
+
+	void OcclusionBuffer::rasterize(WorkerPool* workers)
+	{
+		uint32_t tileCount = m_tilesX * m_tilesY;
+		if (!workers)
+		{
+			for (uint32_t tile = 0; tile < tileCount; tile++) rasterizeTile(tile);
+			return;
+		}
+
+		// Tiles share no pixels, so each can be rasterized by any worker.
+		workers->parallelFor(tileCount, 1, [this](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t tile = begin; tile < end; tile++) rasterizeTile(tile);
+		});
+	}
+
+	void OcclusionBuffer::rasterizeTile(uint32_t tile)
+	{
+		int32_t tileX = static_cast<int32_t>((tile % m_tilesX) * tileSize);
+		int32_t tileY = static_cast<int32_t>((tile / m_tilesX) * tileSize);
+
+		for (int32_t y = tileY; y < tileY + static_cast<int32_t>(tileSize); y++)
+		{
+			std::fill_n(m_depth.begin() + y * m_width + tileX, tileSize, 1.f);
+		}
+
+		for (uint32_t index : m_bins[tile])
+		{
+			const Triangle& triangle = m_triangles[index];
+			// Starting on a multiple of four keeps every group of pixels within the tile.
+			int32_t startX = std::max(triangle.minX, tileX) & ~3;
+			int32_t endX = std::min(triangle.maxX, tileX + static_cast<int32_t>(tileSize) - 1);
+			int32_t startY = std::max(triangle.minY, tileY);
+			int32_t endY = std::min(triangle.maxY, tileY + static_cast<int32_t>(tileSize) - 1);
+
+			for (int32_t y = startY; y <= endY; y++)
+			{
+				float* row = m_depth.data() + y * m_width;
+				float centreY = static_cast<float>(y) + 0.5f;
+				float rowEdge[3];
+				for (uint32_t edge = 0; edge < 3; edge++) rowEdge[edge] = triangle.edgeB[edge] * centreY + triangle.edgeC[edge];
+				float rowDepth = triangle.depth + triangle.depthY * centreY;
+
+				int32_t x = startX;
+#if defined(NG_OCCLUSION_SSE)
+				const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+				const __m128 zero = _mm_setzero_ps();
+				for (; x <= endX; x += 4)
+				{
+					__m128 centreX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+					__m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edgeA[0]), centreX), _mm_set1_ps(rowEdge[0]));
+					__m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edgeA[1]), centreX), _mm_set1_ps(rowEdge[1]));
+					__m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edgeA[2]), centreX), _mm_set1_ps(rowEdge[2]));
+					__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+					__m128 depth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.depthX), centreX), _mm_set1_ps(rowDepth));
+					__m128 current = _mm_loadu_ps(row + x);
+					__m128 nearest = _mm_min_ps(current, depth);
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+				}
+#endif
+				for (; x <= endX; x++)
+				{
+					float centreX = static_cast<float>(x) + 0.5f;
+					bool inside = true;
+					for (uint32_t edge = 0; edge < 3; edge++) inside &= triangle.edgeA[edge] * centreX + rowEdge[edge] >= 0.f;
+					if (inside) row[x] = std::min(row[x], triangle.depthX * centreX + rowDepth);
+				}
+			}
+		}
+
+		// Reduce the tile's pixels to the depth range of each block, and those to the range of the tile.
+		uint32_t blocksX = m_width / blockSize;
+		float tileMin = 1.f, tileMax = 0.f;
+		for (int32_t blockY = tileY; blockY < tileY + static_cast<int32_t>(tileSize); blockY += blockSize)
+		{
+			for (int32_t blockX = tileX; blockX < tileX + static_cast<int32_t>(tileSize); blockX += blockSize)
+			{
+				float blockMin = 1.f, blockMax = 0.f;
+				for (int32_t y = blockY; y < blockY + static_cast<int32_t>(blockSize); y++)
+				{
+					const float* row = m_depth.data() + y * m_width + blockX;
+					for (uint32_t x = 0; x < blockSize; x++)
+					{
+						blockMin = std::min(blockMin, row[x]);
+						blockMax = std::max(blockMax, row[x]);
+					}
+				}
+
+				uint32_t block = (blockY / blockSize) * blocksX + blockX / blockSize;
+				m_blockMin[block] = blockMin;
+				m_blockMax[block] = blockMax;
+				tileMin = std::min(tileMin, blockMin);
+				tileMax = std::max(tileMax, blockMax);
+			}
+		}
+		m_tileMin[tile] = tileMin;
+		m_tileMax[tile] = tileMax;
+	}
+
+	bool OcclusionBuffer::isVisible(const glm::vec3& centre, const glm::vec3& extent) const
+	{
+		// The box's screen rectangle and nearest depth, from its corners.
+		float minX = static_cast<float>(m_width), minY = static_cast<float>(m_height), maxX = 0.f, maxY = 0.f;
+		float nearest = 1.f;
+		for (uint32_t corner = 0; corner < 8; corner++)
+		{
+			glm::vec3 offset(corner & 1 ? extent.x : -extent.x, corner & 2 ? extent.y : -extent.y, corner & 4 ? extent.z : -extent.z);
+			glm::vec4 clip = m_viewProjection * glm::vec4(centre + offset, 1.f);
+			// A box reaching past the near plane or behind the camera is in front of everything.
+			if (clip.w < minimumW || clip.z < -clip.w) return true;
+
+			float x = (clip.x / clip.w * 0.5f + 0.5f) * m_width;
+			float y = (clip.y / clip.w * 0.5f + 0.5f) * m_height;
+			minX = std::min(minX, x); maxX = std::max(maxX, x);
+			minY = std::min(minY, y); maxY = std::max(maxY, y);
+			nearest = std::min(nearest, clip.z / clip.w * 0.5f + 0.5f);
+		}
+
+		if (maxX < 0.f || maxY < 0.f || minX >= m_width || minY >= m_height) return false;
+
+		// Every pixel the rectangle touches.
+		int32_t pixelMinX = std::max(static_cast<int32_t>(std::floor(minX)), 0);
+		int32_t pixelMinY = std::max(static_cast<int32_t>(std::floor(minY)), 0);
+		int32_t pixelMaxX = std::min(static_cast<int32_t>(std::floor(maxX)), static_cast<int32_t>(m_width) - 1);
+		int32_t pixelMaxY = std::min(static_cast<int32_t>(std::floor(maxY)), static_cast<int32_t>(m_height) - 1);
+		float biasedNearest = nearest - depthBias;
+
+		uint32_t blocksX = m_width / blockSize;
+		for (int32_t tileY = pixelMinY / static_cast<int32_t>(tileSize); tileY <= pixelMaxY / static_cast<int32_t>(tileSize); tileY++)
+		{
+			for (int32_t tileX = pixelMinX / static_cast<int32_t>(tileSize); tileX <= pixelMaxX / static_cast<int32_t>(tileSize); tileX++)
+			{
+				uint32_t tile = tileY * m_tilesX + tileX;
+				// Behind everything in the tile, or in front of everything in it.
+				if (biasedNearest > m_tileMax[tile]) continue;
+				if (biasedNearest < m_tileMin[tile]) return true;
+
+				int32_t blockMinX = std::max(pixelMinX, tileX * static_cast<int32_t>(tileSize)) / static_cast<int32_t>(blockSize);
+				int32_t blockMaxX = std::min(pixelMaxX, (tileX + 1) * static_cast<int32_t>(tileSize) - 1) / static_cast<int32_t>(blockSize);
+				int32_t blockMinY = std::max(pixelMinY, tileY * static_cast<int32_t>(tileSize)) / static_cast<int32_t>(blockSize);
+				int32_t blockMaxY = std::min(pixelMaxY, (tileY + 1) * static_cast<int32_t>(tileSize) - 1) / static_cast<int32_t>(blockSize);
+				for (int32_t blockY = blockMinY; blockY <= blockMaxY; blockY++)
+				{
+					for (int32_t blockX = blockMinX; blockX <= blockMaxX; blockX++)
+					{
+						if (biasedNearest <= m_blockMax[blockY * blocksX + blockX]) return true;
+					}
+				}
+			}
+		}
+		return false;
+	}
+
+	uint32_t OcclusionBuffer::cullBoxes(const BoxBounds& boxes, std::vector<uint32_t>& visible) const
+	{
+		uint32_t count = 0;
+		for (uint32_t index : visible)
+		{
+			glm::vec3 centre(boxes.centreX[index], boxes.centreY[index], boxes.centreZ[index]);
+			glm::vec3 extent(boxes.extentX[index], boxes.extentY[index], boxes.extentZ[index]);
+			if (isVisible(centre, extent)) visible[count++] = index;
+		}
+		visible.resize(count);
+		return count;
+	}
+
+	const char* OcclusionBuffer::getInstructionSet()
+	{
+#if defined(NG_OCCLUSION_SSE)
+		return "SSE2";
+#else
+		return "Scalar";
+#endif
+	}
+}
@@ -9,7 +9,7 @@ namespace Engine
 {
 	RenderAPI::API RenderAPI::s_API = RenderAPI::API::OpenGL;
 
-	IndexBuffer* IndexBuffer::create(uint32_t* indices, uint32_t count)
+	IndexBuffer* IndexBuffer::create(uint32_t* indices, uint32_t count, BufferUsage usage)
 	{
 		switch (RenderAPI::getAPI())
 		{
@@ -17,7 +17,27 @@ namespace Engine
 			Log::error("Not having a rendering API is currently not supported");
 			break;
 		case RenderAPI::API::OpenGL:
-			return new OpenGLIndexBuffer(indices, count);
+			return new OpenGLIndexBuffer(indices, count, usage);
+		case RenderAPI::API::Direct3D:
+			Log::error("Direct3D is currently not supported");
+			break;
+		case RenderAPI::API::Vulkan:
+			Log::error("Vulkan is currently not supported");
+			break;
+		}
+
+		return nullptr;
+	}
+
+	IndexBuffer* IndexBuffer::create(uint16_t* indices, uint32_t count, BufferUsage usage)
+	{
+		switch (RenderAPI::getAPI())
+		{
+		case RenderAPI::API::None:
+			Log::error("Not having a rendering API is currently not supported");
+			break;
+		case RenderAPI::API::OpenGL:
+			return new OpenGLIndexBuffer(indices, count, usage);
 		case RenderAPI::API::Direct3D:
 			Log::error("Direct3D is currently not supported");
 			break;
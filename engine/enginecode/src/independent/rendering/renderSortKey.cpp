@@ -0,0 +1,51 @@
+#include "engine_pch.h"
+#include "rendering/renderSortKey.h"
+
+namespace Engine
+{
+	void radixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch)
+	{
+		const size_t count = items.size();
+		if (count < 2) return;
+		scratch.resize(count);
+
+		// Count the occurrences of every byte value in every byte position in a single pass.
+		uint32_t histograms[8][256] = {};
+		for (const SortItem& item : items)
+		{
+			for (uint32_t byte = 0; byte < 8; byte++) histograms[byte][(item.key >> (byte * 8)) & 0xFF]++;
+		}
+
+		SortItem* src = items.data();
+		SortItem* dst = scratch.data();
+
+		for (uint32_t byte = 0; byte < 8; byte++)
+		{
+			uint32_t* histogram = histograms[byte];
+
+			// Every key has the same value in this byte, so this pass would not change the order.
+			if (histogram[(src[0].key >> (byte * 8)) & 0xFF] == count) continue;
+
+			// Convert the counts to starting offsets.
+			uint32_t offset = 0;
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t bucketCount = histogram[i];
+				histogram[i] = offset;
+				offset += bucketCount;
+			}
+
+			// Scatter the items into their buckets, keeping the order of equal bytes stable.
+			for (size_t i = 0; i < count; i++)
+			{
+				uint32_t bucket = (src[i].key >> (byte * 8)) & 0xFF;
+				dst[histogram[bucket]++] = src[i];
+			}
+
+			std::swap(src, dst);
+		}
+
+		// The result lives in whichever buffer was written last.
+		if (src != items.data()) std::memcpy(items.data(), src, count * sizeof(SortItem));
+	}
+}
@@ -0,0 +1,362 @@
+#include "engine_pch.h"
+#include <glad/glad.h>
+#include "rendering/renderer3D.h"
+#include "rendering/std140Layout.h"
+#include "platforms/OpenGL/OpenGLStreamingBuffer.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
+#include "platforms/OpenGL/OpenGLMeshPool.h"
+#include "systems/log.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace Engine
+{
+	namespace
+	{
+		/** @brief Handles to the uniforms the renderer sets, resolved once per shader rather than by name on every draw. */
+		struct ShaderUniforms
+		{
+			std::weak_ptr<OpenGLShader> shader; // The shader the handles belong to, so one freed and replaced at the same address is resolved again
+			UniformHandle<int> texData;
+			UniformHandle<int> texArray;
+			UniformHandle<int> materialIndex;
+			UniformHandle<glm::vec4> tint;
+			UniformHandle<glm::mat4> model;
+			UniformHandle<glm::mat3> normalMatrix;
+		};
+
+		/** @brief A single draw recorded between begin and end. */
+		struct DrawCommand
+		{
+			OpenGLVertexArray* geometry;
+			Material* material;
+			glm::mat4 model;
+			glm::mat3 normalMatrix;
+			uint32_t instanceCount; // 0 for a regular draw using model
+			int32_t materialIndex; // Entry in b_materials, -1 if the shader does not read it
+			const ShaderUniforms* uniforms; // The shader's handles, set in end
+			OpenGLMeshPool* pool; // The pool holding mesh, null unless submitted from one
+			MeshHandle mesh;
+		};
+
+		/** @brief One entry of the b_materials storage block, laid out as std430. */
+		struct MaterialEntry
+		{
+			uint64_t handle; // Bindless texture handle, 0 to sample a bound texture
+			uint32_t layer;
+			uint32_t useTexData; // Non zero to sample the 2D texture on unit 0 rather than the array on unit 1
+			glm::vec4 tint;
+		};
+		static_assert(sizeof(MaterialEntry) == 32, "MaterialEntry must match the std430 layout of b_materials");
+
+		/** @brief State owned by the renderer. */
+		struct InternalData
+		{
+			std::shared_ptr<OpenGLStreamingBuffer> frameUniforms; // Camera and light blocks, rewritten every frame
+			Std140Writer<UniformBlocks::CameraLayout> cameraBlock;
+			Std140Writer<UniformBlocks::LightsLayout> lightsBlock;
+			glm::mat4 view = glm::mat4(1.f);
+			std::vector<DrawCommand> commands;
+			std::vector<SortItem> sortItems;
+			std::vector<SortItem> sortScratch;
+			std::vector<MaterialEntry> materials; // This frame's b_materials block
+			std::unordered_map<Material*, int32_t> materialIndices;
+			std::unordered_map<OpenGLShader*, ShaderUniforms> shaderUniforms; // Nodes are stable, so commands can point at them
+			std::vector<OpenGLMeshPool*> pools; // Pools drawn from this frame, whose regions are fenced once every draw is issued
+			std::shared_ptr<OpenGLTexture> fallbackTexture; // Sampled through its handle by textures not yet resident
+			bool bindless = false;
+			RendererStats stats;
+		};
+
+		InternalData* s_data = nullptr;
+
+		/** @brief Get the texture a draw needs bound, 0 if it is sampled through a handle or has none. */
+		uint32_t textureOf(const DrawCommand& cmd)
+		{
+			if (cmd.material->getTextureArray()) return cmd.material->getTextureArray()->getID();
+
+			const auto& texture = cmd.material->getTexture();
+			if (!texture || (cmd.materialIndex >= 0 && s_data->bindless)) return 0;
+			return texture->getID();
+		}
+
+		/** @brief Get the unit a draw's texture is bound to, arrays and 2D textures have their own so their samplers never share one. */
+		uint32_t textureUnitOf(const DrawCommand& cmd)
+		{
+			return cmd.material->getTextureArray() ? Renderer3D::textureArrayUnit : 0;
+		}
+
+		/** @brief Get a shader's uniform handles, looking them up by name the first time the shader is drawn with. */
+		const ShaderUniforms& uniformsOf(const std::shared_ptr<OpenGLShader>& shader)
+		{
+			ShaderUniforms& uniforms = s_data->shaderUniforms[shader.get()];
+			if (uniforms.shader.lock() == shader) return uniforms;
+
+			uniforms.shader = shader;
+			uniforms.texData = shader->getUniformHandle<int>("u_texData");
+			uniforms.texArray = shader->getUniformHandle<int>("u_texArray");
+			uniforms.materialIndex = shader->getUniformHandle<int>("u_materialIndex");
+			uniforms.tint = shader->getUniformHandle<glm::vec4>("u_tint");
+			uniforms.model = shader->getUniformHandle<glm::mat4>("u_model");
+			uniforms.normalMatrix = shader->getUniformHandle<glm::mat3>("u_normalMatrix");
+			return uniforms;
+		}
+
+		/** @brief Get the GL type of a geometry's indices. */
+		GLenum toGLIndexType(IndexType type)
+		{
+			return type == IndexType::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		}
+
+		/** @brief Find or add a material's entry in this frame's b_materials block. */
+		int32_t materialIndexOf(Material* material)
+		{
+			auto it = s_data->materialIndices.find(material);
+			if (it != s_data->materialIndices.end()) return it->second;
+
+			if (s_data->materials.size() == Renderer3D::maxMaterials)
+			{
+				Log::error("More than {0} materials drawn this frame, reusing the first", Renderer3D::maxMaterials);
+				return 0;
+			}
+
+			MaterialEntry entry = {};
+			entry.layer = material->getLayer();
+			entry.tint = material->getTint();
+			if (s_data->bindless && material->getTexture() && !material->getTextureArray())
+			{
+				entry.handle = material->getTexture()->getBindlessHandle();
+				if (!entry.handle) entry.handle = s_data->fallbackTexture->getBindlessHandle();
+			}
+			// Without bindless handles a 2D texture is bound like any other draw's, at the cost of breaking the batch.
+			else if (material->getTexture() && !material->getTextureArray()) entry.useTexData = 1;
+
+			int32_t index = static_cast<int32_t>(s_data->materials.size());
+			s_data->materials.push_back(entry);
+			s_data->materialIndices[material] = index;
+			return index;
+		}
+	}
+
+	void Renderer3D::init()
+	{
+		s_data = new InternalData;
+		// Room for both uniform blocks and the materials block per frame, each padded out to the offset alignment.
+		s_data->frameUniforms.reset(new OpenGLStreamingBuffer(UniformBlocks::CameraLayout::size + UniformBlocks::LightsLayout::size + maxMaterials * sizeof(MaterialEntry) + 3 * 256));
+
+		s_data->bindless = OpenGLTexture::isBindlessSupported();
+		unsigned char white[4] = { 255, 255, 255, 255 };
+		s_data->fallbackTexture.reset(new OpenGLTexture(1, 1, 4, white));
+	}
+
+	void Renderer3D::shutdown()
+	{
+		delete s_data;
+		s_data = nullptr;
+	}
+
+	void Renderer3D::begin(const Camera& camera, const PointLight& light)
+	{
+		s_data->commands.clear();
+		s_data->view = camera.view;
+
+		// Scene wide data is written once per frame and shared by every shader.
+		s_data->cameraBlock.set<0>(camera.view);
+		s_data->cameraBlock.set<1>(camera.projection);
+		s_data->cameraBlock.set<2>(glm::vec3(glm::inverse(camera.view)[3]));
+
+		s_data->lightsBlock.set<0>(light.position);
+		s_data->lightsBlock.set<1>(light.colour);
+
+		// Copy the blocks into this frame's region of the streaming buffer and bind them in place.
+		OpenGLStreamingBuffer& frameUniforms = *s_data->frameUniforms;
+		frameUniforms.beginFrame();
+
+		StreamAllocation cameraBlock = frameUniforms.allocate(s_data->cameraBlock.size(), frameUniforms.getUniformAlignment());
+		StreamAllocation lightsBlock = frameUniforms.allocate(s_data->lightsBlock.size(), frameUniforms.getUniformAlignment());
+		if (!cameraBlock.isValid() || !lightsBlock.isValid()) return;
+
+		memcpy(cameraBlock.data, s_data->cameraBlock.data(), cameraBlock.size);
+		memcpy(lightsBlock.data, s_data->lightsBlock.data(), lightsBlock.size);
+
+		frameUniforms.bindRange(GL_UNIFORM_BUFFER, UniformBlocks::Camera, cameraBlock);
+		frameUniforms.bindRange(GL_UNIFORM_BUFFER, UniformBlocks::Lights, lightsBlock);
+	}
+
+	void Renderer3D::submit(const std::shared_ptr<OpenGLVertexArray>& geometry, const std::shared_ptr<Material>& material, const glm::mat4& model, const glm::mat3& normalMatrix)
+	{
+		// A shader still compiling in parallel is skipped rather than waited on.
+		if (!material->getShader()->isReady()) return;
+		s_data->commands.push_back({ geometry.get(), material.get(), model, normalMatrix, 0, -1, nullptr, nullptr, MeshHandle() });
+	}
+
+	void Renderer3D::submit(const std::shared_ptr<OpenGLVertexArray>& geometry, const std::shared_ptr<Material>& material, const glm::mat4& model)
+	{
+		submit(geometry, material, model, glm::transpose(glm::inverse(glm::mat3(model))));
+	}
+
+	void Renderer3D::submitInstanced(const std::shared_ptr<OpenGLVertexArray>& geometry, const std::shared_ptr<Material>& material, uint32_t instanceCount)
+	{
+		if (instanceCount == 0 || !material->getShader()->isReady()) return;
+		s_data->commands.push_back({ geometry.get(), material.get(), glm::mat4(1.f), glm::mat3(1.f), instanceCount, -1, nullptr, nullptr, MeshHandle() });
+	}
+
+	void Renderer3D::submit(OpenGLMeshPool& pool, const MeshHandle& mesh, const std::shared_ptr<Material>& material, const glm::mat4& model, const glm::mat3& normalMatrix)
+	{
+		if (!mesh.isValid() || !material->getShader()->isReady()) return;
+		s_data->commands.push_back({ pool.getVertexArray().get(), material.get(), model, normalMatrix, 0, -1, nullptr, &pool, mesh });
+
+		auto& pools = s_data->pools;
+		if (std::find(pools.begin(), pools.end(), &pool) == pools.end()) pools.push_back(&pool);
+	}
+
+	void Renderer3D::end()
+	{
+		auto& commands = s_data->commands;
+		auto& items = s_data->sortItems;
+		items.resize(commands.size());
+
+		s_data->materials.clear();
+		s_data->materialIndices.clear();
+
+		// Build a key for every command from the state it needs and its distance from the camera.
+		for (uint32_t i = 0; i < commands.size(); i++)
+		{
+			DrawCommand& cmd = commands[i];
+			OpenGLShader* shader = cmd.material->getShader().get();
+			cmd.uniforms = &uniformsOf(cmd.material->getShader());
+			cmd.materialIndex = cmd.uniforms->materialIndex.isValid() ? materialIndexOf(cmd.material) : -1;
+
+			float depth = -(s_data->view * cmd.model[3]).z;
+
+			// Draws sampling through handles have no texture in their key, so they group by program and geometry alone.
+			items[i].key = SortKey::make(cmd.material->getPass(), shader->getID(), cmd.geometry->getRenderID(), textureOf(cmd), depth);
+			items[i].index = i;
+		}
+
+		radixSort(items, s_data->sortScratch);
+
+		RendererStats& stats = s_data->stats;
+		stats = RendererStats();
+		stats.materials = static_cast<uint32_t>(s_data->materials.size());
+
+		// Every material read this frame is written once and bound for the whole frame.
+		if (!s_data->materials.empty())
+		{
+			OpenGLStreamingBuffer& frameUniforms = *s_data->frameUniforms;
+			uint32_t size = static_cast<uint32_t>(s_data->materials.size() * sizeof(MaterialEntry));
+			StreamAllocation materialsBlock = frameUniforms.allocate(size, frameUniforms.getStorageAlignment());
+			if (materialsBlock.isValid())
+			{
+				memcpy(materialsBlock.data, s_data->materials.data(), size);
+				frameUniforms.bindRange(GL_SHADER_STORAGE_BUFFER, materialsBinding, materialsBlock);
+			}
+		}
+
+		OpenGLShader* currentShader = nullptr;
+		OpenGLVertexArray* currentGeometry = nullptr;
+		uint32_t currentTextures[2] = { 0, 0 };
+		bool blending = false;
+
+		for (uint32_t i = 0; i < items.size(); i++)
+		{
+			const DrawCommand& cmd = commands[items[i].index];
+			OpenGLShader* shader = cmd.material->getShader().get();
+			uint32_t texture = textureOf(cmd);
+
+			// Transparent draws sort after every opaque one, so blending is switched on once, at the first of them.
+			// They still test against the opaque depth but leave it unchanged, so they never hide each other.
+			if (!blending && cmd.material->getPass() == RenderPass::Transparent)
+			{
+				blending = true;
+				OpenGLStateCache::enable(GL_BLEND);
+				OpenGLStateCache::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				OpenGLStateCache::depthMask(false);
+			}
+
+			// Only issue the state changes which differ from the previous draw.
+			if (shader != currentShader)
+			{
+				currentShader = shader;
+				OpenGLStateCache::useProgram(shader->getID());
+				shader->upload(cmd.uniforms->texData, 0);
+				shader->upload(cmd.uniforms->texArray, static_cast<int>(textureArrayUnit));
+				stats.programBinds++;
+			}
+
+			if (cmd.geometry != currentGeometry)
+			{
+				currentGeometry = cmd.geometry;
+				currentGeometry->bind();
+				stats.vertexArrayBinds++;
+			}
+
+			uint32_t unit = textureUnitOf(cmd);
+			if (texture && texture != currentTextures[unit])
+			{
+				currentTextures[unit] = texture;
+				OpenGLStateCache::bindTexture(unit, texture);
+				stats.textureBinds++;
+			}
+
+			// Per draw uniforms go through the cached handles, and unchanged values are filtered by the shader's shadow copies.
+			if (cmd.materialIndex >= 0) shader->upload(cmd.uniforms->materialIndex, cmd.materialIndex);
+			else shader->upload(cmd.uniforms->tint, cmd.material->getTint());
+
+			if (cmd.pool)
+			{
+				// Opaque pool draws sorted together with the same material need no state change between them, so they are drawn with one call.
+				// Their order makes no difference to the image, so they are grouped by mesh for repeats to become instances of one command.
+				uint32_t last = i + 1;
+				if (cmd.material->getPass() == RenderPass::Opaque)
+				{
+					while (last < items.size() && commands[items[last].index].pool == cmd.pool && commands[items[last].index].material == cmd.material) last++;
+					std::stable_sort(items.begin() + i, items.begin() + last, [&commands](const SortItem& a, const SortItem& b) { return commands[a.index].mesh.firstIndex < commands[b.index].mesh.firstIndex; });
+				}
+
+				for (uint32_t j = i; j < last; j++)
+				{
+					const DrawCommand& pooled = commands[items[j].index];
+					cmd.pool->submit(pooled.mesh, pooled.model, pooled.normalMatrix);
+				}
+				cmd.pool->flush();
+
+				stats.pooledDraws += last - i;
+				stats.indirectCommands += cmd.pool->getLastCommandCount();
+				i = last - 1;
+			}
+			else if (cmd.instanceCount > 0)
+			{
+				// Per instance transforms come from the geometry's instance attributes.
+				glDrawElementsInstanced(GL_TRIANGLES, cmd.geometry->getDrawCount(), toGLIndexType(cmd.geometry->getIndexType()), nullptr, cmd.instanceCount);
+				stats.instances += cmd.instanceCount;
+			}
+			else
+			{
+				shader->upload(cmd.uniforms->model, cmd.model);
+				shader->upload(cmd.uniforms->normalMatrix, cmd.normalMatrix);
+				glDrawElements(GL_TRIANGLES, cmd.geometry->getDrawCount(), toGLIndexType(cmd.geometry->getIndexType()), nullptr);
+			}
+			stats.drawCalls++;
+		}
+
+		// Leave the state opaque drawing expects for whatever draws next.
+		if (blending)
+		{
+			OpenGLStateCache::disable(GL_BLEND);
+			OpenGLStateCache::depthMask(true);
+		}
+
+		for (OpenGLMeshPool* pool : s_data->pools) pool->endFrame();
+		s_data->pools.clear();
+		commands.clear();
+
+		// The frame's uniform blocks may be overwritten once the GPU has executed these draws.
+		s_data->frameUniforms->endFrame();
+	}
+
+	const RendererStats& Renderer3D::getStats()
+	{
+		return s_data->stats;
+	}
+}
@@ -0,0 +1,84 @@
+#include "engine_pch.h"
+#include "rendering/shaderCache.h"
+#include <cstdio>
+#include <fstream>
+
+namespace Engine
+{
+	namespace
+	{
+		const uint32_t s_magic = 0x4E494247; // "GBIN"
+		const uint32_t s_version = 1; // Bump when the file layout changes
+	}
+
+	namespace ShaderCache
+	{
+		uint64_t hash(const void* data, size_t size, uint64_t hash)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= bytes[i];
+				hash *= 0x100000001B3ull;
+			}
+			return hash;
+		}
+
+		uint64_t programKey(const std::vector<std::string>& sources, const std::string& driver)
+		{
+			uint64_t key = hash(&s_version, sizeof(s_version));
+			key = hash(driver.data(), driver.size(), key);
+			for (const std::string& source : sources)
+			{
+				uint64_t size = source.size();
+				key = hash(&size, sizeof(size), key);
+				key = hash(source.data(), source.size(), key);
+			}
+			return key;
+		}
+
+		std::string cachePath(uint64_t key)
+		{
+			char name[17];
+			snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+			return std::string("./cache/shaders/") + name + ".bin";
+		}
+
+		bool writeBinary(const std::string& filepath, const ProgramBinary& binary)
+		{
+			if (binary.data.empty()) return false;
+
+			std::ofstream handle(filepath, std::ios::out | std::ios::binary);
+			if (!handle.is_open()) return false;
+
+			uint32_t header[4] = { s_magic, s_version, binary.format, static_cast<uint32_t>(binary.data.size()) };
+			handle.write(reinterpret_cast<const char*>(header), sizeof(header));
+			handle.write(reinterpret_cast<const char*>(binary.data.data()), binary.data.size());
+
+			return handle.good();
+		}
+
+		bool readBinary(const std::string& filepath, ProgramBinary& binary)
+		{
+			std::ifstream handle(filepath, std::ios::in | std::ios::binary);
+			if (!handle.is_open()) return false;
+
+			uint32_t header[4] = {};
+			handle.read(reinterpret_cast<char*>(header), sizeof(header));
+			if (!handle || header[0] != s_magic || header[1] != s_version || header[3] == 0) return false;
+
+			// A file whose length disagrees with its header, e.g. from a crash mid-write, is treated as a miss before anything is allocated.
+			std::streamoff start = handle.tellg();
+			handle.seekg(0, std::ios::end);
+			std::streamoff end = handle.tellg();
+			handle.seekg(start);
+			if (!handle || static_cast<uint64_t>(end - start) != header[3]) return false;
+
+			binary.format = header[2];
+			binary.data.resize(header[3]);
+			handle.read(reinterpret_cast<char*>(binary.data.data()), binary.data.size());
+
+			return static_cast<bool>(handle);
+		}
+	}
+}
@@ -0,0 +1,172 @@
+#include "engine_pch.h"
+#include "rendering/shaderPreprocessor.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+namespace Engine
+{
+	namespace
+	{
+		const char* s_featureDefines[ShaderFeatures::Count] = { "INSTANCED", "MATERIAL_BUFFER", "HAS_NORMAL_MAP", "ALPHA_TEST" };
+		const char* s_stageRegions[ShaderStages::Count] = { "#region Vertex", "#region Fragment", "#region Geometry", "#region TessellationControl", "#region TessellationEvaluation", "#region Compute" };
+
+		/** @brief Check if a line starts with a directive, ignoring leading whitespace. */
+		bool isDirective(const std::string& line, const char* directive)
+		{
+			size_t start = line.find_first_not_of(" \t");
+			return start != std::string::npos && line.compare(start, strlen(directive), directive) == 0;
+		}
+
+		/** @brief Get the key a file is remembered by in an included set, the same however the path was spelt. */
+		std::string includeKey(const std::filesystem::path& filepath)
+		{
+			std::error_code pathError;
+			std::filesystem::path canonical = std::filesystem::weakly_canonical(filepath, pathError);
+			return pathError ? filepath.string() : canonical.string();
+		}
+
+		bool expand(const std::filesystem::path& filepath, std::set<std::string>& included, std::string& out, std::string& error);
+
+		/** @brief Append source lines to the output with their includes expanded, resolving paths relative to the file they came from. */
+		bool expandLines(std::istream& lines, const std::filesystem::path& filepath, std::set<std::string>& included, std::string& out, std::string& error)
+		{
+			std::string line;
+			while (getline(lines, line))
+			{
+				if (isDirective(line, "#include"))
+				{
+					size_t open = line.find('"'), close = line.rfind('"');
+					if (open == std::string::npos || close <= open)
+					{
+						error = "Malformed #include in " + filepath.string() + ": " + line;
+						return false;
+					}
+
+					std::filesystem::path include = filepath.parent_path() / line.substr(open + 1, close - open - 1);
+					if (!expand(include, included, out, error)) return false;
+					continue;
+				}
+
+				out += line + "\n";
+			}
+
+			return true;
+		}
+
+		/** @brief Append a file to the output with its includes expanded, skipping files already included. */
+		bool expand(const std::filesystem::path& filepath, std::set<std::string>& included, std::string& out, std::string& error)
+		{
+			if (!included.insert(includeKey(filepath)).second) return true;
+
+			std::ifstream handle(filepath, std::ios::in);
+			if (!handle.is_open())
+			{
+				error = "Could not open shader source: " + filepath.string();
+				return false;
+			}
+
+			return expandLines(handle, filepath, included, out, error);
+		}
+	}
+
+	namespace ShaderPreprocessor
+	{
+		std::vector<std::string> featureDefines(uint32_t features)
+		{
+			std::vector<std::string> defines;
+			for (uint32_t bit = 0; bit < ShaderFeatures::Count; bit++)
+			{
+				if (features & (1u << bit)) defines.push_back(s_featureDefines[bit]);
+			}
+			return defines;
+		}
+
+		bool resolveIncludes(const std::string& filepath, std::string& source, std::string& error)
+		{
+			std::set<std::string> included;
+			source.clear();
+			return expand(filepath, included, source, error);
+		}
+
+		ShaderSources splitStages(const std::string& source)
+		{
+			ShaderSources stages;
+			int32_t stage = -1;
+
+			std::istringstream lines(source);
+			std::string line;
+			while (getline(lines, line))
+			{
+				bool isRegion = false;
+				for (uint32_t i = 0; i < ShaderStages::Count; i++)
+				{
+					if (line.find(s_stageRegions[i]) != std::string::npos) { stage = i; isRegion = true; break; }
+				}
+
+				if (!isRegion && stage >= 0) stages[stage] += line + "\n";
+			}
+
+			return stages;
+		}
+
+		std::string injectDefines(const std::string& source, const std::vector<std::string>& defines)
+		{
+			if (defines.empty() || source.empty()) return source;
+
+			std::string block;
+			for (const std::string& define : defines) block += "#define " + define + "\n";
+
+			// #version must be the first line and #extension lines must precede any code, so insert after both.
+			size_t insertAt = 0, position = 0;
+			while (position < source.size())
+			{
+				size_t end = source.find('\n', position);
+				if (end == std::string::npos) end = source.size();
+
+				std::string line = source.substr(position, end - position);
+				bool blank = line.find_first_not_of(" \t\r") == std::string::npos;
+				if (isDirective(line, "#version") || isDirective(line, "#extension")) insertAt = std::min(end + 1, source.size());
+				else if (!blank) break;
+
+				position = end + 1;
+			}
+
+			std::string result = source;
+			if (insertAt == source.size() && source.back() != '\n') block = "\n" + block;
+			result.insert(insertAt, block);
+			return result;
+		}
+
+		bool load(const std::string& filepath, uint32_t features, ShaderSources& sources, std::string& error)
+		{
+			std::ifstream handle(filepath, std::ios::in);
+			if (!handle.is_open())
+			{
+				error = "Could not open shader source: " + filepath;
+				return false;
+			}
+			std::stringstream file;
+			file << handle.rdbuf();
+
+			// Split before expanding, so a header included by several stages is pulled into each of them rather than only the first.
+			std::vector<std::string> defines = featureDefines(features);
+			ShaderSources regions = splitStages(file.str());
+			for (uint32_t i = 0; i < ShaderStages::Count; i++)
+			{
+				sources[i].clear();
+				if (regions[i].empty()) continue;
+
+				std::set<std::string> included = { includeKey(filepath) };
+				std::istringstream lines(regions[i]);
+				if (!expandLines(lines, filepath, included, sources[i], error)) return false;
+				sources[i] = injectDefines(sources[i], defines);
+			}
+
+			return true;
+		}
+	}
+}
@@ -0,0 +1,343 @@
+#include "engine_pch.h"
+#include "rendering/textureCompression.h"
+#include "rendering/assetCache.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace Engine
+{
+	namespace
+	{
+		const uint32_t s_ddsMagic = 0x20534444; // "DDS "
+		const uint32_t s_fourCC_DXT1 = 0x31545844; // "DXT1"
+		const uint32_t s_fourCC_DXT5 = 0x35545844; // "DXT5"
+		const uint32_t s_maxDimension = 16384; // Largest width or height accepted from a DDS header
+
+		/** @brief Pack an RGB colour to 5:6:5. */
+		uint16_t toRGB565(const uint8_t* c)
+		{
+			return static_cast<uint16_t>(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+		}
+
+		/** @brief Expand a 5:6:5 colour back to 8 bits per channel, replicating the high bits. */
+		void fromRGB565(uint16_t v, uint8_t* c)
+		{
+			uint8_t r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+			c[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+			c[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+			c[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+		}
+
+		void writeLE16(uint8_t* out, uint16_t v) { out[0] = v & 0xFF; out[1] = v >> 8; }
+		void writeLE32(uint8_t* out, uint32_t v) { for (int i = 0; i < 4; i++) out[i] = (v >> (8 * i)) & 0xFF; }
+
+		/** @brief Encode the colour half of a block, always in four colour mode. */
+		void encodeColourBlock(const uint8_t block[64], uint8_t out[8])
+		{
+			// Bounding box of the block's colours.
+			uint8_t lo[3] = { 255, 255, 255 }, hi[3] = { 0, 0, 0 };
+			for (int i = 0; i < 16; i++)
+			{
+				for (int c = 0; c < 3; c++)
+				{
+					lo[c] = std::min(lo[c], block[i * 4 + c]);
+					hi[c] = std::max(hi[c], block[i * 4 + c]);
+				}
+			}
+
+			// Pull the endpoints in slightly, the interpolated colours then cover the box better.
+			for (int c = 0; c < 3; c++)
+			{
+				int inset = (hi[c] - lo[c]) >> 4;
+				lo[c] = static_cast<uint8_t>(lo[c] + inset);
+				hi[c] = static_cast<uint8_t>(hi[c] - inset);
+			}
+
+			uint16_t c0 = toRGB565(hi), c1 = toRGB565(lo);
+			if (c0 < c1) std::swap(c0, c1);
+
+			uint32_t indices = 0;
+			if (c0 != c1)
+			{
+				// Palette of the endpoints and the two colours a third of the way between them.
+				uint8_t palette[4][3];
+				fromRGB565(c0, palette[0]);
+				fromRGB565(c1, palette[1]);
+				for (int c = 0; c < 3; c++)
+				{
+					palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c]) / 3);
+					palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c]) / 3);
+				}
+
+				for (int i = 0; i < 16; i++)
+				{
+					int best = 0, bestDistance = INT32_MAX;
+					for (int p = 0; p < 4; p++)
+					{
+						int distance = 0;
+						for (int c = 0; c < 3; c++)
+						{
+							int d = block[i * 4 + c] - palette[p][c];
+							distance += d * d;
+						}
+						if (distance < bestDistance) { bestDistance = distance; best = p; }
+					}
+					indices |= static_cast<uint32_t>(best) << (2 * i);
+				}
+			}
+
+			writeLE16(out, c0);
+			writeLE16(out + 2, c1);
+			writeLE32(out + 4, indices);
+		}
+
+		/** @brief Encode the alpha half of a BC3 block in eight value mode. */
+		void encodeAlphaBlock(const uint8_t block[64], uint8_t out[8])
+		{
+			uint8_t a0 = 0, a1 = 255;
+			for (int i = 0; i < 16; i++)
+			{
+				a0 = std::max(a0, block[i * 4 + 3]);
+				a1 = std::min(a1, block[i * 4 + 3]);
+			}
+
+			uint64_t indices = 0;
+			if (a0 != a1)
+			{
+				// a0 > a1 selects the endpoints plus six evenly spaced values between them.
+				int palette[8] = { a0, a1 };
+				for (int p = 1; p < 7; p++) palette[p + 1] = ((7 - p) * a0 + p * a1) / 7;
+
+				for (int i = 0; i < 16; i++)
+				{
+					int best = 0, bestDistance = INT32_MAX;
+					for (int p = 0; p < 8; p++)
+					{
+						int distance = std::abs(block[i * 4 + 3] - palette[p]);
+						if (distance < bestDistance) { bestDistance = distance; best = p; }
+					}
+					indices |= static_cast<uint64_t>(best) << (3 * i);
+				}
+			}
+
+			out[0] = a0;
+			out[1] = a1;
+			for (int i = 0; i < 6; i++) out[2 + i] = (indices >> (8 * i)) & 0xFF;
+		}
+	}
+
+	namespace TextureCompression
+	{
+		uint32_t blockSize(TextureFormat format)
+		{
+			switch (format)
+			{
+			case TextureFormat::BC1: return 8;
+			case TextureFormat::BC3: return 16;
+			default: return 0;
+			}
+		}
+
+		uint32_t levelSize(TextureFormat format, uint32_t width, uint32_t height)
+		{
+			switch (format)
+			{
+			case TextureFormat::RGB8: return width * height * 3;
+			case TextureFormat::RGBA8: return width * height * 4;
+			default: return ((width + 3) / 4) * ((height + 3) / 4) * blockSize(format);
+			}
+		}
+
+		std::vector<TextureMip> buildMipChain(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels)
+		{
+			std::vector<TextureMip> chain;
+
+			// Expand the top level to RGBA so every level shares one layout.
+			TextureMip top;
+			top.width = width;
+			top.height = height;
+			top.data.resize(static_cast<size_t>(width) * height * 4);
+			for (uint32_t i = 0; i < width * height; i++)
+			{
+				for (uint32_t c = 0; c < 3; c++) top.data[i * 4 + c] = pixels[i * channels + c];
+				top.data[i * 4 + 3] = channels == 4 ? pixels[i * channels + 3] : 255;
+			}
+			chain.push_back(std::move(top));
+
+			while (chain.back().width > 1 || chain.back().height > 1)
+			{
+				const TextureMip& src = chain.back();
+				TextureMip dst;
+				dst.width = std::max(1u, src.width / 2);
+				dst.height = std::max(1u, src.height / 2);
+				dst.data.resize(static_cast<size_t>(dst.width) * dst.height * 4);
+
+				for (uint32_t y = 0; y < dst.height; y++)
+				{
+					// Clamp so a dimension which is already 1 averages the same row or column twice.
+					uint32_t y0 = std::min(y * 2, src.height - 1), y1 = std::min(y * 2 + 1, src.height - 1);
+					for (uint32_t x = 0; x < dst.width; x++)
+					{
+						uint32_t x0 = std::min(x * 2, src.width - 1), x1 = std::min(x * 2 + 1, src.width - 1);
+						for (uint32_t c = 0; c < 4; c++)
+						{
+							uint32_t sum = src.data[(y0 * src.width + x0) * 4 + c] + src.data[(y0 * src.width + x1) * 4 + c]
+								+ src.data[(y1 * src.width + x0) * 4 + c] + src.data[(y1 * src.width + x1) * 4 + c];
+							dst.data[(y * dst.width + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+						}
+					}
+				}
+				chain.push_back(std::move(dst));
+			}
+
+			return chain;
+		}
+
+		void encodeBC1Block(const uint8_t block[64], uint8_t out[8])
+		{
+			encodeColourBlock(block, out);
+		}
+
+		void encodeBC3Block(const uint8_t block[64], uint8_t out[16])
+		{
+			encodeAlphaBlock(block, out);
+			encodeColourBlock(block, out + 8);
+		}
+
+		TextureData compress(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels, TextureFormat format)
+		{
+			return compressMipChain(buildMipChain(pixels, width, height, channels), format);
+		}
+
+		TextureData compressMipChain(const std::vector<TextureMip>& chain, TextureFormat format)
+		{
+			TextureData texture;
+			texture.format = format;
+
+			uint32_t bytesPerBlock = blockSize(format);
+			for (const TextureMip& level : chain)
+			{
+				TextureMip mip;
+				mip.width = level.width;
+				mip.height = level.height;
+				mip.data.resize(levelSize(format, level.width, level.height));
+
+				uint32_t blocksX = (level.width + 3) / 4, blocksY = (level.height + 3) / 4;
+				uint8_t block[64];
+				for (uint32_t by = 0; by < blocksY; by++)
+				{
+					for (uint32_t bx = 0; bx < blocksX; bx++)
+					{
+						// Gather the block, repeating edge pixels where it overhangs the level.
+						for (uint32_t i = 0; i < 16; i++)
+						{
+							uint32_t x = std::min(bx * 4 + i % 4, level.width - 1);
+							uint32_t y = std::min(by * 4 + i / 4, level.height - 1);
+							memcpy(block + i * 4, level.data.data() + (y * level.width + x) * 4, 4);
+						}
+
+						uint8_t* out = mip.data.data() + (by * blocksX + bx) * bytesPerBlock;
+						if (format == TextureFormat::BC1) encodeBC1Block(block, out);
+						else encodeBC3Block(block, out);
+					}
+				}
+				texture.mips.push_back(std::move(mip));
+			}
+
+			return texture;
+		}
+
+		bool writeDDS(const std::string& filepath, const TextureData& texture)
+		{
+			if (!texture.isCompressed() || texture.mips.empty()) return false;
+
+			std::ofstream handle(filepath, std::ios::out | std::ios::binary);
+			if (!handle.is_open()) return false;
+
+			// DDS_HEADER as 31 dwords, with a DDS_PIXELFORMAT carrying the FourCC at dword 18.
+			uint32_t header[31] = {};
+			header[0] = 124;
+			header[1] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000; // Caps, height, width, pixel format, mip count, linear size
+			header[2] = texture.mips[0].height;
+			header[3] = texture.mips[0].width;
+			header[4] = static_cast<uint32_t>(texture.mips[0].data.size());
+			header[6] = static_cast<uint32_t>(texture.mips.size());
+			header[18] = 32;
+			header[19] = 0x4; // FourCC
+			header[20] = texture.format == TextureFormat::BC1 ? s_fourCC_DXT1 : s_fourCC_DXT5;
+			header[26] = 0x1000 | 0x400000 | 0x8; // Texture, mipmap, complex
+
+			handle.write(reinterpret_cast<const char*>(&s_ddsMagic), sizeof(s_ddsMagic));
+			handle.write(reinterpret_cast<const char*>(header), sizeof(header));
+			for (const TextureMip& mip : texture.mips) handle.write(reinterpret_cast<const char*>(mip.data.data()), mip.data.size());
+
+			return handle.good();
+		}
+
+		bool readDDS(const std::string& filepath, TextureData& texture)
+		{
+			std::ifstream handle(filepath, std::ios::in | std::ios::binary);
+			if (!handle.is_open()) return false;
+
+			uint32_t magic = 0;
+			uint32_t header[31] = {};
+			handle.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+			handle.read(reinterpret_cast<char*>(header), sizeof(header));
+			if (!handle || magic != s_ddsMagic || header[0] != 124 || !(header[19] & 0x4)) return false;
+
+			if (header[20] == s_fourCC_DXT1) texture.format = TextureFormat::BC1;
+			else if (header[20] == s_fourCC_DXT5) texture.format = TextureFormat::BC3;
+			else return false;
+
+			uint32_t width = header[3], height = header[2];
+			uint32_t mipCount = (header[1] & 0x20000) ? std::max(1u, header[6]) : 1;
+			if (width == 0 || height == 0 || width > s_maxDimension || height > s_maxDimension) return false;
+
+			// A full chain halves down to 1x1, so more levels than that means a corrupt header.
+			uint32_t fullChain = 1;
+			while ((std::max(width, height) >> fullChain) > 0) fullChain++;
+			if (mipCount > fullChain) return false;
+
+			// The header's linear size, when present, is the size of the top level in blocks.
+			if ((header[1] & 0x80000) && header[4] != levelSize(texture.format, width, height)) return false;
+
+			// Every level must be in the file, and nothing else may follow them.
+			uint64_t payload = 0;
+			for (uint32_t level = 0; level < mipCount; level++) payload += levelSize(texture.format, std::max(1u, width >> level), std::max(1u, height >> level));
+
+			std::streamoff start = handle.tellg();
+			handle.seekg(0, std::ios::end);
+			std::streamoff end = handle.tellg();
+			handle.seekg(start);
+			if (!handle || static_cast<uint64_t>(end - start) != payload) return false;
+
+			texture.mips.clear();
+			for (uint32_t level = 0; level < mipCount; level++)
+			{
+				TextureMip mip;
+				mip.width = std::max(1u, width >> level);
+				mip.height = std::max(1u, height >> level);
+				mip.data.resize(levelSize(texture.format, mip.width, mip.height));
+
+				handle.read(reinterpret_cast<char*>(mip.data.data()), mip.data.size());
+				if (!handle) return false;
+
+				texture.mips.push_back(std::move(mip));
+			}
+
+			return true;
+		}
+
+		std::string cachePath(const std::string& sourcePath)
+		{
+			return AssetCache::cachePath(sourcePath, "textures", ".dds");
+		}
+
+		std::string cachePath(const std::string& sourcePath, TextureFormat format)
+		{
+			return AssetCache::cachePath(sourcePath, "textures", format == TextureFormat::BC1 ? ".bc1.dds" : ".bc3.dds");
+		}
+	}
+}
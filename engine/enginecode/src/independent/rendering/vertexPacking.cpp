@@ -0,0 +1,179 @@
+#include "engine_pch.h"
+#include "rendering/vertexPacking.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Engine
+{
+	namespace
+	{
+		/** @brief Quantise a [-1, 1] value to a signed normalised integer with the given largest value. */
+		int32_t toSnorm(float value, int32_t maxValue)
+		{
+			return static_cast<int32_t>(std::round(std::clamp(value, -1.f, 1.f) * maxValue));
+		}
+
+		/** @brief Read a signed normalised integer the way GL does, where the most negative value also maps to -1. */
+		float fromSnorm(int32_t value, int32_t maxValue)
+		{
+			return std::max(static_cast<float>(value) / maxValue, -1.f);
+		}
+
+		/** @brief Sign extend the low bits of a packed field. */
+		int32_t signExtend(uint32_t value, uint32_t bits)
+		{
+			uint32_t shift = 32 - bits;
+			return static_cast<int32_t>(value << shift) >> shift;
+		}
+
+		/** @brief The sign of a value, treating zero as positive so folded octants stay on the octahedron. */
+		float signNotZero(float value)
+		{
+			return value >= 0.f ? 1.f : -1.f;
+		}
+	}
+
+	namespace VertexPacking
+	{
+		uint16_t toHalf(float value)
+		{
+			uint32_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+
+			uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+			uint32_t exponent = (bits >> 23) & 0xFF;
+			uint32_t mantissa = bits & 0x7FFFFF;
+
+			// Infinity stays infinity and NaN stays a quiet NaN.
+			if (exponent == 0xFF) return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+
+			int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+			if (halfExponent >= 31) return sign | 0x7C00;
+
+			if (halfExponent <= 0)
+			{
+				// Too small even for a denormal.
+				if (halfExponent < -10) return sign;
+
+				// Denormal, shift the mantissa with its implicit bit into place and round to nearest even.
+				mantissa |= 0x800000;
+				uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+				uint32_t half = mantissa >> shift;
+				uint32_t remainder = mantissa & ((1u << shift) - 1);
+				uint32_t halfway = 1u << (shift - 1);
+				if (remainder > halfway || (remainder == halfway && (half & 1))) half++;
+				return sign | static_cast<uint16_t>(half);
+			}
+
+			uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+			uint32_t remainder = mantissa & 0x1FFF;
+
+			// A carry out of the mantissa correctly bumps the exponent, up to infinity.
+			if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) half++;
+			return sign | static_cast<uint16_t>(half);
+		}
+
+		float fromHalf(uint16_t half)
+		{
+			uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+			uint32_t exponent = (half >> 10) & 0x1F;
+			uint32_t mantissa = half & 0x3FF;
+
+			uint32_t bits;
+			if (exponent == 0x1F) bits = sign | 0x7F800000 | (mantissa << 13);
+			else if (exponent != 0) bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+			else if (mantissa == 0) bits = sign;
+			else
+			{
+				// Denormal, normalise the mantissa for the float's wider exponent.
+				exponent = 127 - 15 + 1;
+				while (!(mantissa & 0x400)) { mantissa <<= 1; exponent--; }
+				bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+			}
+
+			float value;
+			memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+		std::array<uint16_t, 2> packHalf2(const glm::vec2& value)
+		{
+			return { toHalf(value.x), toHalf(value.y) };
+		}
+
+		std::array<uint16_t, 4> packHalf4(const glm::vec4& value)
+		{
+			return { toHalf(value.x), toHalf(value.y), toHalf(value.z), toHalf(value.w) };
+		}
+
+		uint32_t packUByte4N(const glm::vec4& value)
+		{
+			uint32_t packed = 0;
+			for (uint32_t i = 0; i < 4; i++)
+			{
+				uint32_t component = static_cast<uint32_t>(std::round(std::clamp(value[i], 0.f, 1.f) * 255.f));
+				packed |= component << (i * 8);
+			}
+			return packed;
+		}
+
+		glm::vec4 unpackUByte4N(uint32_t packed)
+		{
+			glm::vec4 value;
+			for (uint32_t i = 0; i < 4; i++) value[i] = static_cast<float>((packed >> (i * 8)) & 0xFF) / 255.f;
+			return value;
+		}
+
+		uint32_t packInt2101010Rev(const glm::vec4& value)
+		{
+			uint32_t packed = 0;
+			for (uint32_t i = 0; i < 3; i++) packed |= (static_cast<uint32_t>(toSnorm(value[i], 511)) & 0x3FF) << (i * 10);
+			packed |= (static_cast<uint32_t>(toSnorm(value.w, 1)) & 0x3) << 30;
+			return packed;
+		}
+
+		glm::vec4 unpackInt2101010Rev(uint32_t packed)
+		{
+			glm::vec4 value;
+			for (uint32_t i = 0; i < 3; i++) value[i] = fromSnorm(signExtend(packed >> (i * 10), 10), 511);
+			value.w = fromSnorm(signExtend(packed >> 30, 2), 1);
+			return value;
+		}
+
+		uint32_t packOct16(const glm::vec3& normal)
+		{
+			// A zero vector has no direction, it encodes as the centre of the octahedron, +z.
+			float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+			if (length == 0.f) return 0;
+
+			// Project onto the octahedron |x| + |y| + |z| = 1, then fold the lower half over the diagonals.
+			float scale = 1.f / length;
+			float x = normal.x * scale, y = normal.y * scale;
+			if (normal.z < 0.f)
+			{
+				float foldedX = (1.f - std::abs(y)) * signNotZero(x);
+				y = (1.f - std::abs(x)) * signNotZero(y);
+				x = foldedX;
+			}
+
+			uint32_t packedX = static_cast<uint32_t>(toSnorm(x, 32767)) & 0xFFFF;
+			uint32_t packedY = static_cast<uint32_t>(toSnorm(y, 32767)) & 0xFFFF;
+			return packedX | (packedY << 16);
+		}
+
+		glm::vec3 unpackOct16(uint32_t packed)
+		{
+			float x = fromSnorm(signExtend(packed, 16), 32767);
+			float y = fromSnorm(signExtend(packed >> 16, 16), 32767);
+
+			glm::vec3 normal(x, y, 1.f - std::abs(x) - std::abs(y));
+			if (normal.z < 0.f)
+			{
+				normal.x = (1.f - std::abs(y)) * signNotZero(x);
+				normal.y = (1.f - std::abs(x)) * signNotZero(y);
+			}
+			return glm::normalize(normal);
+		}
+	}
+}
@@ -0,0 +1,297 @@
+#include "engine_pch.h"
+#include "scene/aabbTree.h"
+
+namespace Engine
+{
+	DynamicAABBTree::DynamicAABBTree(float margin, float displacementScale) :
+		m_margin(margin),
+		m_displacementScale(displacementScale)
+	{
+	}
+
+	int32_t DynamicAABBTree::createProxy(const AABB& box, uint32_t userData)
+	{
+		int32_t proxy = allocateNode();
+		Node& node = m_nodes[proxy];
+		node.box = { box.min - glm::vec3(m_margin), box.max + glm::vec3(m_margin) };
+		node.userData = userData;
+		node.height = 0;
+
+		insertLeaf(proxy);
+		m_proxyCount++;
+		return proxy;
+	}
+
+	void DynamicAABBTree::destroyProxy(int32_t proxy)
+	{
+		removeLeaf(proxy);
+		freeNode(proxy);
+		m_proxyCount--;
+	}
+
+	bool DynamicAABBTree::moveProxy(int32_t proxy, const AABB& box, const glm::vec3& displacement)
+	{
+		AABB fat = { box.min - glm::vec3(m_margin), box.max + glm::vec3(m_margin) };
+
+		// Extend the box along the direction of movement, so a steadily moving object stays inside it for longer.
+		glm::vec3 ahead = displacement * m_displacementScale;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (ahead[axis] < 0.f) fat.min[axis] += ahead[axis];
+			else fat.max[axis] += ahead[axis];
+		}
+
+		// Keep the old box while it still holds the object, unless it has grown far larger than the object needs, as after a fast move.
+		const AABB& current = m_nodes[proxy].box;
+		if (current.contains(box))
+		{
+			AABB loose = { fat.min - glm::vec3(4.f * m_margin), fat.max + glm::vec3(4.f * m_margin) };
+			if (loose.contains(current)) return false;
+		}
+
+		removeLeaf(proxy);
+		m_nodes[proxy].box = fat;
+		insertLeaf(proxy);
+		return true;
+	}
+
+	float DynamicAABBTree::getAreaRatio() const
+	{
+		if (m_root == NullNode) return 0.f;
+
+		float rootArea = m_nodes[m_root].box.getSurfaceArea();
+		if (rootArea <= 0.f) return 0.f;
+
+		float totalArea = 0.f;
+		for (const Node& node : m_nodes)
+		{
+			if (node.height > 0) totalArea += node.box.getSurfaceArea();
+		}
+		return totalArea / rootArea;
+	}
+
+	bool DynamicAABBTree::validate() const
+	{
+		if (m_root == NullNode) return m_proxyCount == 0;
+		if (m_nodes[m_root].parent != NullNode) return false;
+
+		uint32_t leaves = 0;
+		std::vector<int32_t> stack = { m_root };
+		while (!stack.empty())
+		{
+			int32_t id = stack.back();
+			stack.pop_back();
+			const Node& node = m_nodes[id];
+
+			if (node.isLeaf())
+			{
+				if (node.child2 != NullNode || node.height != 0) return false;
+				leaves++;
+				continue;
+			}
+
+			const Node& child1 = m_nodes[node.child1];
+			const Node& child2 = m_nodes[node.child2];
+			if (child1.parent != id || child2.parent != id) return false;
+			if (node.height != 1 + std::max(child1.height, child2.height)) return false;
+			if (!node.box.contains(child1.box) || !node.box.contains(child2.box)) return false;
+
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+		}
+		return leaves == m_proxyCount;
+	}
+
+	int32_t DynamicAABBTree::allocateNode()
+	{
+		if (m_freeList == NullNode)
+		{
+			m_nodes.emplace_back();
+			return static_cast<int32_t>(m_nodes.size() - 1);
+		}
+
+		int32_t id = m_freeList;
+		m_freeList = m_nodes[id].parent;
+		m_nodes[id] = Node();
+		return id;
+	}
+
+	void DynamicAABBTree::freeNode(int32_t node)
+	{
+		m_nodes[node] = Node();
+		m_nodes[node].parent = m_freeList;
+		m_freeList = node;
+	}
+
+	void DynamicAABBTree::insertLeaf(int32_t leaf)
+	{
+		if (m_root == NullNode)
+		{
+			m_root = leaf;
+			m_nodes[leaf].parent = NullNode;
+			return;
+		}
+
+		// Descend towards the cheapest sibling, where cost is the area added to the tree by pairing with it.
+		AABB leafBox = m_nodes[leaf].box;
+		int32_t index = m_root;
+		while (!m_nodes[index].isLeaf())
+		{
+			const Node& node = m_nodes[index];
+			float area = node.box.getSurfaceArea();
+			float combinedArea = AABB::merge(node.box, leafBox).getSurfaceArea();
+
+			// Pairing here makes a new parent of the combined area, and every ancestor grows by the same amount.
+			float cost = 2.f * combinedArea;
+			float inheritedCost = 2.f * (combinedArea - area);
+
+			auto descentCost = [&](int32_t child)
+			{
+				const Node& childNode = m_nodes[child];
+				float mergedArea = AABB::merge(childNode.box, leafBox).getSurfaceArea();
+				return (childNode.isLeaf() ? mergedArea : mergedArea - childNode.box.getSurfaceArea()) + inheritedCost;
+			};
+			float cost1 = descentCost(node.child1);
+			float cost2 = descentCost(node.child2);
+
+			if (cost < cost1 && cost < cost2) break;
+			index = cost1 < cost2 ? node.child1 : node.child2;
+		}
+
+		int32_t sibling = index;
+		int32_t oldParent = m_nodes[sibling].parent;
+		int32_t newParent = allocateNode();
+
+		Node& parent = m_nodes[newParent];
+		parent.parent = oldParent;
+		parent.box = AABB::merge(leafBox, m_nodes[sibling].box);
+		parent.height = m_nodes[sibling].height + 1;
+		parent.child1 = sibling;
+		parent.child2 = leaf;
+		m_nodes[sibling].parent = newParent;
+		m_nodes[leaf].parent = newParent;
+
+		if (oldParent == NullNode) m_root = newParent;
+		else if (m_nodes[oldParent].child1 == sibling) m_nodes[oldParent].child1 = newParent;
+		else m_nodes[oldParent].child2 = newParent;
+
+		refitAncestors(m_nodes[leaf].parent);
+	}
+
+	void DynamicAABBTree::removeLeaf(int32_t leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = NullNode;
+			return;
+		}
+
+		int32_t parent = m_nodes[leaf].parent;
+		int32_t grandParent = m_nodes[parent].parent;
+		int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+		// The sibling takes the parent's place.
+		m_nodes[sibling].parent = grandParent;
+		freeNode(parent);
+		m_nodes[leaf].parent = NullNode;
+
+		if (grandParent == NullNode)
+		{
+			m_root = sibling;
+			return;
+		}
+
+		if (m_nodes[grandParent].child1 == parent) m_nodes[grandParent].child1 = sibling;
+		else m_nodes[grandParent].child2 = sibling;
+		refitAncestors(grandParent);
+	}
+
+	void DynamicAABBTree::refitAncestors(int32_t node)
+	{
+		int32_t index = node;
+		while (index != NullNode)
+		{
+			index = balance(index);
+
+			Node& current = m_nodes[index];
+			const Node& child1 = m_nodes[current.child1];
+			const Node& child2 = m_nodes[current.child2];
+			current.height = 1 + std::max(child1.height, child2.height);
+			current.box = AABB::merge(child1.box, child2.box);
+
+			index = current.parent;
+		}
+	}
+
+	int32_t DynamicAABBTree::balance(int32_t iA)
+	{
+		Node& A = m_nodes[iA];
+		if (A.isLeaf() || A.height < 2) return iA;
+
+		int32_t iB = A.child1;
+		int32_t iC = A.child2;
+		Node& B = m_nodes[iB];
+		Node& C = m_nodes[iC];
+		int32_t heightDifference = C.height - B.height;
+
+		if (heightDifference > 1)
+		{
+			// Rotate C up, giving A whichever of C's children is shorter.
+			int32_t iF = C.child1;
+			int32_t iG = C.child2;
+			Node& F = m_nodes[iF];
+			Node& G = m_nodes[iG];
+
+			C.child1 = iA;
+			C.parent = A.parent;
+			A.parent = iC;
+
+			if (C.parent == NullNode) m_root = iC;
+			else if (m_nodes[C.parent].child1 == iA) m_nodes[C.parent].child1 = iC;
+			else m_nodes[C.parent].child2 = iC;
+
+			int32_t iKeep = F.height > G.height ? iF : iG;
+			int32_t iMove = F.height > G.height ? iG : iF;
+			C.child2 = iKeep;
+			A.child2 = iMove;
+			m_nodes[iMove].parent = iA;
+
+			A.box = AABB::merge(B.box, m_nodes[iMove].box);
+			C.box = AABB::merge(A.box, m_nodes[iKeep].box);
+			A.height = 1 + std::max(B.height, m_nodes[iMove].height);
+			C.height = 1 + std::max(A.height, m_nodes[iKeep].height);
+			return iC;
+		}
+
+		if (heightDifference < -1)
+		{
+			// Rotate B up, the mirror of the above.
+			int32_t iD = B.child1;
+			int32_t iE = B.child2;
+			Node& D = m_nodes[iD];
+			Node& E = m_nodes[iE];
+
+			B.child1 = iA;
+			B.parent = A.parent;
+			A.parent = iB;
+
+			if (B.parent == NullNode) m_root = iB;
+			else if (m_nodes[B.parent].child1 == iA) m_nodes[B.parent].child1 = iB;
+			else m_nodes[B.parent].child2 = iB;
+
+			int32_t iKeep = D.height > E.height ? iD : iE;
+			int32_t iMove = D.height > E.height ? iE : iD;
+			B.child2 = iKeep;
+			A.child1 = iMove;
+			m_nodes[iMove].parent = iA;
+
+			A.box = AABB::merge(C.box, m_nodes[iMove].box);
+			B.box = AABB::merge(A.box, m_nodes[iKeep].box);
+			A.height = 1 + std::max(C.height, m_nodes[iMove].height);
+			B.height = 1 + std::max(A.height, m_nodes[iKeep].height);
+			return iB;
+		}
+
+		return iA;
+	}
+}
@@ -0,0 +1,223 @@
+#include "engine_pch.h"
+#include "scene/entityRegistry.h"
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+
+namespace Engine
+{
+	namespace
+	{
+		/** @brief The registered component types, indexed by ID. */
+		std::vector<ComponentInfo>& componentInfos()
+		{
+			static std::vector<ComponentInfo> s_infos;
+			return s_infos;
+		}
+
+		/** @brief Guards registration, as types may first be used from several threads. */
+		std::mutex s_registerMutex;
+	}
+
+	namespace ComponentTypes
+	{
+		uint32_t registerType(const ComponentInfo& info)
+		{
+			std::lock_guard<std::mutex> lock(s_registerMutex);
+			auto& infos = componentInfos();
+
+			// Every type needs a bit of ComponentMask, running out is a programming error.
+			if (infos.size() == maxTypes) std::abort();
+
+			// Reserved up front so references returned by getInfo stay valid while other types register.
+			infos.reserve(maxTypes);
+			infos.push_back(info);
+			return static_cast<uint32_t>(infos.size() - 1);
+		}
+
+		const ComponentInfo& getInfo(uint32_t id)
+		{
+			return componentInfos()[id];
+		}
+	}
+
+	Archetype::Archetype(ComponentMask mask) :
+		m_mask(mask)
+	{
+		uint32_t rowSize = sizeof(Entity);
+		for (uint32_t type = 0; type < ComponentTypes::maxTypes; type++)
+		{
+			m_offsets[type] = 0;
+			if (mask & (ComponentMask(1) << type))
+			{
+				m_types.push_back(type);
+				rowSize += ComponentTypes::getInfo(type).size;
+			}
+		}
+
+		// Lay out the entities, then each array aligned for its type, shrinking the capacity until the padding fits.
+		auto layout = [this](uint32_t capacity)
+		{
+			uint32_t offset = sizeof(Entity) * capacity;
+			for (uint32_t type : m_types)
+			{
+				const ComponentInfo& info = ComponentTypes::getInfo(type);
+				offset = (offset + info.alignment - 1) / info.alignment * info.alignment;
+				m_offsets[type] = offset;
+				offset += info.size * capacity;
+			}
+			return offset;
+		};
+
+		m_capacity = std::max(chunkSize / rowSize, 1u);
+		m_bytes = layout(m_capacity);
+		while (m_bytes > chunkSize && m_capacity > 1) m_bytes = layout(--m_capacity);
+	}
+
+	Archetype::~Archetype()
+	{
+		for (uint32_t chunk = 0; chunk < m_chunks.size(); chunk++)
+		{
+			for (uint32_t type : m_types)
+			{
+				const ComponentInfo& info = ComponentTypes::getInfo(type);
+				uint8_t* column = static_cast<uint8_t*>(getColumn(chunk, type));
+				for (uint32_t row = 0; row < m_chunks[chunk].count; row++) info.destroy(column + info.size * row);
+			}
+			::operator delete(m_chunks[chunk].data, std::align_val_t(chunkAlignment));
+		}
+	}
+
+	void Archetype::allocateRow(Entity entity, uint32_t& chunk, uint32_t& row)
+	{
+		if (m_chunks.empty() || m_chunks.back().count == m_capacity)
+		{
+			Chunk newChunk;
+			newChunk.data = static_cast<uint8_t*>(::operator new(m_bytes, std::align_val_t(chunkAlignment)));
+			m_chunks.push_back(newChunk);
+		}
+
+		chunk = static_cast<uint32_t>(m_chunks.size() - 1);
+		row = m_chunks[chunk].count++;
+		getEntities(chunk)[row] = entity;
+	}
+
+	Entity Archetype::removeRow(uint32_t chunk, uint32_t row, bool destroyComponents)
+	{
+		uint32_t lastChunk = static_cast<uint32_t>(m_chunks.size() - 1);
+		uint32_t lastRow = m_chunks[lastChunk].count - 1;
+		Entity moved = NullEntity;
+
+		for (uint32_t type : m_types)
+		{
+			const ComponentInfo& info = ComponentTypes::getInfo(type);
+			uint8_t* component = static_cast<uint8_t*>(getColumn(chunk, type)) + info.size * row;
+			if (destroyComponents) info.destroy(component);
+
+			// Fill the hole with the archetype's last row, so every chunk but the last stays full.
+			if (chunk != lastChunk || row != lastRow) info.moveAndDestroy(component, static_cast<uint8_t*>(getColumn(lastChunk, type)) + info.size * lastRow);
+		}
+
+		if (chunk != lastChunk || row != lastRow)
+		{
+			moved = getEntities(lastChunk)[lastRow];
+			getEntities(chunk)[row] = moved;
+		}
+
+		if (--m_chunks[lastChunk].count == 0)
+		{
+			::operator delete(m_chunks[lastChunk].data, std::align_val_t(chunkAlignment));
+			m_chunks.pop_back();
+		}
+
+		return moved;
+	}
+
+	EntityRegistry::EntityRegistry()
+	{
+		getArchetype(0);
+	}
+
+	void EntityRegistry::destroy(Entity entity)
+	{
+		if (!isAlive(entity)) return;
+
+		Record& record = m_records[entity.index];
+		Entity moved = m_archetypes[record.archetype]->removeRow(record.chunk, record.row, true);
+		if (moved != NullEntity)
+		{
+			m_records[moved.index].chunk = record.chunk;
+			m_records[moved.index].row = record.row;
+		}
+
+		// Bumping the generation invalidates every handle to the destroyed entity.
+		record.generation++;
+		m_freeRecords.push_back(entity.index);
+		m_alive--;
+	}
+
+	uint32_t EntityRegistry::getArchetype(ComponentMask mask)
+	{
+		auto it = m_archetypeIndices.find(mask);
+		if (it != m_archetypeIndices.end()) return it->second;
+
+		uint32_t index = static_cast<uint32_t>(m_archetypes.size());
+		m_archetypes.emplace_back(new Archetype(mask));
+		m_archetypeIndices.emplace(mask, index);
+		return index;
+	}
+
+	Entity EntityRegistry::createEntity(ComponentMask mask)
+	{
+		Entity entity;
+		if (m_freeRecords.empty())
+		{
+			entity.index = static_cast<uint32_t>(m_records.size());
+			m_records.emplace_back();
+		}
+		else
+		{
+			entity.index = m_freeRecords.back();
+			m_freeRecords.pop_back();
+		}
+
+		Record& record = m_records[entity.index];
+		entity.generation = record.generation;
+		record.archetype = getArchetype(mask);
+		m_archetypes[record.archetype]->allocateRow(entity, record.chunk, record.row);
+
+		m_alive++;
+		return entity;
+	}
+
+	void EntityRegistry::move(Entity entity, ComponentMask mask)
+	{
+		uint32_t toIndex = getArchetype(mask);
+		Record& record = m_records[entity.index];
+		Archetype& from = *m_archetypes[record.archetype];
+		Archetype& to = *m_archetypes[toIndex];
+
+		uint32_t chunk, row;
+		to.allocateRow(entity, chunk, row);
+
+		// Shared components move across, the rest are destroyed, leaving the old row empty.
+		for (uint32_t type : from.getTypes())
+		{
+			const ComponentInfo& info = ComponentTypes::getInfo(type);
+			uint8_t* source = static_cast<uint8_t*>(from.getColumn(record.chunk, type)) + info.size * record.row;
+			if (mask & (ComponentMask(1) << type)) info.moveAndDestroy(static_cast<uint8_t*>(to.getColumn(chunk, type)) + info.size * row, source);
+			else info.destroy(source);
+		}
+
+		Entity moved = from.removeRow(record.chunk, record.row, false);
+		if (moved != NullEntity)
+		{
+			m_records[moved.index].chunk = record.chunk;
+			m_records[moved.index].row = record.row;
+		}
+
+		record.archetype = toIndex;
+		record.chunk = chunk;
+		record.row = row;
+	}
+}
@@ -0,0 +1,278 @@
+#include "engine_pch.h"
+#include "scene/transformHierarchy.h"
+#include "scene/transformKernels.h"
+#include <algorithm>
+#include <numeric>
+
+namespace Engine
+{
+	void TransformHierarchy::reserve(uint32_t count)
+	{
+		m_positions.reserve(count);
+		m_rotations.reserve(count);
+		m_scales.reserve(count);
+		m_parents.reserve(count);
+		m_worlds.reserve(count);
+		m_normals.reserve(count);
+		m_dirty.reserve(count);
+		m_changed.reserve(count);
+		m_ids.reserve(count);
+		m_slots.reserve(count);
+	}
+
+	TransformID TransformHierarchy::create(TransformID parent)
+	{
+		// A new transform is appended after every existing one, so after its parent.
+		uint32_t slot = static_cast<uint32_t>(m_ids.size());
+		TransformID id;
+		if (m_freeIDs.empty())
+		{
+			id = static_cast<TransformID>(m_slots.size());
+			m_slots.push_back(slot);
+		}
+		else
+		{
+			id = m_freeIDs.back();
+			m_freeIDs.pop_back();
+			m_slots[id] = slot;
+		}
+
+		m_positions.push_back(glm::vec3(0.f));
+		m_rotations.push_back(glm::quat(1.f, 0.f, 0.f, 0.f));
+		m_scales.push_back(glm::vec3(1.f));
+		m_parents.push_back(parent == NullTransform ? NullTransform : m_slots[parent]);
+		m_worlds.push_back(glm::mat4(1.f));
+		m_normals.push_back(glm::mat3(1.f));
+		m_dirty.push_back(0);
+		m_changed.push_back(0);
+		m_ids.push_back(id);
+
+		markDirty(slot);
+		return id;
+	}
+
+	void TransformHierarchy::destroy(TransformID id)
+	{
+		uint32_t slot = m_slots[id];
+		uint32_t last = static_cast<uint32_t>(m_ids.size()) - 1;
+
+		// The children take the removed transform's place under its parent, and are recomputed against it.
+		moveChildren(slot, m_parents[slot], true);
+
+		// Fill the hole with the last slot, whose children follow it and whose world matrix is still valid.
+		if (slot != last)
+		{
+			m_positions[slot] = m_positions[last];
+			m_rotations[slot] = m_rotations[last];
+			m_scales[slot] = m_scales[last];
+			m_parents[slot] = m_parents[last];
+			m_worlds[slot] = m_worlds[last];
+			m_normals[slot] = m_normals[last];
+			m_dirty[slot] = m_dirty[last];
+			m_changed[slot] = m_changed[last];
+			m_ids[slot] = m_ids[last];
+			m_slots[m_ids[slot]] = slot;
+
+			moveChildren(last, slot, false);
+			if (m_parents[slot] != NullTransform && m_parents[slot] > slot) m_needsSort = true;
+			if (m_dirty[slot]) markDirty(slot);
+		}
+
+		m_positions.pop_back();
+		m_rotations.pop_back();
+		m_scales.pop_back();
+		m_parents.pop_back();
+		m_worlds.pop_back();
+		m_normals.pop_back();
+		m_dirty.pop_back();
+		m_changed.pop_back();
+		m_ids.pop_back();
+
+		m_slots[id] = NullTransform;
+		m_freeIDs.push_back(id);
+		if (m_firstDirty != NullTransform && m_firstDirty >= last) m_firstDirty = NullTransform;
+	}
+
+	bool TransformHierarchy::setParent(TransformID id, TransformID parent)
+	{
+		uint32_t slot = m_slots[id];
+		uint32_t parentSlot = parent == NullTransform ? NullTransform : m_slots[parent];
+
+		// Refuse to make a transform its own ancestor.
+		for (uint32_t ancestor = parentSlot; ancestor != NullTransform; ancestor = m_parents[ancestor])
+		{
+			if (ancestor == slot) return false;
+		}
+
+		m_parents[slot] = parentSlot;
+		if (parentSlot != NullTransform && parentSlot > slot) m_needsSort = true;
+		markDirty(slot);
+		return true;
+	}
+
+	void TransformHierarchy::setPosition(TransformID id, const glm::vec3& position)
+	{
+		uint32_t slot = m_slots[id];
+		m_positions[slot] = position;
+		markDirty(slot);
+	}
+
+	void TransformHierarchy::setRotation(TransformID id, const glm::quat& rotation)
+	{
+		uint32_t slot = m_slots[id];
+		m_rotations[slot] = rotation;
+		markDirty(slot);
+	}
+
+	void TransformHierarchy::setScale(TransformID id, const glm::vec3& scale)
+	{
+		uint32_t slot = m_slots[id];
+		m_scales[slot] = scale;
+		markDirty(slot);
+	}
+
+	TransformID TransformHierarchy::getParent(TransformID id) const
+	{
+		uint32_t parentSlot = m_parents[m_slots[id]];
+		return parentSlot == NullTransform ? NullTransform : m_ids[parentSlot];
+	}
+
+	void TransformHierarchy::update()
+	{
+		m_updated.clear();
+		if (m_needsSort) sort();
+		if (m_firstDirty == NullTransform) return;
+
+		// Parents precede children, so by the time a slot is reached its parent's changed flag is final.
+		// Slots before the first dirty one were not touched, so their changed flags are stale and never read.
+		uint32_t first = m_firstDirty;
+		uint32_t count = static_cast<uint32_t>(m_ids.size());
+		m_batch.clear();
+		for (uint32_t slot = first; slot < count; slot++)
+		{
+			uint32_t parent = m_parents[slot];
+			bool parentChanged = parent != NullTransform && parent >= first && m_changed[parent];
+
+			m_changed[slot] = m_dirty[slot] || parentChanged;
+			if (!m_changed[slot]) continue;
+
+			m_dirty[slot] = 0;
+			m_batch.push_back(slot);
+			m_updated.push_back(m_ids[slot]);
+		}
+
+		// Gather the batch's local transforms into streams, so the kernel composes them several at a time.
+		uint32_t batchSize = static_cast<uint32_t>(m_batch.size());
+		m_batchTRS.resize(static_cast<size_t>(batchSize) * 10);
+		float* streams[10];
+		for (uint32_t s = 0; s < 10; s++) streams[s] = m_batchTRS.data() + static_cast<size_t>(s) * batchSize;
+		for (uint32_t i = 0; i < batchSize; i++)
+		{
+			uint32_t slot = m_batch[i];
+			const glm::vec3& position = m_positions[slot];
+			const glm::quat& rotation = m_rotations[slot];
+			const glm::vec3& scale = m_scales[slot];
+			streams[0][i] = position.x; streams[1][i] = position.y; streams[2][i] = position.z;
+			streams[3][i] = rotation.x; streams[4][i] = rotation.y; streams[5][i] = rotation.z; streams[6][i] = rotation.w;
+			streams[7][i] = scale.x; streams[8][i] = scale.y; streams[9][i] = scale.z;
+		}
+
+		TRSStreams trs = { { streams[0], streams[1], streams[2] }, { streams[3], streams[4], streams[5], streams[6] }, { streams[7], streams[8], streams[9] } };
+		m_batchLocals.resize(batchSize);
+		m_batchNormals.resize(batchSize);
+		TransformKernels::compose(trs, batchSize, m_batchLocals.data(), m_batchNormals.data());
+
+		// The batch is in slot order, so each parent's world matrix is final before its children are joined to it.
+		for (uint32_t i = 0; i < batchSize; i++)
+		{
+			uint32_t slot = m_batch[i];
+			uint32_t parent = m_parents[slot];
+			if (parent == NullTransform)
+			{
+				m_worlds[slot] = m_batchLocals[i];
+				m_normals[slot] = m_batchNormals[i];
+			}
+			else
+			{
+				m_worlds[slot] = m_worlds[parent] * m_batchLocals[i];
+				m_normals[slot] = m_normals[parent] * m_batchNormals[i];
+			}
+		}
+
+		m_firstDirty = NullTransform;
+	}
+
+	void TransformHierarchy::markDirty(uint32_t slot)
+	{
+		m_dirty[slot] = 1;
+		m_firstDirty = std::min(m_firstDirty, slot);
+	}
+
+	void TransformHierarchy::moveChildren(uint32_t from, uint32_t to, bool dirty)
+	{
+		uint32_t count = static_cast<uint32_t>(m_ids.size());
+		for (uint32_t slot = 0; slot < count; slot++)
+		{
+			if (m_parents[slot] != from) continue;
+
+			m_parents[slot] = to;
+			if (to != NullTransform && to > slot) m_needsSort = true;
+			if (dirty) markDirty(slot);
+		}
+	}
+
+	void TransformHierarchy::sort()
+	{
+		m_needsSort = false;
+		uint32_t count = static_cast<uint32_t>(m_ids.size());
+
+		// Ordering by depth puts every parent before its children.
+		std::vector<uint32_t> depths(count, NullTransform);
+		std::vector<uint32_t> chain;
+		for (uint32_t slot = 0; slot < count; slot++)
+		{
+			uint32_t current = slot;
+			while (current != NullTransform && depths[current] == NullTransform)
+			{
+				chain.push_back(current);
+				current = m_parents[current];
+			}
+
+			uint32_t depth = current == NullTransform ? 0 : depths[current] + 1;
+			for (auto it = chain.rbegin(); it != chain.rend(); ++it) depths[*it] = depth++;
+			chain.clear();
+		}
+
+		std::vector<uint32_t> order(count);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&depths](uint32_t a, uint32_t b) { return depths[a] < depths[b]; });
+
+		// order[newSlot] is the old slot, remap parents through the inverse.
+		std::vector<uint32_t> newSlots(count);
+		for (uint32_t slot = 0; slot < count; slot++) newSlots[order[slot]] = slot;
+
+		auto permute = [&order, count](auto& values)
+		{
+			auto permuted = values;
+			for (uint32_t slot = 0; slot < count; slot++) permuted[slot] = values[order[slot]];
+			values.swap(permuted);
+		};
+
+		permute(m_positions);
+		permute(m_rotations);
+		permute(m_scales);
+		permute(m_parents);
+		permute(m_worlds);
+		permute(m_normals);
+		permute(m_dirty);
+		permute(m_ids);
+
+		m_firstDirty = NullTransform;
+		for (uint32_t slot = 0; slot < count; slot++)
+		{
+			if (m_parents[slot] != NullTransform) m_parents[slot] = newSlots[m_parents[slot]];
+			m_slots[m_ids[slot]] = slot;
+			if (m_dirty[slot] && m_firstDirty == NullTransform) m_firstDirty = slot;
+		}
+	}
+}
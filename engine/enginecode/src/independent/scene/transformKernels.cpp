@@ -0,0 +1,191 @@
+#include "engine_pch.h"
+#include "scene/transformKernels.h"
+#include <algorithm>
+
+// SSE2 is part of every x64 target. AVX2 is only compiled into the functions which use it, and only run once CpuFeatures reports it.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <immintrin.h>
+	#define NG_TRANSFORM_SSE 1
+	#if defined(_MSC_VER)
+		#define NG_TRANSFORM_AVX2 1
+		#define NG_TARGET_AVX2
+	#elif defined(__GNUC__) || defined(__clang__)
+		#define NG_TRANSFORM_AVX2 1
+		#define NG_TARGET_AVX2 __attribute__((target("avx2,fma")))
+	#endif
+#endif
+
+namespace Engine
+{
+	namespace
+	{
+		static_assert(sizeof(glm::mat4) == 16 * sizeof(float) && sizeof(glm::mat3) == 9 * sizeof(float), "The kernels write matrices as tightly packed floats");
+
+		/** @brief Compose one transform, the reference the vector paths must match. */
+		void composeScalar(const TRSStreams& trs, uint32_t begin, uint32_t end, glm::mat4* matrices, glm::mat3* normals)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				float x = trs.rotation[0][i], y = trs.rotation[1][i], z = trs.rotation[2][i], w = trs.rotation[3][i];
+				float xx = x * x, yy = y * y, zz = z * z, xy = x * y, xz = x * z, yz = y * z, wx = w * x, wy = w * y, wz = w * z;
+
+				glm::vec3 basis[3] = {
+					glm::vec3(1.f - 2.f * (yy + zz), 2.f * (xy + wz), 2.f * (xz - wy)),
+					glm::vec3(2.f * (xy - wz), 1.f - 2.f * (xx + zz), 2.f * (yz + wx)),
+					glm::vec3(2.f * (xz + wy), 2.f * (yz - wx), 1.f - 2.f * (xx + yy))
+				};
+
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					float scale = trs.scale[c][i];
+					matrices[i][c] = glm::vec4(basis[c] * scale, 0.f);
+					if (normals) normals[i][c] = basis[c] * (1.f / scale);
+				}
+				matrices[i][3] = glm::vec4(trs.position[0][i], trs.position[1][i], trs.position[2][i], 1.f);
+			}
+		}
+
+#if defined(NG_TRANSFORM_SSE)
+		/** @brief Store one column of four consecutive matrices, from registers holding one row of the column for each matrix. */
+		inline void storeColumn4(__m128 x, __m128 y, __m128 z, __m128 w, float* column, uint32_t matrixStride)
+		{
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			_mm_storeu_ps(column, x);
+			_mm_storeu_ps(column + matrixStride, y);
+			_mm_storeu_ps(column + 2 * matrixStride, z);
+			_mm_storeu_ps(column + 3 * matrixStride, w);
+		}
+
+		/** @brief Store three rows of one column of four consecutive 3x3 matrices, without writing past the last. */
+		inline void storeColumn3(__m128 x, __m128 y, __m128 z, float* column)
+		{
+			__m128 w = _mm_setzero_ps();
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			__m128 lanes[4] = { x, y, z, w };
+			for (uint32_t lane = 0; lane < 4; lane++)
+			{
+				_mm_storel_pi(reinterpret_cast<__m64*>(column + 9 * lane), lanes[lane]);
+				_mm_store_ss(column + 9 * lane + 2, _mm_movehl_ps(lanes[lane], lanes[lane]));
+			}
+		}
+
+		/** @brief Compose four transforms at a time, one per lane. */
+		void composeSSE(const TRSStreams& trs, uint32_t begin, uint32_t end, glm::mat4* matrices, glm::mat3* normals)
+		{
+			const __m128 one = _mm_set1_ps(1.f), zero = _mm_setzero_ps();
+			for (uint32_t i = begin; i < end; i += 4)
+			{
+				__m128 x = _mm_loadu_ps(trs.rotation[0] + i), y = _mm_loadu_ps(trs.rotation[1] + i);
+				__m128 z = _mm_loadu_ps(trs.rotation[2] + i), w = _mm_loadu_ps(trs.rotation[3] + i);
+				__m128 x2 = _mm_add_ps(x, x), y2 = _mm_add_ps(y, y), z2 = _mm_add_ps(z, z);
+				__m128 xx = _mm_mul_ps(x, x2), yy = _mm_mul_ps(y, y2), zz = _mm_mul_ps(z, z2);
+				__m128 xy = _mm_mul_ps(x, y2), xz = _mm_mul_ps(x, z2), yz = _mm_mul_ps(y, z2);
+				__m128 wx = _mm_mul_ps(w, x2), wy = _mm_mul_ps(w, y2), wz = _mm_mul_ps(w, z2);
+
+				__m128 basis[3][3] = {
+					{ _mm_sub_ps(one, _mm_add_ps(yy, zz)), _mm_add_ps(xy, wz), _mm_sub_ps(xz, wy) },
+					{ _mm_sub_ps(xy, wz), _mm_sub_ps(one, _mm_add_ps(xx, zz)), _mm_add_ps(yz, wx) },
+					{ _mm_add_ps(xz, wy), _mm_sub_ps(yz, wx), _mm_sub_ps(one, _mm_add_ps(xx, yy)) }
+				};
+
+				float* matrix = &matrices[i][0][0];
+				float* normal = normals ? &normals[i][0][0] : nullptr;
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					__m128 scale = _mm_loadu_ps(trs.scale[c] + i);
+					storeColumn4(_mm_mul_ps(basis[c][0], scale), _mm_mul_ps(basis[c][1], scale), _mm_mul_ps(basis[c][2], scale), zero, matrix + 4 * c, 16);
+					if (!normal) continue;
+
+					__m128 inverseScale = _mm_div_ps(one, scale);
+					storeColumn3(_mm_mul_ps(basis[c][0], inverseScale), _mm_mul_ps(basis[c][1], inverseScale), _mm_mul_ps(basis[c][2], inverseScale), normal + 3 * c);
+				}
+				storeColumn4(_mm_loadu_ps(trs.position[0] + i), _mm_loadu_ps(trs.position[1] + i), _mm_loadu_ps(trs.position[2] + i), one, matrix + 12, 16);
+			}
+		}
+#endif
+
+#if defined(NG_TRANSFORM_AVX2)
+		/** @brief Compose eight transforms at a time, one per lane, storing each half through the SSE transposes. */
+		NG_TARGET_AVX2 void composeAVX2(const TRSStreams& trs, uint32_t begin, uint32_t end, glm::mat4* matrices, glm::mat3* normals)
+		{
+			const __m256 one = _mm256_set1_ps(1.f);
+			const __m128 zero = _mm_setzero_ps(), oneLanes = _mm_set1_ps(1.f);
+			for (uint32_t i = begin; i < end; i += 8)
+			{
+				__m256 x = _mm256_loadu_ps(trs.rotation[0] + i), y = _mm256_loadu_ps(trs.rotation[1] + i);
+				__m256 z = _mm256_loadu_ps(trs.rotation[2] + i), w = _mm256_loadu_ps(trs.rotation[3] + i);
+				__m256 x2 = _mm256_add_ps(x, x), y2 = _mm256_add_ps(y, y), z2 = _mm256_add_ps(z, z);
+				__m256 wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+				__m256 yz = _mm256_mul_ps(y, z2);
+
+				// The diagonal is one minus two squares, the rest a product plus or minus another.
+				__m256 basis[3][3] = {
+					{ _mm256_fnmadd_ps(z, z2, _mm256_fnmadd_ps(y, y2, one)), _mm256_fmadd_ps(x, y2, wz), _mm256_fmsub_ps(x, z2, wy) },
+					{ _mm256_fmsub_ps(x, y2, wz), _mm256_fnmadd_ps(z, z2, _mm256_fnmadd_ps(x, x2, one)), _mm256_add_ps(yz, wx) },
+					{ _mm256_fmadd_ps(x, z2, wy), _mm256_sub_ps(yz, wx), _mm256_fnmadd_ps(y, y2, _mm256_fnmadd_ps(x, x2, one)) }
+				};
+
+				float* matrix = &matrices[i][0][0];
+				float* normal = normals ? &normals[i][0][0] : nullptr;
+				__m256 columns[3], inverseColumns[3];
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					__m256 scale = _mm256_loadu_ps(trs.scale[c] + i);
+					__m256 inverseScale = _mm256_div_ps(one, scale);
+					for (uint32_t r = 0; r < 3; r++)
+					{
+						columns[r] = _mm256_mul_ps(basis[c][r], scale);
+						inverseColumns[r] = _mm256_mul_ps(basis[c][r], inverseScale);
+					}
+
+					for (uint32_t half = 0; half < 2; half++)
+					{
+						__m128 cx = half ? _mm256_extractf128_ps(columns[0], 1) : _mm256_castps256_ps128(columns[0]);
+						__m128 cy = half ? _mm256_extractf128_ps(columns[1], 1) : _mm256_castps256_ps128(columns[1]);
+						__m128 cz = half ? _mm256_extractf128_ps(columns[2], 1) : _mm256_castps256_ps128(columns[2]);
+						storeColumn4(cx, cy, cz, zero, matrix + 64 * half + 4 * c, 16);
+						if (!normal) continue;
+
+						__m128 nx = half ? _mm256_extractf128_ps(inverseColumns[0], 1) : _mm256_castps256_ps128(inverseColumns[0]);
+						__m128 ny = half ? _mm256_extractf128_ps(inverseColumns[1], 1) : _mm256_castps256_ps128(inverseColumns[1]);
+						__m128 nz = half ? _mm256_extractf128_ps(inverseColumns[2], 1) : _mm256_castps256_ps128(inverseColumns[2]);
+						storeColumn3(nx, ny, nz, normal + 36 * half + 3 * c);
+					}
+				}
+
+				for (uint32_t half = 0; half < 2; half++)
+				{
+					uint32_t first = i + 4 * half;
+					storeColumn4(_mm_loadu_ps(trs.position[0] + first), _mm_loadu_ps(trs.position[1] + first), _mm_loadu_ps(trs.position[2] + first), oneLanes, matrix + 64 * half + 12, 16);
+				}
+			}
+		}
+#endif
+	}
+
+	namespace TransformKernels
+	{
+		void compose(const TRSStreams& trs, uint32_t count, glm::mat4* matrices, glm::mat3* normals, InstructionSet set)
+		{
+			set = std::min(set, CpuFeatures::getSupportedInstructionSet());
+
+			// Each path takes as many whole vectors as it can and leaves the rest to the next narrower one.
+			uint32_t done = 0;
+#if defined(NG_TRANSFORM_AVX2)
+			if (set == InstructionSet::AVX2)
+			{
+				composeAVX2(trs, 0, count & ~7u, matrices, normals);
+				done = count & ~7u;
+			}
+#endif
+#if defined(NG_TRANSFORM_SSE)
+			if (set != InstructionSet::Scalar)
+			{
+				composeSSE(trs, done, count & ~3u, matrices, normals);
+				done = count & ~3u;
+			}
+#endif
+			composeScalar(trs, done, count, matrices, normals);
+		}
+	}
+}
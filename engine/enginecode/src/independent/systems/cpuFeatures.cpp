@@ -0,0 +1,64 @@
+#include "engine_pch.h"
+#include "systems/cpuFeatures.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define NG_CPU_SSE 1
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#include <immintrin.h>
+		#define NG_CPU_AVX2 1
+	#elif defined(__GNUC__) || defined(__clang__)
+		#define NG_CPU_AVX2 1
+	#endif
+#endif
+
+namespace Engine
+{
+	namespace
+	{
+		/** @brief Find the widest instruction set the CPU and operating system support. */
+		InstructionSet detectInstructionSet()
+		{
+#if defined(NG_CPU_AVX2) && defined(_MSC_VER)
+			// AVX2 and FMA need the CPU to have them and the operating system to save the wide registers.
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] >= 7)
+			{
+				__cpuid(info, 1);
+				bool fma = (info[2] & (1 << 12)) != 0, osSavesRegisters = (info[2] & (1 << 27)) != 0, avx = (info[2] & (1 << 28)) != 0;
+				__cpuidex(info, 7, 0);
+				bool avx2 = (info[1] & (1 << 5)) != 0;
+				if (fma && osSavesRegisters && avx && avx2 && (_xgetbv(0) & 6) == 6) return InstructionSet::AVX2;
+			}
+#elif defined(NG_CPU_AVX2)
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return InstructionSet::AVX2;
+#endif
+#if defined(NG_CPU_SSE)
+			return InstructionSet::SSE2;
+#else
+			return InstructionSet::Scalar;
+#endif
+		}
+	}
+
+	namespace CpuFeatures
+	{
+		InstructionSet getSupportedInstructionSet()
+		{
+			static const InstructionSet s_supported = detectInstructionSet();
+			return s_supported;
+		}
+
+		const char* getInstructionSetName(InstructionSet set)
+		{
+			switch (set)
+			{
+			case InstructionSet::AVX2: return "AVX2";
+			case InstructionSet::SSE2: return "SSE2";
+			default: return "Scalar";
+			}
+		}
+	}
+}
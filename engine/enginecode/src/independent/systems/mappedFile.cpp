@@ -0,0 +1,89 @@
+#include "engine_pch.h"
+#include "systems/mappedFile.h"
+
+#ifdef NG_PLATFORM_WINDOWS
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace Engine
+{
+	bool MappedFile::open(const char* filepath)
+	{
+		close();
+
+#ifdef NG_PLATFORM_WINDOWS
+		HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!data)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		m_file = file;
+		m_mapping = mapping;
+		m_data = static_cast<const uint8_t*>(data);
+		m_size = static_cast<size_t>(size.QuadPart);
+#else
+		int file = ::open(filepath, O_RDONLY);
+		if (file < 0) return false;
+
+		struct stat status;
+		if (fstat(file, &status) != 0 || status.st_size == 0)
+		{
+			::close(file);
+			return false;
+		}
+
+		// The mapping keeps its own reference to the file, so the descriptor can be closed straight away.
+		void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		::close(file);
+		if (data == MAP_FAILED) return false;
+
+		m_data = static_cast<const uint8_t*>(data);
+		m_size = static_cast<size_t>(status.st_size);
+#endif
+
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (!m_data) return;
+
+#ifdef NG_PLATFORM_WINDOWS
+		UnmapViewOfFile(m_data);
+		CloseHandle(m_mapping);
+		CloseHandle(m_file);
+		m_mapping = nullptr;
+		m_file = nullptr;
+#else
+		munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+
+		m_data = nullptr;
+		m_size = 0;
+	}
+}
@@ -0,0 +1,89 @@
+#include "engine_pch.h"
+#include "systems/workerPool.h"
+#include <algorithm>
+
+namespace Engine
+{
+	WorkerPool::WorkerPool(uint32_t workerCount)
+	{
+		for (uint32_t i = 0; i < workerCount; i++) m_workers.emplace_back(&WorkerPool::workerLoop, this);
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_wake.notify_all();
+		for (std::thread& worker : m_workers) worker.join();
+	}
+
+	uint32_t WorkerPool::defaultWorkerCount()
+	{
+		// hardware_concurrency may report 0 when it cannot tell.
+		uint32_t threads = std::thread::hardware_concurrency();
+		return threads > 1 ? threads - 1 : 0;
+	}
+
+	void WorkerPool::parallelFor(uint32_t count, uint32_t blockSize, const std::function<void(uint32_t, uint32_t)>& function)
+	{
+		if (count == 0) return;
+		blockSize = std::max(blockSize, 1u);
+
+		// Waking the workers costs more than a single block.
+		if (m_workers.empty() || count <= blockSize)
+		{
+			function(0, count);
+			return;
+		}
+
+		std::lock_guard<std::mutex> callLock(m_callMutex);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_function = &function;
+			m_count = count;
+			m_blockSize = blockSize;
+			m_next = 0;
+			m_busy = static_cast<uint32_t>(m_workers.size());
+			m_generation++;
+		}
+		m_wake.notify_all();
+
+		runBlocks();
+
+		// Every worker must check in, so none is still reading this job when the next one starts.
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [this] { return m_busy == 0; });
+		m_function = nullptr;
+	}
+
+	void WorkerPool::runBlocks()
+	{
+		while (true)
+		{
+			uint32_t begin = m_next.fetch_add(m_blockSize);
+			if (begin >= m_count) break;
+			(*m_function)(begin, std::min(begin + m_blockSize, m_count));
+		}
+	}
+
+	void WorkerPool::workerLoop()
+	{
+		uint32_t generation = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wake.wait(lock, [this, generation] { return m_stopping || m_generation != generation; });
+				if (m_stopping) return;
+				generation = m_generation;
+			}
+
+			runBlocks();
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (--m_busy == 0) m_done.notify_one();
+		}
+	}
+}
@@ -6,6 +6,7 @@
 #include <GLFW/glfw3.h>
 
 #include "platforms/GLFW/GLFW_OpenGL_GC.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
 #include "systems/log.h"
 
 namespace Engine
@@ -18,7 +19,7 @@ namespace Engine
 		if (!result) Log::error("Could not create OpenGL context for this GLFW window: {0}", result);
 
 		//Enable OpenGL debug with a callback
-		glEnable(GL_DEBUG_OUTPUT);
+		OpenGLStateCache::enable(GL_DEBUG_OUTPUT);
 		glDebugMessageCallback(
 			[](
 				GLenum source,
@@ -0,0 +1,58 @@
+#include "engine_pch.h"
+#include <glad/glad.h>
+#include "platforms/OpenGL/OpenGLBufferStorage.h"
+#include "systems/log.h"
+
+namespace Engine
+{
+	namespace OpenGLBufferStorage
+	{
+		void allocate(uint32_t bufferID, uint32_t size, const void* data, BufferUsage usage)
+		{
+			if (usage != BufferUsage::Immutable)
+			{
+				// Mutable storage can be re-specified and updated later.
+				glNamedBufferData(bufferID, size, data, toGLUsage(usage));
+				return;
+			}
+
+			if (!data) Log::error("Immutable buffer of {0} bytes created without data, it can never be filled", size);
+
+			// Without client access flags the driver is free to place the storage in device local memory, filled straight from data.
+			glNamedBufferStorage(bufferID, size, data, 0);
+		}
+
+		bool update(uint32_t bufferID, uint32_t bufferSize, const void* data, uint32_t size, uint32_t offset, BufferUsage usage)
+		{
+			if (usage == BufferUsage::Immutable)
+			{
+				Log::error("Attempted to edit immutable buffer {0}", bufferID);
+				return false;
+			}
+
+			if (offset + size > bufferSize)
+			{
+				Log::error("Edit of {0} bytes at offset {1} overruns buffer of {2} bytes", size, offset, bufferSize);
+				return false;
+			}
+
+			// A full rewrite of a streamed buffer orphans the old storage instead of waiting for draws still reading it.
+			if (usage == BufferUsage::Stream && offset == 0 && size == bufferSize) glInvalidateBufferData(bufferID);
+
+			glNamedBufferSubData(bufferID, offset, size, data);
+			return true;
+		}
+
+		uint32_t toGLUsage(BufferUsage usage)
+		{
+			switch (usage)
+			{
+			case BufferUsage::Immutable: return GL_STATIC_DRAW;
+			case BufferUsage::Static: return GL_STATIC_DRAW;
+			case BufferUsage::Dynamic: return GL_DYNAMIC_DRAW;
+			case BufferUsage::Stream: return GL_STREAM_DRAW;
+			}
+			return GL_DYNAMIC_DRAW;
+		}
+	}
+}
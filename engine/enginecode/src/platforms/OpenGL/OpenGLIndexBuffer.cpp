@@ -1,5 +1,8 @@
 #include "engine_pch.h"
 #include "platforms/OpenGL/OpenGLIndexBuffer.h"
+#include "platforms/OpenGL/OpenGLBufferStorage.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
+#include "systems/log.h"
 #include <glad/glad.h>
 
 namespace Engine
@@ -7,31 +10,66 @@ namespace Engine
 
 	OpenGLIndexBuffer::~OpenGLIndexBuffer()
 	{
-		// Delete the OpenGL buffer identified by m_OpenGL_ID.
+		// Delete the OpenGL buffer identified by m_OpenGL_ID, and forget any bindings of it.
+		OpenGLStateCache::onDeleteBuffer(m_OpenGL_ID);
 		glDeleteBuffers(1, &m_OpenGL_ID);
 	}
 
-	OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t* indices, uint32_t count) : m_count(count)
+	OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t* indices, uint32_t count, BufferUsage usage) : m_count(count), m_usage(usage), m_type(IndexType::UInt32)
+	{
+		allocateStorage(indices, sizeof(uint32_t));
+	}
+
+	OpenGLIndexBuffer::OpenGLIndexBuffer(uint16_t* indices, uint32_t count, BufferUsage usage) : m_count(count), m_usage(usage), m_type(IndexType::UInt16)
+	{
+		allocateStorage(indices, sizeof(uint16_t));
+	}
+
+	void OpenGLIndexBuffer::edit(uint32_t* indices, uint32_t count, uint32_t offset)
+	{
+		editRange(indices, count, offset, IndexType::UInt32);
+	}
+
+	void OpenGLIndexBuffer::edit(uint16_t* indices, uint32_t count, uint32_t offset)
+	{
+		editRange(indices, count, offset, IndexType::UInt16);
+	}
+
+	void OpenGLIndexBuffer::allocateStorage(void* indices, uint32_t indexSize)
 	{
 		// Create a new OpenGL buffer and store its ID in m_OpenGL_ID.
 		glCreateBuffers(1, &m_OpenGL_ID);
 
-		// Bind the newly created buffer as an element array buffer.
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_OpenGL_ID);
+		// Bind the newly created buffer as an element array buffer, attaching it to the bound vertex array.
+		OpenGLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_OpenGL_ID);
+
+		// Allocate storage matching the usage policy and fill it with the provided indices data.
+		OpenGLBufferStorage::allocate(m_OpenGL_ID, indexSize * m_count, indices, m_usage);
+	}
+
+	void OpenGLIndexBuffer::editRange(void* indices, uint32_t count, uint32_t offset, IndexType type)
+	{
+		// Indices of the other width would be reinterpreted rather than converted.
+		if (type != m_type)
+		{
+			Log::error("Index buffer {0} holds {1} bit indices, cannot edit it with {2} bit indices", m_OpenGL_ID, m_type == IndexType::UInt16 ? 16 : 32, type == IndexType::UInt16 ? 16 : 32);
+			return;
+		}
 
-		// Fill the buffer with the provided indices data.
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * count, indices, GL_STATIC_DRAW);
+		// Update a portion of the buffer's data starting from the specified index, without disturbing the bound vertex array.
+		uint32_t indexSize = m_type == IndexType::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t);
+		OpenGLBufferStorage::update(m_OpenGL_ID, indexSize * m_count, indices, indexSize * count, indexSize * offset, m_usage);
 	}
 
 	void OpenGLIndexBuffer::bind()
 	{
-		// Bind the OpenGL index buffer identified by m_OpenGL_ID.
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_OpenGL_ID);
+		// Bind the OpenGL index buffer identified by m_OpenGL_ID, unless it is already bound.
+		OpenGLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_OpenGL_ID);
 	}
 
 	void OpenGLIndexBuffer::unbind()
 	{
 		// Bind a null index buffer, effectively unbinding any currently bound index buffer.
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		OpenGLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	}
 }
\ No newline at end of file
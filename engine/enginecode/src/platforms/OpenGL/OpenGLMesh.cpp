@@ -0,0 +1,78 @@
+#include "engine_pch.h"
+#include <glad/glad.h>
+#include "platforms/OpenGL/OpenGLMesh.h"
+#include "platforms/OpenGL/OpenGLIndexBuffer.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
+#include "rendering/meshImporter.h"
+#include "systems/mappedFile.h"
+#include "systems/log.h"
+
+namespace Engine
+{
+	OpenGLMesh::OpenGLMesh(const char* filepath)
+	{
+		std::string error;
+		std::string meshPath = MeshImporter::convert(filepath, error);
+		if (meshPath.empty())
+		{
+			Log::error("Could not load mesh {0}: {1}", filepath, error);
+			return;
+		}
+
+		// The mapping only needs to live until the blobs have been uploaded.
+		MappedFile file(meshPath.c_str());
+		MeshFileView view;
+		if (!file.isOpen())
+		{
+			Log::error("Could not map mesh file: {0}", meshPath);
+			return;
+		}
+		if (!view.open(file.getData(), file.getSize(), error))
+		{
+			Log::error("Invalid mesh file {0}: {1}", meshPath, error);
+			return;
+		}
+
+		const MeshFileHeader& header = view.getHeader();
+
+		m_vertexBuffer.reset(new OpenGLVertexBuffer(const_cast<void*>(view.getVertices()), header.vertexCount * header.vertexStride, view.getLayout(), BufferUsage::Immutable));
+
+		// Every level of detail shares the vertex buffer and draws its own range of the indices.
+		m_lods.assign(view.getLods(), view.getLods() + header.lodCount);
+		for (const MeshLod& lod : m_lods)
+		{
+			// The vertex array must be bound before the index buffer is created so it captures the element binding.
+			std::shared_ptr<OpenGLVertexArray> vertexArray(new OpenGLVertexArray);
+
+			std::shared_ptr<IndexBuffer> indexBuffer;
+			if (view.getIndexType() == IndexType::UInt16) indexBuffer.reset(new OpenGLIndexBuffer(static_cast<uint16_t*>(const_cast<void*>(view.getIndices())) + lod.firstIndex, lod.indexCount, BufferUsage::Immutable));
+			else indexBuffer.reset(new OpenGLIndexBuffer(static_cast<uint32_t*>(const_cast<void*>(view.getIndices())) + lod.firstIndex, lod.indexCount, BufferUsage::Immutable));
+
+			vertexArray->addVertexBuffer(m_vertexBuffer);
+			vertexArray->setIndexBuffer(indexBuffer);
+			vertexArray->unbind();
+			m_lodVertexArrays.push_back(vertexArray);
+			m_lodIndexBuffers.push_back(indexBuffer);
+		}
+		m_vertexBuffer->unbind();
+
+		m_vertexArray = m_lodVertexArrays[0];
+		m_submeshes.assign(view.getSubmeshes(), view.getSubmeshes() + header.submeshCount);
+		m_bounds = header.bounds;
+	}
+
+	std::shared_ptr<OpenGLVertexArray> OpenGLMesh::createInstancedVertexArray(const std::shared_ptr<OpenGLVertexBuffer>& instances, uint32_t level) const
+	{
+		if (!isLoaded()) return nullptr;
+
+		std::shared_ptr<OpenGLVertexArray> vertexArray(new OpenGLVertexArray);
+		vertexArray->addVertexBuffer(m_vertexBuffer);
+		vertexArray->addVertexBuffer(instances);
+
+		// The index buffer already exists, so it is bound while the new vertex array is to become its element binding.
+		OpenGLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_lodIndexBuffers[level]->getRenderID());
+		vertexArray->setIndexBuffer(m_lodIndexBuffers[level]);
+		vertexArray->unbind();
+		return vertexArray;
+	}
+}
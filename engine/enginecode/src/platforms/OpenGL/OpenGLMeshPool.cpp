@@ -0,0 +1,170 @@
+#include "engine_pch.h"
+#include <glad/glad.h>
+#include "platforms/OpenGL/OpenGLMeshPool.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
+#include "rendering/meshImporter.h"
+#include "systems/mappedFile.h"
+#include "systems/log.h"
+
+namespace Engine
+{
+	OpenGLMeshPool::OpenGLMeshPool(const BufferLayout& layout, uint32_t maxVertices, uint32_t maxIndices, uint32_t maxDraws) :
+		m_vertexStride(layout.getStride()),
+		m_maxVertices(maxVertices),
+		m_maxIndices(maxIndices),
+		m_maxDraws(maxDraws)
+	{
+		// The vertex array must be bound before the index buffer is created so it captures the element binding.
+		m_vertexArray.reset(new OpenGLVertexArray);
+
+		// Allocate the shared storage up front, meshes are copied into it as they are added.
+		m_vertexBuffer.reset(new OpenGLVertexBuffer(nullptr, m_vertexStride * maxVertices, layout, BufferUsage::Dynamic));
+		m_indexBuffer.reset(new OpenGLIndexBuffer(static_cast<uint32_t*>(nullptr), maxIndices, BufferUsage::Dynamic));
+
+		// Each frame region holds the instance data and one command per draw, plus a spare instance to start the data on a whole instance.
+		uint32_t regionSize = (sizeof(InstanceTransform) + sizeof(DrawElementsIndirectCommand)) * maxDraws + sizeof(InstanceTransform);
+		m_streamingBuffer.reset(new OpenGLStreamingBuffer(regionSize));
+		m_meshes.reserve(maxDraws);
+
+		// One transform per draw, advanced once per instance and offset by each command's base instance.
+		m_vertexArray->addVertexBuffer(m_vertexBuffer);
+		m_vertexArray->addVertexBuffer(m_streamingBuffer->getRenderID(), InstanceTransform::Layout::view());
+		m_vertexArray->setIndexBuffer(m_indexBuffer);
+		m_vertexArray->unbind();
+	}
+
+	MeshHandle OpenGLMeshPool::addMesh(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+	{
+		MeshHandle handle;
+
+		if (m_usedVertices + vertexCount > m_maxVertices || m_usedIndices + indexCount > m_maxIndices)
+		{
+			Log::error("Mesh pool is full: cannot add mesh of {0} vertices and {1} indices", vertexCount, indexCount);
+			return handle;
+		}
+
+		// Copy the mesh to the end of the shared buffers.
+		m_vertexBuffer->edit(const_cast<void*>(vertices), vertexCount * m_vertexStride, m_usedVertices * m_vertexStride);
+		m_indexBuffer->edit(const_cast<uint32_t*>(indices), indexCount, m_usedIndices);
+
+		// Indices stay relative to the mesh, the draw's base vertex moves them to the mesh's vertices.
+		handle.firstIndex = m_usedIndices;
+		handle.indexCount = indexCount;
+		handle.baseVertex = static_cast<int32_t>(m_usedVertices);
+
+		m_usedVertices += vertexCount;
+		m_usedIndices += indexCount;
+
+		return handle;
+	}
+
+	MeshHandle OpenGLMeshPool::addMesh(const char* filepath)
+	{
+		std::string error;
+		std::string meshPath = MeshImporter::convert(filepath, error);
+		if (meshPath.empty())
+		{
+			Log::error("Could not load mesh {0}: {1}", filepath, error);
+			return MeshHandle();
+		}
+
+		MappedFile file(meshPath.c_str());
+		MeshFileView view;
+		if (!file.isOpen() || !view.open(file.getData(), file.getSize(), error))
+		{
+			Log::error("Invalid mesh file {0}: {1}", meshPath, error);
+			return MeshHandle();
+		}
+
+		const MeshFileHeader& header = view.getHeader();
+		if (header.vertexStride != m_vertexStride)
+		{
+			Log::error("Mesh {0} has {1} byte vertices, the pool holds {2} byte ones", meshPath, header.vertexStride, m_vertexStride);
+			return MeshHandle();
+		}
+
+		// The pool holds 32 bit indices, so narrowed ones are widened on the way in.
+		const MeshLod& lod = view.getLods()[0];
+		std::vector<uint32_t> indices(lod.indexCount);
+		for (uint32_t i = 0; i < lod.indexCount; i++)
+		{
+			indices[i] = view.getIndexType() == IndexType::UInt16 ? static_cast<const uint16_t*>(view.getIndices())[lod.firstIndex + i] : static_cast<const uint32_t*>(view.getIndices())[lod.firstIndex + i];
+		}
+
+		return addMesh(view.getVertices(), header.vertexCount, indices.data(), lod.indexCount);
+	}
+
+	void OpenGLMeshPool::submit(const MeshHandle& mesh, const glm::mat4& model, const glm::mat3& normalMatrix)
+	{
+		if (!mesh.isValid()) return;
+
+		// The first draw of a frame claims the next region, waiting only if the GPU still reads it.
+		// The claim is made once per frame even if it fails, so later draws do not claim or wait on further regions.
+		if (!m_frameBegun)
+		{
+			m_frameBegun = true;
+			m_streamingBuffer->beginFrame();
+
+			// Instances are addressed from the start of the buffer, so the data starts on the first whole instance inside its block.
+			StreamAllocation instances = m_streamingBuffer->allocate(sizeof(InstanceTransform) * (m_maxDraws + 1), 4);
+			m_commands = m_streamingBuffer->allocate(sizeof(DrawElementsIndirectCommand) * m_maxDraws, 4);
+			m_instances = nullptr;
+			if (instances.isValid())
+			{
+				m_firstInstance = (instances.offset + sizeof(InstanceTransform) - 1) / sizeof(InstanceTransform);
+				m_instances = reinterpret_cast<InstanceTransform*>(static_cast<uint8_t*>(instances.data) + (m_firstInstance * sizeof(InstanceTransform) - instances.offset));
+			}
+
+			if ((!m_instances || !m_commands.isValid()) && !m_allocationFailureLogged)
+			{
+				Log::error("Mesh pool could not allocate room for {0} draws, its draws are dropped", m_maxDraws);
+				m_allocationFailureLogged = true;
+			}
+		}
+
+		if (!m_instances || !m_commands.isValid()) return;
+
+		uint32_t draw = static_cast<uint32_t>(m_meshes.size());
+		if (draw == m_maxDraws)
+		{
+			Log::warn("Mesh pool draw limit of {0} reached, draw dropped", m_maxDraws);
+			return;
+		}
+
+		// Write straight into mapped memory, the commands are built from the meshes when flushed.
+		m_instances[draw] = { model, normalMatrix };
+		m_meshes.push_back(mesh);
+	}
+
+	void OpenGLMeshPool::flush()
+	{
+		m_lastCommandCount = 0;
+		uint32_t drawCount = static_cast<uint32_t>(m_meshes.size()) - m_flushedDraws;
+		if (drawCount == 0) return;
+
+		DrawElementsIndirectCommand* commands = static_cast<DrawElementsIndirectCommand*>(m_commands.data) + m_commandCount;
+		m_lastCommandCount = IndirectDraw::buildCommands(m_meshes.data() + m_flushedDraws, drawCount, m_firstInstance + m_flushedDraws, commands);
+
+		m_vertexArray->bind();
+		OpenGLStateCache::bindBuffer(GL_DRAW_INDIRECT_BUFFER, m_streamingBuffer->getRenderID());
+
+		// Draw every recorded mesh with a single call, the commands are read from this frame's region.
+		const void* offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(m_commands.offset + m_commandCount * sizeof(DrawElementsIndirectCommand)));
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, offset, static_cast<GLsizei>(m_lastCommandCount), 0);
+
+		m_commandCount += m_lastCommandCount;
+		m_flushedDraws += drawCount;
+	}
+
+	void OpenGLMeshPool::endFrame()
+	{
+		if (!m_frameBegun) return;
+		m_frameBegun = false;
+
+		// A region claimed without any draws recorded, because its allocation failed, is still fenced so it is reused in turn.
+		m_streamingBuffer->endFrame();
+		m_meshes.clear();
+		m_flushedDraws = 0;
+		m_commandCount = 0;
+	}
+}
@@ -1,14 +1,51 @@
 #include "engine_pch.h"
 #include "glad/glad.h"
 #include "platforms/OpenGL/OpenGLShader.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
+#include "rendering/shaderCache.h"
+#include "rendering/shaderPreprocessor.h"
+#include <filesystem>
 #include <fstream>
 #include "systems/log.h"
 #include <string>
 #include <array>
+#include <cstring>
 #include "glm/gtc/type_ptr.hpp"
 
 namespace Engine
 {
+	namespace
+	{
+		/** @brief Check the driver can return program binaries at all, queried once. */
+		bool isBinaryCacheSupported()
+		{
+			static const bool s_supported = []
+			{
+				GLint formats = 0;
+				glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+				return formats > 0;
+			}();
+			return s_supported;
+		}
+
+		/** @brief Get the vendor, renderer and version strings, a binary only loads on the driver which wrote it. */
+		const std::string& driverString()
+		{
+			static const std::string s_driver = []
+			{
+				std::string driver;
+				for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+				{
+					const GLubyte* value = glGetString(name);
+					if (value) driver += reinterpret_cast<const char*>(value);
+					driver += '\n';
+				}
+				return driver;
+			}();
+			return s_driver;
+		}
+	}
+
 	OpenGLShader::OpenGLShader(const char* vertexFilepath, const char* fragmentFilepath)
 	{
 		std::string line, vertexSrc, fragmentSrc;
@@ -37,131 +74,300 @@ namespace Engine
 		}
 		handle.close();
 
-		compileAndLink(vertexSrc.c_str(), fragmentSrc.c_str());
+		compileAndLink(vertexSrc.c_str(), fragmentSrc.c_str(), ShaderCompileMode::Blocking);
 	}
 
-	OpenGLShader::OpenGLShader(const char* filepath)
+	OpenGLShader::OpenGLShader(const char* filepath, uint32_t features, ShaderCompileMode mode)
 	{
-		enum Region { None = -1, Vertex = 0, Fragment, Geometry, TessellationControl, TessellationEvaluation, Compute };
-		std::string line; std::array<std::string, Region::Compute + 1>src;
-		uint32_t region = Region::None;
-
-		std::fstream handle(filepath, std::ios::in);
-		if (handle.is_open())
-		{
-			while (getline(handle, line))
-			{
-				if (line.find("#region Vertex") != std::string::npos) { region = Region::Vertex; continue; }
-				if (line.find("#region Fragment") != std::string::npos) { region = Region::Fragment; continue; }
-				if (line.find("#region Geometry") != std::string::npos) { region = Region::Geometry; continue; }
-				if (line.find("#region TessellationControl") != std::string::npos) { region = Region::TessellationControl; continue; }
-				if (line.find("#region TessellationEvaluation") != std::string::npos) { region = Region::TessellationEvaluation; continue; }
-				if (line.find("#region Compute") != std::string::npos) { region = Region::Compute; continue; }
-
-				if (region != Region::None) src[region] += (line + "\n");
-			}
-		}
-		else
+		// Includes are resolved and the variant's feature defines injected before compiling.
+		ShaderSources src;
+		std::string error;
+		if (!ShaderPreprocessor::load(filepath, features, src, error))
 		{
-			Log::error("Could not open shader source: {0}", filepath);
+			Log::error("{0}", error);
 			return;
 		}
-		handle.close();
 
-		compileAndLink(src[Region::Vertex].c_str(), src[Region::Fragment].c_str());
+		compileAndLink(src[ShaderStages::Vertex].c_str(), src[ShaderStages::Fragment].c_str(), mode);
 	}
 
 	OpenGLShader::~OpenGLShader()
 	{
+		// A program deleted mid compile still owns its attached shaders.
+		if (m_pendingVertex) glDeleteShader(m_pendingVertex);
+		if (m_pendingFragment) glDeleteShader(m_pendingFragment);
+
+		OpenGLStateCache::onDeleteProgram(m_OpenGL_ID);
 		glDeleteProgram(m_OpenGL_ID);
 	}
 
 	void OpenGLShader::uploadInt(const char* name, int value)
 	{
-		uint32_t uniformLocation = glGetUniformLocation(m_OpenGL_ID, name);
-		glUniform1i(uniformLocation, value);
+		upload(UniformHandle<int>{ findUniform(name) }, value);
 	}
 
 	void OpenGLShader::uploadFloat(const char* name, float value)
 	{
-		uint32_t uniformLocation = glGetUniformLocation(m_OpenGL_ID, name);
-		glUniform1f(uniformLocation, value);
+		upload(UniformHandle<float>{ findUniform(name) }, value);
 	}
 
 	void OpenGLShader::uploadFloat2(const char* name, const glm::vec2& value)
 	{
-		uint32_t uniformLocation = glGetUniformLocation(m_OpenGL_ID, name);
-		glUniform2f(uniformLocation, value.x, value.y);
+		upload(UniformHandle<glm::vec2>{ findUniform(name) }, value);
 	}
 
 	void OpenGLShader::uploadFloat3(const char* name, const glm::vec3& value)
 	{
-		uint32_t uniformLocation = glGetUniformLocation(m_OpenGL_ID, name);
-		glUniform3f(uniformLocation, value.x, value.y, value.z);
+		upload(UniformHandle<glm::vec3>{ findUniform(name) }, value);
 	}
 
 	void OpenGLShader::uploadFloat4(const char* name, const glm::vec4& value)
 	{
-		uint32_t uniformLocation = glGetUniformLocation(m_OpenGL_ID, name);
-		glUniform4f(uniformLocation, value.x, value.y, value.z, value.w);
+		upload(UniformHandle<glm::vec4>{ findUniform(name) }, value);
+	}
+
+	void OpenGLShader::uploadMat3(const char* name, const glm::mat3& value)
+	{
+		upload(UniformHandle<glm::mat3>{ findUniform(name) }, value);
 	}
 
 	void OpenGLShader::uploadMat4(const char* name, const glm::mat4& value)
 	{
-		uint32_t uniformLocation = glGetUniformLocation(m_OpenGL_ID, name);
-		glUniformMatrix4fv(uniformLocation, 1, GL_FALSE, glm::value_ptr(value));
+		upload(UniformHandle<glm::mat4>{ findUniform(name) }, value);
 	}
 
-	void OpenGLShader::compileAndLink(const char* vertexShaderSrc, const char* fragmentShaderSrc)
+	void OpenGLShader::upload(UniformHandle<int> handle, int value)
 	{
-		GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+		if (!handle.isValid() || !updateShadow(handle.index, &value, sizeof(value))) return;
+		glUniform1i(m_uniforms[handle.index].location, value);
+	}
 
-		const GLchar* source = vertexShaderSrc;
-		glShaderSource(vertexShader, 1, &source, 0);
-		glCompileShader(vertexShader);
+	void OpenGLShader::upload(UniformHandle<float> handle, float value)
+	{
+		if (!handle.isValid() || !updateShadow(handle.index, &value, sizeof(value))) return;
+		glUniform1f(m_uniforms[handle.index].location, value);
+	}
+
+	void OpenGLShader::upload(UniformHandle<glm::vec2> handle, const glm::vec2& value)
+	{
+		if (!handle.isValid() || !updateShadow(handle.index, glm::value_ptr(value), sizeof(value))) return;
+		glUniform2f(m_uniforms[handle.index].location, value.x, value.y);
+	}
+
+	void OpenGLShader::upload(UniformHandle<glm::vec3> handle, const glm::vec3& value)
+	{
+		if (!handle.isValid() || !updateShadow(handle.index, glm::value_ptr(value), sizeof(value))) return;
+		glUniform3f(m_uniforms[handle.index].location, value.x, value.y, value.z);
+	}
+
+	void OpenGLShader::upload(UniformHandle<glm::vec4> handle, const glm::vec4& value)
+	{
+		if (!handle.isValid() || !updateShadow(handle.index, glm::value_ptr(value), sizeof(value))) return;
+		glUniform4f(m_uniforms[handle.index].location, value.x, value.y, value.z, value.w);
+	}
+
+	void OpenGLShader::upload(UniformHandle<glm::mat3> handle, const glm::mat3& value)
+	{
+		if (!handle.isValid() || !updateShadow(handle.index, glm::value_ptr(value), sizeof(value))) return;
+		glUniformMatrix3fv(m_uniforms[handle.index].location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+	void OpenGLShader::upload(UniformHandle<glm::mat4> handle, const glm::mat4& value)
+	{
+		if (!handle.isValid() || !updateShadow(handle.index, glm::value_ptr(value), sizeof(value))) return;
+		glUniformMatrix4fv(m_uniforms[handle.index].location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+
+	int32_t OpenGLShader::findUniform(const char* name) const
+	{
+		auto it = m_uniformIndices.find(name);
+		if (it == m_uniformIndices.end()) return -1;
+		return it->second;
+	}
+
+	bool OpenGLShader::updateShadow(int32_t index, const void* value, uint32_t size)
+	{
+		UniformInfo& uniform = m_uniforms[index];
 
-		GLint isCompiled = 0;
-		glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &isCompiled);
-		if (isCompiled == GL_FALSE)
+		// A value which does not fit the uniform is passed straight through so the driver reports the mismatch.
+		if (size != uniform.shadowSize)
 		{
-			GLint maxLength = 0;
-			glGetShaderiv(vertexShader, GL_INFO_LOG_LENGTH, &maxLength);
+			m_uploadStats.issued++;
+			return true;
+		}
 
-			std::vector<GLchar> infoLog(maxLength);
-			glGetShaderInfoLog(vertexShader, maxLength, &maxLength, &infoLog[0]);
-			Log::error("Shader compile error: {0}", std::string(infoLog.begin(), infoLog.end()));
+		uint8_t* shadow = m_shadow.data() + uniform.shadowOffset;
+		if (uniform.initialised && std::memcmp(shadow, value, size) == 0)
+		{
+			m_uploadStats.skipped++;
+			return false;
+		}
 
-			glDeleteShader(vertexShader);
-			return;
+		std::memcpy(shadow, value, size);
+		uniform.initialised = true;
+		m_uploadStats.issued++;
+		return true;
+	}
+
+	void OpenGLShader::reflectUniforms()
+	{
+		m_uniforms.clear();
+		m_uniformIndices.clear();
+		m_shadow.clear();
+
+		GLint uniformCount = 0;
+		GLint maxNameLength = 0;
+		glGetProgramiv(m_OpenGL_ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+		glGetProgramiv(m_OpenGL_ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+		if (uniformCount <= 0) return;
+
+		std::vector<GLchar> nameBuffer(maxNameLength);
+		uint32_t shadowSize = 0;
+
+		for (GLint i = 0; i < uniformCount; i++)
+		{
+			GLsizei nameLength = 0;
+			GLint arraySize = 0;
+			GLenum glType = 0;
+			glGetActiveUniform(m_OpenGL_ID, i, maxNameLength, &nameLength, &arraySize, &glType, nameBuffer.data());
+
+			UniformInfo uniform;
+			uniform.name = std::string(nameBuffer.data(), nameLength);
+			uniform.location = glGetUniformLocation(m_OpenGL_ID, uniform.name.c_str());
+
+			// Members of uniform blocks have no location and are not set through glUniform*.
+			if (uniform.location < 0) continue;
+
+			// Arrays are reported as "name[0]", strip the suffix so they can be found by their declared name.
+			size_t bracket = uniform.name.find('[');
+			if (bracket != std::string::npos) uniform.name.erase(bracket);
+
+			switch (glType)
+			{
+			case GL_INT:
+			case GL_BOOL:                uniform.type = UniformType::Int;     uniform.shadowSize = sizeof(int); break;
+			case GL_FLOAT:               uniform.type = UniformType::Float;   uniform.shadowSize = sizeof(float); break;
+			case GL_FLOAT_VEC2:          uniform.type = UniformType::Float2;  uniform.shadowSize = sizeof(glm::vec2); break;
+			case GL_FLOAT_VEC3:          uniform.type = UniformType::Float3;  uniform.shadowSize = sizeof(glm::vec3); break;
+			case GL_FLOAT_VEC4:          uniform.type = UniformType::Float4;  uniform.shadowSize = sizeof(glm::vec4); break;
+			case GL_FLOAT_MAT3:          uniform.type = UniformType::Mat3;    uniform.shadowSize = sizeof(glm::mat3); break;
+			case GL_FLOAT_MAT4:          uniform.type = UniformType::Mat4;    uniform.shadowSize = sizeof(glm::mat4); break;
+			case GL_SAMPLER_2D:
+			case GL_SAMPLER_2D_ARRAY:
+			case GL_SAMPLER_3D:
+			case GL_SAMPLER_CUBE:        uniform.type = UniformType::Sampler; uniform.shadowSize = sizeof(int); break;
+			default:                     uniform.type = UniformType::Unknown; uniform.shadowSize = 0; break;
+			}
+
+			uniform.shadowOffset = shadowSize;
+			uniform.initialised = false;
+			shadowSize += uniform.shadowSize;
+
+			m_uniformIndices[uniform.name] = static_cast<int32_t>(m_uniforms.size());
+			m_uniforms.push_back(uniform);
 		}
 
-		GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+		m_shadow.resize(shadowSize);
+	}
 
-		source = fragmentShaderSrc;
-		glShaderSource(fragmentShader, 1, &source, 0);
-		glCompileShader(fragmentShader);
+	bool OpenGLShader::loadBinary(const std::string& cachePath)
+	{
+		ProgramBinary binary;
+		if (!ShaderCache::readBinary(cachePath, binary)) return false;
 
-		glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &isCompiled);
-		if (isCompiled == GL_FALSE)
+		m_OpenGL_ID = glCreateProgram();
+		glProgramBinary(m_OpenGL_ID, binary.format, binary.data.data(), static_cast<GLsizei>(binary.data.size()));
+
+		// A driver update can reject a binary even with matching strings, which is reported as a failed link.
+		GLint isLinked = 0;
+		glGetProgramiv(m_OpenGL_ID, GL_LINK_STATUS, &isLinked);
+		if (isLinked == GL_FALSE)
 		{
-			GLint maxLength = 0;
-			glGetShaderiv(fragmentShader, GL_INFO_LOG_LENGTH, &maxLength);
+			Log::warn("Cached shader binary {0} was rejected, compiling from source", cachePath);
+			glDeleteProgram(m_OpenGL_ID);
+			m_OpenGL_ID = 0;
+			return false;
+		}
 
-			std::vector<GLchar> infoLog(maxLength);
-			glGetShaderInfoLog(fragmentShader, maxLength, &maxLength, &infoLog[0]);
-			Log::error("Shader compile error: {0}", std::string(infoLog.begin(), infoLog.end()));
+		return true;
+	}
 
-			glDeleteShader(fragmentShader);
-			glDeleteShader(vertexShader);
+	void OpenGLShader::saveBinary(const std::string& cachePath)
+	{
+		GLint length = 0;
+		glGetProgramiv(m_OpenGL_ID, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0) return;
+
+		ProgramBinary binary;
+		binary.data.resize(length);
+		GLenum format = 0;
+		glGetProgramBinary(m_OpenGL_ID, length, &length, &format, binary.data.data());
+		binary.data.resize(length);
+		binary.format = format;
+
+		std::error_code error;
+		std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+		if (!ShaderCache::writeBinary(cachePath, binary)) Log::warn("Could not write shader cache {0}", cachePath);
+	}
 
-			return;
+	void OpenGLShader::compileAndLink(const char* vertexShaderSrc, const char* fragmentShaderSrc, ShaderCompileMode mode)
+	{
+		// Reuse the program linked by an earlier run on this driver, skipping compilation entirely.
+		if (isBinaryCacheSupported())
+		{
+			m_cachePath = ShaderCache::cachePath(ShaderCache::programKey({ vertexShaderSrc, fragmentShaderSrc }, driverString()));
+			if (loadBinary(m_cachePath))
+			{
+				reflectUniforms();
+				m_status = ShaderStatus::Ready;
+				return;
+			}
 		}
 
+		if (mode == ShaderCompileMode::Parallel) enableParallelCompile();
+
+		// Submit every stage and the link without querying any status, so the driver is free to compile in the background.
+		m_pendingVertex = glCreateShader(GL_VERTEX_SHADER);
+		const GLchar* source = vertexShaderSrc;
+		glShaderSource(m_pendingVertex, 1, &source, 0);
+		glCompileShader(m_pendingVertex);
+
+		m_pendingFragment = glCreateShader(GL_FRAGMENT_SHADER);
+		source = fragmentShaderSrc;
+		glShaderSource(m_pendingFragment, 1, &source, 0);
+		glCompileShader(m_pendingFragment);
+
 		m_OpenGL_ID = glCreateProgram();
-		glAttachShader(m_OpenGL_ID, vertexShader);
-		glAttachShader(m_OpenGL_ID, fragmentShader);
+		glAttachShader(m_OpenGL_ID, m_pendingVertex);
+		glAttachShader(m_OpenGL_ID, m_pendingFragment);
+		if (!m_cachePath.empty()) glProgramParameteri(m_OpenGL_ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		glLinkProgram(m_OpenGL_ID);
 
+		m_status = ShaderStatus::Pending;
+		if (mode == ShaderCompileMode::Blocking) finishLink();
+	}
+
+	void OpenGLShader::finishLink()
+	{
+		GLuint vertexShader = m_pendingVertex, fragmentShader = m_pendingFragment;
+		m_pendingVertex = m_pendingFragment = 0;
+
+		// Stage errors are reported before the link error they cause.
+		for (GLuint shader : { vertexShader, fragmentShader })
+		{
+			GLint isCompiled = 0;
+			glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+			if (isCompiled == GL_FALSE)
+			{
+				GLint maxLength = 0;
+				glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
+
+				std::vector<GLchar> infoLog(maxLength);
+				glGetShaderInfoLog(shader, maxLength, &maxLength, &infoLog[0]);
+				Log::error("Shader compile error: {0}", std::string(infoLog.begin(), infoLog.end()));
+			}
+		}
+
 		GLint isLinked = 0;
 		glGetProgramiv(m_OpenGL_ID, GL_LINK_STATUS, (int*)&isLinked);
 		if (isLinked == GL_FALSE)
@@ -170,17 +376,69 @@ namespace Engine
 			glGetProgramiv(m_OpenGL_ID, GL_INFO_LOG_LENGTH, &maxLength);
 
 			std::vector<GLchar> infoLog(maxLength);
-			glGetProgramInfoLog(m_OpenGL_ID, maxLength, &maxLength, &infoLog[0]);
+			if (maxLength > 0) glGetProgramInfoLog(m_OpenGL_ID, maxLength, &maxLength, &infoLog[0]);
 			Log::error("Shader linking error: {0}", std::string(infoLog.begin(), infoLog.end()));
 
+			OpenGLStateCache::onDeleteProgram(m_OpenGL_ID);
 			glDeleteProgram(m_OpenGL_ID);
+			m_OpenGL_ID = 0;
 			glDeleteShader(vertexShader);
 			glDeleteShader(fragmentShader);
 
+			m_status = ShaderStatus::Failed;
 			return;
 		}
 
 		glDetachShader(m_OpenGL_ID, vertexShader);
 		glDetachShader(m_OpenGL_ID, fragmentShader);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		if (!m_cachePath.empty()) saveBinary(m_cachePath);
+
+		reflectUniforms();
+		m_status = ShaderStatus::Ready;
+	}
+
+	ShaderStatus OpenGLShader::poll()
+	{
+		if (m_status != ShaderStatus::Pending) return m_status;
+
+#ifdef GL_KHR_parallel_shader_compile
+		// Querying completion never blocks, unlike the link status which waits for the compiler threads.
+		if (isParallelCompileSupported())
+		{
+			GLint isComplete = GL_FALSE;
+			glGetProgramiv(m_OpenGL_ID, GL_COMPLETION_STATUS_KHR, &isComplete);
+			if (isComplete == GL_FALSE) return m_status;
+		}
+#endif
+
+		// Without the extension there is no way to ask without blocking, so the link is finished on first poll.
+
+		finishLink();
+		return m_status;
+	}
+
+	bool OpenGLShader::isParallelCompileSupported()
+	{
+#ifdef GL_KHR_parallel_shader_compile
+		return GLAD_GL_KHR_parallel_shader_compile != 0;
+#else
+		// The loader was generated without the extension, so its entry points are unavailable.
+		return false;
+#endif
+	}
+
+	void OpenGLShader::enableParallelCompile()
+	{
+		static bool s_enabled = false;
+		if (s_enabled || !isParallelCompileSupported()) return;
+		s_enabled = true;
+
+#ifdef GL_KHR_parallel_shader_compile
+		// Let the driver choose how many compiler threads to use.
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+#endif
 	}
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "engine_pch.h"
+#include "platforms/OpenGL/OpenGLShaderRegistry.h"
+
+namespace Engine
+{
+	std::shared_ptr<OpenGLShader> OpenGLShaderRegistry::get(const std::string& filepath, uint32_t features, ShaderCompileMode mode)
+	{
+		std::shared_ptr<OpenGLShader>& variant = m_files[filepath][features];
+		if (!variant) variant.reset(new OpenGLShader(filepath.c_str(), features, mode));
+		return variant;
+	}
+
+	uint32_t OpenGLShaderRegistry::pollPending()
+	{
+		uint32_t pending = 0;
+		for (auto& file : m_files)
+		{
+			for (auto& variant : file.second)
+			{
+				if (variant.second->poll() == ShaderStatus::Pending) pending++;
+			}
+		}
+		return pending;
+	}
+
+	uint32_t OpenGLShaderRegistry::getVariantCount() const
+	{
+		uint32_t count = 0;
+		for (const auto& file : m_files) count += static_cast<uint32_t>(file.second.size());
+		return count;
+	}
+
+	void OpenGLShaderRegistry::releaseUnused()
+	{
+		for (auto file = m_files.begin(); file != m_files.end();)
+		{
+			Variants& variants = file->second;
+			for (auto variant = variants.begin(); variant != variants.end();)
+			{
+				if (variant->second.use_count() == 1) variant = variants.erase(variant);
+				else ++variant;
+			}
+
+			if (variants.empty()) file = m_files.erase(file);
+			else ++file;
+		}
+	}
+}
@@ -0,0 +1,217 @@
+#include "engine_pch.h"
+#include <glad/glad.h>
+#include "platforms/OpenGL/OpenGLStateCache.h"
+
+namespace Engine
+{
+	uint32_t OpenGLStateCache::s_program = OpenGLStateCache::s_unknown;
+	uint32_t OpenGLStateCache::s_vertexArray = OpenGLStateCache::s_unknown;
+	std::array<uint32_t, OpenGLStateCache::BufferSlotCount> OpenGLStateCache::s_buffers = [] { std::array<uint32_t, BufferSlotCount> a; a.fill(s_unknown); return a; }();
+	std::array<OpenGLStateCache::BufferRange, OpenGLStateCache::s_maxIndexedBindings> OpenGLStateCache::s_uniformRanges = [] { std::array<BufferRange, s_maxIndexedBindings> a; a.fill({ s_unknown, 0, 0 }); return a; }();
+	std::array<OpenGLStateCache::BufferRange, OpenGLStateCache::s_maxIndexedBindings> OpenGLStateCache::s_storageRanges = s_uniformRanges;
+	std::array<uint32_t, OpenGLStateCache::s_maxTextureUnits> OpenGLStateCache::s_textures = [] { std::array<uint32_t, s_maxTextureUnits> a; a.fill(s_unknown); return a; }();
+	std::unordered_map<uint32_t, bool> OpenGLStateCache::s_capabilities;
+	uint32_t OpenGLStateCache::s_unpackAlignment = OpenGLStateCache::s_unknown;
+	uint32_t OpenGLStateCache::s_depthMask = OpenGLStateCache::s_unknown;
+	uint32_t OpenGLStateCache::s_blendSource = OpenGLStateCache::s_unknown;
+	uint32_t OpenGLStateCache::s_blendDestination = OpenGLStateCache::s_unknown;
+	StateCacheStats OpenGLStateCache::s_stats;
+	StateCacheStats OpenGLStateCache::s_lastFrameStats;
+
+	bool OpenGLStateCache::change(uint32_t& cached, uint32_t value)
+	{
+		if (cached == value)
+		{
+			s_stats.filtered++;
+			return false;
+		}
+
+		cached = value;
+		s_stats.issued++;
+		return true;
+	}
+
+	uint32_t OpenGLStateCache::slotOf(uint32_t target)
+	{
+		switch (target)
+		{
+		case GL_ARRAY_BUFFER: return Array;
+		case GL_ELEMENT_ARRAY_BUFFER: return ElementArray;
+		case GL_UNIFORM_BUFFER: return Uniform;
+		case GL_SHADER_STORAGE_BUFFER: return ShaderStorage;
+		case GL_DRAW_INDIRECT_BUFFER: return DrawIndirect;
+		case GL_PIXEL_UNPACK_BUFFER: return PixelUnpack;
+		case GL_COPY_READ_BUFFER: return CopyRead;
+		case GL_COPY_WRITE_BUFFER: return CopyWrite;
+		default: return BufferSlotCount;
+		}
+	}
+
+	void OpenGLStateCache::useProgram(uint32_t program)
+	{
+		if (change(s_program, program)) glUseProgram(program);
+	}
+
+	void OpenGLStateCache::bindVertexArray(uint32_t vertexArray)
+	{
+		if (!change(s_vertexArray, vertexArray)) return;
+
+		glBindVertexArray(vertexArray);
+
+		// The element array binding is part of the vertex array, so it is no longer known.
+		s_buffers[ElementArray] = s_unknown;
+	}
+
+	void OpenGLStateCache::bindBuffer(uint32_t target, uint32_t buffer)
+	{
+		uint32_t slot = slotOf(target);
+		if (slot == BufferSlotCount)
+		{
+			// Untracked targets are always passed through.
+			s_stats.issued++;
+			glBindBuffer(target, buffer);
+			return;
+		}
+
+		if (change(s_buffers[slot], buffer)) glBindBuffer(target, buffer);
+	}
+
+	void OpenGLStateCache::bindBufferRange(uint32_t target, uint32_t index, uint32_t buffer, uint32_t offset, uint32_t size)
+	{
+		BufferRange* range = nullptr;
+		if (index < s_maxIndexedBindings)
+		{
+			if (target == GL_UNIFORM_BUFFER) range = &s_uniformRanges[index];
+			else if (target == GL_SHADER_STORAGE_BUFFER) range = &s_storageRanges[index];
+		}
+
+		if (range && range->buffer == buffer && range->offset == offset && range->size == size)
+		{
+			s_stats.filtered++;
+			return;
+		}
+
+		if (range) *range = { buffer, offset, size };
+		s_stats.issued++;
+		glBindBufferRange(target, index, buffer, offset, size);
+
+		// Indexed binds also replace the generic binding of the target.
+		uint32_t slot = slotOf(target);
+		if (slot != BufferSlotCount) s_buffers[slot] = buffer;
+	}
+
+	void OpenGLStateCache::bindTexture(uint32_t unit, uint32_t texture)
+	{
+		if (unit >= s_maxTextureUnits)
+		{
+			s_stats.issued++;
+			glBindTextureUnit(unit, texture);
+			return;
+		}
+
+		if (change(s_textures[unit], texture)) glBindTextureUnit(unit, texture);
+	}
+
+	void OpenGLStateCache::enable(uint32_t capability)
+	{
+		auto it = s_capabilities.find(capability);
+		if (it != s_capabilities.end() && it->second)
+		{
+			s_stats.filtered++;
+			return;
+		}
+
+		s_capabilities[capability] = true;
+		s_stats.issued++;
+		glEnable(capability);
+	}
+
+	void OpenGLStateCache::disable(uint32_t capability)
+	{
+		auto it = s_capabilities.find(capability);
+		if (it != s_capabilities.end() && !it->second)
+		{
+			s_stats.filtered++;
+			return;
+		}
+
+		s_capabilities[capability] = false;
+		s_stats.issued++;
+		glDisable(capability);
+	}
+
+	void OpenGLStateCache::setUnpackAlignment(uint32_t alignment)
+	{
+		if (change(s_unpackAlignment, alignment)) glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+	}
+
+	void OpenGLStateCache::depthMask(bool write)
+	{
+		if (change(s_depthMask, write ? 1 : 0)) glDepthMask(write ? GL_TRUE : GL_FALSE);
+	}
+
+	void OpenGLStateCache::blendFunc(uint32_t source, uint32_t destination)
+	{
+		if (s_blendSource == source && s_blendDestination == destination)
+		{
+			s_stats.filtered++;
+			return;
+		}
+
+		s_blendSource = source;
+		s_blendDestination = destination;
+		s_stats.issued++;
+		glBlendFunc(source, destination);
+	}
+
+	void OpenGLStateCache::onDeleteProgram(uint32_t program)
+	{
+		// A deleted program stays current until replaced, but its ID may be reused afterwards.
+		if (s_program == program) s_program = s_unknown;
+	}
+
+	void OpenGLStateCache::onDeleteVertexArray(uint32_t vertexArray)
+	{
+		// Deleting the bound vertex array reverts the binding to zero.
+		if (s_vertexArray == vertexArray)
+		{
+			s_vertexArray = 0;
+			s_buffers[ElementArray] = s_unknown;
+		}
+	}
+
+	void OpenGLStateCache::onDeleteBuffer(uint32_t buffer)
+	{
+		// Deleting a bound buffer reverts each of its bindings to zero.
+		for (uint32_t& bound : s_buffers) { if (bound == buffer) bound = 0; }
+		for (BufferRange& range : s_uniformRanges) { if (range.buffer == buffer) range = { 0, 0, 0 }; }
+		for (BufferRange& range : s_storageRanges) { if (range.buffer == buffer) range = { 0, 0, 0 }; }
+	}
+
+	void OpenGLStateCache::onDeleteTexture(uint32_t texture)
+	{
+		// Deleting a bound texture reverts each unit it was bound to to zero.
+		for (uint32_t& bound : s_textures) { if (bound == texture) bound = 0; }
+	}
+
+	void OpenGLStateCache::invalidate()
+	{
+		s_program = s_unknown;
+		s_vertexArray = s_unknown;
+		s_buffers.fill(s_unknown);
+		s_uniformRanges.fill({ s_unknown, 0, 0 });
+		s_storageRanges.fill({ s_unknown, 0, 0 });
+		s_textures.fill(s_unknown);
+		s_capabilities.clear();
+		s_unpackAlignment = s_unknown;
+		s_depthMask = s_unknown;
+		s_blendSource = s_unknown;
+		s_blendDestination = s_unknown;
+	}
+
+	void OpenGLStateCache::beginFrame()
+	{
+		s_lastFrameStats = s_stats;
+		s_stats = StateCacheStats();
+	}
+}
@@ -0,0 +1,104 @@
+#include "engine_pch.h"
+#include <glad/glad.h>
+#include "platforms/OpenGL/OpenGLStreamingBuffer.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
+#include "systems/log.h"
+#include <algorithm>
+
+namespace Engine
+{
+	OpenGLStreamingBuffer::OpenGLStreamingBuffer(uint32_t regionSize, uint32_t regionCount) :
+		m_regionSize(regionSize),
+		m_regionCount(regionCount),
+		m_fences(regionCount, nullptr)
+	{
+		GLint uniformAlignment = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+		if (uniformAlignment > 0) m_uniformAlignment = static_cast<uint32_t>(uniformAlignment);
+
+		GLint storageAlignment = 0;
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+		if (storageAlignment > 0) m_storageAlignment = static_cast<uint32_t>(storageAlignment);
+
+		// Every region must start on an alignment any block inside it can use.
+		uint32_t alignment = std::max(m_uniformAlignment, m_storageAlignment);
+		m_regionSize = (regionSize + alignment - 1) / alignment * alignment;
+
+		// Create immutable storage which stays mapped, coherent writes need no explicit flush.
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glCreateBuffers(1, &m_OpenGL_ID);
+		glNamedBufferStorage(m_OpenGL_ID, static_cast<GLsizeiptr>(m_regionSize) * m_regionCount, nullptr, flags);
+
+		m_mapped = static_cast<uint8_t*>(glMapNamedBufferRange(m_OpenGL_ID, 0, static_cast<GLsizeiptr>(m_regionSize) * m_regionCount, flags));
+		if (!m_mapped) Log::error("Could not persistently map streaming buffer of {0} bytes", m_regionSize * m_regionCount);
+	}
+
+	OpenGLStreamingBuffer::~OpenGLStreamingBuffer()
+	{
+		for (void* fence : m_fences)
+		{
+			if (fence) glDeleteSync(static_cast<GLsync>(fence));
+		}
+
+		if (m_mapped) glUnmapNamedBuffer(m_OpenGL_ID);
+		OpenGLStateCache::onDeleteBuffer(m_OpenGL_ID);
+		glDeleteBuffers(1, &m_OpenGL_ID);
+	}
+
+	void OpenGLStreamingBuffer::beginFrame()
+	{
+		m_region = (m_region + 1) % m_regionCount;
+		m_regionHead = 0;
+
+		GLsync fence = static_cast<GLsync>(m_fences[m_region]);
+		if (!fence) return;
+
+		// Poll first, only count a stall if the GPU has not finished with the region yet.
+		GLenum result = glClientWaitSync(fence, 0, 0);
+		if (result == GL_TIMEOUT_EXPIRED)
+		{
+			m_stallCount++;
+			do
+			{
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1ms
+			} while (result == GL_TIMEOUT_EXPIRED);
+		}
+
+		if (result == GL_WAIT_FAILED) Log::error("Waiting on streaming buffer fence failed");
+
+		glDeleteSync(fence);
+		m_fences[m_region] = nullptr;
+	}
+
+	StreamAllocation OpenGLStreamingBuffer::allocate(uint32_t size, uint32_t alignment)
+	{
+		StreamAllocation allocation;
+
+		// Align the absolute offset, so blocks can be addressed in units of their alignment from the buffer start.
+		uint32_t regionBase = m_region * m_regionSize;
+		uint32_t start = ((regionBase + m_regionHead + alignment - 1) & ~(alignment - 1)) - regionBase;
+		if (!m_mapped || start + size > m_regionSize)
+		{
+			Log::error("Streaming buffer region of {0} bytes is full", m_regionSize);
+			return allocation;
+		}
+
+		m_regionHead = start + size;
+
+		allocation.offset = regionBase + start;
+		allocation.size = size;
+		allocation.data = m_mapped + allocation.offset;
+		return allocation;
+	}
+
+	void OpenGLStreamingBuffer::endFrame()
+	{
+		// Signalled once the GPU has executed every command reading this region.
+		m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	void OpenGLStreamingBuffer::bindRange(uint32_t target, uint32_t index, const StreamAllocation& allocation)
+	{
+		OpenGLStateCache::bindBufferRange(target, index, m_OpenGL_ID, allocation.offset, allocation.size);
+	}
+}
@@ -1,20 +1,36 @@
 #include "engine_pch.h"
 #include <glad/glad.h>
 #include "platforms/OpenGL/OpenGLTexture.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
+#include "systems/log.h"
+#include <algorithm>
+#include <filesystem>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
 namespace Engine
 {
-	OpenGLTexture::OpenGLTexture(const char* filepath)
+	namespace
 	{
-		int width, height, channels;
-		unsigned char* data = stbi_load(filepath, &width, &height, &channels, 0);
+		// S3TC internal formats, from EXT_texture_compression_s3tc.
+		const GLenum s_formatBC1 = 0x83F0; // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+		const GLenum s_formatBC3 = 0x83F3; // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
 
-		if (data) init(width, height, channels, data);
+		/** @brief Check a cache file exists and is no older than its source. */
+		bool isCacheFresh(const std::string& cachePath, const char* sourcePath)
+		{
+			std::error_code cacheError, sourceError;
+			auto cacheTime = std::filesystem::last_write_time(cachePath, cacheError);
+			auto sourceTime = std::filesystem::last_write_time(sourcePath, sourceError);
+			return !cacheError && !sourceError && cacheTime >= sourceTime;
+		}
+	}
 
-		stbi_image_free(data);
+	OpenGLTexture::OpenGLTexture(const char* filepath)
+	{
+		TextureData data;
+		if (loadData(filepath, isCompressionSupported(), data)) init(data);
 	}
 
 	OpenGLTexture::OpenGLTexture(uint32_t width, uint32_t height, uint32_t channels, unsigned char* data)
@@ -22,40 +38,258 @@ namespace Engine
 		if (data) { init(width, height, channels, data); }
 	}
 
+	OpenGLTexture::OpenGLTexture(const TextureData& data)
+	{
+		if (!data.mips.empty()) init(data);
+	}
+
 	OpenGLTexture::~OpenGLTexture()
 	{
+		// A texture still showing a placeholder does not own the ID it reports.
+		if (!m_ownsID) return;
+
+		releaseBindlessHandle(m_bindlessHandle);
+		OpenGLStateCache::onDeleteTexture(m_OpenGL_ID);
 		glDeleteTextures(1, &m_OpenGL_ID);
 	}
 
+	bool OpenGLTexture::loadData(const char* filepath, bool compress, TextureData& data)
+	{
+		std::string cachePath = TextureCompression::cachePath(filepath);
+
+		// Use previously transcoded blocks directly, skipping the image decode entirely.
+		if (compress && isCacheFresh(cachePath, filepath))
+		{
+			if (TextureCompression::readDDS(cachePath, data)) return true;
+			Log::warn("Texture cache {0} is unreadable, transcoding again", cachePath);
+		}
+
+		int width, height, channels;
+		unsigned char* pixels = stbi_load(filepath, &width, &height, &channels, 0);
+		if (!pixels)
+		{
+			Log::error("Could not load texture: {0}", filepath);
+			return false;
+		}
+
+		if (channels != 3 && channels != 4)
+		{
+			Log::error("Texture {0} has {1} channels, only 3 or 4 are supported", filepath, channels);
+			stbi_image_free(pixels);
+			return false;
+		}
+
+		if (compress)
+		{
+			// First load: transcode with a full mip chain and cache the result for next time.
+			TextureFormat format = channels == 4 ? TextureFormat::BC3 : TextureFormat::BC1;
+			data = TextureCompression::compress(pixels, width, height, channels, format);
+
+			std::error_code error;
+			std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+			if (!TextureCompression::writeDDS(cachePath, data)) Log::warn("Could not write texture cache {0}", cachePath);
+		}
+		else
+		{
+			// Without compression support the mip chain is still built here rather than on the GPU.
+			data.format = TextureFormat::RGBA8;
+			data.mips = TextureCompression::buildMipChain(pixels, width, height, channels);
+		}
+
+		stbi_image_free(pixels);
+		return true;
+	}
+
+	bool OpenGLTexture::loadData(const char* filepath, TextureFormat format, TextureData& data)
+	{
+		std::string cachePath = TextureCompression::cachePath(filepath, format);
+
+		if (isCacheFresh(cachePath, filepath))
+		{
+			if (TextureCompression::readDDS(cachePath, data) && data.format == format) return true;
+			Log::warn("Texture cache {0} is unreadable, transcoding again", cachePath);
+		}
+
+		// Transcode from the uncompressed chain, so three and four channel images can share one format.
+		TextureData chain;
+		if (!loadData(filepath, false, chain)) return false;
+		data = TextureCompression::compressMipChain(chain.mips, format);
+
+		std::error_code error;
+		std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path(), error);
+		if (!TextureCompression::writeDDS(cachePath, data)) Log::warn("Could not write texture cache {0}", cachePath);
+
+		return true;
+	}
+
 	void OpenGLTexture::edit(uint32_t xOffset, uint32_t yOffset, uint32_t width, uint32_t height, unsigned char* data)
 	{
-		glBindTexture(GL_TEXTURE_2D, m_OpenGL_ID);
+		if (m_format == TextureFormat::BC1 || m_format == TextureFormat::BC3)
+		{
+			Log::error("Compressed texture {0} cannot be edited", m_OpenGL_ID);
+			return;
+		}
+
 		if (data)
 		{
-			if (m_channels == 3) glTextureSubImage2D(GL_TEXTURE_2D, 0, xOffset, yOffset, width, height, GL_RGB, GL_UNSIGNED_BYTE, data);
-			else if (m_channels == 4) glTextureSubImage2D(GL_TEXTURE_2D, 0, xOffset, yOffset, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+			if (m_channels == 3) glTextureSubImage2D(m_OpenGL_ID, 0, xOffset, yOffset, width, height, GL_RGB, GL_UNSIGNED_BYTE, data);
+			else if (m_channels == 4) glTextureSubImage2D(m_OpenGL_ID, 0, xOffset, yOffset, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
 		}
 	}
 
 	void OpenGLTexture::init(uint32_t width, uint32_t height, uint32_t channels, unsigned char* data)
 	{
-		glGenTextures(1, &m_OpenGL_ID);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, m_OpenGL_ID);
+		if (channels != 3 && channels != 4) return;
+
+		// Texture state is set through the texture itself, so no unit binding is disturbed.
+		glCreateTextures(GL_TEXTURE_2D, 1, &m_OpenGL_ID);
+
+		glTextureParameteri(m_OpenGL_ID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(m_OpenGL_ID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(m_OpenGL_ID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(m_OpenGL_ID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		uint32_t levels = 1;
+		while ((std::max(width, height) >> levels) > 0) levels++;
 
-		if (channels == 3) glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		else if (channels == 4) glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		else return;
-		glGenerateMipmap(GL_TEXTURE_2D);
+		if (channels == 3) glTextureStorage2D(m_OpenGL_ID, levels, GL_RGB8, width, height);
+		else glTextureStorage2D(m_OpenGL_ID, levels, GL_RGBA8, width, height);
+
+		// Rows of three channel images are tightly packed.
+		OpenGLStateCache::setUnpackAlignment(1);
+		glTextureSubImage2D(m_OpenGL_ID, 0, 0, 0, width, height, channels == 3 ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE, data);
+		glGenerateTextureMipmap(m_OpenGL_ID);
 
 		m_width = width;
 		m_height = height;
 		m_channels = channels;
+		m_format = channels == 3 ? TextureFormat::RGB8 : TextureFormat::RGBA8;
+	}
+
+	void OpenGLTexture::init(const TextureData& data)
+	{
+		uint32_t textureID = createStorage(data);
+
+		// Upload every level as stored, compressed blocks go to the GPU untouched.
+		for (uint32_t level = 0; level < data.mips.size(); level++) uploadLevel(textureID, data.format, level, data.mips[level], data.mips[level].data.data());
+
+		makeResident(textureID, data);
+	}
+
+	uint32_t OpenGLTexture::createStorage(const TextureData& data)
+	{
+		uint32_t textureID;
+		glCreateTextures(GL_TEXTURE_2D, 1, &textureID);
+
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		// The chain is complete down to the given levels, so sample between them.
+		GLint levels = static_cast<GLint>(data.mips.size());
+		glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(textureID, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+		glTextureStorage2D(textureID, levels, toGLInternalFormat(data.format), data.mips[0].width, data.mips[0].height);
+		return textureID;
+	}
+
+	void OpenGLTexture::uploadLevel(uint32_t textureID, TextureFormat format, uint32_t level, const TextureMip& mip, const void* pixels)
+	{
+		// Pixels are a pointer into client memory, or an offset while a pixel unpack buffer is bound.
+		OpenGLStateCache::setUnpackAlignment(1);
+		if (format == TextureFormat::BC1 || format == TextureFormat::BC3)
+		{
+			glCompressedTextureSubImage2D(textureID, level, 0, 0, mip.width, mip.height, toGLInternalFormat(format), TextureCompression::levelSize(format, mip.width, mip.height), pixels);
+		}
+		else
+		{
+			glTextureSubImage2D(textureID, level, 0, 0, mip.width, mip.height, format == TextureFormat::RGB8 ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+		}
+	}
+
+	void OpenGLTexture::usePlaceholder(const OpenGLTexture& placeholder)
+	{
+		m_OpenGL_ID = placeholder.m_OpenGL_ID;
+		m_ownsID = false;
+		m_width = placeholder.m_width;
+		m_height = placeholder.m_height;
+		m_channels = placeholder.m_channels;
+		m_format = placeholder.m_format;
+	}
+
+	void OpenGLTexture::makeResident(uint32_t textureID, const TextureData& data)
+	{
+		m_OpenGL_ID = textureID;
+		m_ownsID = true;
+		m_width = data.mips[0].width;
+		m_height = data.mips[0].height;
+		m_channels = (data.format == TextureFormat::RGB8 || data.format == TextureFormat::BC1) ? 3 : 4;
+		m_format = data.format;
+	}
+
+	uint32_t OpenGLTexture::toGLInternalFormat(TextureFormat format)
+	{
+		switch (format)
+		{
+		case TextureFormat::RGB8: return GL_RGB8;
+		case TextureFormat::BC1: return s_formatBC1;
+		case TextureFormat::BC3: return s_formatBC3;
+		default: return GL_RGBA8;
+		}
+	}
+
+	uint64_t OpenGLTexture::getBindlessHandle()
+	{
+		if (m_bindlessHandle || !m_ownsID || !m_OpenGL_ID) return m_bindlessHandle;
+
+		m_bindlessHandle = createBindlessHandle(m_OpenGL_ID);
+		return m_bindlessHandle;
+	}
+
+	bool OpenGLTexture::isCompressionSupported()
+	{
+		// Queried once, S3TC is not core and some drivers expose it only through the extension.
+		static const bool s_supported = []
+		{
+			GLint bc1 = GL_FALSE, bc3 = GL_FALSE;
+			glGetInternalformativ(GL_TEXTURE_2D, s_formatBC1, GL_INTERNALFORMAT_SUPPORTED, 1, &bc1);
+			glGetInternalformativ(GL_TEXTURE_2D, s_formatBC3, GL_INTERNALFORMAT_SUPPORTED, 1, &bc3);
+			return bc1 == GL_TRUE && bc3 == GL_TRUE;
+		}();
+
+		return s_supported;
+	}
+
+	bool OpenGLTexture::isBindlessSupported()
+	{
+#ifdef GL_ARB_bindless_texture
+		return GLAD_GL_ARB_bindless_texture != 0;
+#else
+		// The loader was generated without the extension, so its entry points are unavailable.
+		return false;
+#endif
+	}
+
+	uint64_t OpenGLTexture::createBindlessHandle(uint32_t textureID)
+	{
+#ifdef GL_ARB_bindless_texture
+		if (!isBindlessSupported()) return 0;
+
+		// A handle must be resident before any shader samples through it.
+		GLuint64 handle = glGetTextureHandleARB(textureID);
+		if (handle) glMakeTextureHandleResidentARB(handle);
+		return handle;
+#else
+		return 0;
+#endif
+	}
+
+	void OpenGLTexture::releaseBindlessHandle(uint64_t handle)
+	{
+#ifdef GL_ARB_bindless_texture
+		if (handle) glMakeTextureHandleNonResidentARB(handle);
+#endif
 	}
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "engine_pch.h"
+#include <glad/glad.h>
+#include "platforms/OpenGL/OpenGLTextureArray.h"
+#include "platforms/OpenGL/OpenGLTexture.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
+#include "systems/log.h"
+#include <algorithm>
+
+namespace Engine
+{
+	OpenGLTextureArray::OpenGLTextureArray(uint32_t width, uint32_t height, uint32_t layerCount, TextureFormat format) :
+		m_width(width),
+		m_height(height),
+		m_layerCapacity(layerCount),
+		m_format(format)
+	{
+		while ((std::max(width, height) >> m_levels) > 0) m_levels++;
+
+		glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_OpenGL_ID);
+
+		glTextureParameteri(m_OpenGL_ID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(m_OpenGL_ID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(m_OpenGL_ID, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTextureParameteri(m_OpenGL_ID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(m_OpenGL_ID, GL_TEXTURE_MAX_LEVEL, m_levels - 1);
+
+		glTextureStorage3D(m_OpenGL_ID, m_levels, OpenGLTexture::toGLInternalFormat(format), width, height, layerCount);
+	}
+
+	OpenGLTextureArray::~OpenGLTextureArray()
+	{
+		OpenGLStateCache::onDeleteTexture(m_OpenGL_ID);
+		glDeleteTextures(1, &m_OpenGL_ID);
+	}
+
+	int32_t OpenGLTextureArray::addLayer(const TextureData& data)
+	{
+		if (m_layerCount == m_layerCapacity)
+		{
+			Log::error("Texture array {0} is full with {1} layers", m_OpenGL_ID, m_layerCapacity);
+			return -1;
+		}
+
+		// Every layer shares the storage's size, format and level count.
+		if (data.format != m_format || data.mips.size() != m_levels || data.mips[0].width != m_width || data.mips[0].height != m_height)
+		{
+			Log::error("Texture array {0} holds {1}x{2} layers with {3} levels, cannot add a {4}x{5} image with {6} levels",
+				m_OpenGL_ID, m_width, m_height, m_levels, data.mips.empty() ? 0 : data.mips[0].width, data.mips.empty() ? 0 : data.mips[0].height, data.mips.size());
+			return -1;
+		}
+
+		OpenGLStateCache::setUnpackAlignment(1);
+		GLenum internalFormat = OpenGLTexture::toGLInternalFormat(m_format);
+		for (uint32_t level = 0; level < m_levels; level++)
+		{
+			const TextureMip& mip = data.mips[level];
+			if (data.isCompressed()) glCompressedTextureSubImage3D(m_OpenGL_ID, level, 0, 0, m_layerCount, mip.width, mip.height, 1, internalFormat, static_cast<GLsizei>(mip.data.size()), mip.data.data());
+			else glTextureSubImage3D(m_OpenGL_ID, level, 0, 0, m_layerCount, mip.width, mip.height, 1, m_format == TextureFormat::RGB8 ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE, mip.data.data());
+		}
+
+		return static_cast<int32_t>(m_layerCount++);
+	}
+
+	int32_t OpenGLTextureArray::addLayer(const char* filepath)
+	{
+		if (m_format == TextureFormat::RGB8)
+		{
+			Log::error("Texture array {0} is RGB8, add prepared data rather than {1}", m_OpenGL_ID, filepath);
+			return -1;
+		}
+
+		// Compressed arrays go through the DDS cache, so later runs skip both the decode and the transcode.
+		TextureData data;
+		bool compressed = m_format == TextureFormat::BC1 || m_format == TextureFormat::BC3;
+		if (!(compressed ? OpenGLTexture::loadData(filepath, m_format, data) : OpenGLTexture::loadData(filepath, false, data))) return -1;
+
+		return addLayer(data);
+	}
+}
@@ -0,0 +1,178 @@
+#include "engine_pch.h"
+#include <cstring>
+#include <glad/glad.h>
+#include "platforms/OpenGL/OpenGLTextureStreamer.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
+#include "systems/log.h"
+
+namespace Engine
+{
+	OpenGLTextureStreamer::OpenGLTextureStreamer(uint32_t uploadBudget, uint32_t workerCount) :
+		m_compress(OpenGLTexture::isCompressionSupported())
+	{
+		// Mid grey, so unloaded surfaces are lit plausibly rather than flashing.
+		unsigned char grey[4] = { 128, 128, 128, 255 };
+		m_placeholder.reset(new OpenGLTexture(1, 1, 4, grey));
+
+		// Each frame stages into its own fenced region, so a region is only rewritten once the GPU has read it.
+		m_staging.reset(new OpenGLStreamingBuffer(uploadBudget));
+
+		if (workerCount == 0) workerCount = 1;
+		for (uint32_t i = 0; i < workerCount; i++) m_workers.emplace_back(&OpenGLTextureStreamer::workerLoop, this);
+	}
+
+	OpenGLTextureStreamer::~OpenGLTextureStreamer()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_condition.notify_all();
+		for (std::thread& worker : m_workers) worker.join();
+
+		for (PendingUpload& upload : m_uploads)
+		{
+			if (upload.textureID)
+			{
+				OpenGLStateCache::onDeleteTexture(upload.textureID);
+				glDeleteTextures(1, &upload.textureID);
+			}
+		}
+	}
+
+	std::shared_ptr<OpenGLTexture> OpenGLTextureStreamer::load(const char* filepath)
+	{
+		std::shared_ptr<OpenGLTexture> texture(new OpenGLTexture);
+		texture->usePlaceholder(*m_placeholder);
+
+		m_pendingCount++;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_requests.push_back({ filepath, texture });
+		}
+		m_condition.notify_one();
+
+		return texture;
+	}
+
+	void OpenGLTextureStreamer::update()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			while (!m_decoded.empty())
+			{
+				m_uploads.push_back(std::move(m_decoded.front()));
+				m_decoded.pop_front();
+			}
+		}
+
+		m_lastFrameBytes = 0;
+		if (m_uploads.empty()) return;
+
+		m_staging->beginFrame();
+		OpenGLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, m_staging->getRenderID());
+
+		const uint32_t alignment = 16;
+		uint32_t staged = 0;
+		bool budgetSpent = false;
+		while (!m_uploads.empty() && !budgetSpent)
+		{
+			PendingUpload& upload = m_uploads.front();
+			std::shared_ptr<OpenGLTexture> texture = upload.texture.lock();
+
+			// Nobody holds the texture any more, so drop it rather than spending budget on it.
+			if (!texture)
+			{
+				if (upload.textureID)
+				{
+					OpenGLStateCache::onDeleteTexture(upload.textureID);
+					glDeleteTextures(1, &upload.textureID);
+				}
+				m_uploads.pop_front();
+				m_pendingCount--;
+				continue;
+			}
+
+			if (!upload.textureID) upload.textureID = OpenGLTexture::createStorage(upload.data);
+
+			while (upload.nextLevel < upload.data.mips.size())
+			{
+				const TextureMip& mip = upload.data.mips[upload.nextLevel];
+				uint32_t size = static_cast<uint32_t>(mip.data.size());
+				uint32_t stagedSize = (size + alignment - 1) & ~(alignment - 1);
+
+				if (staged + stagedSize <= m_staging->getRegionSize())
+				{
+					StreamAllocation allocation = m_staging->allocate(size, alignment);
+					memcpy(allocation.data, mip.data.data(), size);
+					OpenGLTexture::uploadLevel(upload.textureID, upload.data.format, upload.nextLevel, mip, reinterpret_cast<const void*>(static_cast<uintptr_t>(allocation.offset)));
+					staged += stagedSize;
+				}
+				else if (m_lastFrameBytes == 0)
+				{
+					// A level larger than the whole budget can never be staged, upload it alone from client memory so it still progresses.
+					OpenGLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+					OpenGLTexture::uploadLevel(upload.textureID, upload.data.format, upload.nextLevel, mip, mip.data.data());
+					OpenGLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, m_staging->getRenderID());
+					budgetSpent = true;
+				}
+				else
+				{
+					budgetSpent = true;
+					break;
+				}
+
+				m_lastFrameBytes += size;
+				upload.nextLevel++;
+				if (budgetSpent) break;
+			}
+
+			if (upload.nextLevel == upload.data.mips.size())
+			{
+				texture->makeResident(upload.textureID, upload.data);
+				m_uploads.pop_front();
+				m_pendingCount--;
+			}
+		}
+
+		// Later uploads from client memory must not read from the staging buffer.
+		OpenGLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		m_staging->endFrame();
+	}
+
+	void OpenGLTextureStreamer::workerLoop()
+	{
+		while (true)
+		{
+			LoadRequest request;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_condition.wait(lock, [this] { return m_stopping || !m_requests.empty(); });
+				if (m_stopping) return;
+
+				request = std::move(m_requests.front());
+				m_requests.pop_front();
+			}
+
+			// Released before a worker reached it, skip the disk read entirely.
+			if (request.texture.expired())
+			{
+				m_pendingCount--;
+				continue;
+			}
+
+			// Decoding and transcoding make no OpenGL calls, only the upload needs the render thread.
+			PendingUpload upload;
+			upload.texture = request.texture;
+			if (!OpenGLTexture::loadData(request.filepath.c_str(), m_compress, upload.data))
+			{
+				Log::warn("Streamed texture {0} keeps its placeholder", request.filepath);
+				m_pendingCount--;
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_decoded.push_back(std::move(upload));
+		}
+	}
+}
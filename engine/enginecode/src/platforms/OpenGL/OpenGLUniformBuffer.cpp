@@ -0,0 +1,38 @@
+#include "engine_pch.h"
+#include <glad/glad.h>
+#include "platforms/OpenGL/OpenGLUniformBuffer.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
+
+namespace Engine
+{
+	OpenGLUniformBuffer::~OpenGLUniformBuffer()
+	{
+		// Delete the OpenGL buffer identified by m_OpenGL_ID, and forget any bindings of it.
+		OpenGLStateCache::onDeleteBuffer(m_OpenGL_ID);
+		glDeleteBuffers(1, &m_OpenGL_ID);
+	}
+
+	OpenGLUniformBuffer::OpenGLUniformBuffer(uint32_t size, uint32_t bindingPoint) : m_size(size), m_bindingPoint(bindingPoint)
+	{
+		// Create a new OpenGL buffer and store its ID in m_OpenGL_ID.
+		glCreateBuffers(1, &m_OpenGL_ID);
+
+		// Allocate the buffer without binding it, its contents are written every frame.
+		glNamedBufferData(m_OpenGL_ID, size, nullptr, GL_DYNAMIC_DRAW);
+
+		// Attach the buffer to its binding point so every shader using the block reads from it.
+		bind();
+	}
+
+	void OpenGLUniformBuffer::uploadData(const void* data, uint32_t size, uint32_t offset)
+	{
+		// Update a portion of the buffer's data starting from the specified offset, without binding it.
+		glNamedBufferSubData(m_OpenGL_ID, offset, size, data);
+	}
+
+	void OpenGLUniformBuffer::bind()
+	{
+		// Bind the whole buffer to its indexed binding point.
+		OpenGLStateCache::bindBufferRange(GL_UNIFORM_BUFFER, m_bindingPoint, m_OpenGL_ID, 0, m_size);
+	}
+}
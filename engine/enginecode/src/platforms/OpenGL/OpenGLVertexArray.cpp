@@ -1,6 +1,7 @@
 #include "engine_pch.h"
 #include <glad/glad.h>
 #include "platforms/OpenGL/OpenGLVertexArray.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
 
 namespace Engine
 {
@@ -20,6 +21,13 @@ namespace Engine
 			case ShaderDataType::Short2: return GL_SHORT;   // Convert Short2 to GL_SHORT
 			case ShaderDataType::Short3: return GL_SHORT;   // Convert Short3 to GL_SHORT
 			case ShaderDataType::Short4: return GL_SHORT;   // Convert Short4 to GL_SHORT
+			case ShaderDataType::Mat4:   return GL_FLOAT;   // Convert Mat4 to GL_FLOAT
+			case ShaderDataType::Half2:  return GL_HALF_FLOAT; // Convert Half2 to GL_HALF_FLOAT
+			case ShaderDataType::Half4:  return GL_HALF_FLOAT; // Convert Half4 to GL_HALF_FLOAT
+			case ShaderDataType::UByte4N: return GL_UNSIGNED_BYTE; // Convert UByte4N to GL_UNSIGNED_BYTE
+			case ShaderDataType::Int2101010Rev: return GL_INT_2_10_10_10_REV; // Convert Int2101010Rev to GL_INT_2_10_10_10_REV
+			case ShaderDataType::Oct16:  return GL_SHORT;   // Convert Oct16 to GL_SHORT
+			case ShaderDataType::Mat3:   return GL_FLOAT;   // Convert Mat3 to GL_FLOAT
 			default: return GL_INVALID_ENUM;                // Return GL_INVALID_ENUM for unsupported types
 			}
 		}
@@ -28,7 +36,8 @@ namespace Engine
 	// Destructor: Responsible for cleaning up the OpenGL vertex array object.
 	OpenGLVertexArray::~OpenGLVertexArray()
 	{
-		// Delete the OpenGL vertex array identified by m_OpenGL_ID
+		// Delete the OpenGL vertex array identified by m_OpenGL_ID, and forget it if it is bound.
+		OpenGLStateCache::onDeleteVertexArray(m_OpenGL_ID);
 		glDeleteVertexArrays(1, &m_OpenGL_ID);
 	}
 
@@ -39,43 +48,67 @@ namespace Engine
 		glCreateVertexArrays(1, &m_OpenGL_ID);
 
 		// Bind the newly created vertex array
-		glBindVertexArray(m_OpenGL_ID);
+		OpenGLStateCache::bindVertexArray(m_OpenGL_ID);
 	}
 
 	// Method to add a vertex buffer to the vertex array.
 	void OpenGLVertexArray::addVertexBuffer(const std::shared_ptr<OpenGLVertexBuffer>& vertexBuffer)
+	{
+		// Set up the attributes sourced from the vertex buffer.
+		addVertexBuffer(vertexBuffer->getRenderID(), vertexBuffer->getLayout());
+
+		// Keep the vertex buffer alive for as long as the vertex array uses it.
+		m_vertexBuffer.push_back(vertexBuffer);
+	}
+
+	// Method to add attributes sourced from an externally owned buffer to the vertex array.
+	void OpenGLVertexArray::addVertexBuffer(uint32_t bufferID, const BufferLayout& layout)
+	{
+		// A runtime layout is set up through a view of its elements, the same as a static one.
+		addVertexBuffer(bufferID, layout.getView());
+	}
+
+	// Method to add attributes described by a view of a layout's elements to the vertex array.
+	void OpenGLVertexArray::addVertexBuffer(uint32_t bufferID, const BufferLayoutView& layout)
 	{
 		// Bind this vertex array so that vertex buffer settings are applied to it.
-		glBindVertexArray(m_OpenGL_ID);
+		OpenGLStateCache::bindVertexArray(m_OpenGL_ID);
 
 		// Bind the specified vertex buffer to the OpenGL context.
-		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer->getRenderID());
-
-		// Get the layout (vertex attributes) of the vertex buffer.
-		const auto& layout = vertexBuffer->getLayout();
+		OpenGLStateCache::bindBuffer(GL_ARRAY_BUFFER, bufferID);
 
 		// Loop through each element (attribute) in the layout.
 		for (auto& element : layout)
 		{
 			uint32_t normalised = GL_FALSE;
 
-			// Check if the attribute needs to be normalized.
-			if (element.m_normalised) { normalised = GL_TRUE; }
+			// Check if the attribute needs to be normalized, packed types always are.
+			if (element.m_normalised || SDT::isNormalised(element.m_dataType)) { normalised = GL_TRUE; }
+
+			// Matrices are split into one attribute per column.
+			uint32_t slots = SDT::attributeSlots(element.m_dataType);
+			uint32_t slotSize = element.m_size / slots;
 
-			// Enable the vertex attribute at m_attributeIndex.
-			glEnableVertexAttribArray(m_attributeIndex);
+			for (uint32_t slot = 0; slot < slots; slot++)
+			{
+				// Enable the vertex attribute at m_attributeIndex.
+				glEnableVertexAttribArray(m_attributeIndex);
+
+				// Specify the layout and properties of the vertex attribute.
+				glVertexAttribPointer(
+					m_attributeIndex,
+					SDT::componentCount(element.m_dataType) / slots, // Number of components in the attribute.
+					SDT::toGLType(element.m_dataType),               // OpenGL data type of the attribute.
+					normalised,
+					layout.getStride(),                              // Distance between consecutive attributes.
+					(void*)(uintptr_t)(element.m_offset + slot * slotSize)); // Offset of the attribute in the vertex buffer.
 
-			// Specify the layout and properties of the vertex attribute.
-			glVertexAttribPointer(
-				m_attributeIndex,
-				SDT::componentCount(element.m_dataType),     // Number of components in the attribute.
-				SDT::toGLType(element.m_dataType),           // OpenGL data type of the attribute.
-				normalised,
-				layout.getStride(),                         // Distance between consecutive attributes.
-				(void*)element.m_offset);                   // Offset of the attribute in the vertex buffer.
+				// Advance the attribute per instance rather than per vertex if requested.
+				glVertexAttribDivisor(m_attributeIndex, element.m_divisor);
 
-			// Move to the next attribute index.
-			m_attributeIndex++;
+				// Move to the next attribute index.
+				m_attributeIndex++;
+			}
 		}
 	}
 
@@ -89,14 +122,14 @@ namespace Engine
 	// Method to bind the vertex array for rendering.
 	void OpenGLVertexArray::bind()
 	{
-		// Bind the OpenGL vertex array identified by m_OpenGL_ID.
-		glBindVertexArray(m_OpenGL_ID);
+		// Bind the OpenGL vertex array identified by m_OpenGL_ID, unless it is already bound.
+		OpenGLStateCache::bindVertexArray(m_OpenGL_ID);
 	}
 
 	// Method to unbind the currently bound vertex array.
 	void OpenGLVertexArray::unbind()
 	{
 		// Bind a null vertex array, effectively unbinding any currently bound vertex array.
-		glBindVertexArray(0);
+		OpenGLStateCache::bindVertexArray(0);
 	}
 }
\ No newline at end of file
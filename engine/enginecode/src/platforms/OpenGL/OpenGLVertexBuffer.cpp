@@ -1,6 +1,8 @@
 #include "engine_pch.h"
 #include <glad/glad.h>
 #include "platforms/OpenGL/OpenGLVertexBuffer.h"
+#include "platforms/OpenGL/OpenGLBufferStorage.h"
+#include "platforms/OpenGL/OpenGLStateCache.h"
 
 namespace Engine
 {
@@ -32,40 +34,49 @@ namespace Engine
 
 	OpenGLVertexBuffer::~OpenGLVertexBuffer()
 	{
-		// Delete the OpenGL buffer identified by m_OpenGL_ID.
+		// Delete the OpenGL buffer identified by m_OpenGL_ID, and forget any bindings of it.
+		OpenGLStateCache::onDeleteBuffer(m_OpenGL_ID);
 		glDeleteBuffers(1, &m_OpenGL_ID);
 	}
 
-	OpenGLVertexBuffer::OpenGLVertexBuffer(void* vertices, uint32_t size, BufferLayout layout) : m_layout(layout)
+	OpenGLVertexBuffer::OpenGLVertexBuffer(void* vertices, uint32_t size, BufferLayout layout, BufferUsage usage) :
+		OpenGLVertexBuffer(vertices, size, BufferLayoutView(), usage)
+	{
+		// Keep the runtime layout and view its elements.
+		m_layout = layout;
+		m_view = m_layout.getView();
+	}
+
+	OpenGLVertexBuffer::OpenGLVertexBuffer(void* vertices, uint32_t size, const BufferLayoutView& layout, BufferUsage usage) :
+		m_view(layout),
+		m_size(size),
+		m_usage(usage)
 	{
 		// Create a new OpenGL buffer and store its ID in m_OpenGL_ID.
 		glCreateBuffers(1, &m_OpenGL_ID);
 
 		// Bind the newly created buffer as an array buffer.
-		glBindBuffer(GL_ARRAY_BUFFER, m_OpenGL_ID);
+		OpenGLStateCache::bindBuffer(GL_ARRAY_BUFFER, m_OpenGL_ID);
 
-		// Fill the buffer with the provided vertex data.
-		glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_DYNAMIC_DRAW);
+		// Allocate storage matching the usage policy and fill it with the provided vertex data.
+		OpenGLBufferStorage::allocate(m_OpenGL_ID, size, vertices, usage);
 	}
 
 	void OpenGLVertexBuffer::edit(void* vertices, uint32_t size, uint32_t offset)
 	{
-		// Bind the vertex buffer for editing.
-		glBindBuffer(GL_ARRAY_BUFFER, m_OpenGL_ID);
-
-		// Update a portion of the buffer's data starting from the specified offset.
-		glBufferSubData(GL_ARRAY_BUFFER, offset, size, vertices);
+		// Update a portion of the buffer's data starting from the specified offset, if the usage policy allows it.
+		OpenGLBufferStorage::update(m_OpenGL_ID, m_size, vertices, size, offset, m_usage);
 	}
 
 	void OpenGLVertexBuffer::bind()
 	{
-		// Bind the OpenGL vertex buffer identified by m_OpenGL_ID.
-		glBindBuffer(GL_ARRAY_BUFFER, m_OpenGL_ID);
+		// Bind the OpenGL vertex buffer identified by m_OpenGL_ID, unless it is already bound.
+		OpenGLStateCache::bindBuffer(GL_ARRAY_BUFFER, m_OpenGL_ID);
 	}
 
 	void OpenGLVertexBuffer::unbind()
 	{
 		// Bind a null vertex buffer, effectively unbinding any currently bound vertex buffer.
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		OpenGLStateCache::bindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 }
\ No newline at end of file
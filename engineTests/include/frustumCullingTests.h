@@ -0,0 +1,4 @@
+#pragma once
+#include <gtest/gtest.h>
+#include "rendering/frustumCulling.h"
+#include "systems/workerPool.h"
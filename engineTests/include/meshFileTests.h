@@ -0,0 +1,6 @@
+#pragma once
+#include <gtest/gtest.h>
+#include "rendering/meshFile.h"
+#include "rendering/meshImporter.h"
+#include "rendering/vertexPacking.h"
+#include "systems/mappedFile.h"
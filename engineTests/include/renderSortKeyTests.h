@@ -0,0 +1,5 @@
+#pragma once
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include "rendering/renderSortKey.h"
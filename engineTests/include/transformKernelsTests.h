@@ -0,0 +1,3 @@
+#pragma once
+#include <gtest/gtest.h>
+#include "scene/transformKernels.h"
@@ -0,0 +1,5 @@
+#pragma once
+#include <gtest/gtest.h>
+#include "rendering/vertexLayout.h"
+#include "rendering/instanceTransform.h"
+#include "rendering/meshImporter.h"
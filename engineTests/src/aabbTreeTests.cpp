@@ -0,0 +1,141 @@
+#include "aabbTreeTests.h"
+#include <algorithm>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+	/** @brief A random box between 0.1 and 2 units across, somewhere in a 100 unit cube. */
+	Engine::AABB randomBox(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> position(-50.f, 50.f), size(0.1f, 2.f);
+		glm::vec3 min(position(random), position(random), position(random));
+		return { min, min + glm::vec3(size(random), size(random), size(random)) };
+	}
+}
+
+TEST(AABBTree, StaysValidAndBalanced)
+{
+	Engine::DynamicAABBTree tree;
+	std::mt19937 random(5);
+	std::vector<int32_t> proxies;
+	for (uint32_t i = 0; i < 1000; i++) proxies.push_back(tree.createProxy(randomBox(random), i));
+
+	EXPECT_TRUE(tree.validate());
+	EXPECT_EQ(tree.getProxyCount(), 1000u);
+	// A perfectly balanced tree of 1000 leaves has a height of 10.
+	EXPECT_LE(tree.getHeight(), 20);
+
+	// Objects moving within their margin stay put, and ones moving further are reinserted.
+	Engine::AABB box = randomBox(random);
+	int32_t proxy = tree.createProxy(box, 1000);
+	EXPECT_FALSE(tree.moveProxy(proxy, { box.min + glm::vec3(0.05f), box.max + glm::vec3(0.05f) }));
+	EXPECT_TRUE(tree.moveProxy(proxy, { box.min + glm::vec3(10.f), box.max + glm::vec3(10.f) }, glm::vec3(10.f)));
+	EXPECT_TRUE(tree.getFatAABB(proxy).contains({ box.min + glm::vec3(25.f), box.max + glm::vec3(25.f) }));
+	EXPECT_EQ(tree.getUserData(proxy), 1000u);
+
+	for (uint32_t i = 0; i < proxies.size(); i += 2) tree.destroyProxy(proxies[i]);
+	for (uint32_t i = 1; i < proxies.size(); i += 2) tree.moveProxy(proxies[i], randomBox(random));
+
+	EXPECT_TRUE(tree.validate());
+	EXPECT_EQ(tree.getProxyCount(), 501u);
+	EXPECT_LE(tree.getHeight(), 18);
+}
+
+TEST(AABBTree, QueriesMatchBruteForce)
+{
+	Engine::DynamicAABBTree tree;
+	std::mt19937 random(7);
+	std::vector<Engine::AABB> fatBoxes;
+	for (uint32_t i = 0; i < 2000; i++)
+	{
+		int32_t proxy = tree.createProxy(randomBox(random), i);
+		fatBoxes.push_back(tree.getFatAABB(proxy));
+	}
+
+	auto collect = [](std::vector<uint32_t>& found) { return [&found](int32_t, uint32_t userData) { found.push_back(userData); return true; }; };
+
+	Engine::AABB region = { glm::vec3(-10.f), glm::vec3(15.f) };
+	std::vector<uint32_t> found, expected;
+	tree.queryBox(region, collect(found));
+	for (uint32_t i = 0; i < fatBoxes.size(); i++) if (region.overlaps(fatBoxes[i])) expected.push_back(i);
+	std::sort(found.begin(), found.end());
+	EXPECT_EQ(found, expected);
+	EXPECT_FALSE(found.empty());
+
+	glm::vec3 centre(5.f, -3.f, 2.f);
+	float radius = 12.f;
+	found.clear();
+	expected.clear();
+	tree.querySphere(centre, radius, collect(found));
+	for (uint32_t i = 0; i < fatBoxes.size(); i++)
+	{
+		glm::vec3 offset = centre - glm::clamp(centre, fatBoxes[i].min, fatBoxes[i].max);
+		if (glm::dot(offset, offset) <= radius * radius) expected.push_back(i);
+	}
+	std::sort(found.begin(), found.end());
+	EXPECT_EQ(found, expected);
+
+	glm::mat4 projection = glm::perspective(glm::radians(60.f), 1.5f, 0.1f, 40.f);
+	glm::mat4 view = glm::lookAt(glm::vec3(0.f, 0.f, 30.f), glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+	Engine::Frustum frustum = Engine::Frustum::fromMatrix(projection * view);
+	found.clear();
+	expected.clear();
+	tree.queryFrustum(frustum, collect(found));
+	for (uint32_t i = 0; i < fatBoxes.size(); i++) if (frustum.intersectsBox(fatBoxes[i].getCentre(), fatBoxes[i].getExtent())) expected.push_back(i);
+	std::sort(found.begin(), found.end());
+	EXPECT_EQ(found, expected);
+	EXPECT_GT(found.size(), 0u);
+	EXPECT_LT(found.size(), fatBoxes.size());
+}
+
+TEST(AABBTree, RaycastFindsNearestObject)
+{
+	Engine::DynamicAABBTree tree;
+	std::vector<Engine::AABB> boxes;
+	for (uint32_t i = 0; i < 10; i++)
+	{
+		float z = -5.f * static_cast<float>(i);
+		boxes.push_back({ glm::vec3(-1.f, -1.f, z - 1.f), glm::vec3(1.f, 1.f, z + 1.f) });
+		// Off to the side, never on the ray.
+		boxes.push_back({ glm::vec3(4.f, -1.f, z - 1.f), glm::vec3(6.f, 1.f, z + 1.f) });
+	}
+	for (uint32_t i = 0; i < boxes.size(); i++) tree.createProxy(boxes[i], i);
+
+	glm::vec3 origin(0.f, 0.f, -12.f), direction(0.f, 0.f, -1.f);
+	uint32_t tested = 0;
+	auto hitTest = [&](int32_t, uint32_t userData)
+	{
+		tested++;
+		float distance;
+		return boxes[userData].raycast(origin, glm::vec3(1.f) / direction, 100.f, distance) ? distance : -1.f;
+	};
+
+	// Starting between the third and fourth boxes, the fourth is the first hit, one unit in front of it.
+	Engine::RayHit hit = tree.raycast(origin, direction, 100.f, hitTest);
+	ASSERT_TRUE(hit.isHit());
+	EXPECT_EQ(tree.getUserData(hit.proxy), 6u);
+	EXPECT_FLOAT_EQ(hit.distance, 2.f);
+	EXPECT_LT(tested, boxes.size());
+
+	EXPECT_FALSE(tree.raycast(origin, direction, 1.f, hitTest).isHit());
+	EXPECT_FALSE(tree.raycast(origin, glm::vec3(0.f, 1.f, 0.f), 100.f, hitTest).isHit());
+}
+
+TEST(AABBTree, ScreenPointsUnprojectToRays)
+{
+	Camera camera;
+	camera.projection = glm::perspective(glm::radians(90.f), 2.f, 0.1f, 100.f);
+	camera.updateView(glm::translate(glm::mat4(1.f), glm::vec3(0.f, 0.f, 5.f)));
+
+	glm::vec3 origin, direction;
+	camera.screenPointToRay(glm::vec2(400.f, 200.f), glm::vec2(800.f, 400.f), origin, direction);
+	EXPECT_NEAR(origin.x, 0.f, 1e-4f);
+	EXPECT_NEAR(origin.z, 4.9f, 1e-4f);
+	EXPECT_NEAR(direction.z, -1.f, 1e-4f);
+
+	// The top right corner is at 45 degrees vertically and twice as far out horizontally.
+	camera.screenPointToRay(glm::vec2(800.f, 0.f), glm::vec2(800.f, 400.f), origin, direction);
+	EXPECT_NEAR(direction.x / -direction.z, 2.f, 1e-3f);
+	EXPECT_NEAR(direction.y / -direction.z, 1.f, 1e-3f);
+}
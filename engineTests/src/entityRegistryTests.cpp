@@ -0,0 +1,89 @@
+#include "entityRegistryTests.h"
+#include <memory>
+#include <set>
+
+namespace
+{
+	struct Position { float x, y, z; };
+	struct Velocity { float x, y, z; };
+	struct Name { std::shared_ptr<int> tag; };
+}
+
+TEST(EntityRegistry, CreateGetAndDestroy)
+{
+	Engine::EntityRegistry registry;
+	Engine::Entity a = registry.create(Position{ 1.f, 2.f, 3.f });
+	Engine::Entity b = registry.create(Position{ 4.f, 5.f, 6.f }, Velocity{ 1.f, 0.f, 0.f });
+
+	EXPECT_EQ(registry.size(), 2u);
+	ASSERT_NE(registry.get<Position>(a), nullptr);
+	EXPECT_EQ(registry.get<Position>(a)->y, 2.f);
+	EXPECT_EQ(registry.get<Velocity>(a), nullptr);
+	EXPECT_TRUE(registry.has<Velocity>(b));
+
+	registry.destroy(a);
+	EXPECT_FALSE(registry.isAlive(a));
+	EXPECT_EQ(registry.get<Position>(a), nullptr);
+
+	// The record is reused with a new generation, so the old handle stays dead.
+	Engine::Entity c = registry.create(Position{ 7.f, 8.f, 9.f });
+	EXPECT_EQ(c.index, a.index);
+	EXPECT_FALSE(registry.isAlive(a));
+	EXPECT_EQ(registry.get<Position>(c)->x, 7.f);
+	EXPECT_EQ(registry.get<Position>(b)->x, 4.f);
+}
+
+TEST(EntityRegistry, AddAndRemoveMoveBetweenArchetypes)
+{
+	Engine::EntityRegistry registry;
+	std::shared_ptr<int> tag = std::make_shared<int>(42);
+	Engine::Entity entity = registry.create(Position{ 1.f, 0.f, 0.f }, Name{ tag });
+
+	registry.add(entity, Velocity{ 0.f, 2.f, 0.f });
+	EXPECT_EQ(registry.get<Position>(entity)->x, 1.f);
+	EXPECT_EQ(registry.get<Velocity>(entity)->y, 2.f);
+	EXPECT_EQ(tag.use_count(), 2);
+
+	// Components are moved rather than copied, and destroyed when removed.
+	registry.remove<Name>(entity);
+	EXPECT_FALSE(registry.has<Name>(entity));
+	EXPECT_EQ(tag.use_count(), 1);
+	EXPECT_EQ(registry.get<Velocity>(entity)->y, 2.f);
+
+	registry.add(entity, Velocity{ 0.f, 3.f, 0.f });
+	EXPECT_EQ(registry.get<Velocity>(entity)->y, 3.f);
+}
+
+TEST(EntityRegistry, QueriesSpanArchetypesAndChunks)
+{
+	Engine::EntityRegistry registry;
+	std::vector<Engine::Entity> moving;
+	for (int i = 0; i < 5000; i++)
+	{
+		if (i % 2) moving.push_back(registry.create(Position{ 0.f, 0.f, 0.f }, Velocity{ 1.f, 0.f, 0.f }));
+		else registry.create(Position{ 0.f, 0.f, 0.f });
+	}
+
+	// Destroying from the middle keeps the arrays packed.
+	for (size_t i = 0; i < moving.size(); i += 3) registry.destroy(moving[i]);
+
+	auto chunks = registry.query<Position, Velocity>();
+	EXPECT_GT(chunks.size(), 1u);
+	uint32_t rows = 0;
+	for (const auto& chunk : chunks) rows += chunk.count;
+	EXPECT_EQ(rows, 2500u - 834u);
+
+	registry.each<Position, Velocity>([](Engine::Entity, Position& position, const Velocity& velocity) { position.x += velocity.x; });
+
+	std::set<uint32_t> seen;
+	uint32_t moved = 0, still = 0;
+	registry.each<Position>([&](Engine::Entity entity, const Position& position)
+	{
+		seen.insert(entity.index);
+		if (position.x == 1.f) moved++;
+		else still++;
+	});
+	EXPECT_EQ(moved, rows);
+	EXPECT_EQ(still, 2500u);
+	EXPECT_EQ(seen.size(), registry.size());
+}
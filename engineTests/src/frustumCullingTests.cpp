@@ -0,0 +1,111 @@
+#include "frustumCullingTests.h"
+#include <atomic>
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+	/** @brief A camera at (0, 0, 5) looking down -z with a 90 degree field of view. */
+	Engine::Frustum testFrustum()
+	{
+		glm::mat4 projection = glm::perspective(glm::radians(90.f), 1.f, 0.1f, 100.f);
+		glm::mat4 view = glm::lookAt(glm::vec3(0.f, 0.f, 5.f), glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+		return Engine::Frustum::fromMatrix(projection * view);
+	}
+}
+
+TEST(FrustumCulling, PlanesBoundTheView)
+{
+	Engine::Frustum frustum = testFrustum();
+	EXPECT_TRUE(frustum.intersectsSphere(glm::vec3(0.f), 0.5f));
+	EXPECT_FALSE(frustum.intersectsSphere(glm::vec3(0.f, 0.f, 10.f), 1.f));
+	EXPECT_FALSE(frustum.intersectsSphere(glm::vec3(0.f, 0.f, -200.f), 1.f));
+	EXPECT_FALSE(frustum.intersectsSphere(glm::vec3(20.f, 0.f, 0.f), 1.f));
+
+	// Just beyond the right plane, a sphere is saved by its radius and a box by its extent.
+	EXPECT_TRUE(frustum.intersectsSphere(glm::vec3(5.5f, 0.f, 0.f), 1.f));
+	EXPECT_TRUE(frustum.intersectsBox(glm::vec3(5.5f, 0.f, 0.f), glm::vec3(1.f)));
+	EXPECT_FALSE(frustum.intersectsBox(glm::vec3(5.5f, 0.f, 0.f), glm::vec3(0.1f)));
+}
+
+TEST(FrustumCulling, VectorTestsMatchScalarTests)
+{
+	Engine::Frustum frustum = testFrustum();
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> position(-40.f, 40.f), size(0.1f, 4.f);
+
+	Engine::SphereBounds spheres;
+	Engine::BoxBounds boxes;
+	std::vector<uint32_t> expectedSpheres, expectedBoxes;
+	for (uint32_t i = 0; i < 3 * Engine::FrustumCulling::blockSize + 13; i++)
+	{
+		glm::vec3 centre(position(random), position(random), position(random));
+		glm::vec3 extent(size(random), size(random), size(random));
+		spheres.add(centre, extent.x);
+		boxes.add(centre, extent);
+		if (frustum.intersectsSphere(centre, extent.x)) expectedSpheres.push_back(i);
+		if (frustum.intersectsBox(centre, extent)) expectedBoxes.push_back(i);
+	}
+
+	// Every path the CPU can run, with a count which leaves a tail for each narrower path.
+	uint32_t supported = static_cast<uint32_t>(Engine::CpuFeatures::getSupportedInstructionSet());
+	for (uint32_t set = 0; set <= supported; set++)
+	{
+		Engine::InstructionSet instructionSet = static_cast<Engine::InstructionSet>(set);
+		SCOPED_TRACE(Engine::CpuFeatures::getInstructionSetName(instructionSet));
+
+		std::vector<uint32_t> visible(spheres.size());
+		visible.resize(Engine::FrustumCulling::cullSpheres(frustum, spheres, 0, spheres.size(), visible.data(), instructionSet));
+		EXPECT_EQ(visible, expectedSpheres);
+
+		visible.resize(boxes.size());
+		visible.resize(Engine::FrustumCulling::cullBoxes(frustum, boxes, 0, boxes.size(), visible.data(), instructionSet));
+		EXPECT_EQ(visible, expectedBoxes);
+	}
+
+	std::vector<uint32_t> visible;
+	EXPECT_EQ(Engine::FrustumCulling::cullSpheres(frustum, spheres, visible), expectedSpheres.size());
+	EXPECT_EQ(visible, expectedSpheres);
+	Engine::FrustumCulling::cullBoxes(frustum, boxes, visible);
+	EXPECT_EQ(visible, expectedBoxes);
+
+	// Split across workers, the list is the same and in the same order.
+	Engine::WorkerPool workers(3);
+	Engine::FrustumCulling::cullSpheres(frustum, spheres, visible, &workers);
+	EXPECT_EQ(visible, expectedSpheres);
+	Engine::FrustumCulling::cullBoxes(frustum, boxes, visible, &workers);
+	EXPECT_EQ(visible, expectedBoxes);
+}
+
+TEST(FrustumCulling, TransformedBoxContainsCorners)
+{
+	glm::mat4 world = glm::rotate(glm::translate(glm::mat4(1.f), glm::vec3(3.f, 0.f, 1.f)), 0.6f, glm::vec3(1.f, 1.f, 0.f));
+	glm::vec3 min(-1.f, -2.f, -0.5f), max(1.f, 0.f, 2.f);
+
+	glm::vec3 centre, extent;
+	Engine::FrustumCulling::transformBox(world, min, max, centre, extent);
+
+	for (int corner = 0; corner < 8; corner++)
+	{
+		glm::vec3 local(corner & 1 ? max.x : min.x, corner & 2 ? max.y : min.y, corner & 4 ? max.z : min.z);
+		glm::vec3 point = glm::vec3(world * glm::vec4(local, 1.f));
+		for (int axis = 0; axis < 3; axis++) EXPECT_LE(std::abs(point[axis] - centre[axis]), extent[axis] + 1e-5f);
+	}
+}
+
+TEST(WorkerPool, ParallelForCoversRangeOnce)
+{
+	Engine::WorkerPool workers(4);
+	std::vector<std::atomic<uint32_t>> hits(10000);
+	for (auto& hit : hits) hit = 0;
+
+	for (int run = 0; run < 3; run++)
+	{
+		workers.parallelFor(10000, 64, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++) hits[i]++;
+		});
+	}
+
+	for (auto& hit : hits) EXPECT_EQ(hit.load(), 3u);
+}
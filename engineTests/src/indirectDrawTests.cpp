@@ -0,0 +1,79 @@
+#include "indirectDrawTests.h"
+
+namespace
+{
+	/** @brief A handle to a mesh at the given ranges of a pool. */
+	Engine::MeshHandle mesh(uint32_t firstIndex, uint32_t indexCount, int32_t baseVertex)
+	{
+		Engine::MeshHandle handle;
+		handle.firstIndex = firstIndex;
+		handle.indexCount = indexCount;
+		handle.baseVertex = baseVertex;
+		return handle;
+	}
+
+	// Two meshes as a pool would place them, the second after the first's 36 indices and 24 vertices.
+	const Engine::MeshHandle s_cube = mesh(0, 36, 0);
+	const Engine::MeshHandle s_pyramid = mesh(36, 18, 24);
+}
+
+TEST(IndirectDraw, CommandsDrawEachMeshFromItsRanges)
+{
+	Engine::MeshHandle meshes[2] = { s_cube, s_pyramid };
+	Engine::DrawElementsIndirectCommand commands[2];
+
+	ASSERT_EQ(Engine::IndirectDraw::buildCommands(meshes, 2, 10, commands), 2u);
+
+	EXPECT_EQ(commands[0].count, 36u);
+	EXPECT_EQ(commands[0].instanceCount, 1u);
+	EXPECT_EQ(commands[0].firstIndex, 0u);
+	EXPECT_EQ(commands[0].baseVertex, 0);
+	EXPECT_EQ(commands[0].baseInstance, 10u);
+
+	EXPECT_EQ(commands[1].count, 18u);
+	EXPECT_EQ(commands[1].instanceCount, 1u);
+	EXPECT_EQ(commands[1].firstIndex, 36u);
+	EXPECT_EQ(commands[1].baseVertex, 24);
+	EXPECT_EQ(commands[1].baseInstance, 11u);
+}
+
+TEST(IndirectDraw, ConsecutiveDrawsOfAMeshBecomeInstances)
+{
+	Engine::MeshHandle meshes[5] = { s_cube, s_cube, s_cube, s_pyramid, s_pyramid };
+	Engine::DrawElementsIndirectCommand commands[5];
+
+	ASSERT_EQ(Engine::IndirectDraw::buildCommands(meshes, 5, 0, commands), 2u);
+
+	// Each command's instances start at its first draw's instance data.
+	EXPECT_EQ(commands[0].instanceCount, 3u);
+	EXPECT_EQ(commands[0].baseInstance, 0u);
+	EXPECT_EQ(commands[1].instanceCount, 2u);
+	EXPECT_EQ(commands[1].baseInstance, 3u);
+	EXPECT_EQ(commands[1].firstIndex, 36u);
+}
+
+TEST(IndirectDraw, SeparatedRepeatsGetTheirOwnCommand)
+{
+	// The cube's draws are not adjacent, so their instance data is not either.
+	Engine::MeshHandle meshes[3] = { s_cube, s_pyramid, s_cube };
+	Engine::DrawElementsIndirectCommand commands[3];
+
+	ASSERT_EQ(Engine::IndirectDraw::buildCommands(meshes, 3, 4, commands), 3u);
+	EXPECT_EQ(commands[2].firstIndex, 0u);
+	EXPECT_EQ(commands[2].instanceCount, 1u);
+	EXPECT_EQ(commands[2].baseInstance, 6u);
+}
+
+TEST(IndirectDraw, InvalidHandlesAreSkipped)
+{
+	Engine::MeshHandle meshes[4] = { Engine::MeshHandle(), s_cube, Engine::MeshHandle(), s_cube };
+	Engine::DrawElementsIndirectCommand commands[4];
+
+	// The skipped draws keep their instance slots, so the cubes are two commands reading instances 1 and 3.
+	ASSERT_EQ(Engine::IndirectDraw::buildCommands(meshes, 4, 0, commands), 2u);
+	EXPECT_EQ(commands[0].baseInstance, 1u);
+	EXPECT_EQ(commands[1].baseInstance, 3u);
+	EXPECT_EQ(commands[1].instanceCount, 1u);
+
+	EXPECT_EQ(Engine::IndirectDraw::buildCommands(meshes, 1, 0, commands), 0u);
+}
@@ -0,0 +1,36 @@
+#include "lodSelectionTests.h"
+
+namespace
+{
+	/** @brief Three levels, each with twice the error of the last. */
+	const Engine::MeshLod s_lods[3] = { { 0, 300, 0.f }, { 300, 150, 0.01f }, { 450, 75, 0.02f } };
+}
+
+TEST(LodSelection, ScreenErrorShrinksWithDistance)
+{
+	EXPECT_FLOAT_EQ(Engine::LodSelection::getScreenError(0.01f, 1.f, 500.f), 5.f);
+	EXPECT_FLOAT_EQ(Engine::LodSelection::getScreenError(0.01f, 10.f, 500.f), 0.5f);
+}
+
+TEST(LodSelection, CoarsensWithDistance)
+{
+	// At a scale of 500 pixels, level 1 is one pixel at 5 units and level 2 is one pixel at 10.
+	EXPECT_EQ(Engine::LodSelection::select(s_lods, 3, 1.f, 2.f, 500.f, 0), 0u);
+	EXPECT_EQ(Engine::LodSelection::select(s_lods, 3, 1.f, 8.f, 500.f, 0), 1u);
+	EXPECT_EQ(Engine::LodSelection::select(s_lods, 3, 1.f, 20.f, 500.f, 0), 2u);
+
+	// Scaling the object up doubles its error, so it holds detail twice as far.
+	EXPECT_EQ(Engine::LodSelection::select(s_lods, 3, 2.f, 8.f, 500.f, 0), 0u);
+	EXPECT_EQ(Engine::LodSelection::select(s_lods, 1, 1.f, 100.f, 500.f, 0), 0u);
+}
+
+TEST(LodSelection, HysteresisHoldsNearBoundary)
+{
+	// Just past the level 1 boundary, a mesh at level 0 stays there and one at level 1 does not come back.
+	EXPECT_EQ(Engine::LodSelection::select(s_lods, 3, 1.f, 5.5f, 500.f, 0), 0u);
+	EXPECT_EQ(Engine::LodSelection::select(s_lods, 3, 1.f, 4.5f, 500.f, 1), 1u);
+
+	// Well past it, either switches.
+	EXPECT_EQ(Engine::LodSelection::select(s_lods, 3, 1.f, 7.f, 500.f, 0), 1u);
+	EXPECT_EQ(Engine::LodSelection::select(s_lods, 3, 1.f, 3.f, 500.f, 1), 0u);
+}
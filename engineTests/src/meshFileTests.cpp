@@ -0,0 +1,228 @@
+#include "meshFileTests.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	/** @brief Two submeshes of a strip of four vertices, each a Float3 position and a UByte4N colour. */
+	Engine::MeshData buildStrip()
+	{
+		Engine::MeshData mesh;
+		mesh.layout = Engine::BufferLayout({ Engine::ShaderDataType::Float3, Engine::ShaderDataType::UByte4N });
+
+		for (uint32_t v = 0; v < 4; v++)
+		{
+			float position[3] = { static_cast<float>(v), static_cast<float>(v % 2), 0.f };
+			uint32_t colour = 0xFF000000u | v;
+			const uint8_t* p = reinterpret_cast<const uint8_t*>(position);
+			const uint8_t* c = reinterpret_cast<const uint8_t*>(&colour);
+			mesh.vertices.insert(mesh.vertices.end(), p, p + sizeof(position));
+			mesh.vertices.insert(mesh.vertices.end(), c, c + sizeof(colour));
+		}
+
+		mesh.indices = { 0, 1, 2, 2, 1, 3 };
+		mesh.submeshes.resize(2);
+		mesh.submeshes[0].indexCount = 3;
+		mesh.submeshes[1].firstIndex = 3;
+		mesh.submeshes[1].indexCount = 3;
+		mesh.bounds.max[0] = 3.f;
+		mesh.bounds.max[1] = 1.f;
+		return mesh;
+	}
+}
+
+TEST(MeshFile, RoundTripThroughMapping)
+{
+	Engine::MeshData mesh = buildStrip();
+	const char* path = "meshFileTest.gmsh";
+	ASSERT_TRUE(Engine::MeshFile::write(path, mesh));
+
+	{
+		Engine::MappedFile file(path);
+		ASSERT_TRUE(file.isOpen());
+
+		Engine::MeshFileView view;
+		std::string error;
+		ASSERT_TRUE(view.open(file.getData(), file.getSize(), error)) << error;
+
+		const Engine::MeshFileHeader& header = view.getHeader();
+		EXPECT_EQ(header.vertexCount, 4u);
+		EXPECT_EQ(header.vertexStride, 16u);
+		EXPECT_EQ(header.submeshCount, 2u);
+		EXPECT_FLOAT_EQ(header.bounds.max[0], 3.f);
+
+		// Four vertices fit in 16 bit indices, and every blob is aligned for direct upload.
+		ASSERT_EQ(view.getIndexType(), Engine::IndexType::UInt16);
+		EXPECT_EQ(header.vertexOffset % Engine::MeshFile::blobAlignment, 0u);
+		EXPECT_EQ(header.indexOffset % Engine::MeshFile::blobAlignment, 0u);
+
+		const uint16_t* indices = static_cast<const uint16_t*>(view.getIndices());
+		for (uint32_t i = 0; i < 6; i++) EXPECT_EQ(indices[i], mesh.indices[i]);
+		EXPECT_EQ(memcmp(view.getVertices(), mesh.vertices.data(), mesh.vertices.size()), 0);
+		EXPECT_EQ(view.getSubmeshes()[1].firstIndex, 3u);
+
+		Engine::BufferLayout layout = view.getLayout();
+		EXPECT_EQ(layout.getStride(), 16u);
+		ASSERT_EQ(layout.end() - layout.begin(), 2);
+		EXPECT_EQ(layout.begin()[1].m_dataType, Engine::ShaderDataType::UByte4N);
+		EXPECT_EQ(layout.begin()[1].m_offset, 12u);
+	}
+
+	std::remove(path);
+}
+
+TEST(MeshFile, RejectsTruncatedAndForeignFiles)
+{
+	Engine::MeshData mesh = buildStrip();
+	const char* path = "meshFileTest.gmsh";
+	ASSERT_TRUE(Engine::MeshFile::write(path, mesh));
+
+	std::ifstream handle(path, std::ios::binary);
+	std::vector<uint8_t> contents((std::istreambuf_iterator<char>(handle)), std::istreambuf_iterator<char>());
+	handle.close();
+	std::remove(path);
+
+	Engine::MeshFileView view;
+	std::string error;
+	EXPECT_TRUE(view.open(contents.data(), contents.size(), error));
+	EXPECT_FALSE(view.open(contents.data(), contents.size() - 1, error));
+	EXPECT_FALSE(view.open(contents.data(), sizeof(Engine::MeshFileHeader) - 1, error));
+
+	contents[0] ^= 0xFF;
+	EXPECT_FALSE(view.open(contents.data(), contents.size(), error));
+}
+
+TEST(MeshFile, ImportsOBJ)
+{
+	// One quad and one triangle in separate groups, the triangle using negative indices and no normals.
+	const char* path = "meshFileTest.obj";
+	{
+		std::ofstream obj(path);
+		obj << "o quad\n"
+			"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+			"vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+			"vn 0 0 1\n"
+			"f 1/1/1 2/2/1 3/3/1 4/4/1\n"
+			"g triangle\n"
+			"v 0 0 2\nv 1 0 2\nv 0 1 2\n"
+			"f -3 -2 -1\n";
+	}
+
+	Engine::MeshData mesh;
+	std::string error;
+	ASSERT_TRUE(Engine::MeshImporter::importOBJ(path, mesh, error)) << error;
+	std::remove(path);
+
+	EXPECT_EQ(mesh.layout.getStride(), sizeof(Engine::MeshImporter::Vertex));
+	EXPECT_EQ(mesh.vertices.size(), 7 * sizeof(Engine::MeshImporter::Vertex));
+	ASSERT_EQ(mesh.indices.size(), 9u);
+	ASSERT_EQ(mesh.submeshes.size(), 2u);
+	EXPECT_EQ(mesh.submeshes[0].indexCount, 6u);
+	EXPECT_EQ(mesh.submeshes[1].firstIndex, 6u);
+	EXPECT_FLOAT_EQ(mesh.submeshes[1].bounds.min[2], 2.f);
+	EXPECT_FLOAT_EQ(mesh.bounds.max[2], 2.f);
+
+	// The triangle's smooth normal faces +z, as does the quad's given one.
+	const Engine::MeshImporter::Vertex* vertices = reinterpret_cast<const Engine::MeshImporter::Vertex*>(mesh.vertices.data());
+	for (uint32_t index : mesh.indices) EXPECT_EQ(vertices[index].normal, Engine::VertexPacking::packOct16(glm::vec3(0.f, 0.f, 1.f)));
+}
+
+TEST(MeshFile, ImportBuildsLods)
+{
+	// A closed sphere of 16 rings of 32 quads, sharing its vertices so it has no seams.
+	const char* path = "meshFileTest.obj";
+	{
+		std::ofstream obj(path);
+		const uint32_t rings = 16, segments = 32;
+		obj << "v 0 1 0\n";
+		for (uint32_t r = 1; r < rings; r++)
+		{
+			for (uint32_t s = 0; s < segments; s++)
+			{
+				float theta = 3.14159265f * r / rings, phi = 6.28318531f * s / segments;
+				obj << "v " << sinf(theta) * cosf(phi) << " " << cosf(theta) << " " << sinf(theta) * sinf(phi) << "\n";
+			}
+		}
+		obj << "v 0 -1 0\n";
+
+		auto ringVertex = [&](uint32_t r, uint32_t s) { return 2 + (r - 1) * segments + s % segments; };
+		uint32_t bottom = 2 + (rings - 1) * segments;
+		for (uint32_t s = 0; s < segments; s++)
+		{
+			obj << "f 1 " << ringVertex(1, s + 1) << " " << ringVertex(1, s) << "\n";
+			for (uint32_t r = 1; r + 1 < rings; r++) obj << "f " << ringVertex(r, s) << " " << ringVertex(r, s + 1) << " " << ringVertex(r + 1, s + 1) << " " << ringVertex(r + 1, s) << "\n";
+			obj << "f " << ringVertex(rings - 1, s) << " " << ringVertex(rings - 1, s + 1) << " " << bottom << "\n";
+		}
+	}
+
+	Engine::MeshData mesh;
+	std::string error;
+	ASSERT_TRUE(Engine::MeshImporter::importOBJ(path, mesh, error)) << error;
+	std::remove(path);
+
+	// Each level follows the last in the indices, with fewer triangles and more error, as every step's error adds to the last.
+	ASSERT_GT(mesh.lods.size(), 1u);
+	ASSERT_LE(mesh.lods.size(), Engine::MeshImporter::maxLods);
+	EXPECT_EQ(mesh.lods[0].indexCount, 2u * 32u * 15u * 3u);
+	for (size_t i = 1; i < mesh.lods.size(); i++)
+	{
+		EXPECT_EQ(mesh.lods[i].firstIndex, mesh.lods[i - 1].firstIndex + mesh.lods[i - 1].indexCount);
+		EXPECT_LT(mesh.lods[i].indexCount, mesh.lods[i - 1].indexCount);
+		EXPECT_GT(mesh.lods[i].error, mesh.lods[i - 1].error);
+		EXPECT_LT(mesh.lods[i].error, 0.5f);
+	}
+	EXPECT_EQ(mesh.lods.back().firstIndex + mesh.lods.back().indexCount, mesh.indices.size());
+
+	// Every level keeps its own range of the sphere's one submesh, covering the level's indices.
+	ASSERT_EQ(mesh.submeshes.size(), mesh.lods.size());
+	for (size_t i = 0; i < mesh.lods.size(); i++)
+	{
+		ASSERT_EQ(mesh.lods[i].submeshCount, 1u);
+		const Engine::Submesh& submesh = mesh.submeshes[mesh.lods[i].firstSubmesh];
+		EXPECT_EQ(submesh.firstIndex, mesh.lods[i].firstIndex);
+		EXPECT_EQ(submesh.indexCount, mesh.lods[i].indexCount);
+	}
+
+	// The tables survive the file, and a level reaching past the indices, or a submesh past its level, is refused.
+	const char* meshPath = "meshFileTest.gmsh";
+	ASSERT_TRUE(Engine::MeshFile::write(meshPath, mesh));
+	std::ifstream handle(meshPath, std::ios::binary);
+	std::vector<uint8_t> contents((std::istreambuf_iterator<char>(handle)), std::istreambuf_iterator<char>());
+	handle.close();
+	std::remove(meshPath);
+
+	Engine::MeshFileView view;
+	ASSERT_TRUE(view.open(contents.data(), contents.size(), error)) << error;
+	ASSERT_EQ(view.getHeader().lodCount, mesh.lods.size());
+	EXPECT_EQ(view.getLods()[1].indexCount, mesh.lods[1].indexCount);
+	EXPECT_FLOAT_EQ(view.getLods()[1].error, mesh.lods[1].error);
+	EXPECT_EQ(view.getSubmeshes()[view.getLods()[1].firstSubmesh].firstIndex, mesh.lods[1].firstIndex);
+
+	// A refused file leaves the view empty, so the header is copied first.
+	Engine::MeshFileHeader header = view.getHeader();
+	Engine::Submesh* submeshes = reinterpret_cast<Engine::Submesh*>(contents.data() + header.submeshOffset);
+	submeshes[1].indexCount++;
+	EXPECT_FALSE(view.open(contents.data(), contents.size(), error));
+	submeshes[1].indexCount--;
+
+	Engine::MeshLod* lods = reinterpret_cast<Engine::MeshLod*>(contents.data() + header.lodOffset);
+	lods[1].indexCount = header.indexCount;
+	EXPECT_FALSE(view.open(contents.data(), contents.size(), error));
+}
+
+TEST(MeshFile, RejectsBadFaceIndices)
+{
+	const char* path = "meshFileTest.obj";
+	{
+		std::ofstream obj(path);
+		obj << "v 0 0 0\nv 1 0 0\nf 1 2 3\n";
+	}
+
+	Engine::MeshData mesh;
+	std::string error;
+	EXPECT_FALSE(Engine::MeshImporter::importOBJ(path, mesh, error));
+	EXPECT_FALSE(error.empty());
+	std::remove(path);
+}
@@ -0,0 +1,153 @@
+#include "meshOptimizerTests.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+
+namespace
+{
+	/** @brief A grid of quads, two triangles each, with the triangles shuffled. */
+	void buildShuffledGrid(uint32_t size, std::vector<float>& positions, std::vector<uint32_t>& indices)
+	{
+		for (uint32_t y = 0; y <= size; y++)
+		{
+			for (uint32_t x = 0; x <= size; x++) positions.insert(positions.end(), { static_cast<float>(x), static_cast<float>(y), 0.f });
+		}
+
+		std::vector<std::array<uint32_t, 3>> triangles;
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				uint32_t v = y * (size + 1) + x;
+				triangles.push_back({ v, v + 1, v + size + 2 });
+				triangles.push_back({ v, v + size + 2, v + size + 1 });
+			}
+		}
+
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(7));
+		for (const auto& triangle : triangles) indices.insert(indices.end(), triangle.begin(), triangle.end());
+	}
+
+	/** @brief Two concentric spheres of radius 1 and 2, wound outwards, with the triangles of both shuffled together. The outer sphere's vertices follow the inner's. */
+	void buildShuffledShells(uint32_t rings, uint32_t segments, std::vector<float>& positions, std::vector<uint32_t>& indices)
+	{
+		std::vector<std::array<uint32_t, 3>> triangles;
+		for (float radius : { 1.f, 2.f })
+		{
+			uint32_t first = static_cast<uint32_t>(positions.size() / 3);
+			for (uint32_t ring = 0; ring <= rings; ring++)
+			{
+				float theta = 3.14159265f * ring / rings;
+				for (uint32_t segment = 0; segment <= segments; segment++)
+				{
+					float phi = 6.28318531f * segment / segments;
+					positions.insert(positions.end(), { radius * std::sin(theta) * std::cos(phi), radius * std::cos(theta), radius * std::sin(theta) * std::sin(phi) });
+				}
+			}
+
+			for (uint32_t ring = 0; ring < rings; ring++)
+			{
+				for (uint32_t segment = 0; segment < segments; segment++)
+				{
+					uint32_t v = first + ring * (segments + 1) + segment;
+					triangles.push_back({ v, v + 1, v + segments + 2 });
+					triangles.push_back({ v, v + segments + 2, v + segments + 1 });
+				}
+			}
+		}
+
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(7));
+		for (const auto& triangle : triangles) indices.insert(indices.end(), triangle.begin(), triangle.end());
+	}
+
+	/** @brief Sort each triangle's corners and then the triangles, so triangle lists can be compared regardless of order. */
+	std::vector<std::array<uint32_t, 3>> canonical(const std::vector<uint32_t>& indices, const std::vector<float>& positions, const std::vector<float>& original)
+	{
+		std::vector<std::array<uint32_t, 3>> triangles;
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			std::array<uint32_t, 3> triangle;
+			for (int c = 0; c < 3; c++)
+			{
+				// Map each vertex back to its original index through its unique position.
+				const float* p = &positions[indices[i + c] * 3];
+				for (size_t v = 0; v < original.size() / 3; v++)
+				{
+					if (original[v * 3] == p[0] && original[v * 3 + 1] == p[1] && original[v * 3 + 2] == p[2]) { triangle[c] = static_cast<uint32_t>(v); break; }
+				}
+			}
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.push_back(triangle);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+}
+
+TEST(MeshOptimizer, VertexCacheLowersMissRatio)
+{
+	std::vector<float> positions;
+	std::vector<uint32_t> indices;
+	buildShuffledGrid(32, positions, indices);
+	uint32_t vertexCount = static_cast<uint32_t>(positions.size() / 3);
+
+	float before = Engine::MeshOptimizer::cacheMissRatio(indices.data(), static_cast<uint32_t>(indices.size()), vertexCount);
+	Engine::MeshOptimizer::optimizeVertexCache(indices.data(), static_cast<uint32_t>(indices.size()), vertexCount);
+	float after = Engine::MeshOptimizer::cacheMissRatio(indices.data(), static_cast<uint32_t>(indices.size()), vertexCount);
+
+	EXPECT_GT(before, 2.f);
+	EXPECT_LT(after, 1.f);
+}
+
+TEST(MeshOptimizer, OverdrawStaysWithinThreshold)
+{
+	// An inner shell inside an outer one, so draw order decides how much of the inner shell is shaded and then hidden.
+	std::vector<float> positions;
+	std::vector<uint32_t> indices;
+	buildShuffledShells(24, 48, positions, indices);
+	uint32_t vertexCount = static_cast<uint32_t>(positions.size() / 3);
+	uint32_t indexCount = static_cast<uint32_t>(indices.size());
+	uint32_t outerFirst = vertexCount / 2;
+
+	Engine::MeshOptimizer::optimizeVertexCache(indices.data(), indexCount, vertexCount);
+	float cached = Engine::MeshOptimizer::cacheMissRatio(indices.data(), indexCount, vertexCount);
+
+	std::vector<uint32_t> reordered = indices;
+	Engine::MeshOptimizer::optimizeOverdraw(reordered.data(), indexCount, positions.data(), vertexCount, 12, 1.05f);
+
+	EXPECT_LE(Engine::MeshOptimizer::cacheMissRatio(reordered.data(), indexCount, vertexCount), cached * 1.05f);
+	EXPECT_EQ(canonical(reordered, positions, positions), canonical(indices, positions, positions));
+
+	// The outer shell occludes the inner one, so most of the first half drawn should be outer triangles.
+	uint32_t outerInFirstHalf = 0;
+	for (uint32_t i = 0; i < indexCount / 2; i += 3) outerInFirstHalf += reordered[i] >= outerFirst ? 1 : 0;
+	EXPECT_GT(outerInFirstHalf, indexCount / 6 * 9 / 10);
+}
+
+TEST(MeshOptimizer, FetchRemapKeepsTrianglesAndDropsUnused)
+{
+	std::vector<float> positions;
+	std::vector<uint32_t> indices;
+	buildShuffledGrid(4, positions, indices);
+	positions.insert(positions.end(), { 100.f, 100.f, 0.f });
+	std::vector<float> original = positions;
+	std::vector<uint32_t> originalIndices = indices;
+
+	uint32_t kept = Engine::MeshOptimizer::optimizeVertexFetch(positions.data(), static_cast<uint32_t>(positions.size() / 3), 12, indices.data(), static_cast<uint32_t>(indices.size()));
+
+	EXPECT_EQ(kept, 25);
+	EXPECT_EQ(indices[0], 0);
+	EXPECT_EQ(*std::max_element(indices.begin(), indices.end()), kept - 1);
+	EXPECT_EQ(canonical(indices, positions, original), canonical(originalIndices, original, original));
+}
+
+TEST(MeshOptimizer, ShortIndicesOnlyWhenVerticesFit)
+{
+	EXPECT_TRUE(Engine::MeshOptimizer::fitsShortIndices(65536));
+	EXPECT_FALSE(Engine::MeshOptimizer::fitsShortIndices(65537));
+
+	uint32_t indices[3] = { 0, 1, 65535 };
+	std::vector<uint16_t> shortIndices = Engine::MeshOptimizer::toShortIndices(indices, 3);
+	EXPECT_EQ(shortIndices[2], 65535);
+}
@@ -0,0 +1,114 @@
+#include "meshSimplifierTests.h"
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace
+{
+	/** @brief A closed UV sphere with no seams, one vertex per point. */
+	void buildSphere(uint32_t rings, uint32_t segments, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices)
+	{
+		positions.push_back(glm::vec3(0.f, 1.f, 0.f));
+		for (uint32_t r = 1; r < rings; r++)
+		{
+			float theta = 3.14159265f * r / rings;
+			for (uint32_t s = 0; s < segments; s++)
+			{
+				float phi = 2.f * 3.14159265f * s / segments;
+				positions.push_back(glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+			}
+		}
+		positions.push_back(glm::vec3(0.f, -1.f, 0.f));
+
+		uint32_t bottom = static_cast<uint32_t>(positions.size() - 1);
+		auto ring = [segments](uint32_t r, uint32_t s) { return 1 + (r - 1) * segments + s % segments; };
+		for (uint32_t s = 0; s < segments; s++)
+		{
+			indices.insert(indices.end(), { 0, ring(1, s + 1), ring(1, s) });
+			indices.insert(indices.end(), { bottom, ring(rings - 1, s), ring(rings - 1, s + 1) });
+			for (uint32_t r = 1; r + 1 < rings; r++)
+			{
+				indices.insert(indices.end(), { ring(r, s), ring(r, s + 1), ring(r + 1, s + 1) });
+				indices.insert(indices.end(), { ring(r, s), ring(r + 1, s + 1), ring(r + 1, s) });
+			}
+		}
+	}
+
+	/** @brief Check each edge of a triangle list is shared by exactly two triangles, as in a closed surface. */
+	bool isClosed(const std::vector<uint32_t>& indices, uint32_t count)
+	{
+		std::vector<std::pair<uint32_t, uint32_t>> edges;
+		for (uint32_t i = 0; i < count; i++) edges.push_back({ indices[i], indices[i - i % 3 + (i + 1) % 3] });
+		for (const auto& edge : edges)
+		{
+			// A consistently wound closed surface uses each directed edge once, in one direction.
+			if (std::count(edges.begin(), edges.end(), std::make_pair(edge.second, edge.first)) != 1) return false;
+		}
+		return true;
+	}
+}
+
+TEST(MeshSimplifier, FlatAreasCollapseWithoutError)
+{
+	// A 9x9 grid of points on a plane, 128 triangles.
+	std::vector<glm::vec3> positions;
+	std::vector<uint32_t> indices;
+	for (uint32_t y = 0; y < 9; y++) for (uint32_t x = 0; x < 9; x++) positions.push_back(glm::vec3(x, y, 0.f));
+	for (uint32_t y = 0; y < 8; y++)
+	{
+		for (uint32_t x = 0; x < 8; x++)
+		{
+			uint32_t i = y * 9 + x;
+			indices.insert(indices.end(), { i, i + 1, i + 10, i, i + 10, i + 9 });
+		}
+	}
+
+	std::vector<uint32_t> simplified(indices.size());
+	float error = -1.f;
+	uint32_t count = Engine::MeshSimplifier::simplify(simplified.data(), indices.data(), static_cast<uint32_t>(indices.size()), &positions[0].x,
+		static_cast<uint32_t>(positions.size()), sizeof(glm::vec3), 0, 1e-4f, &error);
+
+	// Only the interior can go, leaving a fan across the locked border of 32 points.
+	EXPECT_LT(count, indices.size() / 2);
+	EXPECT_EQ(count % 3, 0u);
+	EXPECT_NEAR(error, 0.f, 1e-3f);
+
+	float area = 0.f;
+	for (uint32_t i = 0; i < count; i += 3)
+	{
+		glm::vec3 normal = glm::cross(positions[simplified[i + 1]] - positions[simplified[i]], positions[simplified[i + 2]] - positions[simplified[i]]);
+		EXPECT_GT(normal.z, 0.f);
+		area += 0.5f * normal.z;
+	}
+	EXPECT_NEAR(area, 64.f, 1e-3f);
+}
+
+TEST(MeshSimplifier, CurvedSurfacesReduceToTargetAndStayClosed)
+{
+	std::vector<glm::vec3> positions;
+	std::vector<uint32_t> indices;
+	buildSphere(16, 32, positions, indices);
+	uint32_t indexCount = static_cast<uint32_t>(indices.size());
+	ASSERT_TRUE(isClosed(indices, indexCount));
+
+	std::vector<uint32_t> half(indexCount), quarter(indexCount);
+	float halfError = 0.f, quarterError = 0.f;
+	uint32_t halfCount = Engine::MeshSimplifier::simplify(half.data(), indices.data(), indexCount, &positions[0].x, static_cast<uint32_t>(positions.size()), sizeof(glm::vec3), indexCount / 2, FLT_MAX, &halfError);
+	uint32_t quarterCount = Engine::MeshSimplifier::simplify(quarter.data(), indices.data(), indexCount, &positions[0].x, static_cast<uint32_t>(positions.size()), sizeof(glm::vec3), indexCount / 4, FLT_MAX, &quarterError);
+
+	EXPECT_LE(halfCount, indexCount / 2);
+	EXPECT_GT(halfCount, indexCount / 4);
+	EXPECT_LE(quarterCount, indexCount / 4);
+	EXPECT_TRUE(isClosed(half, halfCount));
+	EXPECT_TRUE(isClosed(quarter, quarterCount));
+
+	// Coarser levels move further from the surface, but stay close for a unit sphere.
+	EXPECT_GT(halfError, 0.f);
+	EXPECT_GE(quarterError, halfError);
+	EXPECT_LT(quarterError, 0.25f);
+
+	// An error limit stops the collapses early.
+	std::vector<uint32_t> limited(indexCount);
+	uint32_t limitedCount = Engine::MeshSimplifier::simplify(limited.data(), indices.data(), indexCount, &positions[0].x, static_cast<uint32_t>(positions.size()), sizeof(glm::vec3), 0, halfError * 0.5f);
+	EXPECT_GT(limitedCount, halfCount);
+}
@@ -0,0 +1,102 @@
+#include "occlusionCullingTests.h"
+#include <random>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+	/** @brief A camera at the origin looking down -z, with a 90 degree field of view across a 2:1 screen. */
+	glm::mat4 testViewProjection()
+	{
+		return glm::perspective(glm::radians(90.f), 2.f, 0.1f, 100.f);
+	}
+
+	/** @brief Window depth of a point on the view axis at a distance, for the test camera. */
+	float windowDepth(float distance)
+	{
+		glm::vec4 clip = testViewProjection() * glm::vec4(0.f, 0.f, -distance, 1.f);
+		return clip.z / clip.w * 0.5f + 0.5f;
+	}
+
+	/** @brief An 8x8 wall facing the camera, 10 units away. */
+	void addWall(Engine::OcclusionBuffer& buffer)
+	{
+		buffer.addOccluder(glm::mat4(1.f), Engine::OccluderMesh::box(glm::vec3(-4.f, -4.f, -10.f), glm::vec3(4.f, 4.f, -10.f)));
+	}
+}
+
+TEST(OcclusionCulling, RasterizesOccluderDepth)
+{
+	Engine::OcclusionBuffer buffer(256, 128);
+	buffer.begin(testViewProjection());
+	addWall(buffer);
+	buffer.rasterize();
+
+	EXPECT_GT(buffer.getTriangleCount(), 0u);
+	// The wall covers the centre of the screen at its depth, and nothing else is drawn.
+	EXPECT_NEAR(buffer.getDepth(128, 64), windowDepth(10.f), 1e-5f);
+	EXPECT_NEAR(buffer.getDepth(120, 58), windowDepth(10.f), 1e-5f);
+	EXPECT_EQ(buffer.getDepth(10, 10), 1.f);
+	EXPECT_EQ(buffer.getDepth(250, 120), 1.f);
+}
+
+TEST(OcclusionCulling, HidesBoxesBehindOccluders)
+{
+	Engine::OcclusionBuffer buffer(256, 128);
+	buffer.begin(testViewProjection());
+	addWall(buffer);
+	buffer.rasterize();
+
+	EXPECT_FALSE(buffer.isVisible(glm::vec3(0.f, 0.f, -20.f), glm::vec3(0.5f)));
+	// In front of the wall, poking out from behind it, or off to the side.
+	EXPECT_TRUE(buffer.isVisible(glm::vec3(0.f, 0.f, -5.f), glm::vec3(0.5f)));
+	EXPECT_TRUE(buffer.isVisible(glm::vec3(0.f, 0.f, -20.f), glm::vec3(10.f, 0.5f, 0.5f)));
+	EXPECT_TRUE(buffer.isVisible(glm::vec3(15.f, 0.f, -20.f), glm::vec3(0.5f)));
+	// Reaching past the near plane.
+	EXPECT_TRUE(buffer.isVisible(glm::vec3(0.f, 0.f, -12.f), glm::vec3(0.5f, 0.5f, 12.f)));
+
+	// An occluder's own box is never hidden by it.
+	EXPECT_TRUE(buffer.isVisible(glm::vec3(0.f, 0.f, -10.f), glm::vec3(4.f, 4.f, 0.f)));
+
+	Engine::BoxBounds boxes;
+	boxes.add(glm::vec3(0.f, 0.f, -20.f), glm::vec3(0.5f));
+	boxes.add(glm::vec3(0.f, 0.f, -5.f), glm::vec3(0.5f));
+	boxes.add(glm::vec3(0.2f, -0.3f, -50.f), glm::vec3(1.f));
+	boxes.add(glm::vec3(15.f, 0.f, -20.f), glm::vec3(0.5f));
+	std::vector<uint32_t> visible = { 0, 1, 2, 3 };
+	EXPECT_EQ(buffer.cullBoxes(boxes, visible), 2u);
+	EXPECT_EQ(visible, (std::vector<uint32_t>{ 1, 3 }));
+}
+
+TEST(OcclusionCulling, WorkersMatchSingleThread)
+{
+	std::mt19937 random(11);
+	std::uniform_real_distribution<float> position(-15.f, 15.f), depth(-60.f, -5.f), size(0.2f, 3.f);
+
+	Engine::OcclusionBuffer single(256, 128), threaded(256, 128);
+	single.begin(testViewProjection());
+	threaded.begin(testViewProjection());
+	for (uint32_t i = 0; i < 200; i++)
+	{
+		glm::vec3 centre(position(random), position(random), depth(random));
+		glm::vec3 extent(size(random), size(random), size(random));
+		glm::mat4 world = glm::rotate(glm::translate(glm::mat4(1.f), centre), position(random), glm::normalize(glm::vec3(1.f, 2.f, 3.f)));
+		Engine::OccluderMesh mesh = Engine::OccluderMesh::box(-extent, extent);
+		single.addOccluder(world, mesh);
+		threaded.addOccluder(world, mesh);
+	}
+
+	Engine::WorkerPool workers(3);
+	single.rasterize();
+	threaded.rasterize(&workers);
+
+	uint32_t covered = 0;
+	for (uint32_t y = 0; y < single.getHeight(); y++)
+	{
+		for (uint32_t x = 0; x < single.getWidth(); x++)
+		{
+			ASSERT_EQ(single.getDepth(x, y), threaded.getDepth(x, y));
+			covered += single.getDepth(x, y) < 1.f;
+		}
+	}
+	EXPECT_GT(covered, 0u);
+}
@@ -0,0 +1,46 @@
+#include "renderSortKeyTests.h"
+
+TEST(RenderSortKey, OpaqueBeforeTransparent)
+{
+	uint64_t opaque = Engine::SortKey::make(Engine::RenderPass::Opaque, 4095, 4095, 4095, 1000.f);
+	uint64_t transparent = Engine::SortKey::make(Engine::RenderPass::Transparent, 1, 1, 1, 0.1f);
+
+	EXPECT_LT(opaque, transparent);
+}
+
+TEST(RenderSortKey, OpaqueGroupsStateThenFrontToBack)
+{
+	uint64_t nearB = Engine::SortKey::make(Engine::RenderPass::Opaque, 2, 1, 1, 1.f);
+	uint64_t farA = Engine::SortKey::make(Engine::RenderPass::Opaque, 1, 1, 1, 50.f);
+	uint64_t nearA = Engine::SortKey::make(Engine::RenderPass::Opaque, 1, 1, 1, 2.f);
+
+	EXPECT_LT(farA, nearB);
+	EXPECT_LT(nearA, farA);
+}
+
+TEST(RenderSortKey, TransparentBackToFront)
+{
+	uint64_t nearKey = Engine::SortKey::make(Engine::RenderPass::Transparent, 1, 1, 1, 1.5f);
+	uint64_t farKey = Engine::SortKey::make(Engine::RenderPass::Transparent, 2, 2, 2, 30.f);
+
+	EXPECT_LT(farKey, nearKey);
+}
+
+TEST(RenderSortKey, RadixSortMatchesStdSort)
+{
+	std::mt19937_64 rng(42);
+	std::vector<Engine::SortItem> items(1000);
+	for (uint32_t i = 0; i < items.size(); i++) items[i] = { rng() & 0x0000FFFF00FFFFFFull, i };
+
+	std::vector<Engine::SortItem> expected = items;
+	std::stable_sort(expected.begin(), expected.end(), [](const Engine::SortItem& a, const Engine::SortItem& b) { return a.key < b.key; });
+
+	std::vector<Engine::SortItem> scratch;
+	Engine::radixSort(items, scratch);
+
+	for (uint32_t i = 0; i < items.size(); i++)
+	{
+		EXPECT_EQ(items[i].key, expected[i].key);
+		EXPECT_EQ(items[i].index, expected[i].index);
+	}
+}
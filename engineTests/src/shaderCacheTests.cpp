@@ -0,0 +1,60 @@
+#include "shaderCacheTests.h"
+#include <cstdio>
+#include <fstream>
+
+TEST(ShaderCache, KeyDependsOnSourcesAndDriver)
+{
+	uint64_t key = Engine::ShaderCache::programKey({ "void main() {}", "out vec4 c;" }, "Vendor Renderer 4.6");
+
+	EXPECT_EQ(key, Engine::ShaderCache::programKey({ "void main() {}", "out vec4 c;" }, "Vendor Renderer 4.6"));
+	EXPECT_NE(key, Engine::ShaderCache::programKey({ "void main() {}", "out vec4 d;" }, "Vendor Renderer 4.6"));
+	EXPECT_NE(key, Engine::ShaderCache::programKey({ "void main() {}", "out vec4 c;" }, "Vendor Renderer 4.5"));
+
+	// Moving text across the stage boundary must not produce the same key.
+	EXPECT_NE(Engine::ShaderCache::programKey({ "ab", "c" }, ""), Engine::ShaderCache::programKey({ "a", "bc" }, ""));
+}
+
+TEST(ShaderCache, CachePathIsHex)
+{
+	EXPECT_EQ(Engine::ShaderCache::cachePath(0x1234ABCDull), "./cache/shaders/000000001234abcd.bin");
+}
+
+TEST(ShaderCache, BinaryRoundTrip)
+{
+	Engine::ProgramBinary written;
+	written.format = 0x8E21;
+	for (uint8_t i = 0; i < 100; i++) written.data.push_back(i * 3);
+
+	const char* path = "shaderCacheTest.bin";
+	ASSERT_TRUE(Engine::ShaderCache::writeBinary(path, written));
+
+	Engine::ProgramBinary read;
+	ASSERT_TRUE(Engine::ShaderCache::readBinary(path, read));
+	std::remove(path);
+
+	EXPECT_EQ(read.format, written.format);
+	EXPECT_EQ(read.data, written.data);
+}
+
+TEST(ShaderCache, MissingFileIsAMiss)
+{
+	Engine::ProgramBinary read;
+	EXPECT_FALSE(Engine::ShaderCache::readBinary("shaderCacheTestMissing.bin", read));
+}
+
+TEST(ShaderCache, SizeMismatchIsAMiss)
+{
+	const char* path = "shaderCacheTest.bin";
+
+	// A header claiming far more data than follows it.
+	uint32_t header[4] = { 0x4E494247, 1, 0x8E21, 0xFFFFFFF0u };
+	{
+		std::ofstream handle(path, std::ios::out | std::ios::binary);
+		handle.write(reinterpret_cast<const char*>(header), sizeof(header));
+		handle.write("abcd", 4);
+	}
+
+	Engine::ProgramBinary read;
+	EXPECT_FALSE(Engine::ShaderCache::readBinary(path, read));
+	std::remove(path);
+}
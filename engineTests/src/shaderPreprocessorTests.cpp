@@ -0,0 +1,79 @@
+#include "shaderPreprocessorTests.h"
+#include <cstdio>
+#include <fstream>
+
+TEST(ShaderPreprocessor, FeatureDefinesFollowBitOrder)
+{
+	auto defines = Engine::ShaderPreprocessor::featureDefines(Engine::ShaderFeatures::AlphaTest | Engine::ShaderFeatures::Instanced);
+
+	ASSERT_EQ(defines.size(), 2);
+	EXPECT_EQ(defines[0], "INSTANCED");
+	EXPECT_EQ(defines[1], "ALPHA_TEST");
+	EXPECT_TRUE(Engine::ShaderPreprocessor::featureDefines(Engine::ShaderFeatures::None).empty());
+}
+
+TEST(ShaderPreprocessor, DefinesFollowVersionAndExtensions)
+{
+	std::string source = "\n#version 440 core\n#extension GL_ARB_bindless_texture : enable\n\nvoid main() {}\n";
+	std::string result = Engine::ShaderPreprocessor::injectDefines(source, { "INSTANCED" });
+
+	EXPECT_EQ(result, "\n#version 440 core\n#extension GL_ARB_bindless_texture : enable\n#define INSTANCED\n\nvoid main() {}\n");
+	EXPECT_EQ(Engine::ShaderPreprocessor::injectDefines(source, {}), source);
+}
+
+TEST(ShaderPreprocessor, SplitStagesAtRegions)
+{
+	auto stages = Engine::ShaderPreprocessor::splitStages("ignored\n#region Vertex\nvert\n#region Fragment\nfrag\n");
+
+	EXPECT_EQ(stages[Engine::ShaderStages::Vertex], "vert\n");
+	EXPECT_EQ(stages[Engine::ShaderStages::Fragment], "frag\n");
+	EXPECT_TRUE(stages[Engine::ShaderStages::Geometry].empty());
+}
+
+TEST(ShaderPreprocessor, IncludesResolveOnce)
+{
+	{
+		std::ofstream("shaderPreprocessorCommon.glsl") << "common\n";
+		std::ofstream("shaderPreprocessorLighting.glsl") << "#include \"shaderPreprocessorCommon.glsl\"\nlighting\n";
+		std::ofstream("shaderPreprocessorMain.glsl") << "#include \"shaderPreprocessorCommon.glsl\"\n#include \"shaderPreprocessorLighting.glsl\"\nmain\n";
+	}
+
+	std::string source, error;
+	bool resolved = Engine::ShaderPreprocessor::resolveIncludes("shaderPreprocessorMain.glsl", source, error);
+
+	std::string missingSource;
+	bool missing = Engine::ShaderPreprocessor::resolveIncludes("shaderPreprocessorMissing.glsl", missingSource, error);
+
+	std::remove("shaderPreprocessorCommon.glsl");
+	std::remove("shaderPreprocessorLighting.glsl");
+	std::remove("shaderPreprocessorMain.glsl");
+
+	EXPECT_TRUE(resolved);
+	EXPECT_EQ(source, "common\nlighting\nmain\n");
+	EXPECT_FALSE(missing);
+	EXPECT_FALSE(error.empty());
+}
+
+TEST(ShaderPreprocessor, EachStageGetsItsOwnIncludes)
+{
+	// The fragment stage reaches the shared header through another include, after the vertex stage already included it.
+	{
+		std::ofstream("shaderPreprocessorBlocks.glsl") << "blocks\n";
+		std::ofstream("shaderPreprocessorLighting.glsl") << "#include \"shaderPreprocessorBlocks.glsl\"\nlighting\n";
+		std::ofstream("shaderPreprocessorStages.glsl") << "#region Vertex\n#version 450\n#include \"shaderPreprocessorBlocks.glsl\"\nvert\n"
+			"#region Fragment\n#version 450\n#include \"shaderPreprocessorLighting.glsl\"\n#include \"shaderPreprocessorBlocks.glsl\"\nfrag\n";
+	}
+
+	Engine::ShaderSources sources;
+	std::string error;
+	bool loaded = Engine::ShaderPreprocessor::load("shaderPreprocessorStages.glsl", Engine::ShaderFeatures::None, sources, error);
+
+	std::remove("shaderPreprocessorBlocks.glsl");
+	std::remove("shaderPreprocessorLighting.glsl");
+	std::remove("shaderPreprocessorStages.glsl");
+
+	ASSERT_TRUE(loaded) << error;
+	EXPECT_EQ(sources[Engine::ShaderStages::Vertex], "#version 450\nblocks\nvert\n");
+	EXPECT_EQ(sources[Engine::ShaderStages::Fragment], "#version 450\nblocks\nlighting\nfrag\n");
+	EXPECT_TRUE(sources[Engine::ShaderStages::Geometry].empty());
+}
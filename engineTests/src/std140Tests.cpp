@@ -0,0 +1,45 @@
+#include "std140Tests.h"
+
+TEST(Std140, CameraBlockOffsets)
+{
+	using Layout = Engine::UniformBlocks::CameraLayout;
+
+	EXPECT_EQ(Layout::offsets[0], 0);
+	EXPECT_EQ(Layout::offsets[1], 64);
+	EXPECT_EQ(Layout::offsets[2], 128);
+	EXPECT_EQ(Layout::size, 144);
+}
+
+TEST(Std140, MixedBlockOffsets)
+{
+	using Layout = Engine::Std140Layout<float, glm::vec3, float, glm::vec2, glm::mat3, glm::vec4>;
+
+	static_assert(Layout::offsets[1] == 16, "vec3 must be aligned to 16 bytes");
+
+	EXPECT_EQ(Layout::offsets[0], 0);
+	EXPECT_EQ(Layout::offsets[1], 16);
+	EXPECT_EQ(Layout::offsets[2], 28);
+	EXPECT_EQ(Layout::offsets[3], 32);
+	EXPECT_EQ(Layout::offsets[4], 48);
+	EXPECT_EQ(Layout::offsets[5], 96);
+	EXPECT_EQ(Layout::size, 112);
+}
+
+TEST(Std140, WriterPadsMat3Columns)
+{
+	using Layout = Engine::Std140Layout<float, glm::mat3>;
+	Engine::Std140Writer<Layout> writer;
+
+	glm::mat3 m(glm::vec3(1.f, 2.f, 3.f), glm::vec3(4.f, 5.f, 6.f), glm::vec3(7.f, 8.f, 9.f));
+	writer.set<0>(0.5f);
+	writer.set<1>(m);
+
+	const float* data = reinterpret_cast<const float*>(writer.data());
+	EXPECT_EQ(writer.size(), 64);
+	EXPECT_EQ(data[0], 0.5f);
+	EXPECT_EQ(data[4], 1.f);
+	EXPECT_EQ(data[6], 3.f);
+	EXPECT_EQ(data[8], 4.f);
+	EXPECT_EQ(data[12], 7.f);
+	EXPECT_EQ(data[14], 9.f);
+}
@@ -0,0 +1,120 @@
+#include "textureCompressionTests.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+TEST(TextureCompression, MipChainReachesOnePixel)
+{
+	std::vector<uint8_t> pixels(8 * 2 * 3, 100);
+	auto chain = Engine::TextureCompression::buildMipChain(pixels.data(), 8, 2, 3);
+
+	ASSERT_EQ(chain.size(), 4);
+	EXPECT_EQ(chain[1].width, 4);
+	EXPECT_EQ(chain[1].height, 1);
+	EXPECT_EQ(chain[3].width, 1);
+	EXPECT_EQ(chain[3].height, 1);
+	EXPECT_EQ(chain[3].data[0], 100);
+	EXPECT_EQ(chain[3].data[3], 255);
+}
+
+TEST(TextureCompression, SolidBlockEncodesExactly)
+{
+	uint8_t block[64];
+	for (int i = 0; i < 16; i++) { block[i * 4] = 255; block[i * 4 + 1] = 0; block[i * 4 + 2] = 0; block[i * 4 + 3] = 128; }
+
+	uint8_t out[16];
+	Engine::TextureCompression::encodeBC3Block(block, out);
+
+	// Alpha endpoints match so every alpha index is 0.
+	EXPECT_EQ(out[0], 128);
+	EXPECT_EQ(out[1], 128);
+	for (int i = 2; i < 8; i++) EXPECT_EQ(out[i], 0);
+
+	// Pure red in 5:6:5, every colour index selecting the first endpoint.
+	EXPECT_EQ(out[8] | (out[9] << 8), 0xF800);
+	for (int i = 12; i < 16; i++) EXPECT_EQ(out[i], 0);
+}
+
+TEST(TextureCompression, DDSRoundTrip)
+{
+	std::vector<uint8_t> pixels(6 * 5 * 4);
+	for (size_t i = 0; i < pixels.size(); i++) pixels[i] = static_cast<uint8_t>(i * 7);
+
+	Engine::TextureData written = Engine::TextureCompression::compress(pixels.data(), 6, 5, 4, Engine::TextureFormat::BC3);
+	ASSERT_EQ(written.mips.size(), 3);
+	EXPECT_EQ(written.mips[0].data.size(), 2 * 2 * 16);
+
+	const char* path = "textureCompressionTest.dds";
+	ASSERT_TRUE(Engine::TextureCompression::writeDDS(path, written));
+
+	Engine::TextureData read;
+	ASSERT_TRUE(Engine::TextureCompression::readDDS(path, read));
+	std::remove(path);
+
+	EXPECT_EQ(read.format, Engine::TextureFormat::BC3);
+	ASSERT_EQ(read.mips.size(), written.mips.size());
+	for (size_t i = 0; i < read.mips.size(); i++)
+	{
+		EXPECT_EQ(read.mips[i].width, written.mips[i].width);
+		EXPECT_EQ(read.mips[i].height, written.mips[i].height);
+		EXPECT_EQ(read.mips[i].data, written.mips[i].data);
+	}
+}
+
+TEST(TextureCompression, CompressMipChainMatchesCompress)
+{
+	std::vector<uint8_t> pixels(8 * 4 * 3);
+	for (size_t i = 0; i < pixels.size(); i++) pixels[i] = static_cast<uint8_t>(i * 13);
+
+	auto chain = Engine::TextureCompression::buildMipChain(pixels.data(), 8, 4, 3);
+	Engine::TextureData fromChain = Engine::TextureCompression::compressMipChain(chain, Engine::TextureFormat::BC1);
+	Engine::TextureData fromPixels = Engine::TextureCompression::compress(pixels.data(), 8, 4, 3, Engine::TextureFormat::BC1);
+
+	EXPECT_EQ(fromChain.format, Engine::TextureFormat::BC1);
+	ASSERT_EQ(fromChain.mips.size(), fromPixels.mips.size());
+	for (size_t i = 0; i < fromChain.mips.size(); i++) EXPECT_EQ(fromChain.mips[i].data, fromPixels.mips[i].data);
+}
+
+TEST(TextureCompression, DDSRejectsMismatchedLength)
+{
+	std::vector<uint8_t> pixels(8 * 8 * 4, 50);
+	Engine::TextureData written = Engine::TextureCompression::compress(pixels.data(), 8, 8, 4, Engine::TextureFormat::BC1);
+
+	const char* path = "textureCompressionTest.dds";
+	ASSERT_TRUE(Engine::TextureCompression::writeDDS(path, written));
+
+	// Drop the last byte of the smallest level.
+	std::vector<char> bytes;
+	{
+		std::ifstream handle(path, std::ios::in | std::ios::binary);
+		bytes.assign(std::istreambuf_iterator<char>(handle), std::istreambuf_iterator<char>());
+	}
+	{
+		std::ofstream handle(path, std::ios::out | std::ios::binary);
+		handle.write(bytes.data(), bytes.size() - 1);
+	}
+
+	Engine::TextureData read;
+	EXPECT_FALSE(Engine::TextureCompression::readDDS(path, read));
+
+	// A header claiming a far larger texture than the file holds.
+	uint32_t width = 4096;
+	memcpy(bytes.data() + 4 + 3 * 4, &width, sizeof(width));
+	{
+		std::ofstream handle(path, std::ios::out | std::ios::binary);
+		handle.write(bytes.data(), bytes.size());
+	}
+	EXPECT_FALSE(Engine::TextureCompression::readDDS(path, read));
+	std::remove(path);
+}
+
+TEST(TextureCompression, CachePathsKeepSourcesApart)
+{
+	using Engine::TextureCompression::cachePath;
+
+	EXPECT_NE(cachePath("a/b.png"), cachePath("a_b.png"));
+	EXPECT_EQ(cachePath("./a/b.png"), cachePath("a/b.png"));
+	EXPECT_EQ(cachePath("a/c/../b.png"), cachePath("a/b.png"));
+	EXPECT_EQ(cachePath("a\\b.png"), cachePath("a/b.png"));
+}
@@ -0,0 +1,134 @@
+#include "transformHierarchyTests.h"
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+	/** @brief Check two matrices agree to within floating point error. */
+	void expectNear(const glm::mat4& a, const glm::mat4& b)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			for (int r = 0; r < 4; r++) EXPECT_NEAR(a[c][r], b[c][r], 1e-5f);
+		}
+	}
+
+	/** @brief Check if a transform was recomputed by the last update. */
+	bool wasUpdated(const Engine::TransformHierarchy& hierarchy, Engine::TransformID id)
+	{
+		const auto& updated = hierarchy.getUpdated();
+		return std::find(updated.begin(), updated.end(), id) != updated.end();
+	}
+}
+
+TEST(TransformHierarchy, WorldMatchesGlmComposition)
+{
+	Engine::TransformHierarchy hierarchy;
+	Engine::TransformID root = hierarchy.create();
+	Engine::TransformID child = hierarchy.create(root);
+
+	glm::quat spin = glm::angleAxis(0.7f, glm::normalize(glm::vec3(0.f, 1.f, 1.f)));
+	hierarchy.setPosition(root, glm::vec3(1.f, 2.f, 3.f));
+	hierarchy.setRotation(root, spin);
+	hierarchy.setScale(root, glm::vec3(2.f, 1.f, 0.5f));
+	hierarchy.setPosition(child, glm::vec3(0.f, 0.f, -4.f));
+	hierarchy.update();
+
+	glm::mat4 rootWorld = glm::translate(glm::mat4(1.f), glm::vec3(1.f, 2.f, 3.f)) * glm::mat4_cast(spin) * glm::scale(glm::mat4(1.f), glm::vec3(2.f, 1.f, 0.5f));
+	expectNear(hierarchy.getWorld(root), rootWorld);
+	expectNear(hierarchy.getWorld(child), rootWorld * glm::translate(glm::mat4(1.f), glm::vec3(0.f, 0.f, -4.f)));
+
+	// Normal matrices undo the parent's non uniform scale.
+	glm::mat3 expectedNormal = glm::transpose(glm::inverse(glm::mat3(hierarchy.getWorld(child))));
+	for (int c = 0; c < 3; c++)
+	{
+		for (int r = 0; r < 3; r++) EXPECT_NEAR(hierarchy.getNormal(child)[c][r], expectedNormal[c][r], 1e-5f);
+	}
+}
+
+TEST(TransformHierarchy, OnlyDirtySubtreesUpdate)
+{
+	Engine::TransformHierarchy hierarchy;
+	Engine::TransformID a = hierarchy.create();
+	Engine::TransformID aChild = hierarchy.create(a);
+	Engine::TransformID b = hierarchy.create();
+	Engine::TransformID bChild = hierarchy.create(b);
+	hierarchy.update();
+	EXPECT_EQ(hierarchy.getUpdated().size(), 4u);
+
+	// Nothing changed, nothing is recomputed.
+	hierarchy.update();
+	EXPECT_TRUE(hierarchy.getUpdated().empty());
+
+	hierarchy.setPosition(a, glm::vec3(5.f, 0.f, 0.f));
+	hierarchy.update();
+	EXPECT_EQ(hierarchy.getUpdated().size(), 2u);
+	EXPECT_TRUE(wasUpdated(hierarchy, a));
+	EXPECT_TRUE(wasUpdated(hierarchy, aChild));
+	EXPECT_FALSE(wasUpdated(hierarchy, b));
+	EXPECT_FALSE(wasUpdated(hierarchy, bChild));
+	EXPECT_FLOAT_EQ(hierarchy.getWorld(aChild)[3].x, 5.f);
+}
+
+TEST(TransformHierarchy, ReparentingKeepsHandles)
+{
+	Engine::TransformHierarchy hierarchy;
+	Engine::TransformID child = hierarchy.create();
+	Engine::TransformID grandchild = hierarchy.create(child);
+	Engine::TransformID parent = hierarchy.create();
+	hierarchy.setPosition(child, glm::vec3(0.f, 1.f, 0.f));
+	hierarchy.setPosition(grandchild, glm::vec3(0.f, 0.f, 1.f));
+	hierarchy.setPosition(parent, glm::vec3(10.f, 0.f, 0.f));
+
+	// The parent was created after the child, so the hierarchy must reorder itself.
+	ASSERT_TRUE(hierarchy.setParent(child, parent));
+	EXPECT_FALSE(hierarchy.setParent(parent, grandchild));
+	hierarchy.update();
+
+	EXPECT_EQ(hierarchy.getParent(child), parent);
+	EXPECT_EQ(hierarchy.getParent(grandchild), child);
+	EXPECT_EQ(hierarchy.getParent(parent), Engine::NullTransform);
+	EXPECT_EQ(hierarchy.getPosition(parent), glm::vec3(10.f, 0.f, 0.f));
+	EXPECT_EQ(glm::vec3(hierarchy.getWorld(grandchild)[3]), glm::vec3(10.f, 1.f, 1.f));
+}
+
+TEST(TransformHierarchy, DestroyMovesChildrenToParent)
+{
+	Engine::TransformHierarchy hierarchy;
+	Engine::TransformID root = hierarchy.create();
+	Engine::TransformID middle = hierarchy.create(root);
+	Engine::TransformID leaf = hierarchy.create(middle);
+	Engine::TransformID other = hierarchy.create();
+	Engine::TransformID otherChild = hierarchy.create(other);
+	hierarchy.setPosition(root, glm::vec3(1.f, 0.f, 0.f));
+	hierarchy.setPosition(middle, glm::vec3(0.f, 5.f, 0.f));
+	hierarchy.setPosition(leaf, glm::vec3(0.f, 0.f, 1.f));
+	hierarchy.setPosition(other, glm::vec3(0.f, 0.f, -3.f));
+	hierarchy.setPosition(otherChild, glm::vec3(2.f, 0.f, 0.f));
+	hierarchy.update();
+
+	// The last slot fills the hole, so the moved transform keeps its handle and world matrix without being recomputed.
+	hierarchy.destroy(middle);
+	EXPECT_EQ(hierarchy.size(), 4u);
+	EXPECT_EQ(hierarchy.getParent(leaf), root);
+	EXPECT_EQ(hierarchy.getParent(otherChild), other);
+	EXPECT_EQ(glm::vec3(hierarchy.getWorld(otherChild)[3]), glm::vec3(2.f, 0.f, -3.f));
+
+	// Only the orphaned child is recomputed, now relative to its grandparent.
+	hierarchy.update();
+	EXPECT_TRUE(wasUpdated(hierarchy, leaf));
+	EXPECT_FALSE(wasUpdated(hierarchy, otherChild));
+	EXPECT_EQ(glm::vec3(hierarchy.getWorld(leaf)[3]), glm::vec3(1.f, 0.f, 1.f));
+
+	// A destroyed handle is reused, and moving a parent still updates a child that was moved into its hole.
+	EXPECT_EQ(hierarchy.create(leaf), middle);
+	hierarchy.destroy(root);
+	hierarchy.setPosition(other, glm::vec3(0.f, 0.f, 3.f));
+	hierarchy.update();
+	EXPECT_EQ(hierarchy.size(), 4u);
+	EXPECT_EQ(hierarchy.getParent(leaf), Engine::NullTransform);
+	EXPECT_EQ(hierarchy.getParent(middle), leaf);
+	EXPECT_EQ(glm::vec3(hierarchy.getWorld(leaf)[3]), glm::vec3(0.f, 0.f, 1.f));
+	EXPECT_EQ(glm::vec3(hierarchy.getWorld(middle)[3]), glm::vec3(0.f, 0.f, 1.f));
+	EXPECT_EQ(glm::vec3(hierarchy.getWorld(otherChild)[3]), glm::vec3(2.f, 0.f, 3.f));
+}
@@ -0,0 +1,78 @@
+#include "transformKernelsTests.h"
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace
+{
+	/** @brief Random transforms as streams, with scales kept away from zero. */
+	struct RandomTransforms
+	{
+		std::vector<float> values[10];
+		Engine::TRSStreams trs;
+
+		explicit RandomTransforms(uint32_t count)
+		{
+			std::mt19937 random(7);
+			std::uniform_real_distribution<float> unit(-1.f, 1.f), scale(0.25f, 4.f);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				glm::quat rotation = glm::normalize(glm::quat(unit(random), unit(random), unit(random), unit(random)));
+				float components[10] = { 10.f * unit(random), 10.f * unit(random), 10.f * unit(random), rotation.x, rotation.y, rotation.z, rotation.w, scale(random), scale(random), scale(random) };
+				for (uint32_t c = 0; c < 10; c++) values[c].push_back(components[c]);
+			}
+			trs = { { values[0].data(), values[1].data(), values[2].data() }, { values[3].data(), values[4].data(), values[5].data(), values[6].data() }, { values[7].data(), values[8].data(), values[9].data() } };
+		}
+
+		/** @brief The matrix glm composes for one transform. */
+		glm::mat4 expected(uint32_t i) const
+		{
+			glm::quat rotation(values[6][i], values[3][i], values[4][i], values[5][i]);
+			return glm::translate(glm::mat4(1.f), glm::vec3(values[0][i], values[1][i], values[2][i])) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.f), glm::vec3(values[7][i], values[8][i], values[9][i]));
+		}
+	};
+}
+
+TEST(TransformKernels, EveryInstructionSetMatchesGlm)
+{
+	// An odd count runs every path's whole vectors and then the narrower paths' tails.
+	const uint32_t count = 37;
+	RandomTransforms transforms(count);
+
+	uint32_t supported = static_cast<uint32_t>(Engine::CpuFeatures::getSupportedInstructionSet());
+	for (uint32_t set = 0; set <= supported; set++)
+	{
+		SCOPED_TRACE(Engine::CpuFeatures::getInstructionSetName(static_cast<Engine::InstructionSet>(set)));
+		std::vector<glm::mat4> matrices(count);
+		std::vector<glm::mat3> normals(count);
+		Engine::TransformKernels::compose(transforms.trs, count, matrices.data(), normals.data(), static_cast<Engine::InstructionSet>(set));
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			glm::mat4 expected = transforms.expected(i);
+			glm::mat3 expectedNormal = glm::transpose(glm::inverse(glm::mat3(expected)));
+			for (int c = 0; c < 4; c++)
+			{
+				for (int r = 0; r < 4; r++) EXPECT_NEAR(matrices[i][c][r], expected[c][r], 1e-4f);
+			}
+			for (int c = 0; c < 3; c++)
+			{
+				for (int r = 0; r < 3; r++) EXPECT_NEAR(normals[i][c][r], expectedNormal[c][r], 1e-4f);
+			}
+		}
+	}
+}
+
+TEST(TransformKernels, NormalsAreOptional)
+{
+	const uint32_t count = 9;
+	RandomTransforms transforms(count);
+	std::vector<glm::mat4> matrices(count);
+	Engine::TransformKernels::compose(transforms.trs, count, matrices.data(), nullptr);
+	for (uint32_t i = 0; i < count; i++) EXPECT_NEAR(matrices[i][3][0], transforms.values[0][i], 1e-6f);
+
+	// Asking for a wider set than the CPU has falls back rather than faulting.
+	Engine::TransformKernels::compose(transforms.trs, count, matrices.data(), nullptr, Engine::InstructionSet::AVX2);
+	EXPECT_NEAR(matrices[count - 1][0][0], transforms.expected(count - 1)[0][0], 1e-4f);
+}
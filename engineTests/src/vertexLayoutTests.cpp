@@ -0,0 +1,74 @@
+#include "vertexLayoutTests.h"
+#include <cstdint>
+
+namespace
+{
+	struct PaddedVertex
+	{
+		float position[3];
+		int16_t normal[3];
+		int16_t uv[2];
+	};
+
+	struct PackedVertex
+	{
+		uint16_t uv[2];
+		uint32_t normal;
+		uint16_t tangent;
+	};
+
+	using PaddedLayout = Engine::VertexLayout<Engine::VertexAttributes::Float3, Engine::VertexAttributes::Short3N, Engine::VertexAttributes::Short2N>;
+	using PackedLayout = Engine::VertexLayout<Engine::VertexAttributes::Half2, Engine::VertexAttributes::Int2101010Rev, Engine::VertexAttribute<Engine::ShaderDataType::Short>>;
+}
+
+TEST(VertexLayout, StridePadsLikeStruct)
+{
+	static_assert(PaddedLayout::matches<PaddedVertex>({ offsetof(PaddedVertex, position), offsetof(PaddedVertex, normal), offsetof(PaddedVertex, uv) }), "");
+	EXPECT_EQ(PaddedLayout::stride, 24);
+	EXPECT_EQ(PaddedLayout::elements[2].m_offset, 18);
+	EXPECT_TRUE(PaddedLayout::elements[1].m_normalised);
+}
+
+TEST(VertexLayout, OffsetsAlignLikeStruct)
+{
+	static_assert(PackedLayout::matches<PackedVertex>({ offsetof(PackedVertex, uv), offsetof(PackedVertex, normal), offsetof(PackedVertex, tangent) }), "");
+	EXPECT_EQ(PackedLayout::elements[1].m_offset, 4);
+	EXPECT_EQ(PackedLayout::stride, 12);
+}
+
+TEST(VertexLayout, MismatchedStructIsRejected)
+{
+	using Reordered = Engine::VertexLayout<Engine::VertexAttributes::Short3N, Engine::VertexAttributes::Float3, Engine::VertexAttributes::Short2N>;
+	EXPECT_FALSE(Reordered::matches<PaddedVertex>({ offsetof(PaddedVertex, position), offsetof(PaddedVertex, normal), offsetof(PaddedVertex, uv) }));
+}
+
+TEST(VertexLayout, ViewCoversStaticTable)
+{
+	Engine::BufferLayoutView view = Engine::VertexLayout<Engine::VertexAttributes::InstanceMat4>::view();
+
+	uint32_t count = 0;
+	for (const Engine::BufferElement& element : view)
+	{
+		EXPECT_EQ(element.m_divisor, 1);
+		count++;
+	}
+	EXPECT_EQ(count, 1);
+	EXPECT_EQ(view.getStride(), 64);
+}
+
+TEST(VertexLayout, InstanceTransformFollowsMeshAttributes)
+{
+	using Layout = Engine::InstanceTransform::Layout;
+
+	// Every matrix advances once per instance, with its columns in consecutive slots.
+	for (const Engine::BufferElement& element : Layout::view()) EXPECT_EQ(element.m_divisor, 1);
+	EXPECT_EQ(Layout::elements[0].m_offset, 0);
+	EXPECT_EQ(Layout::elements[1].m_offset, 64);
+	EXPECT_EQ(Layout::stride, 100);
+	EXPECT_EQ(Engine::SDT::size(Engine::ShaderDataType::Mat3) / Engine::SDT::attributeSlots(Engine::ShaderDataType::Mat3), 12);
+
+	// Added after an imported mesh's buffer, the matrices land on the locations the instanced shaders read.
+	EXPECT_EQ(Engine::MeshImporter::Vertex::Layout::slots, Engine::InstanceTransform::modelLocation);
+	EXPECT_EQ(Engine::InstanceTransform::modelLocation + Engine::SDT::attributeSlots(Engine::ShaderDataType::Mat4), Engine::InstanceTransform::normalMatrixLocation);
+	EXPECT_EQ(Engine::InstanceTransform::modelLocation + Layout::slots, 10);
+}
@@ -0,0 +1,62 @@
+#include "vertexPackingTests.h"
+#include "rendering/shaderDataType.h"
+#include <cmath>
+#include <cstring>
+
+TEST(VertexPacking, HalfRoundTripsExactValues)
+{
+	EXPECT_EQ(Engine::VertexPacking::toHalf(1.f), 0x3C00);
+	EXPECT_EQ(Engine::VertexPacking::toHalf(-2.f), 0xC000);
+	EXPECT_EQ(Engine::VertexPacking::toHalf(65504.f), 0x7BFF);
+	EXPECT_EQ(Engine::VertexPacking::toHalf(1e6f), 0x7C00);
+
+	for (float value : { 0.f, 0.5f, 0.33f, -0.66f, 1000.f, 6.1e-5f, 3e-7f })
+	{
+		float roundTrip = Engine::VertexPacking::fromHalf(Engine::VertexPacking::toHalf(value));
+		EXPECT_NEAR(roundTrip, value, std::abs(value) * 1e-3f + 1e-7f);
+	}
+}
+
+TEST(VertexPacking, UByte4NMatchesMemoryOrder)
+{
+	uint32_t packed = Engine::VertexPacking::packUByte4N(glm::vec4(1.f, 0.f, 0.5f, 2.f));
+	uint8_t bytes[4];
+	memcpy(bytes, &packed, 4);
+
+	EXPECT_EQ(bytes[0], 255);
+	EXPECT_EQ(bytes[1], 0);
+	EXPECT_EQ(bytes[2], 128);
+	EXPECT_EQ(bytes[3], 255);
+}
+
+TEST(VertexPacking, Int2101010RevRoundTrips)
+{
+	glm::vec4 normal(0.f, -1.f, 0.6f, -1.f);
+	glm::vec4 unpacked = Engine::VertexPacking::unpackInt2101010Rev(Engine::VertexPacking::packInt2101010Rev(normal));
+
+	for (int i = 0; i < 4; i++) EXPECT_NEAR(unpacked[i], normal[i], 1.f / 511.f);
+}
+
+TEST(VertexPacking, OctahedralRoundTripsEveryOctant)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec3 normal = glm::normalize(glm::vec3(i & 1 ? -0.3f : 0.5f, i & 2 ? -0.8f : 0.2f, i & 4 ? -0.4f : 0.7f));
+		glm::vec3 unpacked = Engine::VertexPacking::unpackOct16(Engine::VertexPacking::packOct16(normal));
+
+		EXPECT_GT(glm::dot(unpacked, normal), 0.99999f);
+	}
+
+	// A zero normal, such as from a degenerate face, still decodes to a unit vector.
+	EXPECT_EQ(Engine::VertexPacking::unpackOct16(Engine::VertexPacking::packOct16(glm::vec3(0.f))), glm::vec3(0.f, 0.f, 1.f));
+}
+
+TEST(VertexPacking, CompactTypesSizes)
+{
+	EXPECT_EQ(Engine::SDT::size(Engine::ShaderDataType::Half2), 4);
+	EXPECT_EQ(Engine::SDT::size(Engine::ShaderDataType::UByte4N), 4);
+	EXPECT_EQ(Engine::SDT::componentCount(Engine::ShaderDataType::Int2101010Rev), 4);
+	EXPECT_EQ(Engine::SDT::componentCount(Engine::ShaderDataType::Oct16), 2);
+	EXPECT_TRUE(Engine::SDT::isNormalised(Engine::ShaderDataType::Int2101010Rev));
+	EXPECT_FALSE(Engine::SDT::isNormalised(Engine::ShaderDataType::Half4));
+}
@@ -7,9 +7,9 @@ layout(location = 1) in vec3 a_vertexColour;
 
 out vec3 fragmentColour;
 
+#include "include/sceneBlocks.glsl"
+
 uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
 
 void main()
 {
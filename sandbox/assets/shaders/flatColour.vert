@@ -5,9 +5,14 @@ layout(location = 1) in vec3 a_vertexColour;
 
 out vec3 fragmentColour;
 
+layout(std140, binding = 0) uniform b_camera
+{
+	mat4 u_view;
+	mat4 u_projection;
+	vec3 u_viewPos;
+};
+
 uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
 
 void main()
 {
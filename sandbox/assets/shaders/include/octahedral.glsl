@@ -0,0 +1,11 @@
+// Decodes an Oct16 attribute, written on the CPU by VertexPacking::packOct16.
+vec3 octDecode(vec2 encoded)
+{
+	vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	if (normal.z < 0.0)
+	{
+		vec2 signs = vec2(encoded.x >= 0.0 ? 1.0 : -1.0, encoded.y >= 0.0 ? 1.0 : -1.0);
+		normal.xy = (1.0 - abs(encoded.yx)) * signs;
+	}
+	return normalize(normal);
+}
@@ -0,0 +1,17 @@
+#include "sceneBlocks.glsl"
+
+vec3 phongLighting(vec3 normal, vec3 fragmentPos)
+{
+	float ambientStrength = 0.4;
+	vec3 ambient = ambientStrength * u_lightColour;
+	vec3 norm = normalize(normal);
+	vec3 lightDir = normalize(u_lightPos - fragmentPos);
+	float diff = max(dot(norm, lightDir), 0.0);
+	vec3 diffuse = diff * u_lightColour;
+	float specularStrength = 0.8;
+	vec3 viewDir = normalize(u_viewPos - fragmentPos);
+	vec3 reflectDir = reflect(-lightDir, norm);  
+	float spec = pow(max(dot(viewDir, reflectDir), 0.0), 64);
+	vec3 specular = specularStrength * spec * u_lightColour;  
+	return ambient + diffuse + specular;
+}
@@ -0,0 +1,12 @@
+layout(std140, binding = 0) uniform b_camera
+{
+	mat4 u_view;
+	mat4 u_projection;
+	vec3 u_viewPos;
+};
+
+layout(std140, binding = 1) uniform b_lights
+{
+	vec3 u_lightPos;
+	vec3 u_lightColour;
+};
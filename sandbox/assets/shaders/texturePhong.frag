@@ -6,10 +6,19 @@ in vec3 normal;
 in vec3 fragmentPos;
 in vec2 texCoord;
 
+layout(std140, binding = 0) uniform b_camera
+{
+	mat4 u_view;
+	mat4 u_projection;
+	vec3 u_viewPos;
+};
+
+layout(std140, binding = 1) uniform b_lights
+{
+	vec3 u_lightPos;
+	vec3 u_lightColour;
+};
 
-uniform vec3 u_lightPos; 
-uniform vec3 u_viewPos; 	
-uniform vec3 u_lightColour;	
 uniform vec4 u_tint;
 
 uniform sampler2D u_texData;
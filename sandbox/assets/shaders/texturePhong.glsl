@@ -3,28 +3,41 @@
 #version 440 core
 			
 layout(location = 0) in vec3 a_vertexPosition;
-layout(location = 1) in vec3 a_vertexNormal;
+layout(location = 1) in vec2 a_vertexNormal;
 layout(location = 2) in vec2 a_texCoord;
 
 out vec3 fragmentPos;
 out vec3 normal;
 out vec2 texCoord;
 
+#include "include/sceneBlocks.glsl"
+#include "include/octahedral.glsl"
+
+// Normal matrices are computed on the CPU, once per object rather than once per vertex.
+#ifdef INSTANCED
+layout(location = 3) in mat4 a_model;
+layout(location = 7) in mat3 a_normalMatrix;
+#define MODEL a_model
+#define NORMAL_MATRIX a_normalMatrix
+#else
 uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
+uniform mat3 u_normalMatrix;
+#define MODEL u_model
+#define NORMAL_MATRIX u_normalMatrix
+#endif
 
 void main()
 {
-	fragmentPos = vec3(u_model * vec4(a_vertexPosition, 1.0));
-	normal = mat3(transpose(inverse(u_model))) * a_vertexNormal;
+	fragmentPos = vec3(MODEL * vec4(a_vertexPosition, 1.0));
+	normal = NORMAL_MATRIX * octDecode(a_vertexNormal);
 	texCoord = vec2(a_texCoord.x, a_texCoord.y);
-	gl_Position =  u_projection * u_view * u_model * vec4(a_vertexPosition,1.0);
+	gl_Position =  u_projection * u_view * MODEL * vec4(a_vertexPosition,1.0);
 }
 
 #region Fragment
 
 #version 440 core
+#extension GL_ARB_bindless_texture : enable
 			
 layout(location = 0) out vec4 colour;
 
@@ -32,26 +45,53 @@ in vec3 normal;
 in vec3 fragmentPos;
 in vec2 texCoord;
 
-uniform vec3 u_lightPos; 
-uniform vec3 u_viewPos; 	
-uniform vec3 u_lightColour;
-uniform vec4 u_tint;	
+#include "include/phong.glsl"
+
+#ifdef MATERIAL_BUFFER
+struct Material
+{
+	uvec2 handle;
+	uint layer;
+	uint useTexData;
+	vec4 tint;
+};
+
+layout(std430, binding = 0) readonly buffer b_materials
+{
+	Material u_materials[];
+};
+
+uniform int u_materialIndex;
+
+uniform sampler2DArray u_texArray;
+uniform sampler2D u_texData;
+
+vec4 sampleMaterial(Material material)
+{
+#ifdef GL_ARB_bindless_texture
+	if (material.handle != uvec2(0)) return texture(sampler2D(material.handle), texCoord);
+#endif
+	if (material.useTexData != 0u) return texture(u_texData, texCoord);
+	return texture(u_texArray, vec3(texCoord, float(material.layer)));
+}
+#else
+uniform vec4 u_tint;
 
 uniform sampler2D u_texData;
+#endif
 
 void main()
 {
-	float ambientStrength = 0.4;
-	vec3 ambient = ambientStrength * u_lightColour;
-	vec3 norm = normalize(normal);
-	vec3 lightDir = normalize(u_lightPos - fragmentPos);
-	float diff = max(dot(norm, lightDir), 0.0);
-	vec3 diffuse = diff * u_lightColour;
-	float specularStrength = 0.8;
-	vec3 viewDir = normalize(u_viewPos - fragmentPos);
-	vec3 reflectDir = reflect(-lightDir, norm);  
-	float spec = pow(max(dot(viewDir, reflectDir), 0.0), 64);
-	vec3 specular = specularStrength * spec * u_lightColour;  
-	
-	colour = vec4((ambient + diffuse + specular), 1.0) * texture(u_texData, texCoord) * u_tint;
-}
\ No newline at end of file
+#ifdef MATERIAL_BUFFER
+	Material material = u_materials[u_materialIndex];
+	vec4 albedo = sampleMaterial(material) * material.tint;
+#else
+	vec4 albedo = texture(u_texData, texCoord) * u_tint;
+#endif
+
+#ifdef ALPHA_TEST
+	if (albedo.a < 0.5) discard;
+#endif
+
+	colour = vec4(phongLighting(normal, fragmentPos), 1.0) * albedo;
+}
@@ -10,9 +10,14 @@ out vec3 fragmentPos;
 out vec3 normal;
 out vec2 texCoord;
 
+layout(std140, binding = 0) uniform b_camera
+{
+	mat4 u_view;
+	mat4 u_projection;
+	vec3 u_viewPos;
+};
+
 uniform mat4 u_model;
-uniform mat4 u_view;
-uniform mat4 u_projection;
 
 
 void main()